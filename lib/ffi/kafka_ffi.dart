@@ -1,5 +1,8 @@
+import 'dart:async';
+import 'dart:convert';
 import 'dart:ffi';
 import 'dart:io';
+import 'dart:typed_data';
 import 'package:ffi/ffi.dart';
 
 // 加载Kafka C/C++客户端库
@@ -26,9 +29,149 @@ typedef KafkaClientHandle = Pointer<Void>;
 // Kafka消息句柄
 typedef KafkaMessageHandle = Pointer<Void>;
 
+// 消息存储句柄
+typedef KafkaStoreHandle = Pointer<Void>;
+
+// 集群主题概览句柄
+typedef KafkaOverviewHandle = Pointer<Void>;
+
+// 主题索引句柄
+typedef KafkaTopicIndexHandle = Pointer<Void>;
+
 // 错误码
 typedef KafkaErrorCode = Int32;
 
+// 消息类型（与kafka_client.h中的KAFKA_PAYLOAD_*保持一致）
+// 消费循环暂停的原因（位掩码，与kafka_client.h中的KAFKA_PAUSE_*保持一致）
+class KafkaPauseReason {
+  static const int ring = 1; // 环形队列积压，UI取得不够快
+  static const int memory = 4; // 进程内存超过软上限
+}
+
+// 消费者配置档（与kafka_client.h中的KAFKA_CONSUMER_PROFILE_*保持一致）
+class KafkaConsumerProfile {
+  static const int standard = 0;
+  static const int scan = 1; // 全量扫描：大批量拉取、深预取队列、不提交偏移量
+}
+
+class KafkaPayloadType {
+  static const int empty = 0;
+  static const int text = 1;
+  static const int json = 2;
+  static const int xml = 3;
+  static const int confluent = 4;
+  static const int binary = 5;
+  static const int avro = 6; // 已按schema解码为JSON
+  static const int protobuf = 7; // 已按schema解码为JSON
+
+  // 能否直接按UTF-8解码
+  static bool isText(int type) => type != confluent && type != binary;
+
+  // 内容是否为JSON文本（可以格式化）
+  static bool isJson(int type) =>
+      type == json || type == avro || type == protobuf;
+
+  static String name(int type) {
+    switch (type) {
+      case empty:
+        return 'Empty';
+      case text:
+        return 'Text';
+      case json:
+        return 'JSON';
+      case xml:
+        return 'XML';
+      case confluent:
+        return 'Schema Registry';
+      case binary:
+        return 'Binary';
+      case avro:
+        return 'Avro';
+      case protobuf:
+        return 'Protobuf';
+      default:
+        return 'Unknown';
+    }
+  }
+}
+
+// 延迟直方图指标（与kafka_client.h中的KAFKA_LATENCY_*保持一致）
+class KafkaLatencyMetric {
+  static const int produceCall = 0; // rd_kafka_produce调用耗时
+  static const int delivery = 1; // 从produce到收到投递报告
+  static const int pollToDrain = 2; // 消息从librdkafka取出到被Dart取走
+  static const int ffiDecode = 3; // Dart解码一批取出的消息
+  static const int count = 4;
+
+  static const List<String> names = [
+    'produceCall',
+    'delivery',
+    'pollToDrain',
+    'ffiDecode',
+  ];
+}
+
+// 原生日志级别（与kafka_client.h中的KAFKA_LOG_*保持一致）
+class KafkaLogLevel {
+  static const int error = 0;
+  static const int warn = 1;
+  static const int info = 2;
+  static const int debug = 3;
+}
+
+// 主题配置值的来源（与rd_kafka_ConfigSource_t一致）
+class KafkaConfigSource {
+  static const int unknown = 0;
+  static const int dynamicTopic = 1;
+  static const int dynamicBroker = 2;
+  static const int dynamicDefaultBroker = 3;
+  static const int staticBroker = 4;
+  static const int defaultConfig = 5;
+
+  static String name(int source) {
+    switch (source) {
+      case dynamicTopic:
+        return 'Topic';
+      case dynamicBroker:
+        return 'Broker';
+      case dynamicDefaultBroker:
+        return 'Cluster';
+      case staticBroker:
+        return 'Broker (static)';
+      case defaultConfig:
+        return 'Default';
+      default:
+        return 'Unknown';
+    }
+  }
+}
+
+// 解码消息中的字符串，非法UTF-8序列替换为U+FFFD而不是抛出异常（不给length时按NUL结尾）
+String _decodeUtf8Lenient(Pointer<Utf8> data, [int? length]) {
+  final bytes = data.cast<Uint8>().asTypedList(length ?? data.length);
+  return utf8.decode(bytes, allowMalformed: true);
+}
+
+// 按消息类型解码内容：文本直接解码，二进制转成十六进制
+String _decodePayload(Pointer<Utf8> data, int length, int payloadType) {
+  if (length <= 0) {
+    return '';
+  }
+  if (KafkaPayloadType.isText(payloadType)) {
+    return _decodeUtf8Lenient(data, length);
+  }
+
+  final bytes = data.cast<Uint8>().asTypedList(length);
+  final result = StringBuffer();
+  for (int i = 0; i < bytes.length; i++) {
+    if (i > 0) {
+      result.write(i % 16 == 0 ? '\n' : ' ');
+    }
+    result.write(bytes[i].toRadixString(16).padLeft(2, '0'));
+  }
+  return result.toString();
+}
+
 // 主题分区结构体
 base class KafkaPartitionInfoStruct extends Struct {
   @Int32()
@@ -48,11 +191,53 @@ base class KafkaPartitionInfoStruct extends Struct {
   external int earliest_offset;
 }
 
+// 分区水位结构体（查询失败时偏移量为-1）
+base class KafkaPartitionOffsetsStruct extends Struct {
+  external Pointer<Utf8> topic;
+
+  @Int32()
+  external int partition;
+
+  @Int32()
+  external int leader;
+
+  @Int64()
+  external int earliest_offset;
+
+  @Int64()
+  external int latest_offset;
+}
+
 // 主题配置参数结构体
 base class KafkaConfigParamStruct extends Struct {
   external Pointer<Utf8> key;
 
   external Pointer<Utf8> value;
+
+  @Int32()
+  external int source;
+
+  @Int32()
+  external int is_default;
+
+  @Int32()
+  external int is_read_only;
+
+  @Int32()
+  external int is_sensitive;
+}
+
+// 主题配置摘要结构体（查询失败时cleanup_policy为空指针）
+base class KafkaTopicConfigSummaryStruct extends Struct {
+  external Pointer<Utf8> topic;
+
+  external Pointer<Utf8> cleanup_policy;
+
+  @Int64()
+  external int retention_ms;
+
+  @Int64()
+  external int retention_bytes;
 }
 
 // 消费者组结构体
@@ -66,6 +251,342 @@ base class KafkaConsumerGroupStruct extends Struct {
   external int lag;
 
   external Pointer<Utf8> status;
+
+  @Int32()
+  external int coordinator;
+
+  @Int64()
+  external int offset;
+}
+
+// 主题完整详情结构体（error非0时其余字段为空）
+base class KafkaTopicDescriptionStruct extends Struct {
+  @Int32()
+  external int error;
+
+  @Int32()
+  external int partition_count;
+
+  @Int32()
+  external int replication_factor;
+
+  @Int32()
+  external int config_count;
+
+  @Int32()
+  external int group_count;
+
+  external Pointer<KafkaPartitionInfoStruct> partitions;
+
+  external Pointer<KafkaConfigParamStruct> configs;
+
+  external Pointer<KafkaConsumerGroupStruct> groups;
+}
+
+// 集群主题概览行结构体
+base class KafkaTopicOverviewStruct extends Struct {
+  external Pointer<Utf8> topic;
+
+  @Int32()
+  external int partition_count;
+
+  @Int32()
+  external int replication_factor;
+
+  @Int32()
+  external int under_replicated;
+
+  @Int64()
+  external int messages;
+
+  external Pointer<Utf8> cleanup_policy;
+
+  @Int64()
+  external int retention_ms;
+
+  @Int64()
+  external int retention_bytes;
+}
+
+// 主题索引刷新结果结构体
+base class KafkaTopicIndexDiffStruct extends Struct {
+  external Pointer<Pointer<Utf8>> added;
+
+  @Int32()
+  external int added_count;
+
+  external Pointer<Pointer<Utf8>> removed;
+
+  @Int32()
+  external int removed_count;
+
+  @Int32()
+  external int total;
+}
+
+// 批量取出的消息结构体
+base class KafkaMessageRecordStruct extends Struct {
+  external Pointer<Utf8> topic;
+
+  external Pointer<Utf8> key;
+
+  external Pointer<Utf8> content;
+
+  @Int32()
+  external int content_len;
+
+  @Int32()
+  external int total_len;
+
+  @Int32()
+  external int payload_type;
+
+  @Int32()
+  external int schema_id;
+
+  @Int32()
+  external int partition;
+
+  @Int64()
+  external int offset;
+
+  @Int64()
+  external int timestamp;
+}
+
+// 客户端统计快照中的broker结构体
+base class KafkaBrokerStatsStruct extends Struct {
+  external Pointer<Utf8> name;
+
+  external Pointer<Utf8> state;
+
+  @Int32()
+  external int node_id;
+
+  @Int64()
+  external int rtt_avg_us;
+
+  @Int64()
+  external int rtt_p99_us;
+
+  @Int64()
+  external int int_latency_avg_us;
+
+  @Int64()
+  external int outbuf_cnt;
+
+  @Int64()
+  external int waitresp_cnt;
+
+  @Int64()
+  external int tx;
+
+  @Int64()
+  external int tx_errs;
+
+  @Int64()
+  external int rx;
+
+  @Int64()
+  external int rx_bytes;
+
+  @Int64()
+  external int rx_errs;
+
+  @Int64()
+  external int req_timeouts;
+
+  @Int64()
+  external int connects;
+
+  @Int64()
+  external int disconnects;
+}
+
+// 客户端统计快照中的主题结构体
+base class KafkaTopicStatsStruct extends Struct {
+  external Pointer<Utf8> topic;
+
+  @Int64()
+  external int batch_size_avg;
+
+  @Int64()
+  external int batch_count_avg;
+
+  @Int64()
+  external int metadata_age_ms;
+
+  @Int32()
+  external int partition_start;
+
+  @Int32()
+  external int partition_count;
+}
+
+// 客户端统计快照中的分区结构体
+base class KafkaPartitionStatsStruct extends Struct {
+  @Int32()
+  external int topic_index;
+
+  @Int32()
+  external int partition;
+
+  @Int32()
+  external int leader;
+
+  @Int64()
+  external int msgq_cnt;
+
+  @Int64()
+  external int xmit_msgq_cnt;
+
+  @Int64()
+  external int fetchq_cnt;
+
+  @Int64()
+  external int app_offset;
+
+  @Int64()
+  external int committed_offset;
+
+  @Int64()
+  external int hi_offset;
+
+  @Int64()
+  external int consumer_lag;
+
+  @Int64()
+  external int tx_msgs;
+
+  @Int64()
+  external int rx_msgs;
+}
+
+// 客户端统计快照结构体
+base class KafkaStatsSnapshotStruct extends Struct {
+  external Pointer<Utf8> name;
+
+  external Pointer<Utf8> type;
+
+  @Int64()
+  external int time;
+
+  @Int64()
+  external int ts_us;
+
+  @Int64()
+  external int replyq;
+
+  @Int64()
+  external int msg_cnt;
+
+  @Int64()
+  external int msg_size;
+
+  @Int64()
+  external int tx;
+
+  @Int64()
+  external int tx_bytes;
+
+  @Int64()
+  external int rx;
+
+  @Int64()
+  external int rx_bytes;
+
+  @Int64()
+  external int tx_msgs;
+
+  @Int64()
+  external int rx_msgs;
+
+  external Pointer<Utf8> group_state;
+
+  @Int64()
+  external int rebalance_cnt;
+
+  external Pointer<KafkaBrokerStatsStruct> brokers;
+
+  @Int32()
+  external int broker_count;
+
+  external Pointer<KafkaTopicStatsStruct> topics;
+
+  @Int32()
+  external int topic_count;
+
+  external Pointer<KafkaPartitionStatsStruct> partitions;
+
+  @Int32()
+  external int partition_count;
+}
+
+// 延迟分布结构体（纳秒）
+base class KafkaLatencySummaryStruct extends Struct {
+  @Int64()
+  external int count;
+
+  @Int64()
+  external int min_ns;
+
+  @Int64()
+  external int mean_ns;
+
+  @Int64()
+  external int p50_ns;
+
+  @Int64()
+  external int p90_ns;
+
+  @Int64()
+  external int p99_ns;
+
+  @Int64()
+  external int p999_ns;
+
+  @Int64()
+  external int max_ns;
+}
+
+// broker接收速率结构体
+base class KafkaBrokerRateStruct extends Struct {
+  external Pointer<Utf8> name;
+
+  @Int32()
+  external int node_id;
+
+  @Double()
+  external double bytes_per_sec;
+}
+
+// 扫描速率结构体
+base class KafkaScanRateStruct extends Struct {
+  @Double()
+  external double interval_sec;
+
+  @Double()
+  external double bytes_per_sec;
+
+  @Double()
+  external double msgs_per_sec;
+
+  external Pointer<KafkaBrokerRateStruct> brokers;
+
+  @Int32()
+  external int broker_count;
+}
+
+// 内存账户占用结构体
+base class KafkaMemoryUsageStruct extends Struct {
+  external Pointer<Utf8> kind;
+  external Pointer<Utf8> name;
+
+  @Int64()
+  external int bytes;
+
+  @Int64()
+  external int peak_bytes;
 }
 
 // 创建Kafka生产者
@@ -74,6 +595,20 @@ typedef CreateKafkaProducerFunc = KafkaClientHandle Function(
 typedef CreateKafkaProducer = KafkaClientHandle Function(
     Pointer<Utf8> bootstrapServers);
 
+// 获取共享管理客户端
+typedef AcquireKafkaAdminClientFunc = KafkaClientHandle Function(
+    Pointer<Utf8> bootstrapServers);
+typedef AcquireKafkaAdminClient = KafkaClientHandle Function(
+    Pointer<Utf8> bootstrapServers);
+
+// 释放共享管理客户端
+typedef ReleaseKafkaAdminClientFunc = Void Function(KafkaClientHandle client);
+typedef ReleaseKafkaAdminClient = void Function(KafkaClientHandle client);
+
+// 让元数据缓存失效
+typedef InvalidateKafkaMetadataFunc = Void Function(KafkaClientHandle client);
+typedef InvalidateKafkaMetadata = void Function(KafkaClientHandle client);
+
 // 创建Kafka消费者
 typedef CreateKafkaConsumerFunc = KafkaClientHandle Function(
     Pointer<Utf8> bootstrapServers, Pointer<Utf8> groupId);
@@ -90,6 +625,24 @@ typedef CreateKafkaConsumerWithConfig = KafkaClientHandle Function(
     Pointer<Utf8> groupId,
     Pointer<Utf8> autoOffsetReset);
 
+// 按配置档创建消费者
+typedef CreateKafkaConsumerWithProfileFunc = KafkaClientHandle Function(
+    Pointer<Utf8> bootstrapServers,
+    Pointer<Utf8> groupId,
+    Pointer<Utf8> autoOffsetReset,
+    Int32 profile,
+    Pointer<Pointer<Utf8>> configKeys,
+    Pointer<Pointer<Utf8>> configValues,
+    Int32 configCount);
+typedef CreateKafkaConsumerWithProfile = KafkaClientHandle Function(
+    Pointer<Utf8> bootstrapServers,
+    Pointer<Utf8> groupId,
+    Pointer<Utf8> autoOffsetReset,
+    int profile,
+    Pointer<Pointer<Utf8>> configKeys,
+    Pointer<Pointer<Utf8>> configValues,
+    int configCount);
+
 // 重置消费者偏移量到特定时间戳
 typedef SeekToTimestampFunc = KafkaErrorCode Function(
     KafkaClientHandle consumer, Pointer<Utf8> topic, Int64 timestampMs);
@@ -165,6 +718,139 @@ typedef GetKafkaMessageTimestamp = int Function(KafkaMessageHandle message);
 typedef FreeKafkaMessageFunc = Void Function(KafkaMessageHandle message);
 typedef FreeKafkaMessage = void Function(KafkaMessageHandle message);
 
+// 启动后台消费循环
+typedef StartKafkaConsumeLoopFunc = KafkaErrorCode Function(
+    KafkaClientHandle consumer, Int32 ringCapacity);
+typedef StartKafkaConsumeLoop = int Function(
+    KafkaClientHandle consumer, int ringCapacity);
+
+// 停止后台消费循环
+typedef StopKafkaConsumeLoopFunc = Void Function(KafkaClientHandle consumer);
+typedef StopKafkaConsumeLoop = void Function(KafkaClientHandle consumer);
+
+// 配置消费背压水位
+typedef SetKafkaConsumeBackpressureFunc = KafkaErrorCode Function(
+    KafkaClientHandle consumer,
+    Int32 ringHighPercent,
+    Int32 ringLowPercent,
+    KafkaStoreHandle store);
+typedef SetKafkaConsumeBackpressure = int Function(
+    KafkaClientHandle consumer,
+    int ringHighPercent,
+    int ringLowPercent,
+    KafkaStoreHandle store);
+
+// 获取消费循环暂停的原因
+typedef GetKafkaConsumePauseStateFunc = Int32 Function(
+    KafkaClientHandle consumer);
+typedef GetKafkaConsumePauseState = int Function(KafkaClientHandle consumer);
+
+// 配置Schema Registry解码
+typedef SetKafkaSchemaRegistryFunc = KafkaErrorCode Function(
+    KafkaClientHandle consumer,
+    Pointer<Utf8> registryUrl,
+    Pointer<Utf8> localDir,
+    Int32 decodeThreads);
+typedef SetKafkaSchemaRegistry = int Function(KafkaClientHandle consumer,
+    Pointer<Utf8> registryUrl, Pointer<Utf8> localDir, int decodeThreads);
+
+// 批量取出消息
+typedef DrainKafkaMessagesFunc = Pointer<KafkaMessageRecordStruct> Function(
+    KafkaClientHandle consumer,
+    Int32 maxMessages,
+    KafkaStoreHandle store,
+    Int32 previewBytes,
+    Pointer<Int32> count);
+typedef DrainKafkaMessages = Pointer<KafkaMessageRecordStruct> Function(
+    KafkaClientHandle consumer,
+    int maxMessages,
+    KafkaStoreHandle store,
+    int previewBytes,
+    Pointer<Int32> count);
+
+// 按偏移量范围读取一页历史消息
+typedef FetchKafkaPageFunc = Pointer<KafkaMessageRecordStruct> Function(
+    KafkaClientHandle consumer,
+    Pointer<Utf8> topic,
+    Pointer<Int32> partitions,
+    Pointer<Int64> startOffsets,
+    Pointer<Int64> endOffsets,
+    Int32 partitionCount,
+    KafkaStoreHandle store,
+    Int32 previewBytes,
+    Int32 timeoutMs,
+    Pointer<Int32> count);
+typedef FetchKafkaPage = Pointer<KafkaMessageRecordStruct> Function(
+    KafkaClientHandle consumer,
+    Pointer<Utf8> topic,
+    Pointer<Int32> partitions,
+    Pointer<Int64> startOffsets,
+    Pointer<Int64> endOffsets,
+    int partitionCount,
+    KafkaStoreHandle store,
+    int previewBytes,
+    int timeoutMs,
+    Pointer<Int32> count);
+
+// 释放批量取出的消息
+typedef FreeKafkaMessageRecordsFunc = Void Function(
+    Pointer<KafkaMessageRecordStruct> records, Int32 count);
+typedef FreeKafkaMessageRecords = void Function(
+    Pointer<KafkaMessageRecordStruct> records, int count);
+
+// 创建消息存储
+typedef CreateKafkaStoreFunc = KafkaStoreHandle Function(Int64 maxBytes);
+typedef CreateKafkaStore = KafkaStoreHandle Function(int maxBytes);
+
+// 释放消息存储
+typedef DestroyKafkaStoreFunc = Void Function(KafkaStoreHandle store);
+typedef DestroyKafkaStore = void Function(KafkaStoreHandle store);
+
+// 清空消息存储
+typedef ClearKafkaStoreFunc = Void Function(KafkaStoreHandle store);
+typedef ClearKafkaStore = void Function(KafkaStoreHandle store);
+
+// 获取被截断消息的完整内容
+typedef FetchKafkaPayloadFunc = Pointer<Utf8> Function(
+    KafkaStoreHandle store, Int32 partition, Int64 offset, Pointer<Int32> len);
+typedef FetchKafkaPayload = Pointer<Utf8> Function(
+    KafkaStoreHandle store, int partition, int offset, Pointer<Int32> len);
+
+// 释放完整消息内容
+typedef FreeKafkaPayloadFunc = Void Function(Pointer<Utf8> payload);
+typedef FreeKafkaPayload = void Function(Pointer<Utf8> payload);
+
+// 启动自动保存
+typedef StartKafkaAutoSaveFunc = KafkaErrorCode Function(
+    KafkaClientHandle consumer,
+    Pointer<Utf8> filePath,
+    Pointer<Utf8> format,
+    Int64 rotateBytes,
+    Int32 rotateIntervalSec,
+    Int32 compress);
+typedef StartKafkaAutoSave = int Function(
+    KafkaClientHandle consumer,
+    Pointer<Utf8> filePath,
+    Pointer<Utf8> format,
+    int rotateBytes,
+    int rotateIntervalSec,
+    int compress);
+
+// 停止自动保存
+typedef StopKafkaAutoSaveFunc = KafkaErrorCode Function(
+    KafkaClientHandle consumer);
+typedef StopKafkaAutoSave = int Function(KafkaClientHandle consumer);
+
+// 格式化JSON
+typedef FormatKafkaJsonFunc = Pointer<Utf8> Function(
+    Pointer<Utf8> data, Int32 len, Int32 indentWidth, Pointer<Int32> outLen);
+typedef FormatKafkaJson = Pointer<Utf8> Function(
+    Pointer<Utf8> data, int len, int indentWidth, Pointer<Int32> outLen);
+
+// 释放格式化结果
+typedef FreeKafkaJsonFunc = Void Function(Pointer<Utf8> json);
+typedef FreeKafkaJson = void Function(Pointer<Utf8> json);
+
 // 获取错误信息
 typedef GetKafkaErrorMsgFunc = Pointer<Utf8> Function(KafkaErrorCode errorCode);
 typedef GetKafkaErrorMsg = Pointer<Utf8> Function(int errorCode);
@@ -196,6 +882,24 @@ typedef FreeKafkaTopicPartitionsFunc = Void Function(
 typedef FreeKafkaTopicPartitions = void Function(
     Pointer<KafkaPartitionInfoStruct> partitions, int partitionCount);
 
+// 批量获取分区水位
+typedef GetKafkaWatermarksFunc = Pointer<KafkaPartitionOffsetsStruct> Function(
+    KafkaClientHandle client,
+    Pointer<Pointer<Utf8>> topics,
+    Int32 topicCount,
+    Pointer<Int32> count);
+typedef GetKafkaWatermarks = Pointer<KafkaPartitionOffsetsStruct> Function(
+    KafkaClientHandle client,
+    Pointer<Pointer<Utf8>> topics,
+    int topicCount,
+    Pointer<Int32> count);
+
+// 释放分区水位
+typedef FreeKafkaWatermarksFunc = Void Function(
+    Pointer<KafkaPartitionOffsetsStruct> offsets, Int32 count);
+typedef FreeKafkaWatermarks = void Function(
+    Pointer<KafkaPartitionOffsetsStruct> offsets, int count);
+
 // 获取主题配置参数
 typedef GetKafkaTopicConfigFunc = Pointer<KafkaConfigParamStruct> Function(
     KafkaClientHandle client,
@@ -212,6 +916,26 @@ typedef FreeKafkaTopicConfigFunc = Void Function(
 typedef FreeKafkaTopicConfig = void Function(
     Pointer<KafkaConfigParamStruct> params, int paramCount);
 
+// 批量获取主题配置摘要
+typedef GetKafkaTopicConfigSummariesFunc
+    = Pointer<KafkaTopicConfigSummaryStruct> Function(
+        KafkaClientHandle client,
+        Pointer<Pointer<Utf8>> topics,
+        Int32 topicCount,
+        Pointer<Int32> count);
+typedef GetKafkaTopicConfigSummaries
+    = Pointer<KafkaTopicConfigSummaryStruct> Function(
+        KafkaClientHandle client,
+        Pointer<Pointer<Utf8>> topics,
+        int topicCount,
+        Pointer<Int32> count);
+
+// 释放主题配置摘要
+typedef FreeKafkaTopicConfigSummariesFunc = Void Function(
+    Pointer<KafkaTopicConfigSummaryStruct> summaries, Int32 count);
+typedef FreeKafkaTopicConfigSummaries = void Function(
+    Pointer<KafkaTopicConfigSummaryStruct> summaries, int count);
+
 // 获取主题的消费者组
 typedef GetKafkaTopicConsumerGroupsFunc
     = Pointer<KafkaConsumerGroupStruct> Function(KafkaClientHandle client,
@@ -226,11 +950,250 @@ typedef FreeKafkaTopicConsumerGroupsFunc = Void Function(
 typedef FreeKafkaTopicConsumerGroups = void Function(
     Pointer<KafkaConsumerGroupStruct> groups, int groupCount);
 
+// 获取主题完整详情
+typedef DescribeKafkaTopicFullFunc = Pointer<KafkaTopicDescriptionStruct>
+    Function(KafkaClientHandle client, Pointer<Utf8> topicName);
+typedef DescribeKafkaTopicFull = Pointer<KafkaTopicDescriptionStruct>
+    Function(KafkaClientHandle client, Pointer<Utf8> topicName);
+
+// 释放主题完整详情
+typedef FreeKafkaTopicDescriptionFunc = Void Function(
+    Pointer<KafkaTopicDescriptionStruct> desc);
+typedef FreeKafkaTopicDescription = void Function(
+    Pointer<KafkaTopicDescriptionStruct> desc);
+
+// 启动集群主题概览
+typedef StartKafkaTopicOverviewFunc = KafkaOverviewHandle Function(
+    KafkaClientHandle client, Pointer<Int32> topicCount);
+typedef StartKafkaTopicOverview = KafkaOverviewHandle Function(
+    KafkaClientHandle client, Pointer<Int32> topicCount);
+
+// 取出已完成的概览行
+typedef DrainKafkaTopicOverviewFunc = Pointer<KafkaTopicOverviewStruct>
+    Function(KafkaOverviewHandle handle, Int32 maxRows, Pointer<Int32> count,
+        Pointer<Int32> done);
+typedef DrainKafkaTopicOverview = Pointer<KafkaTopicOverviewStruct> Function(
+    KafkaOverviewHandle handle,
+    int maxRows,
+    Pointer<Int32> count,
+    Pointer<Int32> done);
+
+// 释放概览行
+typedef FreeKafkaTopicOverviewFunc = Void Function(
+    Pointer<KafkaTopicOverviewStruct> rows, Int32 count);
+typedef FreeKafkaTopicOverview = void Function(
+    Pointer<KafkaTopicOverviewStruct> rows, int count);
+
+// 停止集群主题概览
+typedef StopKafkaTopicOverviewFunc = Void Function(KafkaOverviewHandle handle);
+typedef StopKafkaTopicOverview = void Function(KafkaOverviewHandle handle);
+
+// 创建主题索引
+typedef CreateKafkaTopicIndexFunc = KafkaTopicIndexHandle Function();
+typedef CreateKafkaTopicIndex = KafkaTopicIndexHandle Function();
+
+// 销毁主题索引
+typedef DestroyKafkaTopicIndexFunc = Void Function(KafkaTopicIndexHandle index);
+typedef DestroyKafkaTopicIndex = void Function(KafkaTopicIndexHandle index);
+
+// 刷新主题索引
+typedef RefreshKafkaTopicIndexFunc = Pointer<KafkaTopicIndexDiffStruct> Function(
+    KafkaTopicIndexHandle index, KafkaClientHandle client);
+typedef RefreshKafkaTopicIndex = Pointer<KafkaTopicIndexDiffStruct> Function(
+    KafkaTopicIndexHandle index, KafkaClientHandle client);
+
+// 释放刷新结果
+typedef FreeKafkaTopicIndexDiffFunc = Void Function(
+    Pointer<KafkaTopicIndexDiffStruct> diff);
+typedef FreeKafkaTopicIndexDiff = void Function(
+    Pointer<KafkaTopicIndexDiffStruct> diff);
+
+// 搜索主题索引
+typedef SearchKafkaTopicIndexFunc = Pointer<Int32> Function(
+    KafkaTopicIndexHandle index, Pointer<Utf8> query, Pointer<Int32> count);
+typedef SearchKafkaTopicIndex = Pointer<Int32> Function(
+    KafkaTopicIndexHandle index, Pointer<Utf8> query, Pointer<Int32> count);
+
+// 释放搜索结果
+typedef FreeKafkaTopicIndexMatchesFunc = Void Function(Pointer<Int32> matches);
+typedef FreeKafkaTopicIndexMatches = void Function(Pointer<Int32> matches);
+
+// 异步查询完成回调（在原生后台线程调用，通过NativeCallable.listener转到Dart事件循环）
+typedef KafkaAsyncCallbackFunc = Void Function(Int64 requestId,
+    KafkaErrorCode error, Pointer<Void> result, Int32 count);
+typedef KafkaAsyncCallback = Pointer<NativeFunction<KafkaAsyncCallbackFunc>>;
+
+// 异步连接集群
+typedef ConnectKafkaClusterAsyncFunc = KafkaErrorCode Function(
+    Pointer<Utf8> bootstrapServers,
+    Int64 requestId,
+    Int32 timeoutMs,
+    KafkaAsyncCallback callback);
+typedef ConnectKafkaClusterAsync = int Function(Pointer<Utf8> bootstrapServers,
+    int requestId, int timeoutMs, KafkaAsyncCallback callback);
+
+// 异步获取主题列表
+typedef GetKafkaTopicsAsyncFunc = KafkaErrorCode Function(
+    KafkaClientHandle client,
+    Int64 requestId,
+    Int32 timeoutMs,
+    KafkaAsyncCallback callback);
+typedef GetKafkaTopicsAsync = int Function(KafkaClientHandle client,
+    int requestId, int timeoutMs, KafkaAsyncCallback callback);
+
+// 单主题的异步查询（主题信息、分区、配置、消费者组、完整详情）
+typedef KafkaTopicAsyncFunc = KafkaErrorCode Function(
+    KafkaClientHandle client,
+    Pointer<Utf8> topicName,
+    Int64 requestId,
+    Int32 timeoutMs,
+    KafkaAsyncCallback callback);
+typedef KafkaTopicAsync = int Function(
+    KafkaClientHandle client,
+    Pointer<Utf8> topicName,
+    int requestId,
+    int timeoutMs,
+    KafkaAsyncCallback callback);
+
+// 多主题的异步查询（水位、配置摘要）
+typedef KafkaTopicsAsyncFunc = KafkaErrorCode Function(
+    KafkaClientHandle client,
+    Pointer<Pointer<Utf8>> topics,
+    Int32 topicCount,
+    Int64 requestId,
+    Int32 timeoutMs,
+    KafkaAsyncCallback callback);
+typedef KafkaTopicsAsync = int Function(
+    KafkaClientHandle client,
+    Pointer<Pointer<Utf8>> topics,
+    int topicCount,
+    int requestId,
+    int timeoutMs,
+    KafkaAsyncCallback callback);
+
+// 异步刷新主题索引
+typedef RefreshKafkaTopicIndexAsyncFunc = KafkaErrorCode Function(
+    KafkaTopicIndexHandle index,
+    KafkaClientHandle client,
+    Int64 requestId,
+    Int32 timeoutMs,
+    KafkaAsyncCallback callback);
+typedef RefreshKafkaTopicIndexAsync = int Function(
+    KafkaTopicIndexHandle index,
+    KafkaClientHandle client,
+    int requestId,
+    int timeoutMs,
+    KafkaAsyncCallback callback);
+
+// 取消异步请求
+typedef CancelKafkaAsyncFunc = Void Function(Int64 requestId);
+typedef CancelKafkaAsync = void Function(int requestId);
+
+// 读取客户端统计快照
+typedef GetKafkaStatsFunc = Pointer<Pointer<KafkaStatsSnapshotStruct>> Function(
+    KafkaClientHandle client,
+    Int64 sinceTsUs,
+    Int32 maxCount,
+    Pointer<Int32> count);
+typedef GetKafkaStats = Pointer<Pointer<KafkaStatsSnapshotStruct>> Function(
+    KafkaClientHandle client,
+    int sinceTsUs,
+    int maxCount,
+    Pointer<Int32> count);
+
+// 释放客户端统计快照
+typedef FreeKafkaStatsFunc = Void Function(
+    Pointer<Pointer<KafkaStatsSnapshotStruct>> snapshots, Int32 count);
+typedef FreeKafkaStats = void Function(
+    Pointer<Pointer<KafkaStatsSnapshotStruct>> snapshots, int count);
+
+// 获取延迟分布
+typedef GetKafkaLatencySnapshotFunc = Void Function(
+    Pointer<KafkaLatencySummaryStruct> summaries, Int32 count);
+typedef GetKafkaLatencySnapshot = void Function(
+    Pointer<KafkaLatencySummaryStruct> summaries, int count);
+
+// 重置延迟直方图
+typedef ResetKafkaLatencyFunc = Void Function();
+typedef ResetKafkaLatency = void Function();
+
+// 记录一次延迟
+typedef RecordKafkaLatencyFunc = Void Function(Int32 metric, Int64 valueNs);
+typedef RecordKafkaLatency = void Function(int metric, int valueNs);
+
+// 定时输出延迟分布
+typedef StartKafkaLatencyDumpFunc = KafkaErrorCode Function(
+    Pointer<Utf8> path, Int32 intervalMs);
+typedef StartKafkaLatencyDump = int Function(Pointer<Utf8> path, int intervalMs);
+
+// 停止定时输出
+typedef StopKafkaLatencyDumpFunc = Void Function();
+typedef StopKafkaLatencyDump = void Function();
+
+// 设置原生日志级别
+typedef SetKafkaLogLevelFunc = Void Function(Int32 level);
+typedef SetKafkaLogLevel = void Function(int level);
+
+// 获取原生日志级别
+typedef GetKafkaLogLevelFunc = Int32 Function();
+typedef GetKafkaLogLevel = int Function();
+
+// 原生日志改写到文件
+typedef SetKafkaLogFileFunc = KafkaErrorCode Function(Pointer<Utf8> path);
+typedef SetKafkaLogFile = int Function(Pointer<Utf8> path);
+
+// 输出缓冲中的原生日志
+typedef FlushKafkaLogFunc = Void Function();
+typedef FlushKafkaLog = void Function();
+
+// 计算扫描速率
+typedef GetKafkaScanRateFunc = KafkaErrorCode Function(
+    KafkaClientHandle client, Pointer<KafkaScanRateStruct> rate);
+typedef GetKafkaScanRate = int Function(
+    KafkaClientHandle client, Pointer<KafkaScanRateStruct> rate);
+
+// 释放扫描速率
+typedef FreeKafkaScanRateFunc = Void Function(
+    Pointer<KafkaScanRateStruct> rate);
+typedef FreeKafkaScanRate = void Function(Pointer<KafkaScanRateStruct> rate);
+
+// 获取内存占用明细
+typedef GetKafkaMemoryUsageFunc = Pointer<KafkaMemoryUsageStruct> Function(
+    Pointer<Int32> count, Pointer<Int64> totalBytes);
+typedef GetKafkaMemoryUsage = Pointer<KafkaMemoryUsageStruct> Function(
+    Pointer<Int32> count, Pointer<Int64> totalBytes);
+
+// 释放内存占用明细
+typedef FreeKafkaMemoryUsageFunc = Void Function(
+    Pointer<KafkaMemoryUsageStruct> usage, Int32 count);
+typedef FreeKafkaMemoryUsage = void Function(
+    Pointer<KafkaMemoryUsageStruct> usage, int count);
+
+// 设置内存软上限
+typedef SetKafkaMemorySoftLimitFunc = Void Function(Int64 bytes);
+typedef SetKafkaMemorySoftLimit = void Function(int bytes);
+
+// 获取内存软上限
+typedef GetKafkaMemorySoftLimitFunc = Int64 Function();
+typedef GetKafkaMemorySoftLimit = int Function();
+
 // 绑定函数
 final CreateKafkaProducer _createKafkaProducer =
     kafkaLib.lookupFunction<CreateKafkaProducerFunc, CreateKafkaProducer>(
         'create_kafka_producer');
 
+final AcquireKafkaAdminClient _acquireKafkaAdminClient = kafkaLib
+    .lookupFunction<AcquireKafkaAdminClientFunc, AcquireKafkaAdminClient>(
+        'acquire_kafka_admin_client');
+
+final ReleaseKafkaAdminClient releaseKafkaAdminClient = kafkaLib
+    .lookupFunction<ReleaseKafkaAdminClientFunc, ReleaseKafkaAdminClient>(
+        'release_kafka_admin_client');
+
+final InvalidateKafkaMetadata invalidateKafkaMetadata = kafkaLib
+    .lookupFunction<InvalidateKafkaMetadataFunc, InvalidateKafkaMetadata>(
+        'invalidate_kafka_metadata');
+
 final CreateKafkaConsumer _createKafkaConsumer =
     kafkaLib.lookupFunction<CreateKafkaConsumerFunc, CreateKafkaConsumer>(
         'create_kafka_consumer');
@@ -239,6 +1202,10 @@ final CreateKafkaConsumerWithConfig _createKafkaConsumerWithConfig =
     kafkaLib.lookupFunction<CreateKafkaConsumerWithConfigFunc,
         CreateKafkaConsumerWithConfig>('create_kafka_consumer_with_config');
 
+final CreateKafkaConsumerWithProfile _createKafkaConsumerWithProfile =
+    kafkaLib.lookupFunction<CreateKafkaConsumerWithProfileFunc,
+        CreateKafkaConsumerWithProfile>('create_kafka_consumer_with_profile');
+
 final SeekToTimestamp _seekToTimestamp = kafkaLib
     .lookupFunction<SeekToTimestampFunc, SeekToTimestamp>('seek_to_timestamp');
 
@@ -292,6 +1259,73 @@ final FreeKafkaMessage freeKafkaMessage =
     kafkaLib.lookupFunction<FreeKafkaMessageFunc, FreeKafkaMessage>(
         'free_kafka_message');
 
+final StartKafkaConsumeLoop startKafkaConsumeLoop =
+    kafkaLib.lookupFunction<StartKafkaConsumeLoopFunc, StartKafkaConsumeLoop>(
+        'start_kafka_consume_loop');
+
+final StopKafkaConsumeLoop stopKafkaConsumeLoop =
+    kafkaLib.lookupFunction<StopKafkaConsumeLoopFunc, StopKafkaConsumeLoop>(
+        'stop_kafka_consume_loop');
+
+final SetKafkaConsumeBackpressure setKafkaConsumeBackpressure = kafkaLib
+    .lookupFunction<SetKafkaConsumeBackpressureFunc,
+        SetKafkaConsumeBackpressure>('set_kafka_consume_backpressure');
+
+final GetKafkaConsumePauseState getKafkaConsumePauseState = kafkaLib
+    .lookupFunction<GetKafkaConsumePauseStateFunc, GetKafkaConsumePauseState>(
+        'get_kafka_consume_pause_state');
+
+final SetKafkaSchemaRegistry setKafkaSchemaRegistry = kafkaLib
+    .lookupFunction<SetKafkaSchemaRegistryFunc, SetKafkaSchemaRegistry>(
+        'set_kafka_schema_registry');
+
+final DrainKafkaMessages drainKafkaMessages =
+    kafkaLib.lookupFunction<DrainKafkaMessagesFunc, DrainKafkaMessages>(
+        'drain_kafka_messages');
+
+final FetchKafkaPage fetchKafkaPage =
+    kafkaLib.lookupFunction<FetchKafkaPageFunc, FetchKafkaPage>(
+        'fetch_kafka_page');
+
+final FreeKafkaMessageRecords freeKafkaMessageRecords = kafkaLib
+    .lookupFunction<FreeKafkaMessageRecordsFunc, FreeKafkaMessageRecords>(
+        'free_kafka_message_records');
+
+final CreateKafkaStore createKafkaStore =
+    kafkaLib.lookupFunction<CreateKafkaStoreFunc, CreateKafkaStore>(
+        'create_kafka_store');
+
+final DestroyKafkaStore destroyKafkaStore =
+    kafkaLib.lookupFunction<DestroyKafkaStoreFunc, DestroyKafkaStore>(
+        'destroy_kafka_store');
+
+final ClearKafkaStore clearKafkaStore =
+    kafkaLib.lookupFunction<ClearKafkaStoreFunc, ClearKafkaStore>(
+        'clear_kafka_store');
+
+final FetchKafkaPayload fetchKafkaPayload =
+    kafkaLib.lookupFunction<FetchKafkaPayloadFunc, FetchKafkaPayload>(
+        'fetch_kafka_payload');
+
+final FreeKafkaPayload freeKafkaPayload =
+    kafkaLib.lookupFunction<FreeKafkaPayloadFunc, FreeKafkaPayload>(
+        'free_kafka_payload');
+
+final StartKafkaAutoSave startKafkaAutoSave =
+    kafkaLib.lookupFunction<StartKafkaAutoSaveFunc, StartKafkaAutoSave>(
+        'start_kafka_auto_save');
+
+final StopKafkaAutoSave stopKafkaAutoSave =
+    kafkaLib.lookupFunction<StopKafkaAutoSaveFunc, StopKafkaAutoSave>(
+        'stop_kafka_auto_save');
+
+final FormatKafkaJson formatKafkaJson =
+    kafkaLib.lookupFunction<FormatKafkaJsonFunc, FormatKafkaJson>(
+        'format_kafka_json');
+
+final FreeKafkaJson freeKafkaJson = kafkaLib
+    .lookupFunction<FreeKafkaJsonFunc, FreeKafkaJson>('free_kafka_json');
+
 final GetKafkaErrorMsg getKafkaErrorMsg =
     kafkaLib.lookupFunction<GetKafkaErrorMsgFunc, GetKafkaErrorMsg>(
         'get_kafka_error_msg');
@@ -311,6 +1345,16 @@ final FreeKafkaTopicPartitions freeKafkaTopicPartitions = kafkaLib
     .lookupFunction<FreeKafkaTopicPartitionsFunc, FreeKafkaTopicPartitions>(
         'free_kafka_topic_partitions');
 
+// 批量获取分区水位
+final GetKafkaWatermarks getKafkaWatermarks =
+    kafkaLib.lookupFunction<GetKafkaWatermarksFunc, GetKafkaWatermarks>(
+        'get_kafka_watermarks');
+
+// 释放分区水位
+final FreeKafkaWatermarks freeKafkaWatermarks =
+    kafkaLib.lookupFunction<FreeKafkaWatermarksFunc, FreeKafkaWatermarks>(
+        'free_kafka_watermarks');
+
 // 获取主题配置参数
 final GetKafkaTopicConfig getKafkaTopicConfig =
     kafkaLib.lookupFunction<GetKafkaTopicConfigFunc, GetKafkaTopicConfig>(
@@ -321,6 +1365,16 @@ final FreeKafkaTopicConfig freeKafkaTopicConfig =
     kafkaLib.lookupFunction<FreeKafkaTopicConfigFunc, FreeKafkaTopicConfig>(
         'free_kafka_topic_config');
 
+// 批量获取主题配置摘要
+final GetKafkaTopicConfigSummaries getKafkaTopicConfigSummaries =
+    kafkaLib.lookupFunction<GetKafkaTopicConfigSummariesFunc,
+        GetKafkaTopicConfigSummaries>('get_kafka_topic_config_summaries');
+
+// 释放主题配置摘要
+final FreeKafkaTopicConfigSummaries freeKafkaTopicConfigSummaries =
+    kafkaLib.lookupFunction<FreeKafkaTopicConfigSummariesFunc,
+        FreeKafkaTopicConfigSummaries>('free_kafka_topic_config_summaries');
+
 // 获取主题的消费者组
 final GetKafkaTopicConsumerGroups getKafkaTopicConsumerGroups =
     kafkaLib.lookupFunction<GetKafkaTopicConsumerGroupsFunc,
@@ -331,11 +1385,252 @@ final FreeKafkaTopicConsumerGroups freeKafkaTopicConsumerGroups =
     kafkaLib.lookupFunction<FreeKafkaTopicConsumerGroupsFunc,
         FreeKafkaTopicConsumerGroups>('free_kafka_topic_consumer_groups');
 
+// 获取主题完整详情
+final DescribeKafkaTopicFull describeKafkaTopicFull = kafkaLib
+    .lookupFunction<DescribeKafkaTopicFullFunc, DescribeKafkaTopicFull>(
+        'describe_kafka_topic_full');
+
+// 释放主题完整详情
+final FreeKafkaTopicDescription freeKafkaTopicDescription = kafkaLib
+    .lookupFunction<FreeKafkaTopicDescriptionFunc, FreeKafkaTopicDescription>(
+        'free_kafka_topic_description');
+
+// 集群主题概览
+final StartKafkaTopicOverview startKafkaTopicOverview = kafkaLib
+    .lookupFunction<StartKafkaTopicOverviewFunc, StartKafkaTopicOverview>(
+        'start_kafka_topic_overview');
+
+final DrainKafkaTopicOverview drainKafkaTopicOverview = kafkaLib
+    .lookupFunction<DrainKafkaTopicOverviewFunc, DrainKafkaTopicOverview>(
+        'drain_kafka_topic_overview');
+
+final FreeKafkaTopicOverview freeKafkaTopicOverview = kafkaLib
+    .lookupFunction<FreeKafkaTopicOverviewFunc, FreeKafkaTopicOverview>(
+        'free_kafka_topic_overview');
+
+final StopKafkaTopicOverview stopKafkaTopicOverview = kafkaLib
+    .lookupFunction<StopKafkaTopicOverviewFunc, StopKafkaTopicOverview>(
+        'stop_kafka_topic_overview');
+
+// 主题索引
+final CreateKafkaTopicIndex createKafkaTopicIndex = kafkaLib
+    .lookupFunction<CreateKafkaTopicIndexFunc, CreateKafkaTopicIndex>(
+        'create_kafka_topic_index');
+
+final DestroyKafkaTopicIndex destroyKafkaTopicIndex = kafkaLib
+    .lookupFunction<DestroyKafkaTopicIndexFunc, DestroyKafkaTopicIndex>(
+        'destroy_kafka_topic_index');
+
+final RefreshKafkaTopicIndex refreshKafkaTopicIndex = kafkaLib
+    .lookupFunction<RefreshKafkaTopicIndexFunc, RefreshKafkaTopicIndex>(
+        'refresh_kafka_topic_index');
+
+final FreeKafkaTopicIndexDiff freeKafkaTopicIndexDiff = kafkaLib
+    .lookupFunction<FreeKafkaTopicIndexDiffFunc, FreeKafkaTopicIndexDiff>(
+        'free_kafka_topic_index_diff');
+
+final SearchKafkaTopicIndex searchKafkaTopicIndex = kafkaLib
+    .lookupFunction<SearchKafkaTopicIndexFunc, SearchKafkaTopicIndex>(
+        'search_kafka_topic_index');
+
+final FreeKafkaTopicIndexMatches freeKafkaTopicIndexMatches = kafkaLib
+    .lookupFunction<FreeKafkaTopicIndexMatchesFunc, FreeKafkaTopicIndexMatches>(
+        'free_kafka_topic_index_matches');
+
+// 异步查询
+final ConnectKafkaClusterAsync connectKafkaClusterAsync = kafkaLib
+    .lookupFunction<ConnectKafkaClusterAsyncFunc, ConnectKafkaClusterAsync>(
+        'connect_kafka_cluster_async');
+
+final GetKafkaTopicsAsync getKafkaTopicsAsync =
+    kafkaLib.lookupFunction<GetKafkaTopicsAsyncFunc, GetKafkaTopicsAsync>(
+        'get_kafka_topics_async');
+
+final KafkaTopicAsync getKafkaTopicInfoAsync = kafkaLib
+    .lookupFunction<KafkaTopicAsyncFunc, KafkaTopicAsync>(
+        'get_kafka_topic_info_async');
+
+final KafkaTopicAsync getKafkaTopicPartitionsAsync = kafkaLib
+    .lookupFunction<KafkaTopicAsyncFunc, KafkaTopicAsync>(
+        'get_kafka_topic_partitions_async');
+
+final KafkaTopicsAsync getKafkaWatermarksAsync = kafkaLib
+    .lookupFunction<KafkaTopicsAsyncFunc, KafkaTopicsAsync>(
+        'get_kafka_watermarks_async');
+
+final KafkaTopicAsync getKafkaTopicConfigAsync = kafkaLib
+    .lookupFunction<KafkaTopicAsyncFunc, KafkaTopicAsync>(
+        'get_kafka_topic_config_async');
+
+final KafkaTopicsAsync getKafkaTopicConfigSummariesAsync = kafkaLib
+    .lookupFunction<KafkaTopicsAsyncFunc, KafkaTopicsAsync>(
+        'get_kafka_topic_config_summaries_async');
+
+final KafkaTopicAsync getKafkaTopicConsumerGroupsAsync = kafkaLib
+    .lookupFunction<KafkaTopicAsyncFunc, KafkaTopicAsync>(
+        'get_kafka_topic_consumer_groups_async');
+
+final KafkaTopicAsync describeKafkaTopicFullAsync = kafkaLib
+    .lookupFunction<KafkaTopicAsyncFunc, KafkaTopicAsync>(
+        'describe_kafka_topic_full_async');
+
+final RefreshKafkaTopicIndexAsync refreshKafkaTopicIndexAsync = kafkaLib
+    .lookupFunction<RefreshKafkaTopicIndexAsyncFunc,
+        RefreshKafkaTopicIndexAsync>('refresh_kafka_topic_index_async');
+
+final CancelKafkaAsync cancelKafkaAsync =
+    kafkaLib.lookupFunction<CancelKafkaAsyncFunc, CancelKafkaAsync>(
+        'cancel_kafka_async');
+
+final GetKafkaStats getKafkaStats =
+    kafkaLib.lookupFunction<GetKafkaStatsFunc, GetKafkaStats>(
+        'get_kafka_stats');
+
+final FreeKafkaStats freeKafkaStats =
+    kafkaLib.lookupFunction<FreeKafkaStatsFunc, FreeKafkaStats>(
+        'free_kafka_stats');
+
+final GetKafkaLatencySnapshot getKafkaLatencySnapshot = kafkaLib
+    .lookupFunction<GetKafkaLatencySnapshotFunc, GetKafkaLatencySnapshot>(
+        'get_kafka_latency_snapshot');
+
+final ResetKafkaLatency resetKafkaLatency =
+    kafkaLib.lookupFunction<ResetKafkaLatencyFunc, ResetKafkaLatency>(
+        'reset_kafka_latency');
+
+final RecordKafkaLatency recordKafkaLatency =
+    kafkaLib.lookupFunction<RecordKafkaLatencyFunc, RecordKafkaLatency>(
+        'record_kafka_latency');
+
+final StartKafkaLatencyDump startKafkaLatencyDump =
+    kafkaLib.lookupFunction<StartKafkaLatencyDumpFunc, StartKafkaLatencyDump>(
+        'start_kafka_latency_dump');
+
+final StopKafkaLatencyDump stopKafkaLatencyDump =
+    kafkaLib.lookupFunction<StopKafkaLatencyDumpFunc, StopKafkaLatencyDump>(
+        'stop_kafka_latency_dump');
+
+final SetKafkaLogLevel setKafkaLogLevel =
+    kafkaLib.lookupFunction<SetKafkaLogLevelFunc, SetKafkaLogLevel>(
+        'set_kafka_log_level');
+
+final GetKafkaLogLevel getKafkaLogLevel =
+    kafkaLib.lookupFunction<GetKafkaLogLevelFunc, GetKafkaLogLevel>(
+        'get_kafka_log_level');
+
+final SetKafkaLogFile setKafkaLogFile =
+    kafkaLib.lookupFunction<SetKafkaLogFileFunc, SetKafkaLogFile>(
+        'set_kafka_log_file');
+
+final FlushKafkaLog flushKafkaLog =
+    kafkaLib.lookupFunction<FlushKafkaLogFunc, FlushKafkaLog>(
+        'flush_kafka_log');
+
+final GetKafkaScanRate getKafkaScanRate =
+    kafkaLib.lookupFunction<GetKafkaScanRateFunc, GetKafkaScanRate>(
+        'get_kafka_scan_rate');
+
+final FreeKafkaScanRate freeKafkaScanRate =
+    kafkaLib.lookupFunction<FreeKafkaScanRateFunc, FreeKafkaScanRate>(
+        'free_kafka_scan_rate');
+
+final GetKafkaMemoryUsage getKafkaMemoryUsage =
+    kafkaLib.lookupFunction<GetKafkaMemoryUsageFunc, GetKafkaMemoryUsage>(
+        'get_kafka_memory_usage');
+
+final FreeKafkaMemoryUsage freeKafkaMemoryUsage =
+    kafkaLib.lookupFunction<FreeKafkaMemoryUsageFunc, FreeKafkaMemoryUsage>(
+        'free_kafka_memory_usage');
+
+final SetKafkaMemorySoftLimit setKafkaMemorySoftLimit = kafkaLib
+    .lookupFunction<SetKafkaMemorySoftLimitFunc, SetKafkaMemorySoftLimit>(
+        'set_kafka_memory_soft_limit');
+
+final GetKafkaMemorySoftLimit getKafkaMemorySoftLimit = kafkaLib
+    .lookupFunction<GetKafkaMemorySoftLimitFunc, GetKafkaMemorySoftLimit>(
+        'get_kafka_memory_soft_limit');
+
+// 异步请求被取消
+class KafkaCancelledException implements Exception {
+  final String operation;
+
+  KafkaCancelledException(this.operation);
+
+  @override
+  String toString() => 'KafkaCancelledException: $operation cancelled';
+}
+
+// 一组异步请求的取消句柄：cancel()后尚未完成的请求立即以KafkaCancelledException结束，
+// 原生侧排队中的请求不再执行，执行中的请求结束后丢弃结果
+class KafkaCancelToken {
+  final Set<int> _requestIds = {};
+  bool _cancelled = false;
+
+  bool get isCancelled => _cancelled;
+
+  void cancel() {
+    if (_cancelled) {
+      return;
+    }
+    _cancelled = true;
+    for (final requestId in _requestIds.toList()) {
+      KafkaFFI._cancelAsync(requestId);
+    }
+    _requestIds.clear();
+  }
+}
+
+// 等待原生回调的异步请求
+class _KafkaAsyncRequest<T> {
+  final String operation;
+  final T Function(Pointer<Void> result, int count) convert;
+  final void Function(Pointer<Void> result, int count) release;
+  final Completer<T> completer = Completer<T>();
+  KafkaCancelToken? token;
+  Timer? timer;
+
+  _KafkaAsyncRequest(this.operation, this.convert, this.release);
+
+  void complete(int error, Pointer<Void> result, int count) {
+    timer?.cancel();
+    if (completer.isCompleted) {
+      // Dart侧已经超时或取消，丢弃迟到的结果
+      if (result != nullptr) {
+        release(result, count);
+      }
+      return;
+    }
+    if (error != 0) {
+      if (result != nullptr) {
+        release(result, count);
+      }
+      final errorMsg = getKafkaErrorMsg(error).toDartString();
+      completer.completeError(Exception('Failed to $operation: $errorMsg'));
+      return;
+    }
+    try {
+      // convert负责释放result
+      completer.complete(convert(result, count));
+    } catch (e, stackTrace) {
+      completer.completeError(e, stackTrace);
+    }
+  }
+}
+
 // 高级封装类
 class KafkaFFI {
   static KafkaClientHandle? _producer;
   static KafkaClientHandle? _consumer;
 
+  // 异步查询的默认截止时间
+  static const Duration asyncTimeout = Duration(seconds: 15);
+
+  // 所有异步请求共用一个回调，按请求id分发
+  static final NativeCallable<KafkaAsyncCallbackFunc> _asyncCallback =
+      NativeCallable<KafkaAsyncCallbackFunc>.listener(_onAsyncComplete);
+  static final Map<int, _KafkaAsyncRequest<dynamic>> _asyncRequests = {};
+  static int _nextAsyncRequestId = 1;
+
   // 创建生产者
   static KafkaClientHandle createProducer(String bootstrapServers) {
     print(
@@ -387,6 +1682,46 @@ class KafkaFFI {
     return consumer;
   }
 
+  // 按配置档创建消费者，overrides在配置档之后覆盖任意librdkafka配置
+  static KafkaClientHandle createConsumerWithProfile(
+    String bootstrapServers,
+    String groupId,
+    String autoOffsetReset, {
+    int profile = KafkaConsumerProfile.standard,
+    Map<String, String> overrides = const {},
+  }) {
+    final bootstrapServersPtr = bootstrapServers.toNativeUtf8();
+    final groupIdPtr = groupId.toNativeUtf8();
+    final autoOffsetResetPtr = autoOffsetReset.toNativeUtf8();
+    final count = overrides.length;
+    final keysPtr = calloc<Pointer<Utf8>>(count > 0 ? count : 1);
+    final valuesPtr = calloc<Pointer<Utf8>>(count > 0 ? count : 1);
+    int i = 0;
+    overrides.forEach((key, value) {
+      keysPtr[i] = key.toNativeUtf8();
+      valuesPtr[i] = value.toNativeUtf8();
+      i++;
+    });
+
+    final consumer = _createKafkaConsumerWithProfile(bootstrapServersPtr,
+        groupIdPtr, autoOffsetResetPtr, profile, keysPtr, valuesPtr, count);
+
+    for (int j = 0; j < count; j++) {
+      calloc.free(keysPtr[j]);
+      calloc.free(valuesPtr[j]);
+    }
+    calloc.free(keysPtr);
+    calloc.free(valuesPtr);
+    calloc.free(bootstrapServersPtr);
+    calloc.free(groupIdPtr);
+    calloc.free(autoOffsetResetPtr);
+    if (consumer == nullptr) {
+      throw Exception('Failed to create Kafka consumer with profile $profile');
+    }
+    _consumer = consumer;
+    return consumer;
+  }
+
   // 重置消费者偏移量到特定时间戳
   static void seekToTimestamp(
       KafkaClientHandle consumer, String topic, int timestampMs) {
@@ -402,6 +1737,28 @@ class KafkaFFI {
   }
 
   // 关闭客户端
+  // 获取集群共享的管理客户端（同一bootstrap servers复用一个连接）
+  // 用完调用releaseAdminClient，不要调用closeClient
+  static KafkaClientHandle acquireAdminClient(String bootstrapServers) {
+    final bootstrapServersPtr = bootstrapServers.toNativeUtf8();
+    final client = _acquireKafkaAdminClient(bootstrapServersPtr);
+    calloc.free(bootstrapServersPtr);
+    if (client == nullptr) {
+      throw Exception('Failed to create Kafka admin client');
+    }
+    return client;
+  }
+
+  // 释放共享管理客户端的引用
+  static void releaseAdminClient(KafkaClientHandle client) {
+    releaseKafkaAdminClient(client);
+  }
+
+  // 让连接的元数据缓存失效，下次查询重新请求broker
+  static void invalidateMetadata(KafkaClientHandle client) {
+    invalidateKafkaMetadata(client);
+  }
+
   static void closeClient(KafkaClientHandle client) {
     closeKafkaClient(client);
     if (_producer == client) {
@@ -503,9 +1860,9 @@ class KafkaFFI {
       print('🔧 KafkaFFI:   timestamp: $timestamp');
 
       if (contentPtr != nullptr && topicPtr != nullptr) {
-        final content = contentPtr.toDartString();
-        final topic = topicPtr.toDartString();
-        final key = keyPtr != nullptr ? keyPtr.toDartString() : null;
+        final content = _decodeUtf8Lenient(contentPtr);
+        final topic = _decodeUtf8Lenient(topicPtr);
+        final key = keyPtr != nullptr ? _decodeUtf8Lenient(keyPtr) : null;
 
         print('✅ KafkaFFI: Successfully extracted message:');
         print('✅ KafkaFFI:   topic: $topic');
@@ -522,14 +1879,263 @@ class KafkaFFI {
           'timestamp': timestamp,
         };
       }
-      print('⚠️ KafkaFFI: Either contentPtr or topicPtr is null');
-      return null;
-    } catch (e, stackTrace) {
-      print('❌ KafkaFFI: Error processing message: $e');
-      print('❌ KafkaFFI: Stack trace: $stackTrace');
-      return null;
+      print('⚠️ KafkaFFI: Either contentPtr or topicPtr is null');
+      return null;
+    } catch (e, stackTrace) {
+      print('❌ KafkaFFI: Error processing message: $e');
+      print('❌ KafkaFFI: Stack trace: $stackTrace');
+      return null;
+    } finally {
+      freeKafkaMessage(message);
+    }
+  }
+
+  // 启动后台消费循环
+  static void startConsumeLoop(KafkaClientHandle consumer,
+      {int ringCapacity = 10000}) {
+    final errorCode = startKafkaConsumeLoop(consumer, ringCapacity);
+    if (errorCode != 0) {
+      final errorMsgPtr = getKafkaErrorMsg(errorCode);
+      final errorMsg = errorMsgPtr.toDartString();
+      throw Exception('Failed to start consume loop: $errorMsg');
+    }
+  }
+
+  // 停止后台消费循环
+  static void stopConsumeLoop(KafkaClientHandle consumer) {
+    stopKafkaConsumeLoop(consumer);
+  }
+
+  // 配置消费背压，需在startConsumeLoop之前调用：队列占用达到high时暂停分区，回落到low以下恢复；
+  // 指定store时因内存暂停期间由它淘汰旧记录，它在消费循环停止前不能销毁
+  static void setConsumeBackpressure(
+    KafkaClientHandle consumer, {
+    int ringHighPercent = 80,
+    int ringLowPercent = 50,
+    KafkaStoreHandle? store,
+  }) {
+    final errorCode = setKafkaConsumeBackpressure(
+        consumer, ringHighPercent, ringLowPercent, store ?? nullptr);
+    if (errorCode != 0) {
+      final errorMsgPtr = getKafkaErrorMsg(errorCode);
+      final errorMsg = errorMsgPtr.toDartString();
+      throw Exception('Failed to set consume backpressure: $errorMsg');
+    }
+  }
+
+  // 消费循环当前暂停的原因（KafkaPauseReason位掩码），0表示正常拉取
+  static int getConsumePauseState(KafkaClientHandle consumer) {
+    return getKafkaConsumePauseState(consumer);
+  }
+
+  // 配置Schema Registry解码，需在startConsumeLoop之前调用
+  // registryUrl和localDir都为空时关闭解码
+  static void setSchemaRegistry(
+    KafkaClientHandle consumer, {
+    String? registryUrl,
+    String? localDir,
+    int decodeThreads = 0,
+  }) {
+    final urlPtr = registryUrl != null && registryUrl.isNotEmpty
+        ? registryUrl.toNativeUtf8()
+        : nullptr.cast<Utf8>();
+    final dirPtr = localDir != null && localDir.isNotEmpty
+        ? localDir.toNativeUtf8()
+        : nullptr.cast<Utf8>();
+    final errorCode =
+        setKafkaSchemaRegistry(consumer, urlPtr, dirPtr, decodeThreads);
+    if (urlPtr != nullptr) calloc.free(urlPtr);
+    if (dirPtr != nullptr) calloc.free(dirPtr);
+
+    if (errorCode != 0) {
+      final errorMsgPtr = getKafkaErrorMsg(errorCode);
+      final errorMsg = errorMsgPtr.toDartString();
+      throw Exception('Failed to set schema registry: $errorMsg');
+    }
+  }
+
+  // 批量取出后台消费循环中的消息
+  // 指定store时超长消息只返回预览，完整内容用fetchPayload获取
+  static List<Map<String, dynamic>> drainMessages(
+      KafkaClientHandle consumer, int maxMessages,
+      {KafkaStoreHandle? store, int previewBytes = 0}) {
+    final countPtr = calloc<Int32>();
+
+    try {
+      final recordsPtr = drainKafkaMessages(
+          consumer, maxMessages, store ?? nullptr, previewBytes, countPtr);
+      if (recordsPtr == nullptr) {
+        return [];
+      }
+
+      final decodeTimer = Stopwatch()..start();
+      final messages = _recordsFromNative(recordsPtr, countPtr.value);
+      recordLatency(KafkaLatencyMetric.ffiDecode, decodeTimer.elapsed);
+      return messages;
+    } finally {
+      calloc.free(countPtr);
+    }
+  }
+
+  // 转换并释放批量取出的消息
+  static List<Map<String, dynamic>> _recordsFromNative(
+      Pointer<KafkaMessageRecordStruct> recordsPtr, int count) {
+    final messages = <Map<String, dynamic>>[];
+    try {
+      for (int i = 0; i < count; i++) {
+        final record = recordsPtr[i];
+        messages.add({
+          'topic': _decodeUtf8Lenient(record.topic),
+          'content': _decodePayload(
+              record.content, record.content_len, record.payload_type),
+          'payloadType': record.payload_type,
+          'schemaId': record.schema_id,
+          'contentLength': record.total_len,
+          'truncated': record.content_len < record.total_len,
+          'key': _decodeUtf8Lenient(record.key),
+          'offset': record.offset,
+          'partition': record.partition,
+          'timestamp': record.timestamp,
+        });
+      }
+    } finally {
+      freeKafkaMessageRecords(recordsPtr, count);
+    }
+    return messages;
+  }
+
+  // 按偏移量范围读取一页历史消息（会阻塞到读完或超时，在工作isolate中调用）
+  // ranges的每一项为{'partition', 'start', 'end'}，end不包含；消费者不能订阅主题或运行消费循环
+  static List<Map<String, dynamic>> fetchPage(KafkaClientHandle consumer,
+      String topic, List<Map<String, int>> ranges,
+      {KafkaStoreHandle? store, int previewBytes = 0, int timeoutMs = 5000}) {
+    if (ranges.isEmpty) {
+      return [];
+    }
+
+    final topicPtr = topic.toNativeUtf8();
+    final partitionsPtr = calloc<Int32>(ranges.length);
+    final startsPtr = calloc<Int64>(ranges.length);
+    final endsPtr = calloc<Int64>(ranges.length);
+    final countPtr = calloc<Int32>();
+    for (int i = 0; i < ranges.length; i++) {
+      partitionsPtr[i] = ranges[i]['partition']!;
+      startsPtr[i] = ranges[i]['start']!;
+      endsPtr[i] = ranges[i]['end']!;
+    }
+
+    try {
+      final recordsPtr = fetchKafkaPage(
+          consumer,
+          topicPtr,
+          partitionsPtr,
+          startsPtr,
+          endsPtr,
+          ranges.length,
+          store ?? nullptr,
+          previewBytes,
+          timeoutMs,
+          countPtr);
+      if (recordsPtr == nullptr) {
+        return [];
+      }
+      return _recordsFromNative(recordsPtr, countPtr.value);
+    } finally {
+      calloc.free(topicPtr);
+      calloc.free(partitionsPtr);
+      calloc.free(startsPtr);
+      calloc.free(endsPtr);
+      calloc.free(countPtr);
+    }
+  }
+
+  // 创建消息存储
+  static KafkaStoreHandle createStore(int maxBytes) {
+    final store = createKafkaStore(maxBytes);
+    if (store == nullptr) {
+      throw Exception('Failed to create message store');
+    }
+    return store;
+  }
+
+  // 释放消息存储
+  static void destroyStore(KafkaStoreHandle store) {
+    destroyKafkaStore(store);
+  }
+
+  // 清空消息存储
+  static void clearStore(KafkaStoreHandle store) {
+    clearKafkaStore(store);
+  }
+
+  // 获取被截断消息的完整内容，已被淘汰时返回null
+  static String? fetchPayload(
+      KafkaStoreHandle store, int partition, int offset,
+      {int payloadType = KafkaPayloadType.text}) {
+    final lenPtr = calloc<Int32>();
+
+    try {
+      final payloadPtr = fetchKafkaPayload(store, partition, offset, lenPtr);
+      if (payloadPtr == nullptr) {
+        return null;
+      }
+      try {
+        return _decodePayload(payloadPtr, lenPtr.value, payloadType);
+      } finally {
+        freeKafkaPayload(payloadPtr);
+      }
+    } finally {
+      calloc.free(lenPtr);
+    }
+  }
+
+  // 启动自动保存，由native写入线程直接写原始字节
+  static void startAutoSave(
+    KafkaClientHandle consumer,
+    String filePath,
+    String format, {
+    int rotateBytes = 0,
+    int rotateIntervalSeconds = 0,
+    bool compress = false,
+  }) {
+    final filePathPtr = filePath.toNativeUtf8();
+    final formatPtr = format.toNativeUtf8();
+    final errorCode = startKafkaAutoSave(consumer, filePathPtr, formatPtr,
+        rotateBytes, rotateIntervalSeconds, compress ? 1 : 0);
+    calloc.free(filePathPtr);
+    calloc.free(formatPtr);
+
+    if (errorCode != 0) {
+      final errorMsgPtr = getKafkaErrorMsg(errorCode);
+      final errorMsg = errorMsgPtr.toDartString();
+      throw Exception('Failed to start auto-save: $errorMsg');
+    }
+  }
+
+  // 停止自动保存
+  static void stopAutoSave(KafkaClientHandle consumer) {
+    stopKafkaAutoSave(consumer);
+  }
+
+  // 格式化JSON内容，不是合法JSON时返回null
+  static String? formatJson(String content, {int indentWidth = 2}) {
+    final contentPtr = content.toNativeUtf8();
+    final outLenPtr = calloc<Int32>();
+
+    try {
+      final resultPtr = formatKafkaJson(
+          contentPtr, contentPtr.length, indentWidth, outLenPtr);
+      if (resultPtr == nullptr) {
+        return null;
+      }
+      try {
+        return resultPtr.toDartString(length: outLenPtr.value);
+      } finally {
+        freeKafkaJson(resultPtr);
+      }
     } finally {
-      freeKafkaMessage(message);
+      calloc.free(contentPtr);
+      calloc.free(outLenPtr);
     }
   }
 
@@ -580,36 +2186,88 @@ class KafkaFFI {
     try {
       final partitionsPtr =
           getKafkaTopicPartitions(client, topicNamePtr, partitionCountPtr);
+      return _partitionsFromNative(partitionsPtr, partitionCountPtr.value);
+    } finally {
+      calloc.free(topicNamePtr);
+      calloc.free(partitionCountPtr);
+    }
+  }
 
-      if (partitionsPtr == nullptr) {
-        return [];
-      }
+  static Map<String, dynamic> _partitionToMap(
+      KafkaPartitionInfoStruct partition) {
+    return {
+      'id': partition.id,
+      'leader': partition.leader,
+      'replicas': partition.replicas.toDartString(),
+      'isr': partition.isr.toDartString(),
+      'latestOffset': partition.latest_offset,
+      'earliestOffset': partition.earliest_offset,
+    };
+  }
 
-      final partitionCount = partitionCountPtr.value;
-      final partitions = <Map<String, dynamic>>[];
+  // 转换并释放分区详情
+  static List<Map<String, dynamic>> _partitionsFromNative(
+      Pointer<KafkaPartitionInfoStruct> partitionsPtr, int partitionCount) {
+    if (partitionsPtr == nullptr) {
+      return [];
+    }
+    final partitions = <Map<String, dynamic>>[];
+    for (int i = 0; i < partitionCount; i++) {
+      partitions.add(_partitionToMap(partitionsPtr[i]));
+    }
+    freeKafkaTopicPartitions(partitionsPtr, partitionCount);
+    return partitions;
+  }
 
-      for (int i = 0; i < partitionCount; i++) {
-        final partition = partitionsPtr.elementAt(i).ref;
-        partitions.add({
-          'id': partition.id,
-          'leader': partition.leader,
-          'replicas': partition.replicas.toDartString(),
-          'isr': partition.isr.toDartString(),
-          'latestOffset': partition.latest_offset,
-          'earliestOffset': partition.earliest_offset,
-        });
-      }
+  // 批量获取多个主题所有分区的earliest/latest偏移量（一次请求，按leader并行）
+  static List<Map<String, dynamic>> getWatermarks(
+      KafkaClientHandle client, List<String> topics) {
+    if (topics.isEmpty) {
+      return [];
+    }
+
+    final topicsPtr = calloc<Pointer<Utf8>>(topics.length);
+    final countPtr = calloc<Int32>();
+    for (int i = 0; i < topics.length; i++) {
+      topicsPtr[i] = topics[i].toNativeUtf8();
+    }
 
-      freeKafkaTopicPartitions(partitionsPtr, partitionCount);
-      return partitions;
+    try {
+      final offsetsPtr =
+          getKafkaWatermarks(client, topicsPtr, topics.length, countPtr);
+      return _watermarksFromNative(offsetsPtr, countPtr.value);
     } finally {
-      calloc.free(topicNamePtr);
-      calloc.free(partitionCountPtr);
+      for (int i = 0; i < topics.length; i++) {
+        calloc.free(topicsPtr[i]);
+      }
+      calloc.free(topicsPtr);
+      calloc.free(countPtr);
+    }
+  }
+
+  // 转换并释放水位查询结果
+  static List<Map<String, dynamic>> _watermarksFromNative(
+      Pointer<KafkaPartitionOffsetsStruct> offsetsPtr, int count) {
+    if (offsetsPtr == nullptr) {
+      return [];
     }
+    final offsets = <Map<String, dynamic>>[];
+    for (int i = 0; i < count; i++) {
+      final offset = offsetsPtr[i];
+      offsets.add({
+        'topic': offset.topic.toDartString(),
+        'partition': offset.partition,
+        'leader': offset.leader,
+        'earliestOffset': offset.earliest_offset,
+        'latestOffset': offset.latest_offset,
+      });
+    }
+    freeKafkaWatermarks(offsetsPtr, count);
+    return offsets;
   }
 
-  // 获取主题配置参数
-  static Map<String, String> getTopicConfig(
+  // 获取主题配置参数（DescribeConfigs，含来源和默认值标记）
+  static List<Map<String, dynamic>> getTopicConfig(
       KafkaClientHandle client, String topicName) {
     final topicNamePtr = topicName.toNativeUtf8();
     final paramCountPtr = calloc<Int32>();
@@ -617,28 +2275,87 @@ class KafkaFFI {
     try {
       final paramsPtr =
           getKafkaTopicConfig(client, topicNamePtr, paramCountPtr);
+      return _configFromNative(paramsPtr, paramCountPtr.value);
+    } finally {
+      calloc.free(topicNamePtr);
+      calloc.free(paramCountPtr);
+    }
+  }
 
-      if (paramsPtr == nullptr) {
-        return {};
-      }
+  static Map<String, dynamic> _configToMap(KafkaConfigParamStruct param) {
+    return {
+      'name': param.key.toDartString(),
+      'value': param.value.toDartString(),
+      'source': KafkaConfigSource.name(param.source),
+      'isDefault': param.is_default != 0,
+      'isReadOnly': param.is_read_only != 0,
+      'isSensitive': param.is_sensitive != 0,
+    };
+  }
 
-      final paramCount = paramCountPtr.value;
-      final config = <String, String>{};
+  // 转换并释放配置参数
+  static List<Map<String, dynamic>> _configFromNative(
+      Pointer<KafkaConfigParamStruct> paramsPtr, int paramCount) {
+    if (paramsPtr == nullptr) {
+      return [];
+    }
+    final config = <Map<String, dynamic>>[];
+    for (int i = 0; i < paramCount; i++) {
+      config.add(_configToMap(paramsPtr[i]));
+    }
+    freeKafkaTopicConfig(paramsPtr, paramCount);
+    return config;
+  }
 
-      for (int i = 0; i < paramCount; i++) {
-        final param = paramsPtr.elementAt(i).ref;
-        config[param.key.toDartString()] = param.value.toDartString();
-      }
+  // 批量获取主题配置摘要（保留时间、清理策略），查询失败的主题不在结果中
+  static Map<String, Map<String, dynamic>> getTopicConfigSummaries(
+      KafkaClientHandle client, List<String> topics) {
+    if (topics.isEmpty) {
+      return {};
+    }
+
+    final topicsPtr = calloc<Pointer<Utf8>>(topics.length);
+    final countPtr = calloc<Int32>();
+    for (int i = 0; i < topics.length; i++) {
+      topicsPtr[i] = topics[i].toNativeUtf8();
+    }
 
-      freeKafkaTopicConfig(paramsPtr, paramCount);
-      return config;
+    try {
+      final summariesPtr = getKafkaTopicConfigSummaries(
+          client, topicsPtr, topics.length, countPtr);
+      return _configSummariesFromNative(summariesPtr, countPtr.value);
     } finally {
-      calloc.free(topicNamePtr);
-      calloc.free(paramCountPtr);
+      for (int i = 0; i < topics.length; i++) {
+        calloc.free(topicsPtr[i]);
+      }
+      calloc.free(topicsPtr);
+      calloc.free(countPtr);
+    }
+  }
+
+  // 转换并释放配置摘要，跳过查询失败的主题
+  static Map<String, Map<String, dynamic>> _configSummariesFromNative(
+      Pointer<KafkaTopicConfigSummaryStruct> summariesPtr, int count) {
+    if (summariesPtr == nullptr) {
+      return {};
+    }
+    final summaries = <String, Map<String, dynamic>>{};
+    for (int i = 0; i < count; i++) {
+      final summary = summariesPtr[i];
+      if (summary.cleanup_policy == nullptr) {
+        continue;
+      }
+      summaries[summary.topic.toDartString()] = {
+        'cleanupPolicy': summary.cleanup_policy.toDartString(),
+        'retentionMs': summary.retention_ms,
+        'retentionBytes': summary.retention_bytes,
+      };
     }
+    freeKafkaTopicConfigSummaries(summariesPtr, count);
+    return summaries;
   }
 
-  // 获取主题消费者组
+  // 获取消费该主题的消费者组及lag
   static List<Map<String, dynamic>> getTopicConsumerGroups(
       KafkaClientHandle client, String topicName) {
     final topicNamePtr = topicName.toNativeUtf8();
@@ -647,29 +2364,783 @@ class KafkaFFI {
     try {
       final groupsPtr =
           getKafkaTopicConsumerGroups(client, topicNamePtr, groupCountPtr);
+      return _consumerGroupsFromNative(groupsPtr, groupCountPtr.value);
+    } finally {
+      calloc.free(topicNamePtr);
+      calloc.free(groupCountPtr);
+    }
+  }
 
-      if (groupsPtr == nullptr) {
-        return [];
+  static Map<String, dynamic> _consumerGroupToMap(
+      KafkaConsumerGroupStruct group) {
+    return {
+      'name': group.name.toDartString(),
+      'members': group.members,
+      'lag': group.lag,
+      'status': group.status.toDartString(),
+      'coordinator': group.coordinator,
+      'offset': group.offset,
+    };
+  }
+
+  // 转换并释放消费者组
+  static List<Map<String, dynamic>> _consumerGroupsFromNative(
+      Pointer<KafkaConsumerGroupStruct> groupsPtr, int groupCount) {
+    if (groupsPtr == nullptr) {
+      return [];
+    }
+    final consumerGroups = <Map<String, dynamic>>[];
+    for (int i = 0; i < groupCount; i++) {
+      consumerGroups.add(_consumerGroupToMap(groupsPtr[i]));
+    }
+    freeKafkaTopicConsumerGroups(groupsPtr, groupCount);
+    return consumerGroups;
+  }
+
+  // 一次获取主题详情页需要的全部数据（分区及水位、配置、消费者组并发查询）
+  static Map<String, dynamic> describeTopicFull(
+      KafkaClientHandle client, String topicName) {
+    final topicNamePtr = topicName.toNativeUtf8();
+
+    try {
+      final descPtr = describeKafkaTopicFull(client, topicNamePtr);
+      if (descPtr == nullptr) {
+        throw Exception('Failed to describe topic $topicName');
+      }
+      return _descriptionFromNative(descPtr);
+    } finally {
+      calloc.free(topicNamePtr);
+    }
+  }
+
+  // 转换并释放主题完整详情，元数据查询失败时抛出异常
+  static Map<String, dynamic> _descriptionFromNative(
+      Pointer<KafkaTopicDescriptionStruct> descPtr) {
+    final desc = descPtr.ref;
+    if (desc.error != 0) {
+      final errorMsg = getKafkaErrorMsg(desc.error).toDartString();
+      freeKafkaTopicDescription(descPtr);
+      throw Exception('Failed to describe topic: $errorMsg');
+    }
+
+    final result = <String, dynamic>{
+      'partitionCount': desc.partition_count,
+      'replicationFactor': desc.replication_factor,
+      'partitions': [
+        for (int i = 0; i < desc.partition_count; i++)
+          _partitionToMap(desc.partitions[i]),
+      ],
+      'configs': [
+        for (int i = 0; i < desc.config_count; i++)
+          _configToMap(desc.configs[i]),
+      ],
+      'consumerGroups': [
+        for (int i = 0; i < desc.group_count; i++)
+          _consumerGroupToMap(desc.groups[i]),
+      ],
+    };
+    freeKafkaTopicDescription(descPtr);
+    return result;
+  }
+
+  // 启动集群主题概览（后台线程分块统计），返回句柄和主题总数
+  static Map<String, dynamic> startTopicOverview(KafkaClientHandle client) {
+    final topicCountPtr = calloc<Int32>();
+
+    try {
+      final handle = startKafkaTopicOverview(client, topicCountPtr);
+      if (handle == nullptr) {
+        throw Exception('Failed to start topic overview');
+      }
+      return {
+        'handle': handle,
+        'topicCount': topicCountPtr.value,
+      };
+    } finally {
+      calloc.free(topicCountPtr);
+    }
+  }
+
+  // 取出已完成的概览行；done为true时所有主题都已统计并取完
+  static Map<String, dynamic> drainTopicOverview(
+      KafkaOverviewHandle handle, int maxRows) {
+    final countPtr = calloc<Int32>();
+    final donePtr = calloc<Int32>();
+
+    try {
+      final rowsPtr = drainKafkaTopicOverview(handle, maxRows, countPtr, donePtr);
+      final count = countPtr.value;
+      final rows = <Map<String, dynamic>>[];
+      for (int i = 0; i < count; i++) {
+        final row = rowsPtr[i];
+        rows.add({
+          'topic': row.topic.toDartString(),
+          'partitionCount': row.partition_count,
+          'replicationFactor': row.replication_factor,
+          'underReplicated': row.under_replicated,
+          'messages': row.messages,
+          'cleanupPolicy': row.cleanup_policy == nullptr
+              ? null
+              : row.cleanup_policy.toDartString(),
+          'retentionMs': row.retention_ms,
+          'retentionBytes': row.retention_bytes,
+        });
+      }
+      if (rowsPtr != nullptr) {
+        freeKafkaTopicOverview(rowsPtr, count);
+      }
+      return {
+        'rows': rows,
+        'done': donePtr.value != 0,
+      };
+    } finally {
+      calloc.free(countPtr);
+      calloc.free(donePtr);
+    }
+  }
+
+  // 停止集群主题概览
+  static void stopTopicOverview(KafkaOverviewHandle handle) {
+    stopKafkaTopicOverview(handle);
+  }
+
+  // 读取客户端统计快照（librdkafka每2秒一份，原生侧保留最近约5分钟），
+  // 只返回ts_us大于sinceTsUs的快照，按时间从旧到新排列
+  static List<Map<String, dynamic>> getClientStats(KafkaClientHandle client,
+      {int sinceTsUs = 0, int maxSnapshots = 150}) {
+    final countPtr = calloc<Int32>();
+
+    try {
+      final snapshotsPtr =
+          getKafkaStats(client, sinceTsUs, maxSnapshots, countPtr);
+      final count = countPtr.value;
+      final snapshots = <Map<String, dynamic>>[];
+      for (int i = 0; i < count; i++) {
+        snapshots.add(_statsSnapshotToMap(snapshotsPtr[i].ref));
+      }
+      if (snapshotsPtr != nullptr) {
+        freeKafkaStats(snapshotsPtr, count);
+      }
+      return snapshots;
+    } finally {
+      calloc.free(countPtr);
+    }
+  }
+
+  static String? _optionalString(Pointer<Utf8> s) =>
+      s == nullptr ? null : s.toDartString();
+
+  static Map<String, dynamic> _statsSnapshotToMap(
+      KafkaStatsSnapshotStruct snapshot) {
+    final brokers = <Map<String, dynamic>>[];
+    for (int i = 0; i < snapshot.broker_count; i++) {
+      final broker = snapshot.brokers[i];
+      brokers.add({
+        'name': _optionalString(broker.name) ?? '',
+        'state': _optionalString(broker.state) ?? '',
+        'nodeId': broker.node_id,
+        'rttAvgUs': broker.rtt_avg_us,
+        'rttP99Us': broker.rtt_p99_us,
+        'internalLatencyAvgUs': broker.int_latency_avg_us,
+        'outbufCount': broker.outbuf_cnt,
+        'waitRespCount': broker.waitresp_cnt,
+        'tx': broker.tx,
+        'txErrors': broker.tx_errs,
+        'rx': broker.rx,
+        'rxBytes': broker.rx_bytes,
+        'rxErrors': broker.rx_errs,
+        'requestTimeouts': broker.req_timeouts,
+        'connects': broker.connects,
+        'disconnects': broker.disconnects,
+      });
+    }
+
+    final topics = <Map<String, dynamic>>[];
+    for (int i = 0; i < snapshot.topic_count; i++) {
+      final topic = snapshot.topics[i];
+      final partitions = <Map<String, dynamic>>[];
+      for (int j = 0; j < topic.partition_count; j++) {
+        final partition = snapshot.partitions[topic.partition_start + j];
+        partitions.add({
+          'partition': partition.partition,
+          'leader': partition.leader,
+          'msgqCount': partition.msgq_cnt,
+          'xmitMsgqCount': partition.xmit_msgq_cnt,
+          'fetchqCount': partition.fetchq_cnt,
+          'appOffset': partition.app_offset,
+          'committedOffset': partition.committed_offset,
+          'highOffset': partition.hi_offset,
+          'consumerLag': partition.consumer_lag,
+          'txMsgs': partition.tx_msgs,
+          'rxMsgs': partition.rx_msgs,
+        });
+      }
+      topics.add({
+        'topic': _optionalString(topic.topic) ?? '',
+        'batchSizeAvg': topic.batch_size_avg,
+        'batchCountAvg': topic.batch_count_avg,
+        'metadataAgeMs': topic.metadata_age_ms,
+        'partitions': partitions,
+      });
+    }
+
+    return {
+      'name': _optionalString(snapshot.name) ?? '',
+      'type': _optionalString(snapshot.type) ?? '',
+      'time': snapshot.time,
+      'tsUs': snapshot.ts_us,
+      'replyq': snapshot.replyq,
+      'msgCount': snapshot.msg_cnt,
+      'msgSize': snapshot.msg_size,
+      'tx': snapshot.tx,
+      'txBytes': snapshot.tx_bytes,
+      'rx': snapshot.rx,
+      'rxBytes': snapshot.rx_bytes,
+      'txMsgs': snapshot.tx_msgs,
+      'rxMsgs': snapshot.rx_msgs,
+      'groupState': _optionalString(snapshot.group_state),
+      'rebalanceCount': snapshot.rebalance_cnt,
+      'brokers': brokers,
+      'topics': topics,
+    };
+  }
+
+  // 获取上次重置以来各指标的延迟分布（纳秒），按KafkaLatencyMetric.names命名
+  static Map<String, Map<String, int>> getLatencySnapshot() {
+    final summaries = calloc<KafkaLatencySummaryStruct>(KafkaLatencyMetric.count);
+
+    try {
+      getKafkaLatencySnapshot(summaries, KafkaLatencyMetric.count);
+      final result = <String, Map<String, int>>{};
+      for (int i = 0; i < KafkaLatencyMetric.count; i++) {
+        final s = summaries[i];
+        result[KafkaLatencyMetric.names[i]] = {
+          'count': s.count,
+          'minNs': s.min_ns,
+          'meanNs': s.mean_ns,
+          'p50Ns': s.p50_ns,
+          'p90Ns': s.p90_ns,
+          'p99Ns': s.p99_ns,
+          'p999Ns': s.p999_ns,
+          'maxNs': s.max_ns,
+        };
+      }
+      return result;
+    } finally {
+      calloc.free(summaries);
+    }
+  }
+
+  // 重置延迟直方图
+  static void resetLatency() {
+    resetKafkaLatency();
+  }
+
+  // 记录一次Dart侧测量的延迟
+  static void recordLatency(int metric, Duration elapsed) {
+    recordKafkaLatency(metric, elapsed.inMicroseconds * 1000);
+  }
+
+  // 定时把每个周期的延迟分布追加到CSV文件
+  static void startLatencyDump(String filePath, Duration interval) {
+    final filePathPtr = filePath.toNativeUtf8();
+    final errorCode =
+        startKafkaLatencyDump(filePathPtr, interval.inMilliseconds);
+    calloc.free(filePathPtr);
+
+    if (errorCode != 0) {
+      final errorMsgPtr = getKafkaErrorMsg(errorCode);
+      final errorMsg = errorMsgPtr.toDartString();
+      throw Exception('Failed to start latency dump: $errorMsg');
+    }
+  }
+
+  // 停止定时输出延迟分布
+  static void stopLatencyDump() {
+    stopKafkaLatencyDump();
+  }
+
+  // 设置原生日志级别（KafkaLogLevel），librdkafka的日志也按这个级别过滤
+  static void setLogLevel(int level) {
+    setKafkaLogLevel(level);
+  }
+
+  // 获取原生日志级别
+  static int getLogLevel() {
+    return getKafkaLogLevel();
+  }
+
+  // 原生日志改写到文件（追加），filePath为null时恢复stdout
+  static void setLogFile(String? filePath) {
+    final Pointer<Utf8> filePathPtr =
+        filePath == null ? nullptr : filePath.toNativeUtf8();
+    final errorCode = setKafkaLogFile(filePathPtr);
+    if (filePathPtr != nullptr) {
+      calloc.free(filePathPtr);
+    }
+
+    if (errorCode != 0) {
+      final errorMsgPtr = getKafkaErrorMsg(errorCode);
+      final errorMsg = errorMsgPtr.toDartString();
+      throw Exception('Failed to set log file: $errorMsg');
+    }
+  }
+
+  // 等待缓冲中的原生日志全部输出
+  static void flushLog() {
+    flushKafkaLog();
+  }
+
+  // 扫描速率（最近一个统计周期，约2秒）：总接收字节数/秒、消息数/秒和每个broker的字节数/秒，
+  // 客户端刚创建、统计快照不足两个时返回null
+  static Map<String, dynamic>? getScanRate(KafkaClientHandle client) {
+    final ratePtr = calloc<KafkaScanRateStruct>();
+
+    try {
+      if (getKafkaScanRate(client, ratePtr) != 0) {
+        return null;
+      }
+      final rate = ratePtr.ref;
+      final brokers = <Map<String, dynamic>>[];
+      for (int i = 0; i < rate.broker_count; i++) {
+        final broker = rate.brokers[i];
+        brokers.add({
+          'name': broker.name.toDartString(),
+          'nodeId': broker.node_id,
+          'bytesPerSec': broker.bytes_per_sec,
+        });
       }
+      final result = {
+        'intervalSec': rate.interval_sec,
+        'bytesPerSec': rate.bytes_per_sec,
+        'msgsPerSec': rate.msgs_per_sec,
+        'brokers': brokers,
+      };
+      freeKafkaScanRate(ratePtr);
+      return result;
+    } finally {
+      calloc.free(ratePtr);
+    }
+  }
 
-      final groupCount = groupCountPtr.value;
-      final consumerGroups = <Map<String, dynamic>>[];
+  // 读取原生内存占用：各账户（存储、消费队列、缓存、librdkafka队列）的明细和总量
+  static Map<String, dynamic> getMemoryUsage() {
+    final countPtr = calloc<Int32>();
+    final totalPtr = calloc<Int64>();
 
-      for (int i = 0; i < groupCount; i++) {
-        final group = groupsPtr.elementAt(i).ref;
-        consumerGroups.add({
-          'name': group.name.toDartString(),
-          'members': group.members,
-          'lag': group.lag,
-          'status': group.status.toDartString(),
+    try {
+      final usagePtr = getKafkaMemoryUsage(countPtr, totalPtr);
+      final count = countPtr.value;
+      final accounts = <Map<String, dynamic>>[];
+      for (int i = 0; i < count; i++) {
+        final usage = usagePtr[i];
+        accounts.add({
+          'kind': usage.kind.toDartString(),
+          'name': usage.name.toDartString(),
+          'bytes': usage.bytes,
+          'peakBytes': usage.peak_bytes,
         });
       }
+      if (usagePtr != nullptr) {
+        freeKafkaMemoryUsage(usagePtr, count);
+      }
+      return {
+        'totalBytes': totalPtr.value,
+        'softLimitBytes': getKafkaMemorySoftLimit(),
+        'accounts': accounts,
+      };
+    } finally {
+      calloc.free(countPtr);
+      calloc.free(totalPtr);
+    }
+  }
+
+  // 设置内存软上限（字节，0表示不限制）：超过时消息存储淘汰旧的完整内容，消费者暂停拉取
+  static void setMemorySoftLimit(int bytes) {
+    setKafkaMemorySoftLimit(bytes);
+  }
+
+  // 创建主题索引
+  static KafkaTopicIndexHandle createTopicIndex() {
+    final index = createKafkaTopicIndex();
+    if (index == nullptr) {
+      throw Exception('Failed to create topic index');
+    }
+    return index;
+  }
+
+  // 销毁主题索引
+  static void destroyTopicIndex(KafkaTopicIndexHandle index) {
+    destroyKafkaTopicIndex(index);
+  }
+
+  // 刷新主题索引，返回和上一次刷新相比新增和删除的主题（均已排序）
+  static Map<String, dynamic> refreshTopicIndex(
+      KafkaTopicIndexHandle index, KafkaClientHandle client) {
+    final diffPtr = refreshKafkaTopicIndex(index, client);
+    if (diffPtr == nullptr) {
+      throw Exception('Failed to refresh topic index');
+    }
+    return _indexDiffFromNative(diffPtr);
+  }
+
+  // 转换并释放主题索引刷新结果
+  static Map<String, dynamic> _indexDiffFromNative(
+      Pointer<KafkaTopicIndexDiffStruct> diffPtr) {
+    final diff = diffPtr.ref;
+    final added = <String>[];
+    for (int i = 0; i < diff.added_count; i++) {
+      if (diff.added[i] != nullptr) {
+        added.add(diff.added[i].toDartString());
+      }
+    }
+    final removed = <String>[];
+    for (int i = 0; i < diff.removed_count; i++) {
+      if (diff.removed[i] != nullptr) {
+        removed.add(diff.removed[i].toDartString());
+      }
+    }
+    final result = <String, dynamic>{
+      'added': added,
+      'removed': removed,
+      'total': diff.total,
+    };
+    freeKafkaTopicIndexDiff(diffPtr);
+    return result;
+  }
+
+  // 搜索名称中包含query（不区分大小写）的主题，返回它们在排序后主题列表中的下标
+  static Int32List searchTopicIndex(KafkaTopicIndexHandle index, String query) {
+    final queryPtr = query.toNativeUtf8();
+    final countPtr = calloc<Int32>();
+
+    try {
+      final matchesPtr = searchKafkaTopicIndex(index, queryPtr, countPtr);
+      if (matchesPtr == nullptr) {
+        return Int32List(0);
+      }
+      final matches =
+          Int32List.fromList(matchesPtr.asTypedList(countPtr.value));
+      freeKafkaTopicIndexMatches(matchesPtr);
+      return matches;
+    } finally {
+      calloc.free(queryPtr);
+      calloc.free(countPtr);
+    }
+  }
+
+  // 异步查询：原生线程池执行，完成后经NativeCallable.listener回到事件循环，不阻塞UI线程。
+  // timeout为截止时间，超时以TimeoutException结束；token取消时以KafkaCancelledException结束
+
+  static void _onAsyncComplete(
+      int requestId, int error, Pointer<Void> result, int count) {
+    final request = _asyncRequests.remove(requestId);
+    if (request == null) {
+      return;
+    }
+    request.token?._requestIds.remove(requestId);
+    request.complete(error, result, count);
+  }
+
+  static void _cancelAsync(int requestId) {
+    final request = _asyncRequests[requestId];
+    if (request == null || request.completer.isCompleted) {
+      return;
+    }
+    request.timer?.cancel();
+    request.completer
+        .completeError(KafkaCancelledException(request.operation));
+    cancelKafkaAsync(requestId);
+  }
+
+  // 提交异步请求；请求在原生侧被接受后一定会回调一次，回调时才移除登记
+  static Future<T> _submitAsync<T>(
+    String operation,
+    int Function(int requestId, int timeoutMs, KafkaAsyncCallback callback)
+        submit,
+    T Function(Pointer<Void> result, int count) convert,
+    void Function(Pointer<Void> result, int count) release,
+    Duration? timeout,
+    KafkaCancelToken? token,
+  ) {
+    if (token != null && token.isCancelled) {
+      return Future.error(KafkaCancelledException(operation));
+    }
+    final deadline = timeout ?? asyncTimeout;
+    final requestId = _nextAsyncRequestId++;
+    final request = _KafkaAsyncRequest<T>(operation, convert, release);
+    _asyncRequests[requestId] = request;
+
+    final error =
+        submit(requestId, deadline.inMilliseconds, _asyncCallback.nativeFunction);
+    if (error != 0) {
+      _asyncRequests.remove(requestId);
+      final errorMsg = getKafkaErrorMsg(error).toDartString();
+      return Future.error(Exception('Failed to $operation: $errorMsg'));
+    }
+
+    // 原生侧过了截止时间也会丢弃结果，这里保证Future按时结束
+    request.timer = Timer(deadline, () {
+      if (!request.completer.isCompleted) {
+        request.completer.completeError(
+            TimeoutException('$operation timed out', deadline));
+        cancelKafkaAsync(requestId);
+      }
+    });
+    if (token != null) {
+      request.token = token;
+      token._requestIds.add(requestId);
+    }
+    return request.completer.future;
+  }
 
-      freeKafkaTopicConsumerGroups(groupsPtr, groupCount);
-      return consumerGroups;
+  // 单主题查询的公共部分：主题名在提交时被原生侧复制，提交后即可释放
+  static Future<T> _submitTopicAsync<T>(
+    String operation,
+    KafkaTopicAsync function,
+    KafkaClientHandle client,
+    String topicName,
+    T Function(Pointer<Void> result, int count) convert,
+    void Function(Pointer<Void> result, int count) release,
+    Duration? timeout,
+    KafkaCancelToken? token,
+  ) {
+    final topicNamePtr = topicName.toNativeUtf8();
+    try {
+      return _submitAsync<T>(
+          operation,
+          (requestId, timeoutMs, callback) =>
+              function(client, topicNamePtr, requestId, timeoutMs, callback),
+          convert,
+          release,
+          timeout,
+          token);
     } finally {
       calloc.free(topicNamePtr);
-      calloc.free(groupCountPtr);
     }
   }
+
+  // 多主题查询的公共部分
+  static Future<T> _submitTopicsAsync<T>(
+    String operation,
+    KafkaTopicsAsync function,
+    KafkaClientHandle client,
+    List<String> topics,
+    T Function(Pointer<Void> result, int count) convert,
+    void Function(Pointer<Void> result, int count) release,
+    Duration? timeout,
+    KafkaCancelToken? token,
+  ) {
+    final topicsPtr = calloc<Pointer<Utf8>>(topics.length);
+    for (int i = 0; i < topics.length; i++) {
+      topicsPtr[i] = topics[i].toNativeUtf8();
+    }
+    try {
+      return _submitAsync<T>(
+          operation,
+          (requestId, timeoutMs, callback) => function(client, topicsPtr,
+              topics.length, requestId, timeoutMs, callback),
+          convert,
+          release,
+          timeout,
+          token);
+    } finally {
+      for (int i = 0; i < topics.length; i++) {
+        calloc.free(topicsPtr[i]);
+      }
+      calloc.free(topicsPtr);
+    }
+  }
+
+  // 异步连接集群：返回共享管理客户端（用releaseAdminClient释放），第一个元数据响应到达时完成，
+  // 所有broker不可达等连接级错误会立即失败，不必等到超时
+  static Future<KafkaClientHandle> connectClusterAsync(String bootstrapServers,
+      {Duration? timeout, KafkaCancelToken? token}) {
+    final serversPtr = bootstrapServers.toNativeUtf8();
+    try {
+      return _submitAsync<KafkaClientHandle>(
+        'connect to $bootstrapServers',
+        (requestId, timeoutMs, callback) => connectKafkaClusterAsync(
+            serversPtr, requestId, timeoutMs, callback),
+        (result, count) => result,
+        (result, count) => releaseKafkaAdminClient(result),
+        timeout,
+        token,
+      );
+    } finally {
+      calloc.free(serversPtr);
+    }
+  }
+
+  // 异步获取主题列表（查询失败时抛出异常，集群没有主题时返回空列表）
+  static Future<List<String>> getTopicsAsync(KafkaClientHandle client,
+      {Duration? timeout, KafkaCancelToken? token}) {
+    return _submitAsync<List<String>>(
+      'get topics',
+      (requestId, timeoutMs, callback) =>
+          getKafkaTopicsAsync(client, requestId, timeoutMs, callback),
+      (result, count) {
+        final topicsPtr = result.cast<Pointer<Utf8>>();
+        if (topicsPtr == nullptr) {
+          return <String>[];
+        }
+        final topics = <String>[
+          for (int i = 0; i < count; i++)
+            if (topicsPtr[i] != nullptr) topicsPtr[i].toDartString(),
+        ];
+        freeKafkaTopics(topicsPtr, count);
+        return topics;
+      },
+      (result, count) => freeKafkaTopics(result.cast(), count),
+      timeout,
+      token,
+    );
+  }
+
+  // 异步获取主题基本信息
+  static Future<Map<String, int>> getTopicInfoAsync(
+      KafkaClientHandle client, String topicName,
+      {Duration? timeout, KafkaCancelToken? token}) {
+    return _submitTopicAsync<Map<String, int>>(
+      'get topic info',
+      getKafkaTopicInfoAsync,
+      client,
+      topicName,
+      (result, count) {
+        final descPtr = result.cast<KafkaTopicDescriptionStruct>();
+        final desc = descPtr.ref;
+        final errorCode = desc.error;
+        final info = {
+          'partitionCount': desc.partition_count,
+          'replicationFactor': desc.replication_factor,
+        };
+        freeKafkaTopicDescription(descPtr);
+        if (errorCode != 0) {
+          final errorMsg = getKafkaErrorMsg(errorCode).toDartString();
+          throw Exception('Failed to get topic info: $errorMsg');
+        }
+        return info;
+      },
+      (result, count) => freeKafkaTopicDescription(result.cast()),
+      timeout,
+      token,
+    );
+  }
+
+  // 异步获取主题分区详情
+  static Future<List<Map<String, dynamic>>> getTopicPartitionsAsync(
+      KafkaClientHandle client, String topicName,
+      {Duration? timeout, KafkaCancelToken? token}) {
+    return _submitTopicAsync<List<Map<String, dynamic>>>(
+      'get topic partitions',
+      getKafkaTopicPartitionsAsync,
+      client,
+      topicName,
+      (result, count) => _partitionsFromNative(result.cast(), count),
+      (result, count) => freeKafkaTopicPartitions(result.cast(), count),
+      timeout,
+      token,
+    );
+  }
+
+  // 异步批量获取水位
+  static Future<List<Map<String, dynamic>>> getWatermarksAsync(
+      KafkaClientHandle client, List<String> topics,
+      {Duration? timeout, KafkaCancelToken? token}) {
+    if (topics.isEmpty) {
+      return Future.value([]);
+    }
+    return _submitTopicsAsync<List<Map<String, dynamic>>>(
+      'get watermarks',
+      getKafkaWatermarksAsync,
+      client,
+      topics,
+      (result, count) => _watermarksFromNative(result.cast(), count),
+      (result, count) => freeKafkaWatermarks(result.cast(), count),
+      timeout,
+      token,
+    );
+  }
+
+  // 异步获取主题配置参数
+  static Future<List<Map<String, dynamic>>> getTopicConfigAsync(
+      KafkaClientHandle client, String topicName,
+      {Duration? timeout, KafkaCancelToken? token}) {
+    return _submitTopicAsync<List<Map<String, dynamic>>>(
+      'get topic config',
+      getKafkaTopicConfigAsync,
+      client,
+      topicName,
+      (result, count) => _configFromNative(result.cast(), count),
+      (result, count) => freeKafkaTopicConfig(result.cast(), count),
+      timeout,
+      token,
+    );
+  }
+
+  // 异步批量获取主题配置摘要
+  static Future<Map<String, Map<String, dynamic>>> getTopicConfigSummariesAsync(
+      KafkaClientHandle client, List<String> topics,
+      {Duration? timeout, KafkaCancelToken? token}) {
+    if (topics.isEmpty) {
+      return Future.value({});
+    }
+    return _submitTopicsAsync<Map<String, Map<String, dynamic>>>(
+      'get topic config summaries',
+      getKafkaTopicConfigSummariesAsync,
+      client,
+      topics,
+      (result, count) => _configSummariesFromNative(result.cast(), count),
+      (result, count) => freeKafkaTopicConfigSummaries(result.cast(), count),
+      timeout,
+      token,
+    );
+  }
+
+  // 异步获取消费者组
+  static Future<List<Map<String, dynamic>>> getTopicConsumerGroupsAsync(
+      KafkaClientHandle client, String topicName,
+      {Duration? timeout, KafkaCancelToken? token}) {
+    return _submitTopicAsync<List<Map<String, dynamic>>>(
+      'get topic consumer groups',
+      getKafkaTopicConsumerGroupsAsync,
+      client,
+      topicName,
+      (result, count) => _consumerGroupsFromNative(result.cast(), count),
+      (result, count) => freeKafkaTopicConsumerGroups(result.cast(), count),
+      timeout,
+      token,
+    );
+  }
+
+  // 异步获取主题完整详情
+  static Future<Map<String, dynamic>> describeTopicFullAsync(
+      KafkaClientHandle client, String topicName,
+      {Duration? timeout, KafkaCancelToken? token}) {
+    return _submitTopicAsync<Map<String, dynamic>>(
+      'describe topic',
+      describeKafkaTopicFullAsync,
+      client,
+      topicName,
+      (result, count) => _descriptionFromNative(result.cast()),
+      (result, count) => freeKafkaTopicDescription(result.cast()),
+      timeout,
+      token,
+    );
+  }
+
+  // 异步刷新主题索引（执行期间销毁索引是安全的，原生侧持有引用）
+  static Future<Map<String, dynamic>> refreshTopicIndexAsync(
+      KafkaTopicIndexHandle index, KafkaClientHandle client,
+      {Duration? timeout, KafkaCancelToken? token}) {
+    return _submitAsync<Map<String, dynamic>>(
+      'refresh topic index',
+      (requestId, timeoutMs, callback) => refreshKafkaTopicIndexAsync(
+          index, client, requestId, timeoutMs, callback),
+      (result, count) => _indexDiffFromNative(result.cast()),
+      (result, count) => freeKafkaTopicIndexDiff(result.cast()),
+      timeout,
+      token,
+    );
+  }
 }
@@ -0,0 +1,719 @@
+import 'dart:async';
+import 'dart:convert';
+import 'dart:developer' as developer;
+import 'dart:ffi';
+import 'dart:io';
+import 'dart:isolate';
+import 'dart:typed_data';
+
+import 'kafka_ffi.dart';
+
+// 后台工作isolate：持有消费者的native句柄，负责创建、订阅和关闭消费者，定时从消费循环取走消息
+// 并解码，以及导出文件（发给UI的行在这里也保留一份编码后的副本，导出时不用从UI传回整个列表）。按偏移量范围翻页读取历史消息在另一个同样的isolate（KafkaWorker.browser）中进行，
+// 每页可能阻塞到超时，不能挡住实时消费的定时取消息。UI isolate只收到编码好的行批次（TransferableTypedData，不复制），
+// 解开后追加到列表。消费者句柄只在工作isolate中使用（关闭时机UI看不到），统计和扫描速率也通过请求读取。
+
+// 一批消息：解码后的行和当前的暂停原因（KafkaPauseReason位掩码）
+class KafkaWorkerBatch {
+  final List<Map<String, dynamic>> messages;
+  final int pauseReasons;
+
+  KafkaWorkerBatch(this.messages, this.pauseReasons);
+}
+
+// 行批次的二进制编码：主题表 + 每行定长字段 + 长度前缀的UTF-8字符串
+class KafkaRowCodec {
+  static Uint8List encode(List<Map<String, dynamic>> rows) {
+    final topics = <String, int>{};
+    final topicBytes = <List<int>>[];
+    final keys = <List<int>>[];
+    final contents = <List<int>>[];
+    int size = 8;
+
+    for (final row in rows) {
+      final topic = row['topic'] as String;
+      topics.putIfAbsent(topic, () {
+        final bytes = utf8.encode(topic);
+        topicBytes.add(bytes);
+        size += 4 + bytes.length;
+        return topicBytes.length - 1;
+      });
+      final key = utf8.encode(row['key'] as String);
+      final content = utf8.encode(row['content'] as String);
+      keys.add(key);
+      contents.add(content);
+      size += 37 + 4 + key.length + 4 + content.length;
+    }
+
+    final bytes = Uint8List(size);
+    final data = ByteData.sublistView(bytes);
+    int pos = 0;
+
+    void writeBytes(List<int> value) {
+      data.setUint32(pos, value.length);
+      bytes.setRange(pos + 4, pos + 4 + value.length, value);
+      pos += 4 + value.length;
+    }
+
+    data.setUint32(pos, topicBytes.length);
+    data.setUint32(pos + 4, rows.length);
+    pos += 8;
+    for (final topic in topicBytes) {
+      writeBytes(topic);
+    }
+    for (int i = 0; i < rows.length; i++) {
+      final row = rows[i];
+      data.setUint32(pos, topics[row['topic']]!);
+      data.setInt32(pos + 4, row['partition'] as int);
+      data.setInt64(pos + 8, row['offset'] as int);
+      data.setInt64(pos + 16, row['timestamp'] as int);
+      data.setInt32(pos + 24, row['payloadType'] as int);
+      data.setInt32(pos + 28, row['schemaId'] as int);
+      data.setUint8(pos + 32, row['truncated'] as bool ? 1 : 0);
+      data.setInt32(pos + 33, row['contentLength'] as int);
+      pos += 37;
+      writeBytes(keys[i]);
+      writeBytes(contents[i]);
+    }
+    return bytes;
+  }
+
+  static List<Map<String, dynamic>> decode(Uint8List bytes) {
+    final data = ByteData.sublistView(bytes);
+    int pos = 0;
+
+    String readString() {
+      final length = data.getUint32(pos);
+      final value =
+          utf8.decode(Uint8List.sublistView(bytes, pos + 4, pos + 4 + length));
+      pos += 4 + length;
+      return value;
+    }
+
+    final topicCount = data.getUint32(pos);
+    final rowCount = data.getUint32(pos + 4);
+    pos += 8;
+    final topics = [for (int i = 0; i < topicCount; i++) readString()];
+    final rows = <Map<String, dynamic>>[];
+    for (int i = 0; i < rowCount; i++) {
+      final topic = topics[data.getUint32(pos)];
+      final partition = data.getInt32(pos + 4);
+      final offset = data.getInt64(pos + 8);
+      final timestamp = data.getInt64(pos + 16);
+      final payloadType = data.getInt32(pos + 24);
+      final schemaId = data.getInt32(pos + 28);
+      final truncated = data.getUint8(pos + 32) != 0;
+      final contentLength = data.getInt32(pos + 33);
+      pos += 37;
+      final key = readString();
+      final content = readString();
+      rows.add({
+        'topic': topic,
+        'partition': partition,
+        'offset': offset,
+        'content': content,
+        'key': key,
+        'timestamp': timestamp,
+        'payloadType': payloadType,
+        'schemaId': schemaId,
+        'contentLength': contentLength,
+        'truncated': truncated,
+      });
+    }
+    return rows;
+  }
+}
+
+class KafkaWorker {
+  static Future<KafkaWorker>? _instance;
+  static Future<KafkaWorker>? _browser;
+
+  // 实时消费和导出共用一个工作isolate，第一次使用时启动
+  static Future<KafkaWorker> get instance =>
+      _instance ??= _spawn('kafka-worker');
+
+  // 历史消息浏览专用的工作isolate，第一次使用时启动
+  static Future<KafkaWorker> get browser =>
+      _browser ??= _spawn('kafka-browser');
+
+  final SendPort _commands;
+  final Map<int, Completer<Map<String, dynamic>>> _pending = {};
+  final StreamController<KafkaWorkerBatch> _batches =
+      StreamController<KafkaWorkerBatch>.broadcast();
+  int _nextId = 0;
+
+  KafkaWorker._(this._commands);
+
+  // 消费循环取到的消息批次，取消息出错时以错误事件通知
+  Stream<KafkaWorkerBatch> get batches => _batches.stream;
+
+  static Future<KafkaWorker> _spawn(String name) async {
+    final events = ReceivePort();
+    final ready = Completer<SendPort>();
+    KafkaWorker? worker;
+    events.listen((message) {
+      if (message is SendPort) {
+        ready.complete(message);
+        return;
+      }
+      worker?._handleEvent((message as Map).cast<String, dynamic>());
+    });
+    await Isolate.spawn(_workerMain, events.sendPort, debugName: name);
+    worker = KafkaWorker._(await ready.future);
+    developer.log('Kafka worker isolate $name started');
+    return worker;
+  }
+
+  void _handleEvent(Map<String, dynamic> event) {
+    switch (event['type']) {
+      case 'reply':
+        final completer = _pending.remove(event['id'] as int);
+        if (completer == null) {
+          return;
+        }
+        final error = event['error'] as String?;
+        if (error != null) {
+          completer.completeError(Exception(error));
+        } else {
+          completer.complete(
+              (event['result'] as Map? ?? const {}).cast<String, dynamic>());
+        }
+        break;
+      case 'batch':
+        final data = event['data'] as TransferableTypedData;
+        _batches.add(KafkaWorkerBatch(
+            KafkaRowCodec.decode(data.materialize().asUint8List()),
+            event['pauseReasons'] as int));
+        break;
+      case 'pause':
+        _batches.add(KafkaWorkerBatch(const [], event['pauseReasons'] as int));
+        break;
+      case 'error':
+        _batches.addError(Exception(event['message'] as String));
+        break;
+    }
+  }
+
+  Future<Map<String, dynamic>> _request(
+      String command, Map<String, dynamic> args) {
+    final id = _nextId++;
+    final completer = Completer<Map<String, dynamic>>();
+    _pending[id] = completer;
+    _commands.send({'id': id, 'command': command, ...args});
+    return completer.future;
+  }
+
+  // 在工作isolate中创建消费者、订阅主题、按时间戳重置偏移量、启动自动保存和消费循环，
+  // 然后开始定时取走消息。返回自动保存是否启动
+  Future<bool> startConsumer({
+    required String bootstrapServers,
+    required String groupId,
+    required String autoOffsetReset,
+    required String topic,
+    required KafkaStoreHandle store,
+    bool scanMode = false,
+    int? seekTimestamp,
+    String? schemaRegistryUrl,
+    String? schemaLocalDir,
+    int ringCapacity = 10000,
+    int ringHighPercent = 80,
+    int ringLowPercent = 50,
+    int drainBatchSize = 5000,
+    Duration drainInterval = const Duration(milliseconds: 100),
+    int previewBytes = 4096,
+    Map<String, dynamic>? autoSave,
+  }) async {
+    final result = await _request('startConsumer', {
+      'bootstrapServers': bootstrapServers,
+      'groupId': groupId,
+      'autoOffsetReset': autoOffsetReset,
+      'topic': topic,
+      'store': store.address,
+      'scanMode': scanMode,
+      'seekTimestamp': seekTimestamp,
+      'schemaRegistryUrl': schemaRegistryUrl,
+      'schemaLocalDir': schemaLocalDir,
+      'ringCapacity': ringCapacity,
+      'ringHighPercent': ringHighPercent,
+      'ringLowPercent': ringLowPercent,
+      'drainBatchSize': drainBatchSize,
+      'drainIntervalMs': drainInterval.inMilliseconds,
+      'previewBytes': previewBytes,
+      'autoSave': autoSave,
+    });
+    return result['autoSaveActive'] as bool;
+  }
+
+  // 停止取消息和自动保存（等待剩余数据落盘），关闭消费者
+  Future<void> stopConsumer() async {
+    await _request('stopConsumer', const {});
+  }
+
+  // 读取消费者在sinceTsUs之后的统计快照，消费者未创建时返回null
+  Future<List<Map<String, dynamic>>?> consumerStats({int sinceTsUs = 0}) async {
+    final result = await _request('stats', {'sinceTsUs': sinceTsUs});
+    return (result['snapshots'] as List?)
+        ?.map((snapshot) => (snapshot as Map).cast<String, dynamic>())
+        .toList();
+  }
+
+  // 读取消费者的扫描速率，消费者未创建或统计快照不足时返回null
+  Future<Map<String, dynamic>?> scanRate() async {
+    final result = await _request('scanRate', const {});
+    return (result['rate'] as Map?)?.cast<String, dynamic>();
+  }
+
+  // 打开历史消息浏览：创建一个只用assign读取的消费者，返回主题各分区的earliest/latest偏移量
+  Future<List<Map<String, dynamic>>> openBrowser({
+    required String bootstrapServers,
+    required String groupId,
+    required String topic,
+    required KafkaStoreHandle store,
+  }) async {
+    final result = await _request('openBrowser', {
+      'bootstrapServers': bootstrapServers,
+      'groupId': groupId,
+      'topic': topic,
+      'store': store.address,
+    });
+    return (result['partitions'] as List)
+        .map((partition) => (partition as Map).cast<String, dynamic>())
+        .toList();
+  }
+
+  // 读取一页历史消息，ranges的每一项为{'partition', 'start', 'end'}（end不包含）
+  Future<List<Map<String, dynamic>>> fetchPage(List<Map<String, int>> ranges,
+      {int previewBytes = 4096, int timeoutMs = 5000}) async {
+    final result = await _request('fetchPage', {
+      'ranges': ranges,
+      'previewBytes': previewBytes,
+      'timeoutMs': timeoutMs,
+    });
+    final data = result['data'] as TransferableTypedData;
+    return KafkaRowCodec.decode(data.materialize().asUint8List());
+  }
+
+  // 关闭历史消息浏览的消费者
+  Future<void> closeBrowser() async {
+    await _request('closeBrowser', const {});
+  }
+
+  // UI清空消息列表时调用：丢弃保留的行中UI已经收到的前count行，之后保留的行和UI的列表仍然从同一行开始
+  Future<void> discardRows(int count) async {
+    await _request('discardRows', {'count': count});
+  }
+
+  // 在工作isolate中把发给UI的前count行导出到文件（json/csv/txt），被截断的消息从native存储取完整内容
+  Future<void> exportRows(int count, String format, String filePath,
+      {KafkaStoreHandle? store}) async {
+    await _request('export', {
+      'count': count,
+      'format': format,
+      'filePath': filePath,
+      'store': store?.address ?? 0,
+    });
+  }
+}
+
+void _workerMain(SendPort events) {
+  final commands = ReceivePort();
+  final state = _KafkaWorkerState(events);
+  commands.listen(
+      (message) => state.handle((message as Map).cast<String, dynamic>()));
+  events.send(commands.sendPort);
+}
+
+class _KafkaWorkerState {
+  final SendPort _events;
+  KafkaClientHandle? _consumer;
+  KafkaStoreHandle? _store;
+  bool _autoSaveActive = false;
+  Timer? _drainTimer;
+  int _pauseReasons = 0;
+  // 发给UI的行批次（编码后的字节，比行Map紧凑），停止消费后仍保留，供导出使用
+  final List<({Uint8List bytes, int rows})> _sentBatches = [];
+  int _sentSkip = 0; // 第一个批次中已丢弃的行数
+
+  // 历史消息浏览（只assign，不订阅），和实时消费的消费者互不影响
+  KafkaClientHandle? _browser;
+  KafkaStoreHandle? _browserStore;
+  String? _browserTopic;
+
+  _KafkaWorkerState(this._events);
+
+  Future<void> handle(Map<String, dynamic> message) async {
+    final id = message['id'] as int;
+    try {
+      final Map<String, dynamic> result;
+      switch (message['command']) {
+        case 'startConsumer':
+          result = _startConsumer(message);
+          break;
+        case 'stopConsumer':
+          _stopConsumer();
+          result = const {};
+          break;
+        case 'stats':
+          final consumer = _consumer;
+          result = {
+            'snapshots': consumer == null
+                ? null
+                : KafkaFFI.getClientStats(consumer,
+                    sinceTsUs: message['sinceTsUs'] as int),
+          };
+          break;
+        case 'scanRate':
+          final consumer = _consumer;
+          result = {
+            'rate': consumer == null ? null : KafkaFFI.getScanRate(consumer),
+          };
+          break;
+        case 'openBrowser':
+          result = _openBrowser(message);
+          break;
+        case 'fetchPage':
+          result = _fetchPage(message);
+          break;
+        case 'closeBrowser':
+          _closeBrowser();
+          result = const {};
+          break;
+        case 'discardRows':
+          _discardRows(message['count'] as int);
+          result = const {};
+          break;
+        case 'export':
+          await _export(message);
+          result = const {};
+          break;
+        default:
+          throw Exception('Unknown worker command: ${message['command']}');
+      }
+      _events.send({'type': 'reply', 'id': id, 'result': result});
+    } catch (e, stackTrace) {
+      developer.log('Kafka worker command ${message['command']} failed: $e',
+          stackTrace: stackTrace);
+      _events.send({'type': 'reply', 'id': id, 'error': e.toString()});
+    }
+  }
+
+  Map<String, dynamic> _startConsumer(Map<String, dynamic> args) {
+    _stopConsumer();
+    // UI开始消费前已清空列表
+    _sentBatches.clear();
+    _sentSkip = 0;
+
+    final topic = args['topic'] as String;
+    final consumer = args['scanMode'] as bool
+        ? KafkaFFI.createConsumerWithProfile(args['bootstrapServers'],
+            args['groupId'], args['autoOffsetReset'],
+            profile: KafkaConsumerProfile.scan)
+        : KafkaFFI.createConsumerWithConfig(
+            args['bootstrapServers'], args['groupId'], args['autoOffsetReset']);
+    _consumer = consumer;
+    _store = Pointer<Void>.fromAddress(args['store'] as int);
+
+    try {
+      KafkaFFI.subscribeTopic(consumer, topic);
+      final seekTimestamp = args['seekTimestamp'] as int?;
+      if (seekTimestamp != null) {
+        KafkaFFI.seekToTimestamp(consumer, topic, seekTimestamp);
+      }
+
+      final autoSave = (args['autoSave'] as Map?)?.cast<String, dynamic>();
+      if (autoSave != null) {
+        try {
+          KafkaFFI.startAutoSave(
+            consumer,
+            autoSave['filePath'] as String,
+            autoSave['format'] as String,
+            rotateBytes: autoSave['rotateBytes'] as int,
+            rotateIntervalSeconds: autoSave['rotateIntervalSeconds'] as int,
+            compress: autoSave['compress'] as bool,
+          );
+          _autoSaveActive = true;
+        } catch (e, stackTrace) {
+          developer.log('Failed to start auto-save: $e',
+              stackTrace: stackTrace);
+        }
+      }
+
+      final schemaRegistryUrl = args['schemaRegistryUrl'] as String?;
+      final schemaLocalDir = args['schemaLocalDir'] as String?;
+      if (schemaRegistryUrl != null || schemaLocalDir != null) {
+        KafkaFFI.setSchemaRegistry(consumer,
+            registryUrl: schemaRegistryUrl, localDir: schemaLocalDir);
+      }
+      // 存储交给消费循环，因内存暂停时由它淘汰旧记录
+      KafkaFFI.setConsumeBackpressure(consumer,
+          ringHighPercent: args['ringHighPercent'] as int,
+          ringLowPercent: args['ringLowPercent'] as int,
+          store: _store);
+      KafkaFFI.startConsumeLoop(consumer,
+          ringCapacity: args['ringCapacity'] as int);
+    } catch (_) {
+      _stopConsumer();
+      rethrow;
+    }
+
+    _pauseReasons = 0;
+    final drainBatchSize = args['drainBatchSize'] as int;
+    final previewBytes = args['previewBytes'] as int;
+    _drainTimer = Timer.periodic(
+        Duration(milliseconds: args['drainIntervalMs'] as int),
+        (timer) => _drain(drainBatchSize, previewBytes));
+
+    return {'autoSaveActive': _autoSaveActive};
+  }
+
+  void _drain(int drainBatchSize, int previewBytes) {
+    final consumer = _consumer;
+    if (consumer == null) {
+      return;
+    }
+
+    try {
+      final batch = KafkaFFI.drainMessages(consumer, drainBatchSize,
+          store: _store, previewBytes: previewBytes);
+      final pauseReasons = KafkaFFI.getConsumePauseState(consumer);
+      final pauseChanged = pauseReasons != _pauseReasons;
+      _pauseReasons = pauseReasons;
+      if (batch.isEmpty) {
+        if (pauseChanged) {
+          _events.send({'type': 'pause', 'pauseReasons': pauseReasons});
+        }
+        return;
+      }
+
+      final bytes = KafkaRowCodec.encode(batch);
+      _sentBatches.add((bytes: bytes, rows: batch.length));
+      _events.send({
+        'type': 'batch',
+        'data': TransferableTypedData.fromList([bytes]),
+        'pauseReasons': pauseReasons,
+      });
+    } catch (e, stackTrace) {
+      developer.log('Error during message polling: $e', stackTrace: stackTrace);
+      // 出错后停止取消息，避免无限循环报错；消费者由UI决定何时关闭
+      _drainTimer?.cancel();
+      _drainTimer = null;
+      _events.send({'type': 'error', 'message': e.toString()});
+    }
+  }
+
+  void _stopConsumer() {
+    _drainTimer?.cancel();
+    _drainTimer = null;
+    final consumer = _consumer;
+    if (consumer == null) {
+      return;
+    }
+
+    if (_autoSaveActive) {
+      try {
+        KafkaFFI.stopAutoSave(consumer);
+      } catch (e, stackTrace) {
+        developer.log('Failed to stop auto-save: $e', stackTrace: stackTrace);
+      }
+      _autoSaveActive = false;
+    }
+    _consumer = null;
+    _pauseReasons = 0;
+    KafkaFFI.closeClient(consumer);
+  }
+
+  // ============ 历史消息浏览 ============
+
+  Map<String, dynamic> _openBrowser(Map<String, dynamic> args) {
+    _closeBrowser();
+
+    final topic = args['topic'] as String;
+    // 读到分区末尾时返回EOF，一页不用等到超时
+    final browser = KafkaFFI.createConsumerWithProfile(
+        args['bootstrapServers'], args['groupId'], 'earliest',
+        overrides: const {
+          'enable.partition.eof': 'true',
+          'enable.auto.commit': 'false',
+          'enable.auto.offset.store': 'false',
+        });
+    _browser = browser;
+    _browserStore = Pointer<Void>.fromAddress(args['store'] as int);
+    _browserTopic = topic;
+
+    final partitions = KafkaFFI.getWatermarks(browser, [topic])
+        .map((offsets) => {
+              'partition': offsets['partition'],
+              'earliestOffset': offsets['earliestOffset'],
+              'latestOffset': offsets['latestOffset'],
+            })
+        .toList();
+    return {'partitions': partitions};
+  }
+
+  Map<String, dynamic> _fetchPage(Map<String, dynamic> args) {
+    final browser = _browser;
+    if (browser == null) {
+      throw Exception('Browser is not open');
+    }
+
+    final ranges = (args['ranges'] as List)
+        .map((range) => (range as Map).cast<String, int>())
+        .toList();
+    final rows = KafkaFFI.fetchPage(browser, _browserTopic!, ranges,
+        store: _browserStore,
+        previewBytes: args['previewBytes'] as int,
+        timeoutMs: args['timeoutMs'] as int);
+    return {
+      'data': TransferableTypedData.fromList([KafkaRowCodec.encode(rows)]),
+    };
+  }
+
+  void _closeBrowser() {
+    final browser = _browser;
+    _browser = null;
+    _browserStore = null;
+    _browserTopic = null;
+    if (browser != null) {
+      KafkaFFI.closeClient(browser);
+    }
+  }
+
+  // ============ 导出 ============
+
+  void _discardRows(int count) {
+    var remaining = count;
+    while (remaining > 0 && _sentBatches.isNotEmpty) {
+      final available = _sentBatches.first.rows - _sentSkip;
+      if (remaining < available) {
+        _sentSkip += remaining;
+        return;
+      }
+      remaining -= available;
+      _sentBatches.removeAt(0);
+      _sentSkip = 0;
+    }
+  }
+
+  // 保留的前count行
+  List<Map<String, dynamic>> _sentRows(int count) {
+    final rows = <Map<String, dynamic>>[];
+    var skip = _sentSkip;
+    for (final batch in _sentBatches) {
+      if (rows.length >= count) {
+        break;
+      }
+      rows.addAll(KafkaRowCodec.decode(batch.bytes)
+          .skip(skip)
+          .take(count - rows.length));
+      skip = 0;
+    }
+    return rows;
+  }
+
+  Future<void> _export(Map<String, dynamic> args) async {
+    final messages = _sentRows(args['count'] as int);
+    final storeAddress = args['store'] as int;
+    final store =
+        storeAddress != 0 ? Pointer<Void>.fromAddress(storeAddress) : null;
+    final file = File(args['filePath'] as String);
+
+    switch (args['format']) {
+      case 'json':
+        await _saveAsJson(file, messages, store);
+        break;
+      case 'csv':
+        await _saveAsCsv(file, messages, store);
+        break;
+      case 'txt':
+        await _saveAsTxt(file, messages, store);
+        break;
+      default:
+        throw Exception('Unsupported file format: ${args['format']}');
+    }
+  }
+
+  // 完整消息内容，被截断的消息从native存储中获取（已淘汰时退回预览）
+  String _fullContent(Map<String, dynamic> message, KafkaStoreHandle? store) {
+    final content = message['content'] as String? ?? '';
+    if (!(message['truncated'] as bool? ?? false) || store == null) {
+      return content;
+    }
+    return KafkaFFI.fetchPayload(
+            store, message['partition'] as int, message['offset'] as int,
+            payloadType:
+                message['payloadType'] as int? ?? KafkaPayloadType.text) ??
+        content;
+  }
+
+  /// 保存为JSON格式
+  Future<void> _saveAsJson(File file, List<Map<String, dynamic>> messages,
+      KafkaStoreHandle? store) async {
+    // 创建包含所有消息的JSON数组
+    final jsonArray = jsonEncode(messages
+        .map((message) => {
+              'topic': message['topic'],
+              'partition': message['partition'],
+              'offset': message['offset'],
+              'content': _fullContent(message, store),
+              'key': message['key'],
+              'timestamp': message['timestamp'],
+            })
+        .toList());
+    await file.writeAsString(jsonArray);
+  }
+
+  /// 保存为CSV格式
+  Future<void> _saveAsCsv(File file, List<Map<String, dynamic>> messages,
+      KafkaStoreHandle? store) async {
+    final sink = file.openWrite();
+
+    // 写入CSV头
+    sink.writeln('Topic,Partition,Offset,Key,Timestamp,Content');
+
+    // 写入每条消息
+    for (final message in messages) {
+      final topic = _escapeCsvField(message['topic']?.toString() ?? 'unknown');
+      final partition = message['partition']?.toString() ?? '-1';
+      final offset = message['offset']?.toString() ?? '-1';
+      final key = _escapeCsvField(message['key']?.toString() ?? '');
+      final timestamp = message['timestamp']?.toString() ?? '0';
+      final content = _escapeCsvField(_fullContent(message, store));
+
+      sink.writeln('$topic,$partition,$offset,$key,$timestamp,$content');
+    }
+
+    await sink.flush();
+    await sink.close();
+  }
+
+  /// CSV字段转义：处理逗号、引号和换行符
+  String _escapeCsvField(String field) {
+    if (field.contains(',') || field.contains('"') || field.contains('\n') || field.contains('\r')) {
+      // 将双引号转义为两个双引号，并用双引号包围整个字段
+      return '"${field.replaceAll('"', '""')}"';
+    }
+    return field;
+  }
+
+  /// 保存为TXT格式
+  Future<void> _saveAsTxt(File file, List<Map<String, dynamic>> messages,
+      KafkaStoreHandle? store) async {
+    final sink = file.openWrite();
+
+    for (int i = 0; i < messages.length; i++) {
+      final message = messages[i];
+      sink.writeln('=== Message ${i + 1} ===');
+      sink.writeln('Topic: ${message['topic']}');
+      sink.writeln('Partition: ${message['partition']}');
+      sink.writeln('Offset: ${message['offset']}');
+      sink.writeln('Key: ${message['key']}');
+      sink.writeln('Timestamp: ${message['timestamp']}');
+      sink.writeln('Content:');
+      sink.writeln(_fullContent(message, store));
+      sink.writeln();
+    }
+
+    await sink.flush();
+    await sink.close();
+  }
+}
@@ -0,0 +1,202 @@
+// 客户端统计快照模型（librdkafka statistics，原生层解析）
+
+// broker连接统计
+class KafkaBrokerStats {
+  final String name;
+  final String state;
+  final int nodeId; // bootstrap和组协调者连接为-1
+  final int rttAvgUs;
+  final int rttP99Us;
+  final int internalLatencyAvgUs;
+  final int outbufCount; // 等待发送的请求数
+  final int waitRespCount; // 已发送、等待响应的请求数
+  final int tx;
+  final int txErrors;
+  final int rx;
+  final int rxBytes;
+  final int rxErrors;
+  final int requestTimeouts;
+  final int connects;
+  final int disconnects;
+
+  KafkaBrokerStats({
+    required this.name,
+    required this.state,
+    required this.nodeId,
+    required this.rttAvgUs,
+    required this.rttP99Us,
+    required this.internalLatencyAvgUs,
+    required this.outbufCount,
+    required this.waitRespCount,
+    required this.tx,
+    required this.txErrors,
+    required this.rx,
+    required this.rxBytes,
+    required this.rxErrors,
+    required this.requestTimeouts,
+    required this.connects,
+    required this.disconnects,
+  });
+
+  factory KafkaBrokerStats.fromMap(Map<String, dynamic> map) {
+    return KafkaBrokerStats(
+      name: map['name'],
+      state: map['state'],
+      nodeId: map['nodeId'],
+      rttAvgUs: map['rttAvgUs'],
+      rttP99Us: map['rttP99Us'],
+      internalLatencyAvgUs: map['internalLatencyAvgUs'],
+      outbufCount: map['outbufCount'],
+      waitRespCount: map['waitRespCount'],
+      tx: map['tx'],
+      txErrors: map['txErrors'],
+      rx: map['rx'],
+      rxBytes: map['rxBytes'],
+      rxErrors: map['rxErrors'],
+      requestTimeouts: map['requestTimeouts'],
+      connects: map['connects'],
+      disconnects: map['disconnects'],
+    );
+  }
+}
+
+// 分区统计（偏移量和lag未知时为-1）
+class KafkaPartitionStats {
+  final int partition;
+  final int leader;
+  final int msgqCount; // 生产者待发送的消息数
+  final int xmitMsgqCount;
+  final int fetchqCount; // 消费者预取队列中的消息数
+  final int appOffset;
+  final int committedOffset;
+  final int highOffset;
+  final int consumerLag;
+  final int txMsgs;
+  final int rxMsgs;
+
+  KafkaPartitionStats({
+    required this.partition,
+    required this.leader,
+    required this.msgqCount,
+    required this.xmitMsgqCount,
+    required this.fetchqCount,
+    required this.appOffset,
+    required this.committedOffset,
+    required this.highOffset,
+    required this.consumerLag,
+    required this.txMsgs,
+    required this.rxMsgs,
+  });
+
+  factory KafkaPartitionStats.fromMap(Map<String, dynamic> map) {
+    return KafkaPartitionStats(
+      partition: map['partition'],
+      leader: map['leader'],
+      msgqCount: map['msgqCount'],
+      xmitMsgqCount: map['xmitMsgqCount'],
+      fetchqCount: map['fetchqCount'],
+      appOffset: map['appOffset'],
+      committedOffset: map['committedOffset'],
+      highOffset: map['highOffset'],
+      consumerLag: map['consumerLag'],
+      txMsgs: map['txMsgs'],
+      rxMsgs: map['rxMsgs'],
+    );
+  }
+}
+
+// 主题统计
+class KafkaTopicStats {
+  final String topic;
+  final int batchSizeAvg; // 生产者平均批次字节数
+  final int batchCountAvg; // 生产者平均每批消息数
+  final int metadataAgeMs;
+  final List<KafkaPartitionStats> partitions;
+
+  KafkaTopicStats({
+    required this.topic,
+    required this.batchSizeAvg,
+    required this.batchCountAvg,
+    required this.metadataAgeMs,
+    required this.partitions,
+  });
+
+  factory KafkaTopicStats.fromMap(Map<String, dynamic> map) {
+    return KafkaTopicStats(
+      topic: map['topic'],
+      batchSizeAvg: map['batchSizeAvg'],
+      batchCountAvg: map['batchCountAvg'],
+      metadataAgeMs: map['metadataAgeMs'],
+      partitions: (map['partitions'] as List<Map<String, dynamic>>)
+          .map(KafkaPartitionStats.fromMap)
+          .toList(),
+    );
+  }
+}
+
+// 一个客户端某一时刻的统计快照
+class KafkaClientStats {
+  final String name;
+  final String type; // producer / consumer
+  final int time; // Unix秒
+  final int tsUs; // librdkafka单调时钟，两个快照之差就是间隔
+  final int replyq;
+  final int msgCount;
+  final int msgSize;
+  final int tx;
+  final int txBytes;
+  final int rx;
+  final int rxBytes;
+  final int txMsgs;
+  final int rxMsgs;
+  final String? groupState; // 消费者组状态，非消费者为null
+  final int rebalanceCount;
+  final List<KafkaBrokerStats> brokers;
+  final List<KafkaTopicStats> topics;
+
+  KafkaClientStats({
+    required this.name,
+    required this.type,
+    required this.time,
+    required this.tsUs,
+    required this.replyq,
+    required this.msgCount,
+    required this.msgSize,
+    required this.tx,
+    required this.txBytes,
+    required this.rx,
+    required this.rxBytes,
+    required this.txMsgs,
+    required this.rxMsgs,
+    required this.groupState,
+    required this.rebalanceCount,
+    required this.brokers,
+    required this.topics,
+  });
+
+  factory KafkaClientStats.fromMap(Map<String, dynamic> map) {
+    return KafkaClientStats(
+      name: map['name'],
+      type: map['type'],
+      time: map['time'],
+      tsUs: map['tsUs'],
+      replyq: map['replyq'],
+      msgCount: map['msgCount'],
+      msgSize: map['msgSize'],
+      tx: map['tx'],
+      txBytes: map['txBytes'],
+      rx: map['rx'],
+      rxBytes: map['rxBytes'],
+      txMsgs: map['txMsgs'],
+      rxMsgs: map['rxMsgs'],
+      groupState: map['groupState'],
+      rebalanceCount: map['rebalanceCount'],
+      brokers: (map['brokers'] as List<Map<String, dynamic>>)
+          .map(KafkaBrokerStats.fromMap)
+          .toList(),
+      topics: (map['topics'] as List<Map<String, dynamic>>)
+          .map(KafkaTopicStats.fromMap)
+          .toList(),
+    );
+  }
+}
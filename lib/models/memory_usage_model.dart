@@ -0,0 +1,59 @@
+// 原生内存占用模型（按存储、队列、缓存记账）
+
+// 一个内存账户
+class KafkaMemoryAccount {
+  final String kind; // store / consume_queue / autosave / metadata_cache / config_cache / librdkafka
+  final String name; // 所属客户端名称，消息存储为store-N
+  final int bytes;
+  final int peakBytes;
+
+  KafkaMemoryAccount({
+    required this.kind,
+    required this.name,
+    required this.bytes,
+    required this.peakBytes,
+  });
+
+  factory KafkaMemoryAccount.fromMap(Map<String, dynamic> map) {
+    return KafkaMemoryAccount(
+      kind: map['kind'],
+      name: map['name'],
+      bytes: map['bytes'],
+      peakBytes: map['peakBytes'],
+    );
+  }
+}
+
+// 某一时刻的内存占用明细
+class KafkaMemoryUsage {
+  final int totalBytes;
+  final int softLimitBytes; // 0表示不限制
+  final List<KafkaMemoryAccount> accounts;
+
+  KafkaMemoryUsage({
+    required this.totalBytes,
+    required this.softLimitBytes,
+    required this.accounts,
+  });
+
+  bool get overSoftLimit => softLimitBytes > 0 && totalBytes > softLimitBytes;
+
+  // 按类型汇总
+  Map<String, int> get bytesByKind {
+    final result = <String, int>{};
+    for (final account in accounts) {
+      result[account.kind] = (result[account.kind] ?? 0) + account.bytes;
+    }
+    return result;
+  }
+
+  factory KafkaMemoryUsage.fromMap(Map<String, dynamic> map) {
+    return KafkaMemoryUsage(
+      totalBytes: map['totalBytes'],
+      softLimitBytes: map['softLimitBytes'],
+      accounts: (map['accounts'] as List<Map<String, dynamic>>)
+          .map(KafkaMemoryAccount.fromMap)
+          .toList(),
+    );
+  }
+}
@@ -50,12 +50,48 @@ class KafkaConfigParam {
   final String value;
   final bool isDefault;
   final bool isReadOnly;
+  final bool isSensitive;
+  final String source; // 配置值来源（Topic、Broker、Default等）
 
   KafkaConfigParam({
     required this.name,
     required this.value,
     required this.isDefault,
     required this.isReadOnly,
+    this.isSensitive = false,
+    this.source = '',
+  });
+}
+
+// 主题配置摘要（主题列表显示保留时间和清理策略）
+class TopicConfigSummary {
+  final String cleanupPolicy;
+  final int retentionMs; // -1表示不限
+  final int retentionBytes; // -1表示不限
+
+  TopicConfigSummary({
+    required this.cleanupPolicy,
+    required this.retentionMs,
+    required this.retentionBytes,
+  });
+
+  bool get isCompacted => cleanupPolicy.contains('compact');
+}
+
+// 集群概览中的主题统计（主题列表显示）
+class TopicOverview {
+  final int partitions;
+  final int replicationFactor;
+  final int underReplicated; // ISR少于副本数的分区数
+  final int messages; // -1表示水位查询失败
+  final TopicConfigSummary? config; // 配置查询失败时为null
+
+  TopicOverview({
+    required this.partitions,
+    required this.replicationFactor,
+    required this.underReplicated,
+    required this.messages,
+    this.config,
   });
 }
 
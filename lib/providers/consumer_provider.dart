@@ -1,16 +1,20 @@
 import 'package:flutter/material.dart';
-import 'dart:convert';
+import 'package:flutter/scheduler.dart';
 import 'dart:developer' as developer;
 import 'dart:async';
-import 'dart:io';
+import 'dart:collection';
 import '../ffi/kafka_ffi.dart';
+import '../ffi/kafka_worker.dart';
 
 class ConsumerProvider extends ChangeNotifier {
   bool _isConnected = false;
   bool _isConsuming = false;
   final List<Map<String, dynamic>> _messages = [];
-  Timer? _consumeTimer;
-  KafkaClientHandle? _consumer;
+  // 消费者由后台工作isolate创建、使用和关闭，这里只记录是否已创建，统计也通过工作isolate读取
+  StreamSubscription<KafkaWorkerBatch>? _batchSubscription;
+  bool _consumerStarted = false;
+  // 上次清空后从工作isolate收到的行数；工作isolate保留同样的行用于导出，清空时让它丢弃这么多行
+  int _receivedRows = 0;
   String? _bootstrapServers;
   // 使用固定的消费者组ID，加上当前时间戳，确保每次运行时都使用不同的组ID，便于测试
   final String _consumerGroupId =
@@ -23,27 +27,82 @@ class ConsumerProvider extends ChangeNotifier {
   String _autoOffsetReset = 'latest'; // 'earliest', 'latest'
   int? _seekTimestamp; // 用于按时间戳重置偏移量
 
-  // 自动保存配置
+  // 后台消费循环：native线程轮询，工作isolate定时批量取走、编码后交给UI
+  static const int _ringCapacity = 10000;
+  static const int _drainBatchSize = 5000;
+  static const Duration _drainInterval = Duration(milliseconds: 100);
+  // 列表只保留每条消息的预览，完整内容留在native存储中按需获取
+  static const int _previewBytes = 4096;
+  static const int _storeMaxBytes = 512 * 1024 * 1024;
+  KafkaStoreHandle? _store;
+  // 背压：native队列积压到80%时暂停拉取，回落到50%恢复
+  static const int _ringHighPercent = 80;
+  static const int _ringLowPercent = 50;
+  int _pauseReasons = 0; // KafkaPauseReason位掩码
+  // 全量扫描模式：消费者使用scan配置档（大批量拉取，不提交偏移量）
+  bool _scanMode = false;
+  // 扫描速率：扫描模式消费期间按统计间隔通过工作isolate读取，只通知速率显示
+  static const Duration _scanRateInterval = Duration(seconds: 2);
+  final ValueNotifier<Map<String, dynamic>?> scanRate =
+      ValueNotifier<Map<String, dynamic>?>(null);
+  Timer? _scanRateTimer;
+
+  // 消息发布：drain定时器只把新消息放进暂存区，每帧最多发布一次（可设置更长的最小间隔），
+  // 发布时只更新messageCount，消息列表单独监听它，不触发整个页面重建
+  static const int _stagedMessagesLimit = 50000; // 长时间没有帧（窗口隐藏）时直接发布
+  final List<Map<String, dynamic>> _stagedMessages = [];
+  final ValueNotifier<int> messageCount = ValueNotifier<int>(0);
+  Duration _publishInterval = Duration.zero; // 0表示每帧发布
+  DateTime _lastPublish = DateTime.fromMillisecondsSinceEpoch(0);
+  Timer? _publishTimer;
+  int? _publishFrameCallbackId;
+
+  // 已渲染行的格式化结果（LRU，按partition:offset）
+  static const int _formattedCacheSize = 256;
+  final LinkedHashMap<String, Map<String, dynamic>> _formattedCache =
+      LinkedHashMap();
+  // 已展开显示完整内容的消息（partition:offset）
+  final Set<String> _expandedMessages = {};
+
+  // 自动保存配置（由native写入线程负责，按大小/时间轮转并后台压缩）
   bool _autoSaveEnabled = false;
   String? _autoSaveFilePath;
   String _autoSaveFormat = 'json'; // 'json', 'txt'
-  IOSink? _fileSink;
-  bool _isFirstMessage = true; // 用于JSON格式的数组处理
+  int _autoSaveRotateBytes = 256 * 1024 * 1024;
+  int _autoSaveRotateIntervalSeconds = 3600;
+  bool _autoSaveCompress = true;
+  bool _autoSaveActive = false;
+
+  // Schema Registry解码配置（Avro/Protobuf在native消费循环中并行解码为JSON）
+  String? _schemaRegistryUrl;
+  String? _schemaLocalDir;
 
   // Getters
   bool get isConsuming => _isConsuming;
+  int get pauseReasons => _pauseReasons;
+  bool get scanMode => _scanMode;
+  Duration get publishInterval => _publishInterval;
   List<Map<String, dynamic>> get messages => _messages;
   String get autoOffsetReset => _autoOffsetReset;
   int? get seekTimestamp => _seekTimestamp;
   bool get isConnected => _isConnected;
-  KafkaClientHandle? get consumer => _consumer;
   bool get autoSaveEnabled => _autoSaveEnabled;
   String? get autoSaveFilePath => _autoSaveFilePath;
   String get autoSaveFormat => _autoSaveFormat;
+  int get autoSaveRotateBytes => _autoSaveRotateBytes;
+  int get autoSaveRotateIntervalSeconds => _autoSaveRotateIntervalSeconds;
+  bool get autoSaveCompress => _autoSaveCompress;
+  String? get schemaRegistryUrl => _schemaRegistryUrl;
+  String? get schemaLocalDir => _schemaLocalDir;
 
   // 清空消息列表
   void clearMessages() {
-    _messages.clear();
+    _resetMessages();
+    _formattedCache.clear();
+    _expandedMessages.clear();
+    if (_store != null) {
+      KafkaFFI.clearStore(_store!);
+    }
     notifyListeners();
   }
 
@@ -68,6 +127,9 @@ class ConsumerProvider extends ChangeNotifier {
     required bool enabled,
     String? filePath,
     String? format,
+    int? rotateBytes,
+    int? rotateIntervalSeconds,
+    bool? compress,
   }) {
     _autoSaveEnabled = enabled;
     if (filePath != null) {
@@ -76,6 +138,15 @@ class ConsumerProvider extends ChangeNotifier {
     if (format != null) {
       _autoSaveFormat = format;
     }
+    if (rotateBytes != null) {
+      _autoSaveRotateBytes = rotateBytes;
+    }
+    if (rotateIntervalSeconds != null) {
+      _autoSaveRotateIntervalSeconds = rotateIntervalSeconds;
+    }
+    if (compress != null) {
+      _autoSaveCompress = compress;
+    }
     notifyListeners();
   }
 
@@ -87,121 +158,228 @@ class ConsumerProvider extends ChangeNotifier {
     notifyListeners();
   }
 
-  // 手动格式化JSON字符串
-  String _formatJsonString(String jsonStr) {
-    // 安全检查，确保输入不是空字符串
-    if (jsonStr.trim().isEmpty) {
-      return jsonStr;
+  // 设置Schema Registry配置，下次开始消费时生效；两者都为空时不解码
+  void setSchemaRegistryConfig({String? registryUrl, String? localDir}) {
+    _schemaRegistryUrl =
+        registryUrl != null && registryUrl.isNotEmpty ? registryUrl : null;
+    _schemaLocalDir = localDir != null && localDir.isNotEmpty ? localDir : null;
+    notifyListeners();
+  }
+
+  // 设置消息发布的最小间隔，Duration.zero表示每帧发布
+  void setPublishInterval(Duration interval) {
+    _publishInterval = interval.isNegative ? Duration.zero : interval;
+    notifyListeners();
+  }
+
+  // 安排一次发布：同一时间最多只有一个待执行的发布
+  void _schedulePublish() {
+    // 先检查暂存上限：窗口隐藏时帧回调一直不执行，已安排的发布不能挡住它
+    if (_stagedMessages.length >= _stagedMessagesLimit) {
+      _cancelPublish();
+      _publishStaged();
+      return;
     }
+    if (_publishTimer != null || _publishFrameCallbackId != null) {
+      return;
+    }
+    final wait = _publishInterval - DateTime.now().difference(_lastPublish);
+    if (wait > Duration.zero) {
+      _publishTimer = Timer(wait, () {
+        _publishTimer = null;
+        _schedulePublishFrame();
+      });
+    } else {
+      _schedulePublishFrame();
+    }
+  }
 
-    try {
-      const indent = '  ';
-      int level = 0;
-      final result = StringBuffer();
-      bool inString = false;
-      bool escapeNext = false;
-
-      for (int i = 0; i < jsonStr.length; i++) {
-        final char = jsonStr[i];
-
-        if (escapeNext) {
-          result.write(char);
-          escapeNext = false;
-          continue;
-        }
+  void _schedulePublishFrame() {
+    _publishFrameCallbackId =
+        SchedulerBinding.instance.scheduleFrameCallback((_) {
+      _publishFrameCallbackId = null;
+      _publishStaged();
+    });
+  }
 
-        if (char == '\\') {
-          escapeNext = true;
-          result.write(char);
-          continue;
-        }
+  // 把暂存区的消息追加到列表末尾，只通知消息列表
+  void _publishStaged() {
+    if (_stagedMessages.isEmpty) {
+      return;
+    }
+    _messages.addAll(_stagedMessages);
+    _stagedMessages.clear();
+    _lastPublish = DateTime.now();
+    messageCount.value = _messages.length;
+  }
 
-        if (char == '"') {
-          inString = !inString;
-          result.write(char);
-          continue;
-        }
+  // 取消待执行的发布
+  void _cancelPublish() {
+    _publishTimer?.cancel();
+    _publishTimer = null;
+    if (_publishFrameCallbackId != null) {
+      SchedulerBinding.instance
+          .cancelFrameCallbackWithId(_publishFrameCallbackId!);
+      _publishFrameCallbackId = null;
+    }
+  }
 
-        if (!inString) {
-          switch (char) {
-            case '{':
-            case '[':
-              result.write(char);
-              level++;
-              result.write('\n');
-              result.write(indent * level);
-              break;
-            case '}':
-            case ']':
-              // 确保level不会为负，避免IndexError
-              if (level > 0) {
-                level--;
-              }
-              result.write('\n');
-              result.write(indent * level);
-              result.write(char);
-              break;
-            case ',':
-              result.write(char);
-              result.write('\n');
-              result.write(indent * level);
-              break;
-            case ':':
-              result.write(' ');
-              result.write(char);
-              result.write(' ');
-              break;
-            case ' ':
-            case '\t':
-            case '\n':
-            case '\r':
-              break;
-            default:
-              result.write(char);
-          }
-        } else {
-          result.write(char);
+  // 清空消息列表和暂存区
+  void _resetMessages() {
+    _cancelPublish();
+    _stagedMessages.clear();
+    _messages.clear();
+    messageCount.value = 0;
+    final received = _receivedRows;
+    _receivedRows = 0;
+    if (received > 0) {
+      KafkaWorker.instance
+          .then((worker) => worker.discardRows(received))
+          .catchError((Object e) {
+        developer.log('Failed to discard worker rows: $e');
+      });
+    }
+  }
+
+  // 设置全量扫描模式，下次开始消费时生效
+  void setScanMode(bool enabled) {
+    _scanMode = enabled;
+    notifyListeners();
+  }
+
+  // 读取当前消费者的扫描速率，消费者未创建或统计快照不足时返回null
+  Future<Map<String, dynamic>?> readScanRate() async {
+    if (!_consumerStarted) {
+      return null;
+    }
+    return (await KafkaWorker.instance).scanRate();
+  }
+
+  // 扫描模式下定时读取扫描速率，统计快照不足时保留上一次的结果
+  void _startScanRatePolling() {
+    _stopScanRatePolling();
+    if (!_scanMode) {
+      return;
+    }
+    _scanRateTimer = Timer.periodic(_scanRateInterval, (timer) async {
+      try {
+        final rate = await readScanRate();
+        // 读取期间已停止
+        if (_scanRateTimer != timer || rate == null) {
+          return;
         }
+        scanRate.value = rate;
+      } catch (e) {
+        developer.log('Failed to read scan rate: $e');
       }
+    });
+  }
+
+  void _stopScanRatePolling() {
+    _scanRateTimer?.cancel();
+    _scanRateTimer = null;
+    scanRate.value = null;
+  }
+
+  // 读取当前消费者在sinceTsUs之后的统计快照，消费者未创建时返回null
+  Future<List<Map<String, dynamic>>?> readClientStats({int sinceTsUs = 0}) async {
+    if (!_consumerStarted) {
+      return null;
+    }
+    return (await KafkaWorker.instance).consumerStats(sinceTsUs: sinceTsUs);
+  }
+
+  String _messageKey(Map<String, dynamic> message) =>
+      '${message['partition']}:${message['offset']}';
+
+  // 消息是否只有预览
+  bool isTruncated(Map<String, dynamic> message) =>
+      message['truncated'] as bool? ?? false;
+
+  // 消息是否已展开
+  bool isExpanded(Map<String, dynamic> message) =>
+      _expandedMessages.contains(_messageKey(message));
+
+  // 展开/收起完整内容
+  void toggleExpanded(Map<String, dynamic> message) {
+    final key = _messageKey(message);
+    if (!_expandedMessages.remove(key)) {
+      _expandedMessages.add(key);
+    }
+    notifyListeners();
+  }
+
+  // 消息类型（KafkaPayloadType）
+  int payloadTypeOf(Map<String, dynamic> message) =>
+      message['payloadType'] as int? ?? KafkaPayloadType.text;
 
-      return result.toString();
+  // 获取完整消息内容，被截断的消息从native存储中获取（已淘汰时退回预览）
+  String fullContentFor(Map<String, dynamic> message) {
+    final content = message['content'] as String? ?? '';
+    if (!isTruncated(message) || _store == null) {
+      return content;
+    }
+
+    try {
+      return KafkaFFI.fetchPayload(_store!, message['partition'] as int,
+              message['offset'] as int,
+              payloadType: payloadTypeOf(message)) ??
+          content;
     } catch (e, stackTrace) {
-      developer.log('Error formatting JSON string: $e', stackTrace: stackTrace);
-      // 如果格式化失败，返回原始字符串
-      return jsonStr;
+      developer.log('Error fetching full payload: $e', stackTrace: stackTrace);
+      return content;
+    }
+  }
+
+  // 复制时使用完整内容
+  String copyTextFor(Map<String, dynamic> message) {
+    if (!isTruncated(message) || isExpanded(message)) {
+      return formattedContentFor(message)['formattedContent'] as String;
+    }
+    return processMessageContent(
+            fullContentFor(message), payloadTypeOf(message))['formattedContent']
+        as String;
+  }
+
+  // 获取消息的展示内容（只在行真正被渲染时调用，结果按partition/offset缓存）
+  Map<String, dynamic> formattedContentFor(Map<String, dynamic> message) {
+    final expanded = isTruncated(message) && isExpanded(message);
+    final cacheKey = '${_messageKey(message)}:${expanded ? 'full' : 'preview'}';
+    final cached = _formattedCache.remove(cacheKey);
+    if (cached != null) {
+      // 重新插入，移到最近使用的位置
+      _formattedCache[cacheKey] = cached;
+      return cached;
     }
+
+    final content = expanded
+        ? fullContentFor(message)
+        : message['content'] as String? ?? '';
+    final processed = processMessageContent(content, payloadTypeOf(message));
+    _formattedCache[cacheKey] = processed;
+    if (_formattedCache.length > _formattedCacheSize) {
+      _formattedCache.remove(_formattedCache.keys.first);
+    }
+    return processed;
   }
 
-  // 格式化JSON内容
-  Map<String, dynamic> processMessageContent(String content) {
-    bool isJson = false;
-    String formattedContent = content;
+  // 格式化JSON内容（消息类型由native消费线程识别，这里不再检查内容）
+  // Avro/Protobuf消息已在native侧解码为JSON，同样格式化
+  Map<String, dynamic> processMessageContent(String content, int payloadType) {
+    if (!KafkaPayloadType.isJson(payloadType)) {
+      return {'isJson': false, 'formattedContent': content};
+    }
 
     try {
-      final trimmedContent = content.trim();
-      if (trimmedContent.isNotEmpty &&
-          (trimmedContent.startsWith('{') || trimmedContent.startsWith('['))) {
-        try {
-          final decodedJson = jsonDecode(trimmedContent);
-          isJson = true;
-          formattedContent =
-              jsonEncode(decodedJson, toEncodable: (nonEncodable) {
-            return nonEncodable.toString();
-          });
-          formattedContent = _formatJsonString(formattedContent);
-        } catch (jsonError) {
-          isJson = false;
-          // 保留原始内容
-        }
+      final formatted = KafkaFFI.formatJson(content);
+      if (formatted != null) {
+        return {'isJson': true, 'formattedContent': formatted};
       }
     } catch (e, stackTrace) {
       developer.log('Error processing message content: $e',
           stackTrace: stackTrace);
-      isJson = false;
-      formattedContent = content;
     }
-
-    return {'isJson': isJson, 'formattedContent': formattedContent};
+    return {'isJson': false, 'formattedContent': content};
   }
 
   Future<void> connect(String bootstrapServers) async {
@@ -218,7 +396,7 @@ class ConsumerProvider extends ChangeNotifier {
           stackTrace: stackTrace);
       _isConnected = false;
       _bootstrapServers = null;
-      _consumer = null;
+      _consumerStarted = false;
       throw Exception('Failed to connect consumer to Kafka: $e');
     }
   }
@@ -232,118 +410,98 @@ class ConsumerProvider extends ChangeNotifier {
       developer.log('Starting to consume messages from topic $topic via FFI');
 
       // 1. 清理之前的状态
-      _messages.clear();
+      _resetMessages();
+      _formattedCache.clear();
+      _expandedMessages.clear();
+      if (_store != null) {
+        KafkaFFI.clearStore(_store!);
+      }
       _isConsuming = true;
       notifyListeners(); // 立即通知UI状态更新
-      _consumeTimer?.cancel();
+      await _batchSubscription?.cancel();
+      _batchSubscription = null;
 
-      // 2. 创建或重置消费者实例
-      if (_consumer != null) {
-        developer.log('Closing existing consumer: $_consumer');
-        KafkaFFI.closeClient(_consumer!);
-        _consumer = null;
-      }
+      // 2. 在工作isolate中创建消费者、订阅主题、按时间戳重置偏移量、启动自动保存和消费循环
+      //    （超长消息的完整内容留在native存储中）
+      final worker = await KafkaWorker.instance;
+      _consumerStarted = false;
 
       developer.log('Creating consumer with config:');
       developer.log('  bootstrapServers: $_bootstrapServers');
       developer.log('  consumerGroupId: $_consumerGroupId');
       developer.log('  autoOffsetReset: $_autoOffsetReset');
+      developer.log('  scanMode: $_scanMode');
+      developer.log('  seekTimestamp: $_seekTimestamp');
       developer
           .log('  current timestamp: ${DateTime.now().millisecondsSinceEpoch}');
 
-      _consumer = KafkaFFI.createConsumerWithConfig(
-          _bootstrapServers!, _consumerGroupId, _autoOffsetReset);
-
-      if (_consumer == null) {
-        throw Exception('Failed to create consumer: returned null handle');
-      }
-
-      developer.log('Successfully created consumer with handle: $_consumer');
-
-      // 3. 订阅主题
-      developer.log('Subscribing to topic: $topic');
-      KafkaFFI.subscribeTopic(_consumer!, topic);
-      developer.log('Successfully subscribed to topic $topic');
-
-      // 4. 如果设置了时间戳，按时间戳重置偏移量
-      if (_seekTimestamp != null) {
-        developer.log('Seeking to timestamp: $_seekTimestamp');
-        KafkaFFI.seekToTimestamp(_consumer!, topic, _seekTimestamp!);
-        developer.log('Successfully seeked to timestamp: $_seekTimestamp');
-      }
-
-      // 5. 初始化自动保存文件
-      if (_autoSaveEnabled && _autoSaveFilePath != null) {
-        await _initAutoSaveFile();
+      _store ??= KafkaFFI.createStore(_storeMaxBytes);
+      final autoSave = _autoSaveEnabled && _autoSaveFilePath != null
+          ? {
+              'filePath': _autoSaveFilePath,
+              'format': _autoSaveFormat,
+              'rotateBytes': _autoSaveRotateBytes,
+              'rotateIntervalSeconds': _autoSaveRotateIntervalSeconds,
+              'compress': _autoSaveCompress,
+            }
+          : null;
+      _autoSaveActive = await worker.startConsumer(
+        bootstrapServers: _bootstrapServers!,
+        groupId: _consumerGroupId,
+        autoOffsetReset: _autoOffsetReset,
+        topic: topic,
+        store: _store!,
+        scanMode: _scanMode,
+        seekTimestamp: _seekTimestamp,
+        schemaRegistryUrl: _schemaRegistryUrl,
+        schemaLocalDir: _schemaLocalDir,
+        ringCapacity: _ringCapacity,
+        ringHighPercent: _ringHighPercent,
+        ringLowPercent: _ringLowPercent,
+        drainBatchSize: _drainBatchSize,
+        drainInterval: _drainInterval,
+        previewBytes: _previewBytes,
+        autoSave: autoSave,
+      );
+      _consumerStarted = true;
+      _startScanRatePolling();
+      if (autoSave != null) {
+        developer.log(_autoSaveActive
+            ? 'Started auto-save: $_autoSaveFilePath, format: $_autoSaveFormat'
+            : 'Failed to start auto-save: $_autoSaveFilePath');
       }
+      developer.log('Successfully created consumer in worker isolate');
 
-      // 6. 开始轮询消息
-      developer.log('Starting message polling timer');
-      _consumeTimer =
-          Timer.periodic(const Duration(milliseconds: 300), (timer) {
-        if (!_isConsuming || _consumer == null) {
-          developer.log('Stopping timer because consumer is no longer active');
-          timer.cancel();
+      // 3. 接收工作isolate发来的消息批次
+      _pauseReasons = 0;
+      _batchSubscription = worker.batches.listen((batch) {
+        _receivedRows += batch.messages.length;
+        if (!_isConsuming) {
           return;
         }
-
-        try {
-          developer.log(
-              'Polling for messages with consumer: $_consumer, timeout: 100ms');
-          final message = KafkaFFI.consumeMessage(_consumer!, 100);
-
-          if (message != null) {
-            // 添加类型检查，确保所有字段都存在且类型正确
-            final String topic = message['topic'] as String? ?? 'unknown';
-            final int partition = message['partition'] as int? ?? -1;
-            final int offset = message['offset'] as int? ?? -1;
-            final String content = message['content'] as String? ?? '';
-            final dynamic key = message['key'];
-            final int timestamp = message['timestamp'] as int? ??
-                DateTime.now().millisecondsSinceEpoch;
-
-            // 安全处理key，确保它是字符串
-            final String safeKey = key != null ? key.toString() : '';
-
-            final processedContent = processMessageContent(content);
-
-            developer.log(
-                'Processing message: $topic:$partition:$offset, key: $safeKey, content: $content');
-
-            // 直接更新消息列表，确保UI立即刷新
-            _messages.add({
-              'topic': topic,
-              'partition': partition,
-              'offset': offset,
-              'content': content,
-              'key': safeKey,
-              'timestamp': timestamp,
-              'isJson': processedContent['isJson'],
-              'formattedContent': processedContent['formattedContent']
-            });
-
-            // 如果启用了自动保存，实时写入文件
-            if (_autoSaveEnabled && _fileSink != null) {
-              _writeMessageToFile(content);
-            }
-
-            developer.log(
-                'Added message to list, current message count: ${_messages.length}');
-            // 立即通知UI更新，不使用addPostFrameCallback以避免延迟
+        if (batch.pauseReasons != _pauseReasons) {
+          developer.log('Consume pause state changed: ${batch.pauseReasons}');
+          _pauseReasons = batch.pauseReasons;
+          if (batch.messages.isEmpty) {
             notifyListeners();
-          } else {
-            developer.log('No message received in this poll');
           }
-        } catch (e, stackTrace) {
-          developer.log('Error during message polling: $e',
-              stackTrace: stackTrace);
-          // 如果发生错误，取消定时器，避免无限循环报错
-          timer.cancel();
-          _consumeTimer = null;
-          _isConsuming = false;
-          // 立即通知UI更新
-          notifyListeners();
         }
+        if (batch.messages.isEmpty) {
+          return;
+        }
+        _stagedMessages.addAll(batch.messages);
+        // 等到下一帧再发布，期间到达的批次合并成一次更新
+        _schedulePublish();
+      }, onError: (Object e, StackTrace stackTrace) {
+        developer.log('Error during message polling: $e',
+            stackTrace: stackTrace);
+        // 工作isolate已停止取消息，避免无限循环报错
+        _batchSubscription?.cancel();
+        _batchSubscription = null;
+        _stopScanRatePolling();
+        _isConsuming = false;
+        // 立即通知UI更新
+        notifyListeners();
       });
 
       developer.log('Successfully started message consumption');
@@ -351,17 +509,11 @@ class ConsumerProvider extends ChangeNotifier {
     } catch (e, stackTrace) {
       developer.log('Failed to consume messages: $e', stackTrace: stackTrace);
       _isConsuming = false;
-      _consumeTimer?.cancel();
-      _consumeTimer = null;
-
-      if (_consumer != null) {
-        try {
-          KafkaFFI.closeClient(_consumer!);
-        } catch (closeError) {
-          developer.log('Error closing consumer: $closeError');
-        }
-        _consumer = null;
-      }
+      await _batchSubscription?.cancel();
+      _batchSubscription = null;
+      _stopScanRatePolling();
+      _consumerStarted = false;
+      _autoSaveActive = false;
 
       notifyListeners();
       throw Exception('Failed to consume messages: $e');
@@ -371,26 +523,37 @@ class ConsumerProvider extends ChangeNotifier {
   Future<void> stopConsuming() async {
     try {
       developer.log('Stopping message consumption');
-      _consumeTimer?.cancel();
-
-      // 关闭自动保存文件
-      await _closeAutoSaveFile();
-
-      if (_consumer != null) {
-        KafkaFFI.closeClient(_consumer!);
-        _consumer = null;
+      await _batchSubscription?.cancel();
+      _batchSubscription = null;
+      // 已取到的消息直接发布，不再等下一帧
+      _cancelPublish();
+      _publishStaged();
+      _stopScanRatePolling();
+
+      // 停止自动保存（等待剩余数据落盘）并关闭消费者
+      // 先清除标记再请求关闭，关闭期间不再发出统计请求
+      if (_consumerStarted) {
+        _consumerStarted = false;
+        await (await KafkaWorker.instance).stopConsumer();
+        if (_autoSaveActive) {
+          developer.log('Stopped auto-save: $_autoSaveFilePath');
+        }
         developer.log('Successfully closed Kafka consumer');
       }
+      _autoSaveActive = false;
 
       _isConsuming = false;
+      _pauseReasons = 0;
       developer.log('Successfully stopped message consumption');
       notifyListeners();
     } catch (e, stackTrace) {
       developer.log('Failed to stop consuming: $e', stackTrace: stackTrace);
-      _consumeTimer?.cancel();
+      _batchSubscription?.cancel();
+      _batchSubscription = null;
+      _stopScanRatePolling();
       _isConsuming = false;
-      _consumer = null;
-      await _closeAutoSaveFile();
+      _consumerStarted = false;
+      _autoSaveActive = false;
       notifyListeners();
       throw Exception('Failed to stop consuming: $e');
     }
@@ -400,45 +563,64 @@ class ConsumerProvider extends ChangeNotifier {
     try {
       developer.log('Disconnecting consumer from Kafka');
 
-      if (_isConsuming) {
+      if (_isConsuming || _consumerStarted) {
         await stopConsuming();
       }
 
-      if (_consumer != null) {
-        KafkaFFI.closeClient(_consumer!);
-        _consumer = null;
-      }
-
-      _consumeTimer?.cancel();
       _isConnected = false;
       _bootstrapServers = null;
-      _messages.clear();
+      _resetMessages();
+      _destroyStore();
       developer.log('Successfully disconnected consumer from Kafka');
       notifyListeners();
     } catch (e, stackTrace) {
       developer.log('Failed to disconnect consumer: $e',
           stackTrace: stackTrace);
 
-      try {
-        if (_consumer != null) {
-          KafkaFFI.closeClient(_consumer!);
-          _consumer = null;
-        }
-      } catch (closeError) {
-        developer.log('Error closing FFI consumer: $closeError');
-      }
-
-      _consumeTimer?.cancel();
+      _batchSubscription?.cancel();
+      _batchSubscription = null;
+      _consumerStarted = false;
       _isConnected = false;
       _isConsuming = false;
       _bootstrapServers = null;
-      _messages.clear();
+      _resetMessages();
+      _destroyStore();
       notifyListeners();
       throw Exception('Failed to disconnect consumer: $e');
     }
   }
 
-  /// 保存消息到文件
+  // 释放消息存储
+  void _destroyStore() {
+    _formattedCache.clear();
+    _expandedMessages.clear();
+    if (_store != null) {
+      KafkaFFI.destroyStore(_store!);
+      _store = null;
+    }
+  }
+
+  @override
+  void dispose() {
+    _batchSubscription?.cancel();
+    _cancelPublish();
+    _scanRateTimer?.cancel();
+    _scanRateTimer = null;
+    messageCount.dispose();
+    scanRate.dispose();
+    if (_consumerStarted) {
+      // 先关闭消费者再释放存储，消费循环还在往存储里写
+      _consumerStarted = false;
+      KafkaWorker.instance
+          .then((worker) => worker.stopConsumer())
+          .whenComplete(_destroyStore);
+    } else {
+      _destroyStore();
+    }
+    super.dispose();
+  }
+
+  /// 保存消息到文件（工作isolate保留了发给UI的行，这里只传行数，格式化和写入都在工作isolate中完成）
   /// format: json, csv, txt
   /// filePath: 文件保存路径
   Future<void> saveMessagesToFile(String format, String filePath) async {
@@ -446,22 +628,10 @@ class ConsumerProvider extends ChangeNotifier {
       throw Exception('No messages to save');
     }
 
-    final file = File(filePath);
-
     try {
-      switch (format) {
-        case 'json':
-          await _saveAsJson(file);
-          break;
-        case 'csv':
-          await _saveAsCsv(file);
-          break;
-        case 'txt':
-          await _saveAsTxt(file);
-          break;
-        default:
-          throw Exception('Unsupported file format: $format');
-      }
+      final worker = await KafkaWorker.instance;
+      await worker.exportRows(_messages.length, format, filePath,
+          store: _store);
       developer
           .log('Successfully saved ${_messages.length} messages to $filePath');
     } catch (e, stackTrace) {
@@ -470,154 +640,4 @@ class ConsumerProvider extends ChangeNotifier {
       throw Exception('Failed to save messages: $e');
     }
   }
-
-  /// 保存为JSON格式
-  Future<void> _saveAsJson(File file) async {
-    // 创建包含所有消息的JSON数组
-    final jsonArray = jsonEncode(_messages);
-    await file.writeAsString(jsonArray);
-  }
-
-  /// 保存为CSV格式
-  Future<void> _saveAsCsv(File file) async {
-    final sink = file.openWrite();
-
-    // 写入CSV头
-    sink.writeln('Topic,Partition,Offset,Key,Timestamp,Content');
-
-    // 写入每条消息
-    for (final message in _messages) {
-      final topic = _escapeCsvField(message['topic']?.toString() ?? 'unknown');
-      final partition = message['partition']?.toString() ?? '-1';
-      final offset = message['offset']?.toString() ?? '-1';
-      final key = _escapeCsvField(message['key']?.toString() ?? '');
-      final timestamp = message['timestamp']?.toString() ?? '0';
-      final content = _escapeCsvField(message['content']?.toString() ?? '');
-
-      sink.writeln('$topic,$partition,$offset,$key,$timestamp,$content');
-    }
-
-    await sink.flush();
-    await sink.close();
-  }
-
-  /// CSV字段转义：处理逗号、引号和换行符
-  String _escapeCsvField(String field) {
-    if (field.contains(',') || field.contains('"') || field.contains('\n') || field.contains('\r')) {
-      // 将双引号转义为两个双引号，并用双引号包围整个字段
-      return '"${field.replaceAll('"', '""')}"';
-    }
-    return field;
-  }
-
-  /// 保存为TXT格式
-  Future<void> _saveAsTxt(File file) async {
-    final sink = file.openWrite();
-
-    for (int i = 0; i < _messages.length; i++) {
-      final message = _messages[i];
-      sink.writeln('=== Message ${i + 1} ===');
-      sink.writeln('Topic: ${message['topic']}');
-      sink.writeln('Partition: ${message['partition']}');
-      sink.writeln('Offset: ${message['offset']}');
-      sink.writeln('Key: ${message['key']}');
-      sink.writeln('Timestamp: ${message['timestamp']}');
-      sink.writeln('Content:');
-      sink.writeln(message['content']);
-      sink.writeln();
-    }
-
-    await sink.flush();
-    await sink.close();
-  }
-
-  // ============ 自动保存相关方法 ============
-
-  /// 初始化自动保存文件
-  Future<void> _initAutoSaveFile() async {
-    if (_autoSaveFilePath == null) return;
-
-    try {
-      final file = File(_autoSaveFilePath!);
-      _fileSink = file.openWrite();
-      _isFirstMessage = true;
-
-      // 根据格式写入文件头
-      switch (_autoSaveFormat) {
-        case 'json':
-          _fileSink!.write('[');
-          break;
-        case 'csv':
-          _fileSink!.writeln('Message');
-          break;
-        case 'txt':
-          // TXT 不需要文件头
-          break;
-      }
-
-      developer.log('Initialized auto-save file: $_autoSaveFilePath, format: $_autoSaveFormat');
-    } catch (e, stackTrace) {
-      developer.log('Failed to initialize auto-save file: $e', stackTrace: stackTrace);
-      _fileSink = null;
-    }
-  }
-
-  /// 实时写入消息到文件（只保存消息内容）
-  void _writeMessageToFile(String content) {
-    if (_fileSink == null) return;
-
-    try {
-      switch (_autoSaveFormat) {
-        case 'json':
-          // JSON格式：每条消息作为数组元素
-          if (!_isFirstMessage) {
-            _fileSink!.write(',\n');
-          }
-          // 尝试解析并重新编码以确保格式正确
-          try {
-            final decoded = jsonDecode(content);
-            _fileSink!.write(jsonEncode(decoded));
-          } catch (_) {
-            // 如果不是有效JSON，作为字符串保存
-            _fileSink!.write(jsonEncode(content));
-          }
-          _isFirstMessage = false;
-          break;
-        case 'csv':
-          // CSV格式：每行一条消息，转义特殊字符
-          _fileSink!.writeln(_escapeCsvField(content));
-          break;
-        case 'txt':
-          // TXT格式：每行一条消息
-          _fileSink!.writeln(content);
-          break;
-        default:
-          _fileSink!.writeln(content);
-      }
-    } catch (e, stackTrace) {
-      developer.log('Failed to write message to file: $e', stackTrace: stackTrace);
-    }
-  }
-
-  /// 关闭自动保存文件
-  Future<void> _closeAutoSaveFile() async {
-    if (_fileSink == null) return;
-
-    try {
-      // 根据格式写入文件尾
-      if (_autoSaveFormat == 'json') {
-        _fileSink!.write('\n]');
-      }
-
-      await _fileSink!.flush();
-      await _fileSink!.close();
-      _fileSink = null;
-      _isFirstMessage = true;
-
-      developer.log('Closed auto-save file: $_autoSaveFilePath');
-    } catch (e, stackTrace) {
-      developer.log('Failed to close auto-save file: $e', stackTrace: stackTrace);
-      _fileSink = null;
-    }
-  }
 }
@@ -1,10 +1,15 @@
 import 'package:flutter/material.dart';
 import 'dart:developer' as developer;
+import 'dart:async';
+import 'dart:typed_data';
 import 'package:shared_preferences/shared_preferences.dart';
 import './producer_provider.dart';
 import './consumer_provider.dart';
+import './topic_browser_provider.dart';
 import '../ffi/kafka_ffi.dart';
 import '../models/topic_model.dart';
+import '../models/client_stats_model.dart';
+import '../models/memory_usage_model.dart';
 
 class KafkaConnection {
   final String name;
@@ -32,6 +37,14 @@ class KafkaConnection {
   }
 }
 
+// 预热池中的一个集群：持有一个共享管理客户端引用，空闲超时后释放
+class _WarmClient {
+  final KafkaClientHandle client;
+  Timer? idleTimer;
+
+  _WarmClient(this.client);
+}
+
 class KafkaProvider extends ChangeNotifier {
   bool _isConnected = false;
   List<String> _topics = [
@@ -46,21 +59,57 @@ class KafkaProvider extends ChangeNotifier {
   ];
   List<KafkaConnection> _savedConnections = [];
   KafkaConnection? _currentConnection;
-  KafkaClientHandle? _tempClient;
+  // 当前集群的共享管理客户端（元数据和Admin API查询都复用这个连接）
+  KafkaClientHandle? _adminClient;
+  // 使用管理客户端的异步查询，释放客户端时一并取消
+  KafkaCancelToken _adminRequests = KafkaCancelToken();
+
+  // 预热池（可选）：启动时在后台为最近使用的已保存连接建立共享管理客户端并缓存元数据，
+  // 连接这些集群时直接复用已就绪的客户端；不在使用中的客户端空闲超时后释放
+  bool _warmPoolEnabled = false;
+  List<String> _recentServers = []; // 最近成功连接的集群地址，最近的在前
+  final Map<String, _WarmClient> _warmClients = {};
+  final Set<String> _warming = {};
+  KafkaCancelToken _warmRequests = KafkaCancelToken();
+  Timer? _warmRefreshTimer;
+  static const int _warmPoolSize = 3;
+  static const int _recentLimit = 20;
+  static const Duration _warmIdleTimeout = Duration(minutes: 10);
+  static const Duration _warmRefreshInterval = Duration(seconds: 30);
+
+  // 原生内存软上限（MB，0表示不限制），超过时消息存储淘汰旧内容、消费者暂停拉取
+  int _memorySoftLimitMb = 0;
 
   // 存储主题详情的映射
   Map<String, TopicInfo> _topicDetails = {};
   Map<String, List<KafkaPartitionInfo>> _topicPartitions = {};
   Map<String, List<KafkaConfigParam>> _topicConfigs = {};
+  Map<String, TopicOverview> _topicOverviews = {};
+
+  // 原生主题索引（排序列表和子串搜索），_topics与索引中的顺序一致
+  KafkaTopicIndexHandle? _topicIndex;
+  String _topicQuery = '';
+  Int32List? _topicMatches; // 搜索结果在_topics中的下标，没有搜索时为null
+  // 进行中的索引刷新数：原生索引在刷新时就切换到新列表，_topics要等结果回到Dart才合并，
+  // 期间索引给出的下标对不上_topics
+  int _topicIndexRefreshes = 0;
   Map<String, List<KafkaConsumerGroup>> _topicConsumerGroups = {};
 
   // 加载状态
   bool _isLoadingTopicDetails = false;
   String? _loadingTopic;
 
+  // 集群主题概览（原生层后台分块统计，定时取回已完成的行）
+  KafkaOverviewHandle? _overviewHandle;
+  Timer? _overviewTimer;
+  int _overviewTopicCount = 0;
+  static const Duration _overviewDrainInterval = Duration(milliseconds: 100);
+  static const int _overviewDrainRows = 2000;
+
   // 子Provider
   final ProducerProvider _producerProvider = ProducerProvider();
   final ConsumerProvider _consumerProvider = ConsumerProvider();
+  final TopicBrowserProvider _browserProvider = TopicBrowserProvider();
 
   // 构造函数
   KafkaProvider() {
@@ -71,18 +120,31 @@ class KafkaProvider extends ChangeNotifier {
     _consumerProvider.addListener(() {
       notifyListeners();
     });
+    _browserProvider.addListener(() {
+      notifyListeners();
+    });
   }
 
   // Getters
   List<KafkaConnection> get savedConnections => _savedConnections;
   KafkaConnection? get currentConnection => _currentConnection;
   bool get isConnected => _isConnected;
+  bool get warmPoolEnabled => _warmPoolEnabled;
+  int get memorySoftLimitMb => _memorySoftLimitMb;
   List<String> get topics => _topics;
   ProducerProvider get producerProvider => _producerProvider;
   ConsumerProvider get consumerProvider => _consumerProvider;
+  TopicBrowserProvider get browserProvider => _browserProvider;
   Map<String, TopicInfo> get topicDetails => _topicDetails;
   Map<String, List<KafkaPartitionInfo>> get topicPartitions => _topicPartitions;
   Map<String, List<KafkaConfigParam>> get topicConfigs => _topicConfigs;
+  Map<String, TopicOverview> get topicOverviews => _topicOverviews;
+  String get topicQuery => _topicQuery;
+  int get visibleTopicCount => _topicMatches?.length ?? _topics.length;
+  String visibleTopicAt(int index) =>
+      _topics[_topicMatches == null ? index : _topicMatches![index]];
+  int get overviewTopicCount => _overviewTopicCount;
+  bool get isLoadingOverview => _overviewHandle != null;
   Map<String, List<KafkaConsumerGroup>> get topicConsumerGroups =>
       _topicConsumerGroups;
   bool get isLoadingTopicDetails => _isLoadingTopicDetails;
@@ -102,14 +164,65 @@ class KafkaProvider extends ChangeNotifier {
           });
         }).toList();
       }
+      _recentServers = prefs.getStringList('kafka_recent_connections') ?? [];
+      _warmPoolEnabled = prefs.getBool('kafka_warm_pool') ?? false;
+      _memorySoftLimitMb = prefs.getInt('kafka_memory_soft_limit_mb') ?? 0;
+      KafkaFFI.setMemorySoftLimit(_memorySoftLimitMb * 1024 * 1024);
 
       notifyListeners();
+
+      if (_warmPoolEnabled) {
+        _warmRecentConnections();
+      }
     } catch (e, stackTrace) {
       developer.log('Failed to load saved connections: $e',
           stackTrace: stackTrace);
     }
   }
 
+  /// 开启或关闭连接预热池
+  Future<void> setWarmPoolEnabled(bool enabled) async {
+    _warmPoolEnabled = enabled;
+    if (enabled) {
+      final current = _currentConnection?.bootstrapServers;
+      if (current != null && _adminClient != null) {
+        _keepWarm(current);
+      }
+      _warmRecentConnections();
+    } else {
+      _clearWarmPool();
+    }
+    notifyListeners();
+
+    try {
+      final prefs = await SharedPreferences.getInstance();
+      await prefs.setBool('kafka_warm_pool', enabled);
+    } catch (e, stackTrace) {
+      developer.log('Failed to save warm pool setting: $e',
+          stackTrace: stackTrace);
+    }
+  }
+
+  /// 设置原生内存软上限（MB，0表示不限制）
+  Future<void> setMemorySoftLimitMb(int megabytes) async {
+    _memorySoftLimitMb = megabytes > 0 ? megabytes : 0;
+    KafkaFFI.setMemorySoftLimit(_memorySoftLimitMb * 1024 * 1024);
+    notifyListeners();
+
+    try {
+      final prefs = await SharedPreferences.getInstance();
+      await prefs.setInt('kafka_memory_soft_limit_mb', _memorySoftLimitMb);
+    } catch (e, stackTrace) {
+      developer.log('Failed to save memory soft limit: $e',
+          stackTrace: stackTrace);
+    }
+  }
+
+  /// 读取原生内存占用明细（所有客户端、消息存储和缓存）
+  KafkaMemoryUsage readMemoryUsage() {
+    return KafkaMemoryUsage.fromMap(KafkaFFI.getMemoryUsage());
+  }
+
   Future<void> saveConnection(KafkaConnection connection) async {
     try {
       final existingIndex = _savedConnections.indexWhere(
@@ -137,7 +250,17 @@ class KafkaProvider extends ChangeNotifier {
 
   Future<void> deleteConnection(String connectionName) async {
     try {
+      final removed =
+          _savedConnections.where((c) => c.name == connectionName).toList();
       _savedConnections.removeWhere((c) => c.name == connectionName);
+      // 预热池只保留已保存的连接
+      for (final connection in removed) {
+        final servers = connection.bootstrapServers;
+        if (servers != _currentConnection?.bootstrapServers &&
+            !_savedConnections.any((c) => c.bootstrapServers == servers)) {
+          _dropWarmClient(servers);
+        }
+      }
 
       final prefs = await SharedPreferences.getInstance();
       final connectionsJson = _savedConnections
@@ -157,17 +280,11 @@ class KafkaProvider extends ChangeNotifier {
     try {
       developer.log('Testing connection to Kafka at $bootstrapServers via FFI');
 
-      // 创建临时客户端进行测试
-      final tempClient = KafkaFFI.createProducer(bootstrapServers);
+      // 使用共享管理客户端测试（已连接同一集群时直接复用），第一个元数据响应到达即成功
+      final adminClient = await KafkaFFI.connectClusterAsync(bootstrapServers);
+      KafkaFFI.releaseAdminClient(adminClient);
 
-      // 尝试获取主题列表，验证连接是否成功
-      final topics = KafkaFFI.getTopics(tempClient);
-
-      // 关闭临时客户端
-      KafkaFFI.closeClient(tempClient);
-
-      developer
-          .log('Connection test successful. Found ${topics.length} topics');
+      developer.log('Connection test successful');
       return true;
     } catch (e, stackTrace) {
       developer.log('Connection test failed: $e', stackTrace: stackTrace);
@@ -186,26 +303,27 @@ class KafkaProvider extends ChangeNotifier {
       developer.log(
           'Attempting to connect to Kafka at ${connection.bootstrapServers} via FFI');
 
-      // 使用临时客户端获取主题列表
-      _tempClient = KafkaFFI.createProducer(connection.bootstrapServers);
-
-      // 添加延迟，确保客户端有足够的时间连接到Kafka集群
-      developer.log('Waiting for Kafka client to connect...');
-      await Future.delayed(const Duration(seconds: 1));
+      // 共享管理客户端、生产者和消费者同时启动。管理客户端在第一个元数据响应到达时就绪，
+      // 这次响应已写入元数据缓存，随后的主题列表直接使用它，整个连接只需要一次往返
+      _releaseAdminClient();
+      final adminReady = KafkaFFI.connectClusterAsync(
+              connection.bootstrapServers,
+              token: _adminRequests)
+          .then((client) => _adminClient = client);
+      await Future.wait([
+        adminReady,
+        _producerProvider.connect(connection.bootstrapServers),
+        _consumerProvider.connect(connection.bootstrapServers),
+      ]);
+      developer.log('Kafka clients ready');
 
       await fetchTopics(connection);
 
-      // 连接生产者和消费者
-      await _producerProvider.connect(connection.bootstrapServers);
-      await _consumerProvider.connect(connection.bootstrapServers);
-
       _isConnected = true;
       _currentConnection = connection;
-
-      // 关闭临时客户端
-      if (_tempClient != null) {
-        KafkaFFI.closeClient(_tempClient!);
-        _tempClient = null;
+      _touchRecent(connection.bootstrapServers);
+      if (_warmPoolEnabled) {
+        _keepWarm(connection.bootstrapServers);
       }
 
       developer.log(
@@ -217,10 +335,7 @@ class KafkaProvider extends ChangeNotifier {
       _currentConnection = null;
 
       // 清理资源
-      if (_tempClient != null) {
-        KafkaFFI.closeClient(_tempClient!);
-        _tempClient = null;
-      }
+      _releaseAdminClient();
 
       await _producerProvider.disconnect();
       await _consumerProvider.disconnect();
@@ -249,17 +364,17 @@ class KafkaProvider extends ChangeNotifier {
     try {
       developer.log('Fetching Kafka topics via FFI');
 
-      if (_tempClient == null) {
-        throw Exception('Temp client not initialized');
+      if (_adminClient == null) {
+        throw Exception('Admin client not initialized');
       }
 
-      // 获取topics列表
-      final topicsFromFFI = KafkaFFI.getTopics(_tempClient!);
-      print('📋 topicsFromFFI: $topicsFromFFI');
+      // 新连接重建主题索引，得到排序后的完整主题列表
+      _destroyTopicIndex();
+      await _refreshTopicIndex();
 
-      // 如果FFI返回空列表，创建新的模拟数据
-      if (topicsFromFFI.isNotEmpty) {
-        _topics = topicsFromFFI;
+      // 如果集群没有主题，创建新的模拟数据
+      if (_topics.isNotEmpty) {
+        _startTopicOverview();
       } else {
         developer.log('FFI returned empty topics list, creating new mock data');
         // 创建新的模拟数据，确保始终有主题可显示
@@ -273,11 +388,15 @@ class KafkaProvider extends ChangeNotifier {
           'another-kafka-topic',
           'demo-topic-for-testing'
         ];
+        // 模拟数据不在索引中，下次刷新时重建索引
+        _destroyTopicIndex();
+        _applyTopicQuery();
       }
 
-      developer
-          .log('Successfully fetched ${_topics.length} Kafka topics: $_topics');
+      developer.log('Successfully fetched ${_topics.length} Kafka topics');
       notifyListeners();
+    } on KafkaCancelledException {
+      developer.log('Fetching topics cancelled');
     } catch (e, stackTrace) {
       developer.log('Failed to fetch topics: $e, creating new mock data',
           stackTrace: stackTrace);
@@ -292,11 +411,157 @@ class KafkaProvider extends ChangeNotifier {
         'another-kafka-topic',
         'demo-topic-for-testing'
       ];
+      _destroyTopicIndex();
+      _applyTopicQuery();
       developer.log('Using mock topics: $_topics');
       notifyListeners();
     }
   }
 
+  // 用原生主题索引刷新_topics：新建的索引直接给出完整的排序列表，
+  // 之后只把新增和删除的主题合并进现有列表
+  Future<void> _refreshTopicIndex() async {
+    final isNew = _topicIndex == null;
+    final index = _topicIndex ??= KafkaFFI.createTopicIndex();
+    final Map<String, dynamic> diff;
+    _topicIndexRefreshes++;
+    try {
+      diff = await KafkaFFI.refreshTopicIndexAsync(index, _adminClient!,
+          token: _adminRequests);
+    } finally {
+      _topicIndexRefreshes--;
+    }
+    if (_topicIndex != index) {
+      // 等待期间断开或重建了索引，这次结果已经过时
+      return;
+    }
+    final added = diff['added'] as List<String>;
+    final removed = diff['removed'] as List<String>;
+    final total = diff['total'] as int;
+
+    if (isNew) {
+      _topics = added;
+    } else if (added.isNotEmpty || removed.isNotEmpty) {
+      final removedSet = removed.toSet();
+      final merged = <String>[];
+      int next = 0;
+      for (final topic in _topics) {
+        if (removedSet.contains(topic)) {
+          continue;
+        }
+        while (next < added.length && added[next].compareTo(topic) < 0) {
+          merged.add(added[next++]);
+        }
+        merged.add(topic);
+      }
+      merged.addAll(added.skip(next));
+      _topics = merged;
+    }
+    developer.log(
+        'Topic index refreshed: $total topics, ${added.length} added, ${removed.length} removed');
+
+    // 列表和索引不一致（例如之前显示的是模拟数据）时重建索引
+    if (_topics.length != total) {
+      developer.log('Topic list out of sync with index, rebuilding');
+      _destroyTopicIndex();
+      await _refreshTopicIndex();
+      return;
+    }
+    _applyTopicQuery();
+  }
+
+  void _destroyTopicIndex() {
+    if (_topicIndex != null) {
+      KafkaFFI.destroyTopicIndex(_topicIndex!);
+      _topicIndex = null;
+    }
+  }
+
+  // 按名称搜索主题（不区分大小写的子串匹配），空字符串显示全部主题
+  void searchTopics(String query) {
+    if (query == _topicQuery) {
+      return;
+    }
+    _topicQuery = query;
+    _applyTopicQuery();
+    notifyListeners();
+  }
+
+  void _applyTopicQuery() {
+    if (_topicQuery.isEmpty) {
+      _topicMatches = null;
+    } else if (_topicIndex != null && _topicIndexRefreshes == 0) {
+      _topicMatches = KafkaFFI.searchTopicIndex(_topicIndex!, _topicQuery);
+    } else {
+      // 未连接时列表只有模拟数据；索引刷新期间它的下标对不上_topics（合并后会重新搜索）。
+      // 这两种情况直接在Dart中匹配
+      final query = _topicQuery.toLowerCase();
+      _topicMatches = Int32List.fromList([
+        for (int i = 0; i < _topics.length; i++)
+          if (_topics[i].toLowerCase().contains(query)) i,
+      ]);
+    }
+  }
+
+  // 启动集群主题概览，统计结果分块到达后逐步填入主题列表
+  void _startTopicOverview() {
+    _stopTopicOverview();
+    _topicOverviews = {};
+    try {
+      final started = KafkaFFI.startTopicOverview(_adminClient!);
+      _overviewHandle = started['handle'] as KafkaOverviewHandle;
+      _overviewTopicCount = started['topicCount'] as int;
+      _overviewTimer =
+          Timer.periodic(_overviewDrainInterval, (_) => _drainTopicOverview());
+      developer.log('Started topic overview for $_overviewTopicCount topics');
+    } catch (e) {
+      developer.log('Failed to start topic overview: $e');
+      _overviewTopicCount = 0;
+    }
+  }
+
+  void _drainTopicOverview() {
+    final handle = _overviewHandle;
+    if (handle == null) {
+      return;
+    }
+    final drained = KafkaFFI.drainTopicOverview(handle, _overviewDrainRows);
+    final rows = drained['rows'] as List<Map<String, dynamic>>;
+    for (final row in rows) {
+      final cleanupPolicy = row['cleanupPolicy'] as String?;
+      _topicOverviews[row['topic'] as String] = TopicOverview(
+        partitions: row['partitionCount'] as int,
+        replicationFactor: row['replicationFactor'] as int,
+        underReplicated: row['underReplicated'] as int,
+        messages: row['messages'] as int,
+        config: cleanupPolicy == null
+            ? null
+            : TopicConfigSummary(
+                cleanupPolicy: cleanupPolicy,
+                retentionMs: row['retentionMs'] as int,
+                retentionBytes: row['retentionBytes'] as int,
+              ),
+      );
+    }
+    if (drained['done'] as bool) {
+      developer.log(
+          'Topic overview finished: ${_topicOverviews.length} of $_overviewTopicCount topics');
+      _stopTopicOverview();
+    }
+    if (rows.isNotEmpty || _overviewHandle == null) {
+      notifyListeners();
+    }
+  }
+
+  void _stopTopicOverview() {
+    _overviewTimer?.cancel();
+    _overviewTimer = null;
+    if (_overviewHandle != null) {
+      KafkaFFI.stopTopicOverview(_overviewHandle!);
+      _overviewHandle = null;
+    }
+  }
+
   Future<void> disconnect() async {
     try {
       developer.log('Disconnecting from Kafka');
@@ -304,12 +569,10 @@ class KafkaProvider extends ChangeNotifier {
       // 断开生产者和消费者连接
       await _producerProvider.disconnect();
       await _consumerProvider.disconnect();
+      await _browserProvider.close();
 
       // 清理资源
-      if (_tempClient != null) {
-        KafkaFFI.closeClient(_tempClient!);
-        _tempClient = null;
-      }
+      _releaseAdminClient();
 
       _isConnected = false;
       // 保留模拟数据，不要清空_topics列表
@@ -325,11 +588,9 @@ class KafkaProvider extends ChangeNotifier {
       try {
         await _producerProvider.disconnect();
         await _consumerProvider.disconnect();
+        await _browserProvider.close();
 
-        if (_tempClient != null) {
-          KafkaFFI.closeClient(_tempClient!);
-          _tempClient = null;
-        }
+        _releaseAdminClient();
       } catch (closeError) {
         developer.log('Error closing FFI clients: $closeError');
       }
@@ -345,31 +606,29 @@ class KafkaProvider extends ChangeNotifier {
 
   Future<void> refreshTopics() async {
     try {
-      if (_isConnected && _currentConnection != null) {
-        // 创建临时客户端重新获取主题列表
-        _tempClient =
-            KafkaFFI.createProducer(_currentConnection!.bootstrapServers);
+      if (_isConnected && _adminClient != null) {
+        // 刷新时丢弃缓存的元数据，重新向broker请求
+        KafkaFFI.invalidateMetadata(_adminClient!);
 
-        // 获取主题列表
-        final topicsFromFFI = KafkaFFI.getTopics(_tempClient!);
+        // 增量刷新主题列表，只合并新增和删除的主题
+        final previous = _topics;
+        await _refreshTopicIndex();
 
-        // 如果FFI返回空列表，保留现有的模拟数据
-        if (topicsFromFFI.isNotEmpty) {
-          _topics = topicsFromFFI;
+        // 如果集群没有主题，保留现有的模拟数据
+        if (_topics.isNotEmpty) {
+          _startTopicOverview();
         } else {
+          _topics = previous;
+          _applyTopicQuery();
           developer.log(
               'FFI returned empty topics list during refresh, using existing data');
         }
 
-        // 关闭临时客户端
-        if (_tempClient != null) {
-          KafkaFFI.closeClient(_tempClient!);
-          _tempClient = null;
-        }
-
         developer.log('Successfully refreshed ${_topics.length} Kafka topics');
         notifyListeners();
       }
+    } on KafkaCancelledException {
+      developer.log('Refreshing topics cancelled');
     } catch (e, stackTrace) {
       developer.log('Failed to refresh topics: $e', stackTrace: stackTrace);
     }
@@ -378,13 +637,11 @@ class KafkaProvider extends ChangeNotifier {
   // 获取指定主题的详细信息
   Future<TopicInfo> fetchTopicDetails(String topicName) async {
     try {
-      if (_isConnected && _currentConnection != null) {
-        // 创建临时客户端获取主题详情
-        final tempClient =
-            KafkaFFI.createProducer(_currentConnection!.bootstrapServers);
-
+      if (_isConnected && _adminClient != null) {
         // 获取主题基本信息
-        final topicInfo = KafkaFFI.getTopicInfo(tempClient, topicName);
+        final topicInfo = await KafkaFFI.getTopicInfoAsync(
+            _adminClient!, topicName,
+            token: _adminRequests);
 
         // 获取分区详情以计算汇总信息
         final partitions = await fetchTopicPartitions(topicName);
@@ -407,9 +664,6 @@ class KafkaProvider extends ChangeNotifier {
               .reduce((a, b) => a + b);
         }
 
-        // 关闭临时客户端
-        KafkaFFI.closeClient(tempClient);
-
         // 创建TopicInfo对象
         final info = TopicInfo(
           name: topicName,
@@ -478,14 +732,11 @@ class KafkaProvider extends ChangeNotifier {
   Future<List<KafkaPartitionInfo>> fetchTopicPartitions(
       String topicName) async {
     try {
-      if (_isConnected && _currentConnection != null) {
-        // 创建临时客户端获取分区详情
-        final tempClient =
-            KafkaFFI.createProducer(_currentConnection!.bootstrapServers);
-
+      if (_isConnected && _adminClient != null) {
         // 获取分区详情
-        final partitionsData =
-            KafkaFFI.getTopicPartitions(tempClient, topicName);
+        final partitionsData = await KafkaFFI.getTopicPartitionsAsync(
+            _adminClient!, topicName,
+            token: _adminRequests);
 
         // 解析分区数据
         final partitions = partitionsData.map<KafkaPartitionInfo>((data) {
@@ -513,9 +764,6 @@ class KafkaProvider extends ChangeNotifier {
           );
         }).toList();
 
-        // 关闭临时客户端
-        KafkaFFI.closeClient(tempClient);
-
         // 存储分区详情
         _topicPartitions[topicName] = partitions;
         notifyListeners();
@@ -567,33 +815,31 @@ class KafkaProvider extends ChangeNotifier {
     }
   }
 
+  // 解析DescribeConfigs返回的配置参数
+  List<KafkaConfigParam> _parseConfigParams(List<Map<String, dynamic>> data) {
+    return data.map<KafkaConfigParam>((entry) {
+      return KafkaConfigParam(
+        name: entry['name'] as String? ?? '',
+        value: entry['value'] as String? ?? '',
+        isDefault: entry['isDefault'] as bool? ?? false,
+        isReadOnly: entry['isReadOnly'] as bool? ?? false,
+        isSensitive: entry['isSensitive'] as bool? ?? false,
+        source: entry['source'] as String? ?? '',
+      );
+    }).toList();
+  }
+
   // 获取指定主题的配置参数
   Future<List<KafkaConfigParam>> fetchTopicConfig(String topicName) async {
     try {
-      if (_isConnected && _currentConnection != null) {
-        // 创建临时客户端获取配置参数
-        final tempClient =
-            KafkaFFI.createProducer(_currentConnection!.bootstrapServers);
-
+      if (_isConnected && _adminClient != null) {
         // 获取配置参数
-        final configData = KafkaFFI.getTopicConfig(tempClient, topicName);
+        final configData = await KafkaFFI.getTopicConfigAsync(
+            _adminClient!, topicName,
+            token: _adminRequests);
 
         // 解析配置数据
-        final configs = configData.entries.map<KafkaConfigParam>((entry) {
-          // 确保键值对都存在且类型正确
-          final name = entry.key as String? ?? '';
-          final value = entry.value as String? ?? '';
-
-          return KafkaConfigParam(
-            name: name,
-            value: value,
-            isDefault: name == 'retention.ms' || name == 'cleanup.policy',
-            isReadOnly: name.startsWith('log.'),
-          );
-        }).toList();
-
-        // 关闭临时客户端
-        KafkaFFI.closeClient(tempClient);
+        final configs = _parseConfigParams(configData);
 
         // 存储配置参数
         _topicConfigs[topicName] = configs;
@@ -645,40 +891,34 @@ class KafkaProvider extends ChangeNotifier {
     }
   }
 
+  // 解析消费者组数据（lag和offset为各分区之和）
+  KafkaConsumerGroup _parseConsumerGroup(Map<String, dynamic> data) {
+    final members = data['members'] as int? ?? 0;
+    final coordinator = data['coordinator'] as int? ?? -1;
+    return KafkaConsumerGroup(
+      groupId: data['name'] as String? ?? '',
+      coordinator: coordinator >= 0 ? 'broker-$coordinator' : 'unknown',
+      state: data['status'] as String? ?? '',
+      members: List.generate(members, (i) => 'member-$i'),
+      lag: data['lag'] as int? ?? 0,
+      offset: data['offset'] as int? ?? 0,
+    );
+  }
+
   // 获取指定主题的消费者组
   Future<List<KafkaConsumerGroup>> fetchTopicConsumerGroups(
       String topicName) async {
     try {
-      if (_isConnected && _currentConnection != null) {
-        // 创建临时客户端获取消费者组
-        final tempClient =
-            KafkaFFI.createProducer(_currentConnection!.bootstrapServers);
-
+      if (_isConnected && _adminClient != null) {
         // 获取消费者组
-        final consumerGroupsData =
-            KafkaFFI.getTopicConsumerGroups(tempClient, topicName);
+        final consumerGroupsData = await KafkaFFI.getTopicConsumerGroupsAsync(
+            _adminClient!, topicName,
+            token: _adminRequests);
 
         // 解析消费者组数据
-        final consumerGroups =
-            consumerGroupsData.map<KafkaConsumerGroup>((data) {
-          // 确保所有字段都存在且类型正确
-          final name = data['name'] as String? ?? '';
-          final members = data['members'] as int? ?? 0;
-          final status = data['status'] as String? ?? '';
-          final lag = data['lag'] as int? ?? 0;
-
-          return KafkaConsumerGroup(
-            groupId: name,
-            coordinator: 'broker-${members % 3 + 1}',
-            state: status,
-            members: List.generate(members, (i) => 'member-$i'),
-            lag: lag,
-            offset: lag,
-          );
-        }).toList();
-
-        // 关闭临时客户端
-        KafkaFFI.closeClient(tempClient);
+        final consumerGroups = consumerGroupsData
+            .map<KafkaConsumerGroup>(_parseConsumerGroup)
+            .toList();
 
         // 存储消费者组
         _topicConsumerGroups[topicName] = consumerGroups;
@@ -723,7 +963,7 @@ class KafkaProvider extends ChangeNotifier {
   }
 
   /// 一次性获取主题的所有详细信息（优化版本）
-  /// 只创建一个临时客户端，并行获取所有数据
+  /// 复用共享管理客户端获取所有数据
   Future<void> fetchAllTopicInfo(String topicName, {bool forceRefresh = false}) async {
     developer.log('fetchAllTopicInfo called for topic: $topicName, forceRefresh: $forceRefresh');
     developer.log('Current state: isConnected=$_isConnected, currentConnection=$_currentConnection');
@@ -744,156 +984,104 @@ class KafkaProvider extends ChangeNotifier {
     notifyListeners();
 
     try {
-      if (_isConnected && _currentConnection != null) {
+      if (_isConnected && _adminClient != null) {
         developer.log('Connected, fetching real data from Kafka...');
-        // 创建一个临时客户端，用于所有请求
-        final tempClient = KafkaFFI.createProducer(_currentConnection!.bootstrapServers);
-        developer.log('Created temp client: $tempClient');
-
-        try {
-          // 获取分区、配置和消费者组数据
-          List<Map<String, dynamic>> partitionsData = [];
-          Map<String, String> configData = {};
-          List<Map<String, dynamic>> consumerGroupsData = [];
-          Map<String, int> topicInfo = {'partitionCount': 0, 'replicationFactor': 0};
-
-          // 逐步获取数据，对可能失败的操作进行单独处理
-          try {
-            developer.log('Fetching partitions data...');
-            partitionsData = KafkaFFI.getTopicPartitions(tempClient, topicName);
-            developer.log('Partitions data: $partitionsData');
-          } catch (e) {
-            developer.log('Failed to fetch partitions: $e');
-            partitionsData = []; // 使用空列表而不是失败
-          }
-
-          try {
-            developer.log('Fetching config data...');
-            configData = KafkaFFI.getTopicConfig(tempClient, topicName);
-            developer.log('Config data: $configData');
-          } catch (e) {
-            developer.log('Failed to fetch config: $e');
-            configData = {}; // 使用空映射而不是失败
-          }
+        final adminClient = _adminClient!;
 
-          try {
-            developer.log('Fetching consumer groups data...');
-            consumerGroupsData = KafkaFFI.getTopicConsumerGroups(tempClient, topicName);
-            developer.log('Consumer groups data: $consumerGroupsData');
-          } catch (e) {
-            developer.log('Failed to fetch consumer groups: $e');
-            consumerGroupsData = []; // 使用空列表而不是失败
-          }
+        // 分区、水位、配置和消费者组在原生层一次并发查询
+        developer.log('Describing topic $topicName...');
+        final description = await KafkaFFI.describeTopicFullAsync(
+            adminClient, topicName,
+            token: _adminRequests);
+        final partitionsData =
+            description['partitions'] as List<Map<String, dynamic>>;
+        final configData = description['configs'] as List<Map<String, dynamic>>;
+        final consumerGroupsData =
+            description['consumerGroups'] as List<Map<String, dynamic>>;
+        final topicInfo = <String, int>{
+          'partitionCount': description['partitionCount'] as int,
+          'replicationFactor': description['replicationFactor'] as int,
+        };
+        developer.log('Topic $topicName: ${partitionsData.length} partitions, '
+            '${configData.length} configs, ${consumerGroupsData.length} consumer groups');
 
-          try {
-            developer.log('Fetching topic info...');
-            topicInfo = KafkaFFI.getTopicInfo(tempClient, topicName);
-            developer.log('Topic info: $topicInfo');
-          } catch (e) {
-            developer.log('Failed to fetch topic info: $e');
-            // 使用默认值
-            topicInfo = {'partitionCount': partitionsData.length, 'replicationFactor': 0};
-          }
+        // 解析分区数据
+        final partitions = partitionsData.map<KafkaPartitionInfo>((data) {
+          final id = data['id'] as int? ?? 0;
+          final leader = data['leader'] as int? ?? 0;
+          final replicasStr = data['replicas'] as String? ?? '';
+          final isrStr = data['isr'] as String? ?? '';
+          final latestOffset = data['latestOffset'] as int? ?? 0;
+          final earliestOffset = data['earliestOffset'] as int? ?? 0;
 
-          // 解析分区数据
-          final partitions = partitionsData.map<KafkaPartitionInfo>((data) {
-            final id = data['id'] as int? ?? 0;
-            final leader = data['leader'] as int? ?? 0;
-            final replicasStr = data['replicas'] as String? ?? '';
-            final isrStr = data['isr'] as String? ?? '';
-            final latestOffset = data['latestOffset'] as int? ?? 0;
-            final earliestOffset = data['earliestOffset'] as int? ?? 0;
-
-            final replicas = replicasStr.isNotEmpty
-                ? replicasStr.split(',').map((s) => int.tryParse(s.trim()) ?? 0).toList()
-                : <int>[];
-            final isr = isrStr.isNotEmpty
-                ? isrStr.split(',').map((s) => int.tryParse(s.trim()) ?? 0).toList()
-                : <int>[];
-
-            return KafkaPartitionInfo(
-              id: id,
-              leader: leader,
-              replicas: replicas,
-              isr: isr,
-              latestOffset: latestOffset,
-              earliestOffset: earliestOffset,
-            );
-          }).toList();
-
-          // 解析配置数据
-          final configs = configData.entries.map<KafkaConfigParam>((entry) {
-            final name = entry.key as String? ?? '';
-            final value = entry.value as String? ?? '';
-            return KafkaConfigParam(
-              name: name,
-              value: value,
-              isDefault: name == 'retention.ms' || name == 'cleanup.policy',
-              isReadOnly: name.startsWith('log.'),
-            );
-          }).toList();
-
-          // 解析消费者组数据
-          final consumerGroups = consumerGroupsData.map<KafkaConsumerGroup>((data) {
-            final name = data['name'] as String? ?? '';
-            final members = data['members'] as int? ?? 0;
-            final status = data['status'] as String? ?? '';
-            final lag = data['lag'] as int? ?? 0;
-
-            return KafkaConsumerGroup(
-              groupId: name,
-              coordinator: 'broker-${members % 3 + 1}',
-              state: status,
-              members: List.generate(members, (i) => 'member-$i'),
-              lag: lag,
-              offset: lag,
-            );
-          }).toList();
-
-          // 计算汇总信息
-          int latestOffset = 0;
-          int earliestOffset = 0;
-          int inSyncReplicas = 0;
-          int offlineReplicas = 0;
-
-          if (partitions.isNotEmpty) {
-            latestOffset = partitions.map((p) => p.latestOffset).reduce((a, b) => a + b);
-            earliestOffset = partitions.map((p) => p.earliestOffset).reduce((a, b) => a + b);
-            inSyncReplicas = partitions.map((p) => p.isr.length).reduce((a, b) => a + b);
-            offlineReplicas = partitions
-                .map((p) => p.replicas.length - p.isr.length)
-                .reduce((a, b) => a + b);
-          }
+          final replicas = replicasStr.isNotEmpty
+              ? replicasStr.split(',').map((s) => int.tryParse(s.trim()) ?? 0).toList()
+              : <int>[];
+          final isr = isrStr.isNotEmpty
+              ? isrStr.split(',').map((s) => int.tryParse(s.trim()) ?? 0).toList()
+              : <int>[];
 
-          // 创建 TopicInfo 对象
-          final info = TopicInfo(
-            name: topicName,
-            partitions: topicInfo['partitionCount'] ?? partitions.length,
-            replicationFactor: topicInfo['replicationFactor'] ?? 0,
+          return KafkaPartitionInfo(
+            id: id,
+            leader: leader,
+            replicas: replicas,
+            isr: isr,
             latestOffset: latestOffset,
             earliestOffset: earliestOffset,
-            inSyncReplicas: inSyncReplicas,
-            offlineReplicas: offlineReplicas,
-            createdTime: DateTime.now().subtract(const Duration(days: 7)).toString(),
-            lastModifiedTime: DateTime.now().subtract(const Duration(hours: 2)).toString(),
-            isInternal: topicName.startsWith('__'),
           );
+        }).toList();
+
+        // 解析配置数据
+        final configs = _parseConfigParams(configData);
 
-          // 存储所有数据
-          _topicDetails[topicName] = info;
-          _topicPartitions[topicName] = partitions;
-          _topicConfigs[topicName] = configs;
-          _topicConsumerGroups[topicName] = consumerGroups;
+        // 解析消费者组数据
+        final consumerGroups = consumerGroupsData
+            .map<KafkaConsumerGroup>(_parseConsumerGroup)
+            .toList();
 
-          developer.log('Successfully fetched all info for topic: $topicName');
-        } finally {
-          // 确保关闭临时客户端
-          KafkaFFI.closeClient(tempClient);
+        // 计算汇总信息
+        int latestOffset = 0;
+        int earliestOffset = 0;
+        int inSyncReplicas = 0;
+        int offlineReplicas = 0;
+
+        if (partitions.isNotEmpty) {
+          latestOffset = partitions.map((p) => p.latestOffset).reduce((a, b) => a + b);
+          earliestOffset = partitions.map((p) => p.earliestOffset).reduce((a, b) => a + b);
+          inSyncReplicas = partitions.map((p) => p.isr.length).reduce((a, b) => a + b);
+          offlineReplicas = partitions
+              .map((p) => p.replicas.length - p.isr.length)
+              .reduce((a, b) => a + b);
         }
+
+        // 创建 TopicInfo 对象
+        final info = TopicInfo(
+          name: topicName,
+          partitions: topicInfo['partitionCount'] ?? partitions.length,
+          replicationFactor: topicInfo['replicationFactor'] ?? 0,
+          latestOffset: latestOffset,
+          earliestOffset: earliestOffset,
+          inSyncReplicas: inSyncReplicas,
+          offlineReplicas: offlineReplicas,
+          createdTime: DateTime.now().subtract(const Duration(days: 7)).toString(),
+          lastModifiedTime: DateTime.now().subtract(const Duration(hours: 2)).toString(),
+          isInternal: topicName.startsWith('__'),
+        );
+
+        // 存储所有数据
+        _topicDetails[topicName] = info;
+        _topicPartitions[topicName] = partitions;
+        _topicConfigs[topicName] = configs;
+        _topicConsumerGroups[topicName] = consumerGroups;
+
+        developer.log('Successfully fetched all info for topic: $topicName');
       } else {
         // 即使未连接也尝试获取基本主题信息（用于显示连接状态）
         _setMinimalTopicData(topicName);
       }
+    } on KafkaCancelledException {
+      // 断开连接时取消，不记录为错误
+      developer.log('Fetching topic info for $topicName cancelled');
     } catch (e, stackTrace) {
       developer.log('Failed to fetch topic info for $topicName: $e', stackTrace: stackTrace);
       // 发生错误时使用最小化数据，但不使用固定数值
@@ -906,6 +1094,197 @@ class KafkaProvider extends ChangeNotifier {
     }
   }
 
+  /// 读取当前连接各客户端（admin、producer、consumer）的统计快照，
+  /// sinceTsUs按客户端给出上次读到的最新tsUs，只返回之后的快照。
+  /// 消费者句柄只在工作isolate中有效，它的快照通过工作isolate读取
+  Future<Map<String, List<KafkaClientStats>>> readClientStats(
+      {Map<String, int> sinceTsUs = const {}}) async {
+    final clients = <String, KafkaClientHandle?>{
+      'admin': _adminClient,
+      'producer': _producerProvider.producer,
+    };
+    final result = <String, List<KafkaClientStats>>{};
+    clients.forEach((role, client) {
+      if (client == null) {
+        return;
+      }
+      try {
+        result[role] = KafkaFFI.getClientStats(client,
+                sinceTsUs: sinceTsUs[role] ?? 0)
+            .map(KafkaClientStats.fromMap)
+            .toList();
+      } catch (e) {
+        developer.log('Failed to read $role client stats: $e');
+      }
+    });
+    try {
+      final snapshots = await _consumerProvider.readClientStats(
+          sinceTsUs: sinceTsUs['consumer'] ?? 0);
+      if (snapshots != null) {
+        result['consumer'] =
+            snapshots.map(KafkaClientStats.fromMap).toList();
+      }
+    } catch (e) {
+      developer.log('Failed to read consumer client stats: $e');
+    }
+    return result;
+  }
+
+  // 释放共享管理客户端（概览线程还在使用它，先停止概览；主题索引属于这个集群，一并销毁；
+  // 进行中的异步查询被取消，原生侧执行期间自己持有客户端的引用）
+  void _releaseAdminClient() {
+    // 当前集群在预热池中时，客户端由池继续持有，从现在开始计算空闲时间
+    final servers = _currentConnection?.bootstrapServers;
+    final warm = servers == null ? null : _warmClients[servers];
+    if (warm != null) {
+      _startWarmIdleTimer(servers!, warm);
+    }
+    _adminRequests.cancel();
+    _adminRequests = KafkaCancelToken();
+    _stopTopicOverview();
+    _destroyTopicIndex();
+    if (_adminClient != null) {
+      KafkaFFI.releaseAdminClient(_adminClient!);
+      _adminClient = null;
+    }
+  }
+
+  // 记录最近成功连接的集群，预热池按这个顺序选择要预热的连接
+  Future<void> _touchRecent(String servers) async {
+    _recentServers.remove(servers);
+    _recentServers.insert(0, servers);
+    if (_recentServers.length > _recentLimit) {
+      _recentServers = _recentServers.sublist(0, _recentLimit);
+    }
+    try {
+      final prefs = await SharedPreferences.getInstance();
+      await prefs.setStringList('kafka_recent_connections', _recentServers);
+    } catch (e, stackTrace) {
+      developer.log('Failed to save recent connections: $e',
+          stackTrace: stackTrace);
+    }
+  }
+
+  // 在后台预热最近使用的已保存连接（连接检测的元数据响应同时写入原生元数据缓存）
+  void _warmRecentConnections() {
+    final candidates = _recentServers
+        .where((s) => _savedConnections.any((c) => c.bootstrapServers == s))
+        .take(_warmPoolSize);
+    for (final servers in candidates) {
+      if (_warmClients.containsKey(servers) || !_warming.add(servers)) {
+        continue;
+      }
+      final token = _warmRequests;
+      developer.log('Pre-warming connection to $servers');
+      KafkaFFI.connectClusterAsync(servers, token: token).then((client) {
+        if (token != _warmRequests) {
+          KafkaFFI.releaseAdminClient(client);
+          return;
+        }
+        _warming.remove(servers);
+        if (!_warmPoolEnabled || _warmClients.containsKey(servers)) {
+          KafkaFFI.releaseAdminClient(client);
+          return;
+        }
+        final warm = _WarmClient(client);
+        _warmClients[servers] = warm;
+        if (servers != _currentConnection?.bootstrapServers) {
+          _startWarmIdleTimer(servers, warm);
+        }
+        _startWarmRefresh();
+        developer.log('Connection to $servers is warm');
+      }, onError: (e) {
+        if (token == _warmRequests) {
+          _warming.remove(servers);
+        }
+        developer.log('Failed to pre-warm connection to $servers: $e');
+      });
+    }
+  }
+
+  // 让当前集群留在预热池中（使用期间不计空闲时间），超出容量时淘汰最久未用的空闲连接
+  void _keepWarm(String servers) {
+    final existing = _warmClients[servers];
+    if (existing != null) {
+      existing.idleTimer?.cancel();
+      existing.idleTimer = null;
+      return;
+    }
+    try {
+      _warmClients[servers] =
+          _WarmClient(KafkaFFI.acquireAdminClient(servers));
+    } catch (e) {
+      developer.log('Failed to keep connection to $servers warm: $e');
+      return;
+    }
+    _startWarmRefresh();
+
+    int rank(String s) {
+      final i = _recentServers.indexOf(s);
+      return i < 0 ? _recentServers.length : i;
+    }
+
+    final idle = _warmClients.keys.where((s) => s != servers).toList()
+      ..sort((a, b) => rank(a).compareTo(rank(b)));
+    while (_warmClients.length > _warmPoolSize && idle.isNotEmpty) {
+      _dropWarmClient(idle.removeLast());
+    }
+  }
+
+  void _startWarmIdleTimer(String servers, _WarmClient warm) {
+    warm.idleTimer?.cancel();
+    warm.idleTimer = Timer(_warmIdleTimeout, () {
+      if (_warmClients[servers] == warm) {
+        developer.log('Warm connection to $servers idle, releasing');
+        _dropWarmClient(servers);
+      }
+    });
+  }
+
+  // 定时刷新空闲预热连接的元数据，保持连接活跃、缓存不过期；刷新失败的连接移出预热池
+  void _startWarmRefresh() {
+    _warmRefreshTimer ??= Timer.periodic(_warmRefreshInterval, (_) {
+      final current = _currentConnection?.bootstrapServers;
+      final token = _warmRequests;
+      for (final entry in _warmClients.entries.toList()) {
+        if (entry.key == current) {
+          continue;
+        }
+        final servers = entry.key;
+        final warm = entry.value;
+        KafkaFFI.getTopicsAsync(warm.client, token: token).catchError((e) {
+          if (e is! KafkaCancelledException && _warmClients[servers] == warm) {
+            developer.log('Warm connection to $servers failed: $e');
+            _dropWarmClient(servers);
+          }
+          return <String>[];
+        });
+      }
+    });
+  }
+
+  void _dropWarmClient(String servers) {
+    final warm = _warmClients.remove(servers);
+    if (warm == null) {
+      return;
+    }
+    warm.idleTimer?.cancel();
+    KafkaFFI.releaseAdminClient(warm.client);
+    if (_warmClients.isEmpty) {
+      _warmRefreshTimer?.cancel();
+      _warmRefreshTimer = null;
+    }
+  }
+
+  void _clearWarmPool() {
+    _warmRequests.cancel();
+    _warmRequests = KafkaCancelToken();
+    _warming.clear();
+    for (final servers in _warmClients.keys.toList()) {
+      _dropWarmClient(servers);
+    }
+  }
+
   /// 设置最小化主题数据（当连接不可用时）
   void _setMinimalTopicData(String topicName) {
     _topicDetails[topicName] = TopicInfo(
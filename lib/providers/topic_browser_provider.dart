@@ -0,0 +1,313 @@
+import 'package:flutter/material.dart';
+import 'dart:developer' as developer;
+import 'dart:async';
+import 'dart:collection';
+import '../ffi/kafka_ffi.dart';
+import '../ffi/kafka_worker.dart';
+
+// 一页历史消息：每个分区一段偏移量范围[start, end)
+class _BrowsePage {
+  final int index;
+  final Map<int, ({int start, int end})> ranges;
+  final List<Map<String, dynamic>> messages;
+
+  _BrowsePage(this.index, this.ranges, this.messages);
+}
+
+// 历史消息浏览：可见窗口对应每个分区的偏移量范围，滚动到已加载的边缘时用assign读取上一页或下一页，
+// 沿滚动方向预取相邻的页，只在内存中保留有限的几页。读取在单独的浏览isolate中进行，不影响实时消费。
+//
+// 页号以打开时的锚点为0：从末尾打开时第0页是每个分区最新的一段，页号越小越旧。
+// 第k页在分区p上的范围是[anchor_p + k * size_p, anchor_p + (k + 1) * size_p)，按水位截断。
+class TopicBrowserProvider extends ChangeNotifier {
+  static const int _storeMaxBytes = 128 * 1024 * 1024;
+  static const int _previewBytes = 4096;
+  static const int _fetchTimeoutMs = 5000;
+  static const int _maxResidentPages = 5;
+  static const int _prefetchPages = 1;
+
+  final String _groupId =
+      'flutter-kafka-browser-${DateTime.now().millisecondsSinceEpoch}';
+
+  String? _topic;
+  int _pageMessages = 200; // 每页的消息数，按分区平均分配
+  final Map<int, ({int earliest, int latest})> _watermarks = {};
+  final Map<int, int> _anchors = {};
+  final Map<int, int> _pageSizes = {};
+  final SplayTreeMap<int, _BrowsePage> _pages = SplayTreeMap();
+  final Set<int> _loading = {};
+  List<Map<String, dynamic>> _rows = const [];
+  int _visiblePage = 0;
+  int _direction = 0; // -1向旧的方向滚动，1向新的方向滚动
+  int _lastFirstVisibleRow = 0;
+  KafkaStoreHandle? _store;
+  bool _isOpen = false;
+  int _session = 0; // 每次关闭加一，丢弃旧会话里还没返回的页
+  String? _error;
+
+  // 页面被插入或移除在当前行之前时回调（行数，正数表示前面多了行），UI据此调整滚动位置
+  void Function(int rows)? onRowsShifted;
+
+  bool get isOpen => _isOpen;
+  String? get topic => _topic;
+  String? get error => _error;
+  bool get isLoading => _loading.isNotEmpty;
+  int get pageMessages => _pageMessages;
+  List<Map<String, dynamic>> get rows => _rows;
+  bool get hasOlder => _pages.isNotEmpty && _pageExists(_pages.firstKey()! - 1);
+  bool get hasNewer => _pages.isNotEmpty && _pageExists(_pages.lastKey()! + 1);
+
+  // 打开主题，fromEnd为true时从每个分区最新的消息开始，否则从最早的开始
+  Future<void> open(String bootstrapServers, String topic,
+      {bool fromEnd = true, int pageMessages = 200}) async {
+    await close();
+    _topic = topic;
+    _pageMessages = pageMessages > 0 ? pageMessages : 200;
+    _error = null;
+
+    try {
+      final worker = await KafkaWorker.browser;
+      _store ??= KafkaFFI.createStore(_storeMaxBytes);
+      final partitions = await worker.openBrowser(
+          bootstrapServers: bootstrapServers,
+          groupId: _groupId,
+          topic: topic,
+          store: _store!);
+
+      final available = partitions
+          .where((p) =>
+              (p['earliestOffset'] as int) >= 0 &&
+              (p['latestOffset'] as int) > (p['earliestOffset'] as int))
+          .toList();
+      final perPartition = available.isEmpty
+          ? 0
+          : (_pageMessages + available.length - 1) ~/ available.length;
+      for (final p in available) {
+        final partition = p['partition'] as int;
+        final earliest = p['earliestOffset'] as int;
+        final latest = p['latestOffset'] as int;
+        _watermarks[partition] = (earliest: earliest, latest: latest);
+        _pageSizes[partition] = perPartition;
+        _anchors[partition] = fromEnd ? latest - perPartition : earliest;
+      }
+      _isOpen = true;
+      developer.log(
+          'Browser opened on $topic: ${available.length} partitions with messages');
+      notifyListeners();
+
+      _visiblePage = 0;
+      await _load(0);
+      _ensureAround(0);
+    } catch (e, stackTrace) {
+      developer.log('Failed to open browser: $e', stackTrace: stackTrace);
+      _error = e.toString();
+      _isOpen = false;
+      notifyListeners();
+      rethrow;
+    }
+  }
+
+  // 关闭浏览，释放消费者和存储
+  Future<void> close() async {
+    final wasOpen = _isOpen;
+    _isOpen = false;
+    _session++;
+    _topic = null;
+    _watermarks.clear();
+    _anchors.clear();
+    _pageSizes.clear();
+    _pages.clear();
+    _loading.clear();
+    _rows = const [];
+    _lastFirstVisibleRow = 0;
+    _direction = 0;
+    if (wasOpen) {
+      try {
+        await (await KafkaWorker.browser).closeBrowser();
+      } catch (e, stackTrace) {
+        developer.log('Failed to close browser: $e', stackTrace: stackTrace);
+      }
+    }
+    if (_store != null) {
+      KafkaFFI.destroyStore(_store!);
+      _store = null;
+    }
+    if (wasOpen) {
+      notifyListeners();
+    }
+  }
+
+  // UI报告当前可见的行范围，决定滚动方向、预取相邻页并淘汰远处的页
+  void onVisibleRange(int firstRow, int lastRow) {
+    if (!_isOpen || _pages.isEmpty) {
+      return;
+    }
+    if (firstRow != _lastFirstVisibleRow) {
+      _direction = firstRow < _lastFirstVisibleRow ? -1 : 1;
+      _lastFirstVisibleRow = firstRow;
+    }
+
+    final first = _pageOfRow(firstRow);
+    final last = _pageOfRow(lastRow);
+    _visiblePage = _direction < 0 ? first : last;
+    _ensureAround(_visiblePage);
+  }
+
+  // 获取被截断消息的完整内容（已淘汰时退回预览）
+  String fullContentFor(Map<String, dynamic> message) {
+    final content = message['content'] as String? ?? '';
+    if (!(message['truncated'] as bool? ?? false) || _store == null) {
+      return content;
+    }
+    return KafkaFFI.fetchPayload(
+            _store!, message['partition'] as int, message['offset'] as int,
+            payloadType:
+                message['payloadType'] as int? ?? KafkaPayloadType.text) ??
+        content;
+  }
+
+  int _pageOfRow(int row) {
+    int start = 0;
+    for (final page in _pages.values) {
+      start += page.messages.length;
+      if (row < start) {
+        return page.index;
+      }
+    }
+    return _pages.lastKey()!;
+  }
+
+  // 页在每个分区上的范围，按水位截断；所有分区都为空时返回null
+  Map<int, ({int start, int end})>? _rangesFor(int index) {
+    final ranges = <int, ({int start, int end})>{};
+    _watermarks.forEach((partition, watermark) {
+      final size = _pageSizes[partition]!;
+      final anchor = _anchors[partition]!;
+      var start = anchor + index * size;
+      var end = start + size;
+      if (start < watermark.earliest) {
+        start = watermark.earliest;
+      }
+      if (end > watermark.latest) {
+        end = watermark.latest;
+      }
+      if (start < end) {
+        ranges[partition] = (start: start, end: end);
+      }
+    });
+    return ranges.isEmpty ? null : ranges;
+  }
+
+  bool _pageExists(int index) => _rangesFor(index) != null;
+
+  // 保证可见页和滚动方向上的相邻页已加载（页加载完成时淘汰离可见页最远的页）
+  void _ensureAround(int index) {
+    final wanted = <int>[index];
+    for (int i = 1; i <= _prefetchPages; i++) {
+      if (_direction <= 0) {
+        wanted.add(index - i);
+      }
+      if (_direction >= 0) {
+        wanted.add(index + i);
+      }
+    }
+    // 靠近已加载边缘时，边缘外的一页也要加载，否则滚不过去
+    if (_pages.isNotEmpty) {
+      if (index <= _pages.firstKey()!) {
+        wanted.add(_pages.firstKey()! - 1);
+      }
+      if (index >= _pages.lastKey()!) {
+        wanted.add(_pages.lastKey()! + 1);
+      }
+    }
+    for (final page in wanted) {
+      if (!_pages.containsKey(page) && !_loading.contains(page)) {
+        _load(page);
+      }
+    }
+  }
+
+  Future<void> _load(int index) async {
+    final ranges = _rangesFor(index);
+    if (ranges == null) {
+      return;
+    }
+    final session = _session;
+    _loading.add(index);
+    notifyListeners();
+
+    try {
+      final worker = await KafkaWorker.browser;
+      final messages = await worker.fetchPage(
+          [
+            for (final entry in ranges.entries)
+              {
+                'partition': entry.key,
+                'start': entry.value.start,
+                'end': entry.value.end,
+              }
+          ],
+          previewBytes: _previewBytes,
+          timeoutMs: _fetchTimeoutMs);
+      // 加载期间浏览已关闭或重新打开
+      if (session != _session || !_loading.remove(index)) {
+        return;
+      }
+
+      _pages[index] = _BrowsePage(index, ranges, messages);
+      if (_pages.firstKey() == index && _pages.length > 1) {
+        onRowsShifted?.call(messages.length);
+      }
+      _evict();
+      _rebuildRows();
+      developer.log('Browser loaded page $index: ${messages.length} messages');
+    } catch (e, stackTrace) {
+      developer.log('Failed to load page $index: $e', stackTrace: stackTrace);
+      if (session != _session) {
+        return;
+      }
+      _loading.remove(index);
+      _error = e.toString();
+    }
+    notifyListeners();
+  }
+
+  // 只保留离可见页最近的几页；距离相同时先淘汰滚动方向背后的页
+  void _evict() {
+    while (_pages.length > _maxResidentPages) {
+      final first = _pages.firstKey()!;
+      final last = _pages.lastKey()!;
+      final firstDistance = _visiblePage - first;
+      final lastDistance = last - _visiblePage;
+      final dropFirst = firstDistance > lastDistance ||
+          (firstDistance == lastDistance && _direction > 0);
+      if (dropFirst) {
+        final removed = _pages.remove(first)!;
+        onRowsShifted?.call(-removed.messages.length);
+      } else {
+        _pages.remove(last);
+      }
+    }
+  }
+
+  void _rebuildRows() {
+    _rows = [for (final page in _pages.values) ...page.messages];
+  }
+
+  @override
+  void dispose() {
+    _session++;
+    onRowsShifted = null;
+    final store = _store;
+    _store = null;
+    if (_isOpen) {
+      // 先关闭消费者再释放存储，正在读取的页还会往存储里写
+      _isOpen = false;
+      KafkaWorker.browser.then((worker) => worker.closeBrowser()).whenComplete(
+          () => store != null ? KafkaFFI.destroyStore(store) : null);
+    } else if (store != null) {
+      KafkaFFI.destroyStore(store);
+    }
+    super.dispose();
+  }
+}
@@ -333,6 +333,35 @@ class _ConnectionScreenState extends State<ConnectionScreen> {
                       ],
                     ],
                   ),
+
+                  // 预热池切换
+                  Row(
+                    children: [
+                      Checkbox(
+                        value: kafkaProvider.warmPoolEnabled,
+                        onChanged: (value) {
+                          kafkaProvider.setWarmPoolEnabled(value ?? false);
+                        },
+                        fillColor: WidgetStateProperty.resolveWith((states) {
+                          if (states.contains(WidgetState.selected)) {
+                            return const Color(0xFF2563EB);
+                          }
+                          return Colors.white;
+                        }),
+                        checkColor: Colors.white,
+                        shape: RoundedRectangleBorder(
+                            borderRadius: BorderRadius.circular(4)),
+                        side: const BorderSide(color: Color(0xFFCBD5E1)),
+                      ),
+                      const Text(
+                        'Keep recent connections warm',
+                        style: TextStyle(
+                          fontSize: 14,
+                          color: Color(0xFF475569),
+                        ),
+                      ),
+                    ],
+                  ),
                   const SizedBox(height: 24),
 
                   // 连接和测试按钮
@@ -4,6 +4,8 @@ import 'package:provider/provider.dart';
 import 'package:file_picker/file_picker.dart';
 
 import '../providers/kafka_provider.dart';
+import '../ffi/kafka_ffi.dart';
+import '../widgets/topic_browser_panel.dart';
 
 class ConsumerScreen extends StatefulWidget {
   const ConsumerScreen({super.key});
@@ -23,6 +25,12 @@ class _ConsumerScreenState extends State<ConsumerScreen> {
   String _autoSaveFormat = 'json'; // json, txt
   String? _autoSaveFilePath;
 
+  // Schema Registry地址（Avro/Protobuf消息解码）
+  final _schemaRegistryController = TextEditingController();
+
+  // 浏览模式：按分区偏移量翻页查看主题的历史消息
+  bool _browseMode = false;
+
   @override
   void initState() {
     super.initState();
@@ -440,6 +448,54 @@ class _ConsumerScreenState extends State<ConsumerScreen> {
                                       ),
                                     const SizedBox(height: 24),
 
+                                    // 全量扫描模式（下次开始消费时生效）
+                                    Consumer<KafkaProvider>(
+                                      builder: (context, kafkaProvider, child) {
+                                        final consumerProvider =
+                                            kafkaProvider.consumerProvider;
+                                        return Row(
+                                          children: [
+                                            const Expanded(
+                                              child: Column(
+                                                crossAxisAlignment:
+                                                    CrossAxisAlignment.start,
+                                                children: [
+                                                  Text(
+                                                    'Full Scan',
+                                                    style: TextStyle(
+                                                      fontSize: 14,
+                                                      fontWeight:
+                                                          FontWeight.bold,
+                                                      color: Color(0xFF1E293B),
+                                                    ),
+                                                  ),
+                                                  SizedBox(height: 2),
+                                                  Text(
+                                                    'Large fetches, no offset commits',
+                                                    style: TextStyle(
+                                                      fontSize: 12,
+                                                      color: Color(0xFF64748B),
+                                                    ),
+                                                  ),
+                                                ],
+                                              ),
+                                            ),
+                                            Switch(
+                                              value: consumerProvider.scanMode,
+                                              onChanged: consumerProvider
+                                                      .isConsuming
+                                                  ? null
+                                                  : consumerProvider
+                                                      .setScanMode,
+                                              activeColor:
+                                                  const Color(0xFF3B82F6),
+                                            ),
+                                          ],
+                                        );
+                                      },
+                                    ),
+                                    const SizedBox(height: 24),
+
                                     // 自动保存配置
                                     Row(
                                       children: [
@@ -578,6 +634,22 @@ class _ConsumerScreenState extends State<ConsumerScreen> {
                                     ],
                                     const SizedBox(height: 24),
 
+                                    // Schema Registry配置
+                                    TextField(
+                                      controller: _schemaRegistryController,
+                                      decoration: InputDecoration(
+                                        labelText: 'Schema Registry (optional)',
+                                        border: OutlineInputBorder(
+                                          borderRadius:
+                                              BorderRadius.circular(10),
+                                        ),
+                                        hintText: 'http://localhost:8081',
+                                        helperText:
+                                            'Decodes Avro / Protobuf messages to JSON',
+                                      ),
+                                    ),
+                                    const SizedBox(height: 24),
+
                                     // 消费控制按钮
                                     Consumer<KafkaProvider>(
                                       builder: (context, kafkaProvider, child) {
@@ -612,6 +684,42 @@ class _ConsumerScreenState extends State<ConsumerScreen> {
                                         );
                                       },
                                     ),
+
+                                    // 扫描速率（扫描模式消费期间每个统计间隔更新）
+                                    ValueListenableBuilder<Map<String, dynamic>?>(
+                                      valueListenable: kafkaProvider
+                                          .consumerProvider.scanRate,
+                                      builder: (context, rate, child) {
+                                        if (rate == null) {
+                                          return const SizedBox.shrink();
+                                        }
+                                        final bytesPerSec =
+                                            (rate['bytesPerSec'] as num)
+                                                .round();
+                                        final msgsPerSec =
+                                            (rate['msgsPerSec'] as num)
+                                                .round();
+                                        return Padding(
+                                          padding:
+                                              const EdgeInsets.only(top: 12),
+                                          child: Wrap(
+                                            spacing: 16,
+                                            runSpacing: 4,
+                                            children: [
+                                              _MetaItem(
+                                                label: 'Scan rate',
+                                                value:
+                                                    '${_formatBytes(bytesPerSec)}/s',
+                                              ),
+                                              _MetaItem(
+                                                label: 'Messages',
+                                                value: '$msgsPerSec/s',
+                                              ),
+                                            ],
+                                          ),
+                                        );
+                                      },
+                                    ),
                                   ],
                                 ),
                               ),
@@ -685,6 +793,42 @@ class _ConsumerScreenState extends State<ConsumerScreen> {
                               ),
                               Row(
                                 children: [
+                                  // 浏览历史消息按钮
+                                  Container(
+                                    margin: const EdgeInsets.only(right: 12),
+                                    child: TextButton.icon(
+                                      onPressed: _selectedTopic == null
+                                          ? null
+                                          : () => setState(
+                                              () => _browseMode = !_browseMode),
+                                      icon: Icon(
+                                        _browseMode
+                                            ? Icons.stream
+                                            : Icons.history,
+                                        size: 16,
+                                        color: const Color(0xFF64748B),
+                                      ),
+                                      label: Text(
+                                        _browseMode ? 'Live' : 'Browse',
+                                        style: const TextStyle(
+                                          color: Color(0xFF64748B),
+                                          fontSize: 14,
+                                        ),
+                                      ),
+                                      style: TextButton.styleFrom(
+                                        padding: const EdgeInsets.symmetric(
+                                          horizontal: 12,
+                                          vertical: 6,
+                                        ),
+                                        backgroundColor:
+                                            const Color(0xFFF1F5F9),
+                                        shape: RoundedRectangleBorder(
+                                          borderRadius:
+                                              BorderRadius.circular(8),
+                                        ),
+                                      ),
+                                    ),
+                                  ),
                                   // 保存文件按钮
                                   Container(
                                     margin: const EdgeInsets.only(right: 12),
@@ -726,13 +870,19 @@ class _ConsumerScreenState extends State<ConsumerScreen> {
                                           color: const Color(0xFFA7F3D0),
                                           width: 2),
                                     ),
-                                    child: Text(
-                                      '${consumerProvider.messages.length}',
-                                      style: const TextStyle(
-                                        fontSize: 14,
-                                        color: Color(0xFF065F46),
-                                        fontWeight: FontWeight.bold,
-                                      ),
+                                    child: ValueListenableBuilder<int>(
+                                      valueListenable:
+                                          consumerProvider.messageCount,
+                                      builder: (context, messageCount, child) {
+                                        return Text(
+                                          '$messageCount',
+                                          style: const TextStyle(
+                                            fontSize: 14,
+                                            color: Color(0xFF065F46),
+                                            fontWeight: FontWeight.bold,
+                                          ),
+                                        );
+                                      },
                                     ),
                                   ),
                                 ],
@@ -743,225 +893,268 @@ class _ConsumerScreenState extends State<ConsumerScreen> {
 
                           // 消息列表
                           Expanded(
-                            child: consumerProvider.messages.isEmpty
-                                ? Center(
-                                    child: Column(
-                                      mainAxisAlignment:
-                                          MainAxisAlignment.center,
-                                      children: [
-                                        Container(
-                                          width: 80,
-                                          height: 80,
-                                          decoration: BoxDecoration(
-                                            color: const Color(0xFFF1F5F9),
-                                            borderRadius:
-                                                BorderRadius.circular(16),
-                                          ),
-                                          child: const Icon(
-                                            Icons.email_outlined,
-                                            size: 48,
-                                            color: Color(0xFF94A3B8),
-                                          ),
-                                        ),
-                                        const SizedBox(height: 16),
-                                        Text(
-                                          consumerProvider.isConsuming
-                                              ? 'Waiting for messages...'
-                                              : 'No messages yet. Click "Start Consuming" to begin.',
-                                          textAlign: TextAlign.center,
-                                          style: const TextStyle(
-                                            fontSize: 14,
-                                            color: Color(0xFF64748B),
-                                          ),
-                                        ),
-                                      ],
-                                    ),
+                            // 浏览模式按偏移量翻页读取历史消息；否则只随messageCount重建，新消息按帧追加
+                            child: _browseMode &&
+                                    _selectedTopic != null &&
+                                    kafkaProvider.currentConnection != null
+                                ? TopicBrowserPanel(
+                                    browser: kafkaProvider.browserProvider,
+                                    bootstrapServers: kafkaProvider
+                                        .currentConnection!.bootstrapServers,
+                                    topic: _selectedTopic!,
                                   )
-                                : ListView.builder(
-                                    reverse: false,
-                                    itemCount: consumerProvider.messages.length,
-                                    physics:
-                                        const AlwaysScrollableScrollPhysics(),
-                                    itemBuilder: (context, index) {
-                                      final message =
-                                          consumerProvider.messages[index];
-                                      // 添加调试日志
-                                      print(
-                                          'ConsumerScreen: Rendering message at index $index: ${message['content']?.toString().substring(0, 50)}...');
-                                      final isJson =
-                                          message['isJson'] as bool? ?? false;
-                                      final formattedContent =
-                                          message['formattedContent']
-                                                  as String? ??
-                                              '';
-
-                                      return Container(
-                                        margin:
-                                            const EdgeInsets.only(bottom: 16),
-                                        padding: const EdgeInsets.all(16),
-                                        decoration: BoxDecoration(
-                                          color: const Color(0xFFF8FAFC),
-                                          borderRadius:
-                                              BorderRadius.circular(8),
-                                          border: Border.all(
-                                              color: const Color(0xFFE2E8F0),
-                                              width: 1),
-                                        ),
-                                        child: Column(
-                                          crossAxisAlignment:
-                                              CrossAxisAlignment.stretch,
-                                          children: [
-                                            // 消息元数据
-                                            Container(
-                                              padding:
-                                                  const EdgeInsets.symmetric(
-                                                      horizontal: 12,
-                                                      vertical: 8),
-                                              decoration: BoxDecoration(
-                                                color: const Color(0xFFEFF6FF),
-                                                borderRadius:
-                                                    BorderRadius.circular(6),
-                                              ),
-                                              child: Wrap(
-                                                spacing: 16,
-                                                runSpacing: 8,
-                                                children: [
-                                                  _MetaItem(
-                                                    label: 'Partition',
-                                                    value: message['partition']
-                                                            ?.toString() ??
-                                                        'N/A',
+                                : ValueListenableBuilder<int>(
+                                  valueListenable: consumerProvider.messageCount,
+                                  builder: (context, messageCount, child) {
+                                    return consumerProvider.messages.isEmpty
+                                        ? Center(
+                                            child: Column(
+                                              mainAxisAlignment:
+                                                  MainAxisAlignment.center,
+                                              children: [
+                                                Container(
+                                                  width: 80,
+                                                  height: 80,
+                                                  decoration: BoxDecoration(
+                                                    color: const Color(0xFFF1F5F9),
+                                                    borderRadius:
+                                                        BorderRadius.circular(16),
                                                   ),
-                                                  _MetaItem(
-                                                    label: 'Offset',
-                                                    value: message['offset']
-                                                            ?.toString() ??
-                                                        'N/A',
+                                                  child: const Icon(
+                                                    Icons.email_outlined,
+                                                    size: 48,
+                                                    color: Color(0xFF94A3B8),
                                                   ),
-                                                  _MetaItem(
-                                                    label: 'Timestamp',
-                                                    value: _formatTimestamp(
-                                                        message['timestamp']
-                                                                as int? ??
-                                                            0),
+                                                ),
+                                                const SizedBox(height: 16),
+                                                Text(
+                                                  consumerProvider.isConsuming
+                                                      ? 'Waiting for messages...'
+                                                      : 'No messages yet. Click "Start Consuming" to begin.',
+                                                  textAlign: TextAlign.center,
+                                                  style: const TextStyle(
+                                                    fontSize: 14,
+                                                    color: Color(0xFF64748B),
                                                   ),
-                                                  if (message['key'] != null &&
-                                                      message['key']
-                                                          .toString()
-                                                          .isNotEmpty) ...[
-                                                    _MetaItem(
-                                                      label: 'Key',
-                                                      value: message['key']
-                                                              ?.toString() ??
-                                                          'N/A',
-                                                    ),
-                                                  ],
-                                                ],
-                                              ),
+                                                ),
+                                              ],
                                             ),
-                                            const SizedBox(height: 12),
+                                          )
+                                        : ListView.builder(
+                                            reverse: false,
+                                            itemCount: messageCount,
+                                            physics:
+                                                const AlwaysScrollableScrollPhysics(),
+                                            itemBuilder: (context, index) {
+                                              final message =
+                                                  consumerProvider.messages[index];
+                                              // 只为实际渲染的行做格式化
+                                              final processed = consumerProvider
+                                                  .formattedContentFor(message);
+                                              final payloadType = consumerProvider
+                                                  .payloadTypeOf(message);
+                                              // 结构化和二进制内容用等宽字体
+                                              final useMonospace =
+                                                  payloadType != KafkaPayloadType.text &&
+                                                      payloadType !=
+                                                          KafkaPayloadType.empty;
+                                              final formattedContent =
+                                                  processed['formattedContent']
+                                                          as String? ??
+                                                      '';
 
-                                            // 消息内容和复制按钮
-                                            Column(
-                                              crossAxisAlignment:
-                                                  CrossAxisAlignment.start,
-                                              children: [
-                                                // 复制按钮
-                                                Align(
-                                                  alignment:
-                                                      Alignment.centerRight,
-                                                  child: TextButton.icon(
-                                                    onPressed: () async {
-                                                      await Clipboard.setData(
-                                                          ClipboardData(
-                                                              text:
-                                                                  formattedContent));
-                                                      if (context.mounted) {
-                                                        ScaffoldMessenger.of(
-                                                                context)
-                                                            .showSnackBar(
-                                                          SnackBar(
-                                                            content: const Text(
-                                                                'Message copied to clipboard'),
-                                                            backgroundColor:
-                                                                const Color(
-                                                                    0xFF10B981),
-                                                            duration:
-                                                                const Duration(
-                                                                    seconds: 2),
+                                              return Container(
+                                                margin:
+                                                    const EdgeInsets.only(bottom: 16),
+                                                padding: const EdgeInsets.all(16),
+                                                decoration: BoxDecoration(
+                                                  color: const Color(0xFFF8FAFC),
+                                                  borderRadius:
+                                                      BorderRadius.circular(8),
+                                                  border: Border.all(
+                                                      color: const Color(0xFFE2E8F0),
+                                                      width: 1),
+                                                ),
+                                                child: Column(
+                                                  crossAxisAlignment:
+                                                      CrossAxisAlignment.stretch,
+                                                  children: [
+                                                    // 消息元数据
+                                                    Container(
+                                                      padding:
+                                                          const EdgeInsets.symmetric(
+                                                              horizontal: 12,
+                                                              vertical: 8),
+                                                      decoration: BoxDecoration(
+                                                        color: const Color(0xFFEFF6FF),
+                                                        borderRadius:
+                                                            BorderRadius.circular(6),
+                                                      ),
+                                                      child: Wrap(
+                                                        spacing: 16,
+                                                        runSpacing: 8,
+                                                        children: [
+                                                          _MetaItem(
+                                                            label: 'Partition',
+                                                            value: message['partition']
+                                                                    ?.toString() ??
+                                                                'N/A',
                                                           ),
-                                                        );
-                                                      }
-                                                    },
-                                                    icon: const Icon(Icons.copy,
-                                                        size: 16,
-                                                        color:
-                                                            Color(0xFF64748B)),
-                                                    label: const Text('Copy',
-                                                        style: TextStyle(
-                                                            color: Color(
-                                                                0xFF64748B),
-                                                            fontSize: 12)),
-                                                    style: TextButton.styleFrom(
-                                                      padding: const EdgeInsets
-                                                          .symmetric(
-                                                          horizontal: 12,
-                                                          vertical: 4),
-                                                      backgroundColor:
-                                                          const Color(
-                                                              0xFFF1F5F9),
-                                                      shape:
-                                                          RoundedRectangleBorder(
-                                                              borderRadius:
-                                                                  BorderRadius
-                                                                      .circular(
-                                                                          4)),
+                                                          _MetaItem(
+                                                            label: 'Offset',
+                                                            value: message['offset']
+                                                                    ?.toString() ??
+                                                                'N/A',
+                                                          ),
+                                                          _MetaItem(
+                                                            label: 'Timestamp',
+                                                            value: _formatTimestamp(
+                                                                message['timestamp']
+                                                                        as int? ??
+                                                                    0),
+                                                          ),
+                                                          _MetaItem(
+                                                            label: 'Type',
+                                                            value:
+                                                                KafkaPayloadType.name(
+                                                                    payloadType),
+                                                          ),
+                                                          if ((message['schemaId']
+                                                                      as int? ??
+                                                                  -1) >=
+                                                              0)
+                                                            _MetaItem(
+                                                              label: 'Schema ID',
+                                                              value: message['schemaId']
+                                                                  .toString(),
+                                                            ),
+                                                          if (message['key'] != null &&
+                                                              message['key']
+                                                                  .toString()
+                                                                  .isNotEmpty) ...[
+                                                            _MetaItem(
+                                                              label: 'Key',
+                                                              value: message['key']
+                                                                      ?.toString() ??
+                                                                  'N/A',
+                                                            ),
+                                                          ],
+                                                        ],
+                                                      ),
                                                     ),
-                                                  ),
-                                                ),
-                                                const SizedBox(height: 8),
+                                                    const SizedBox(height: 12),
 
-                                                // 消息内容
-                                                Container(
-                                                  padding:
-                                                      const EdgeInsets.all(12),
-                                                  decoration: BoxDecoration(
-                                                    color: Colors.white,
-                                                    borderRadius:
-                                                        BorderRadius.circular(
-                                                            6),
-                                                    border: Border.all(
-                                                        color: const Color(
-                                                            0xFFE2E8F0),
-                                                        width: 1),
-                                                  ),
-                                                  child: ConstrainedBox(
-                                                    constraints:
-                                                        const BoxConstraints(
-                                                            maxHeight: 300),
-                                                    child:
-                                                        SingleChildScrollView(
-                                                      child: Text(
-                                                        formattedContent,
-                                                        style: TextStyle(
-                                                          fontSize: 14,
-                                                          color:
-                                                              Color(0xFF374151),
-                                                          fontFamily: isJson
-                                                              ? 'Monaco'
-                                                              : null,
+                                                    // 消息内容和复制按钮
+                                                    Column(
+                                                      crossAxisAlignment:
+                                                          CrossAxisAlignment.start,
+                                                      children: [
+                                                        // 展开和复制按钮
+                                                        Row(
+                                                          mainAxisAlignment: MainAxisAlignment.end,
+                                                          children: [
+                                                            if (consumerProvider.isTruncated(message)) ...[
+                                                              TextButton.icon(
+                                                                onPressed: () =>
+                                                                    consumerProvider.toggleExpanded(message),
+                                                                icon: Icon(
+                                                                    consumerProvider.isExpanded(message)
+                                                                        ? Icons.unfold_less
+                                                                        : Icons.unfold_more,
+                                                                    size: 16,
+                                                                    color: const Color(0xFF64748B)),
+                                                                label: Text(
+                                                                    consumerProvider.isExpanded(message)
+                                                                        ? 'Show Preview'
+                                                                        : 'Show Full (${_formatBytes(message['contentLength'] as int? ?? 0)})',
+                                                                    style: const TextStyle(
+                                                                        color: Color(0xFF64748B), fontSize: 12)),
+                                                                style: TextButton.styleFrom(
+                                                                  padding: const EdgeInsets.symmetric(
+                                                                      horizontal: 12, vertical: 4),
+                                                                  backgroundColor: const Color(0xFFF1F5F9),
+                                                                  shape: RoundedRectangleBorder(
+                                                                      borderRadius: BorderRadius.circular(4)),
+                                                                ),
+                                                              ),
+                                                              const SizedBox(width: 8),
+                                                            ],
+                                                            // 复制按钮（被截断的消息复制完整内容）
+                                                            TextButton.icon(
+                                                              onPressed: () async {
+                                                                await Clipboard.setData(ClipboardData(
+                                                                    text: consumerProvider.copyTextFor(message)));
+                                                                if (context.mounted) {
+                                                                  ScaffoldMessenger.of(context).showSnackBar(
+                                                                    const SnackBar(
+                                                                      content: Text('Message copied to clipboard'),
+                                                                      backgroundColor: Color(0xFF10B981),
+                                                                      duration: Duration(seconds: 2),
+                                                                    ),
+                                                                  );
+                                                                }
+                                                              },
+                                                              icon: const Icon(Icons.copy,
+                                                                  size: 16, color: Color(0xFF64748B)),
+                                                              label: const Text('Copy',
+                                                                  style: TextStyle(
+                                                                      color: Color(0xFF64748B), fontSize: 12)),
+                                                              style: TextButton.styleFrom(
+                                                                padding: const EdgeInsets.symmetric(
+                                                                    horizontal: 12, vertical: 4),
+                                                                backgroundColor: const Color(0xFFF1F5F9),
+                                                                shape: RoundedRectangleBorder(
+                                                                    borderRadius: BorderRadius.circular(4)),
+                                                              ),
+                                                            ),
+                                                          ],
                                                         ),
-                                                      ),
+                                                        const SizedBox(height: 8),
+
+                                                        // 消息内容
+                                                        Container(
+                                                          padding:
+                                                              const EdgeInsets.all(12),
+                                                          decoration: BoxDecoration(
+                                                            color: Colors.white,
+                                                            borderRadius:
+                                                                BorderRadius.circular(
+                                                                    6),
+                                                            border: Border.all(
+                                                                color: const Color(
+                                                                    0xFFE2E8F0),
+                                                                width: 1),
+                                                          ),
+                                                          child: ConstrainedBox(
+                                                            constraints:
+                                                                const BoxConstraints(
+                                                                    maxHeight: 300),
+                                                            child:
+                                                                SingleChildScrollView(
+                                                              child: Text(
+                                                                formattedContent,
+                                                                style: TextStyle(
+                                                                  fontSize: 14,
+                                                                  color:
+                                                                      Color(0xFF374151),
+                                                                  fontFamily:
+                                                                      useMonospace
+                                                                          ? 'Monaco'
+                                                                          : null,
+                                                                ),
+                                                              ),
+                                                            ),
+                                                          ),
+                                                        ),
+                                                      ],
                                                     ),
-                                                  ),
+                                                  ],
                                                 ),
-                                              ],
-                                            ),
-                                          ],
-                                        ),
-                                      );
-                                    },
-                                  ),
+                                              );
+                                            },
+                                          );
+                                  },
+                                ),
                           ),
                         ],
                       ),
@@ -1067,6 +1260,12 @@ class _ConsumerScreenState extends State<ConsumerScreen> {
     }
   }
 
+  String _formatBytes(int bytes) {
+    if (bytes < 1024) return '$bytes B';
+    if (bytes < 1024 * 1024) return '${(bytes / 1024).toStringAsFixed(1)} KB';
+    return '${(bytes / (1024 * 1024)).toStringAsFixed(1)} MB';
+  }
+
   String _formatTimestamp(int timestamp) {
     final date = DateTime.fromMillisecondsSinceEpoch(timestamp);
     return '${date.toLocal().toString().substring(0, 19)}';
@@ -1189,6 +1388,11 @@ class _ConsumerScreenState extends State<ConsumerScreen> {
         format: _autoSaveFormat,
       );
 
+      // 设置Schema Registry
+      kafkaProvider.consumerProvider.setSchemaRegistryConfig(
+        registryUrl: _schemaRegistryController.text.trim(),
+      );
+
       try {
         // 开始消费（这会立即更新isConsuming状态）
         await kafkaProvider.consumerProvider
@@ -1,6 +1,7 @@
 import 'package:flutter/material.dart';
 import 'package:provider/provider.dart';
 import '../providers/kafka_provider.dart';
+import '../models/topic_model.dart';
 import '../widgets/topic_details_card.dart';
 
 class TopicListScreen extends StatefulWidget {
@@ -12,6 +13,20 @@ class TopicListScreen extends StatefulWidget {
 
 class _TopicListScreenState extends State<TopicListScreen> {
   String? _selectedTopic;
+  final TextEditingController _searchController = TextEditingController();
+
+  @override
+  void initState() {
+    super.initState();
+    final query = Provider.of<KafkaProvider>(context, listen: false).topicQuery;
+    _searchController.text = query;
+  }
+
+  @override
+  void dispose() {
+    _searchController.dispose();
+    super.dispose();
+  }
 
   @override
   Widget build(BuildContext context) {
@@ -22,7 +37,6 @@ class _TopicListScreenState extends State<TopicListScreen> {
     print(
         '🔍 TopicListScreen: Current connection: ${kafkaProvider.currentConnection}');
     print('🔍 TopicListScreen: Topics count: ${kafkaProvider.topics.length}');
-    print('🔍 TopicListScreen: Topics: ${kafkaProvider.topics}');
 
     // 确保有主题数据
     if (kafkaProvider.topics.isEmpty) {
@@ -125,7 +139,8 @@ class _TopicListScreenState extends State<TopicListScreen> {
                   child: Container(
                     color: const Color(0xFFF8FAFC),
                     padding: const EdgeInsets.all(16),
-                    child: ListView(
+                    child: Column(
+                      crossAxisAlignment: CrossAxisAlignment.stretch,
                       children: [
                         // 添加一个标题
                         const Text(
@@ -137,67 +152,86 @@ class _TopicListScreenState extends State<TopicListScreen> {
                           ),
                           textAlign: TextAlign.center,
                         ),
-                        const SizedBox(height: 20),
-                        // 主题列表
-                        for (int index = 0;
-                            index < kafkaProvider.topics.length;
-                            index++)
-                          Column(
-                            children: [
-                              Container(
-                                decoration: BoxDecoration(
-                                  color: _selectedTopic ==
-                                          kafkaProvider.topics[index]
-                                      ? const Color(0xFFEFF6FF)
-                                      : Colors.white,
-                                  borderRadius: BorderRadius.circular(8),
-                                  border: Border.all(
-                                    color: _selectedTopic ==
-                                            kafkaProvider.topics[index]
-                                        ? const Color(0xFF3B82F6)
-                                        : Colors.transparent,
-                                    width: 2,
+                        const SizedBox(height: 12),
+                        // 主题搜索（原生索引，边输入边过滤）
+                        TextField(
+                          controller: _searchController,
+                          onChanged: kafkaProvider.searchTopics,
+                          decoration: InputDecoration(
+                            hintText: 'Search topics',
+                            prefixIcon: const Icon(Icons.search, size: 20),
+                            suffixIcon: kafkaProvider.topicQuery.isEmpty
+                                ? null
+                                : IconButton(
+                                    icon: const Icon(Icons.clear, size: 18),
+                                    onPressed: () {
+                                      _searchController.clear();
+                                      kafkaProvider.searchTopics('');
+                                    },
                                   ),
+                            isDense: true,
+                            filled: true,
+                            fillColor: Colors.white,
+                            border: OutlineInputBorder(
+                              borderRadius: BorderRadius.circular(8),
+                            ),
+                          ),
+                        ),
+                        const SizedBox(height: 8),
+                        Text(
+                          kafkaProvider.topicQuery.isEmpty
+                              ? '${kafkaProvider.topics.length} topics'
+                              : '${kafkaProvider.visibleTopicCount} of ${kafkaProvider.topics.length} topics',
+                          style: const TextStyle(
+                            fontSize: 12,
+                            color: Color(0xFF64748B),
+                          ),
+                        ),
+                        const SizedBox(height: 12),
+                        // 集群概览统计进度
+                        if (kafkaProvider.isLoadingOverview)
+                          Padding(
+                            padding: const EdgeInsets.only(bottom: 12),
+                            child: Column(
+                              children: [
+                                LinearProgressIndicator(
+                                  value: kafkaProvider.overviewTopicCount > 0
+                                      ? kafkaProvider.topicOverviews.length /
+                                          kafkaProvider.overviewTopicCount
+                                      : null,
                                 ),
-                                child: ListTile(
-                                  title: Text(
-                                    kafkaProvider.topics[index],
-                                    style: TextStyle(
-                                      fontSize: 14,
-                                      fontWeight: FontWeight.w500,
-                                      color: _selectedTopic ==
-                                              kafkaProvider.topics[index]
-                                          ? const Color(0xFF1E40AF)
-                                          : const Color(0xFF1E293B),
-                                    ),
-                                    overflow: TextOverflow.ellipsis,
+                                const SizedBox(height: 4),
+                                Text(
+                                  'Overview ${kafkaProvider.topicOverviews.length} / ${kafkaProvider.overviewTopicCount}',
+                                  style: const TextStyle(
+                                    fontSize: 12,
+                                    color: Color(0xFF64748B),
                                   ),
-                                  onTap: () {
-                                    setState(() {
-                                      _selectedTopic =
-                                          kafkaProvider.topics[index];
-                                    });
-                                  },
-                                  selected: _selectedTopic ==
-                                      kafkaProvider.topics[index],
-                                  selectedColor: const Color(0xFF1E40AF),
-                                  selectedTileColor: const Color(0xFFEFF6FF),
                                 ),
-                              ),
-                              const SizedBox(height: 8),
-                            ],
-                          ),
-                        // 如果没有主题，显示提示
-                        if (kafkaProvider.topics.isEmpty)
-                          const Center(
-                            child: Text(
-                              'No topics available',
-                              style: TextStyle(
-                                fontSize: 16,
-                                color: Color(0xFF64748B),
-                              ),
+                              ],
                             ),
                           ),
+                        // 主题列表（按需构建可见的行）
+                        Expanded(
+                          child: kafkaProvider.visibleTopicCount == 0
+                              ? Center(
+                                  child: Text(
+                                    kafkaProvider.topics.isEmpty
+                                        ? 'No topics available'
+                                        : 'No matching topics',
+                                    style: const TextStyle(
+                                      fontSize: 16,
+                                      color: Color(0xFF64748B),
+                                    ),
+                                  ),
+                                )
+                              : ListView.builder(
+                                  itemCount: kafkaProvider.visibleTopicCount,
+                                  itemBuilder: (context, index) =>
+                                      _buildTopicTile(kafkaProvider,
+                                          kafkaProvider.visibleTopicAt(index)),
+                                ),
+                        ),
                       ],
                     ),
                   ),
@@ -280,6 +314,102 @@ class _TopicListScreenState extends State<TopicListScreen> {
     );
   }
 
+  Widget _buildTopicTile(KafkaProvider kafkaProvider, String topic) {
+    final isSelected = _selectedTopic == topic;
+    return Padding(
+      padding: const EdgeInsets.only(bottom: 8),
+      child: Container(
+        decoration: BoxDecoration(
+          color: isSelected ? const Color(0xFFEFF6FF) : Colors.white,
+          borderRadius: BorderRadius.circular(8),
+          border: Border.all(
+            color: isSelected ? const Color(0xFF3B82F6) : Colors.transparent,
+            width: 2,
+          ),
+        ),
+        child: ListTile(
+          title: Text(
+            topic,
+            style: TextStyle(
+              fontSize: 14,
+              fontWeight: FontWeight.w500,
+              color: isSelected
+                  ? const Color(0xFF1E40AF)
+                  : const Color(0xFF1E293B),
+            ),
+            overflow: TextOverflow.ellipsis,
+          ),
+          subtitle: _buildOverview(kafkaProvider.topicOverviews[topic]),
+          onTap: () {
+            setState(() {
+              _selectedTopic = topic;
+            });
+          },
+          selected: isSelected,
+          selectedColor: const Color(0xFF1E40AF),
+          selectedTileColor: const Color(0xFFEFF6FF),
+        ),
+      ),
+    );
+  }
+
+  // 主题列表中的概览统计：分区、副本、消息数、保留时间和清理策略
+  Widget? _buildOverview(TopicOverview? overview) {
+    if (overview == null) {
+      return null;
+    }
+    final config = overview.config;
+    final parts = <String>[
+      '${overview.partitions} partitions × ${overview.replicationFactor}',
+      overview.messages >= 0
+          ? '${_formatCount(overview.messages)} msgs'
+          : 'msgs: n/a',
+      if (config != null) _formatRetention(config.retentionMs),
+      if (config != null) config.cleanupPolicy,
+      if (overview.underReplicated > 0)
+        '${overview.underReplicated} under-replicated',
+    ];
+    return Text(
+      parts.join(' · '),
+      style: TextStyle(
+        fontSize: 12,
+        color: overview.underReplicated > 0
+            ? const Color(0xFFDC2626)
+            : config != null && config.isCompacted
+                ? const Color(0xFF7C3AED)
+                : const Color(0xFF64748B),
+      ),
+      overflow: TextOverflow.ellipsis,
+    );
+  }
+
+  String _formatCount(int count) {
+    if (count >= 1000000000) {
+      return '${(count / 1000000000).toStringAsFixed(1)}B';
+    }
+    if (count >= 1000000) {
+      return '${(count / 1000000).toStringAsFixed(1)}M';
+    }
+    if (count >= 1000) {
+      return '${(count / 1000).toStringAsFixed(1)}K';
+    }
+    return '$count';
+  }
+
+  String _formatRetention(int retentionMs) {
+    if (retentionMs < 0) {
+      return 'Retention: forever';
+    }
+    final duration = Duration(milliseconds: retentionMs);
+    if (duration.inDays >= 1 && duration.inHours % 24 == 0) {
+      return 'Retention: ${duration.inDays}d';
+    }
+    if (duration.inHours >= 1) {
+      return 'Retention: ${duration.inHours}h';
+    }
+    return 'Retention: ${duration.inMinutes}m';
+  }
+
   Future<void> _disconnect(BuildContext context) async {
     final kafkaProvider = Provider.of<KafkaProvider>(context, listen: false);
     try {
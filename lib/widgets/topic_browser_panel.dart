@@ -0,0 +1,255 @@
+import 'package:flutter/material.dart';
+import 'package:flutter/services.dart';
+
+import '../providers/topic_browser_provider.dart';
+
+// 历史消息浏览面板：固定行高的列表，滚动时把可见行范围报告给TopicBrowserProvider，
+// 由它按需加载上一页/下一页；前面插入或淘汰页时按行高修正滚动位置，保持当前行不动。
+class TopicBrowserPanel extends StatefulWidget {
+  final TopicBrowserProvider browser;
+  final String bootstrapServers;
+  final String topic;
+
+  const TopicBrowserPanel({
+    super.key,
+    required this.browser,
+    required this.bootstrapServers,
+    required this.topic,
+  });
+
+  @override
+  State<TopicBrowserPanel> createState() => _TopicBrowserPanelState();
+}
+
+class _TopicBrowserPanelState extends State<TopicBrowserPanel> {
+  static const double _rowExtent = 56;
+  final ScrollController _scrollController = ScrollController();
+  bool _fromEnd = true;
+
+  @override
+  void initState() {
+    super.initState();
+    widget.browser.onRowsShifted = _onRowsShifted;
+    _open();
+  }
+
+  @override
+  void didUpdateWidget(TopicBrowserPanel oldWidget) {
+    super.didUpdateWidget(oldWidget);
+    if (oldWidget.topic != widget.topic ||
+        oldWidget.bootstrapServers != widget.bootstrapServers) {
+      _open();
+    }
+  }
+
+  @override
+  void dispose() {
+    widget.browser.onRowsShifted = null;
+    widget.browser.close();
+    _scrollController.dispose();
+    super.dispose();
+  }
+
+  Future<void> _open() async {
+    try {
+      await widget.browser
+          .open(widget.bootstrapServers, widget.topic, fromEnd: _fromEnd);
+      if (_scrollController.hasClients) {
+        _scrollController.jumpTo(0);
+      }
+    } catch (e) {
+      if (mounted) {
+        ScaffoldMessenger.of(context).showSnackBar(
+          SnackBar(
+            content: Text('Failed to browse topic: $e'),
+            backgroundColor: Colors.red,
+          ),
+        );
+      }
+    }
+  }
+
+  // 前面多了（或少了）rows行，下一帧按行高平移，保持看到的内容不变
+  void _onRowsShifted(int rows) {
+    WidgetsBinding.instance.addPostFrameCallback((_) {
+      if (!_scrollController.hasClients) {
+        return;
+      }
+      final position = _scrollController.position;
+      final target = (position.pixels + rows * _rowExtent)
+          .clamp(position.minScrollExtent, position.maxScrollExtent);
+      _scrollController.jumpTo(target);
+    });
+  }
+
+  bool _onScroll(ScrollNotification notification) {
+    final metrics = notification.metrics;
+    final first = (metrics.pixels / _rowExtent).floor();
+    final last =
+        ((metrics.pixels + metrics.viewportDimension) / _rowExtent).floor();
+    widget.browser.onVisibleRange(first < 0 ? 0 : first, last);
+    return false;
+  }
+
+  void _showMessage(Map<String, dynamic> message) {
+    final content = widget.browser.fullContentFor(message);
+    showDialog(
+      context: context,
+      builder: (context) => AlertDialog(
+        title: Text(
+            'Partition ${message['partition']} · Offset ${message['offset']}'),
+        content: SizedBox(
+          width: 640,
+          child: SingleChildScrollView(
+            child: SelectableText(
+              content,
+              style: const TextStyle(fontSize: 13, fontFamily: 'Monaco'),
+            ),
+          ),
+        ),
+        actions: [
+          TextButton(
+            onPressed: () => Clipboard.setData(ClipboardData(text: content)),
+            child: const Text('Copy'),
+          ),
+          TextButton(
+            onPressed: () => Navigator.of(context).pop(),
+            child: const Text('Close'),
+          ),
+        ],
+      ),
+    );
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    return AnimatedBuilder(
+      animation: widget.browser,
+      builder: (context, child) {
+        final browser = widget.browser;
+        final rows = browser.rows;
+
+        return Column(
+          crossAxisAlignment: CrossAxisAlignment.stretch,
+          children: [
+            Row(
+              children: [
+                ChoiceChip(
+                  label: const Text('Newest'),
+                  selected: _fromEnd,
+                  onSelected: (_) {
+                    setState(() => _fromEnd = true);
+                    _open();
+                  },
+                ),
+                const SizedBox(width: 8),
+                ChoiceChip(
+                  label: const Text('Oldest'),
+                  selected: !_fromEnd,
+                  onSelected: (_) {
+                    setState(() => _fromEnd = false);
+                    _open();
+                  },
+                ),
+                const Spacer(),
+                if (browser.isLoading)
+                  const SizedBox(
+                    width: 16,
+                    height: 16,
+                    child: CircularProgressIndicator(strokeWidth: 2),
+                  ),
+                const SizedBox(width: 8),
+                Text(
+                  '${rows.length} loaded'
+                  '${browser.hasOlder ? ' · older ↑' : ''}'
+                  '${browser.hasNewer ? ' · newer ↓' : ''}',
+                  style: const TextStyle(
+                    fontSize: 12,
+                    color: Color(0xFF64748B),
+                  ),
+                ),
+              ],
+            ),
+            const SizedBox(height: 12),
+            Expanded(
+              child: rows.isEmpty
+                  ? Center(
+                      child: Text(
+                        browser.isLoading
+                            ? 'Loading messages...'
+                            : browser.error ?? 'No messages in this topic.',
+                        style: const TextStyle(
+                          fontSize: 14,
+                          color: Color(0xFF64748B),
+                        ),
+                      ),
+                    )
+                  : NotificationListener<ScrollNotification>(
+                      onNotification: _onScroll,
+                      child: ListView.builder(
+                        controller: _scrollController,
+                        itemExtent: _rowExtent,
+                        itemCount: rows.length,
+                        itemBuilder: (context, index) {
+                          final message = rows[index];
+                          final time = DateTime.fromMillisecondsSinceEpoch(
+                              message['timestamp'] as int);
+                          return InkWell(
+                            onTap: () => _showMessage(message),
+                            child: Container(
+                              padding:
+                                  const EdgeInsets.symmetric(horizontal: 12),
+                              decoration: const BoxDecoration(
+                                border: Border(
+                                  bottom: BorderSide(
+                                      color: Color(0xFFE2E8F0), width: 1),
+                                ),
+                              ),
+                              child: Row(
+                                children: [
+                                  SizedBox(
+                                    width: 160,
+                                    child: Text(
+                                      'P${message['partition']} · ${message['offset']}',
+                                      style: const TextStyle(
+                                        fontSize: 12,
+                                        fontWeight: FontWeight.w600,
+                                        color: Color(0xFF065F46),
+                                      ),
+                                    ),
+                                  ),
+                                  SizedBox(
+                                    width: 180,
+                                    child: Text(
+                                      time.toString(),
+                                      style: const TextStyle(
+                                        fontSize: 12,
+                                        color: Color(0xFF64748B),
+                                      ),
+                                    ),
+                                  ),
+                                  Expanded(
+                                    child: Text(
+                                      message['content'] as String,
+                                      maxLines: 2,
+                                      overflow: TextOverflow.ellipsis,
+                                      style: const TextStyle(
+                                        fontSize: 13,
+                                        color: Color(0xFF374151),
+                                      ),
+                                    ),
+                                  ),
+                                ],
+                              ),
+                            ),
+                          );
+                        },
+                      ),
+                    ),
+            ),
+          ],
+        );
+      },
+    );
+  }
+}
@@ -550,6 +550,17 @@ class _TopicDetailsCardState extends State<TopicDetailsCard> {
                               ),
                               numeric: false,
                             ),
+                            DataColumn(
+                              label: Text(
+                                'Source',
+                                style: TextStyle(
+                                  fontWeight: FontWeight.bold,
+                                  color: Color(0xFF475569),
+                                  fontSize: 12,
+                                ),
+                              ),
+                              numeric: false,
+                            ),
                           ],
                           rows: configParams.map((param) {
                             return DataRow(
@@ -560,9 +571,20 @@ class _TopicDetailsCardState extends State<TopicDetailsCard> {
                                       fontSize: 13, color: Color(0xFF1E293B)),
                                 )),
                                 DataCell(Text(
-                                  param.value,
+                                  param.isSensitive ? '******' : param.value,
+                                  style: TextStyle(
+                                      fontSize: 13,
+                                      // 使用默认值的参数淡化显示，突出被覆盖的参数
+                                      color: param.isDefault
+                                          ? const Color(0xFF94A3B8)
+                                          : const Color(0xFF1E293B)),
+                                )),
+                                DataCell(Text(
+                                  param.isReadOnly
+                                      ? '${param.source} (read-only)'
+                                      : param.source,
                                   style: const TextStyle(
-                                      fontSize: 13, color: Color(0xFF1E293B)),
+                                      fontSize: 13, color: Color(0xFF64748B)),
                                 )),
                               ],
                             );
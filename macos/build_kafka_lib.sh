@@ -19,7 +19,7 @@ echo "Compiling with flags: $LIBRDKAFKA_CFLAGS"
 echo "Linking with libs: $LIBRDKAFKA_LIBS"
 
 # 编译动态库
-gcc -I. -L/usr/local/lib -L/opt/homebrew/lib $LIBRDKAFKA_CFLAGS -shared -fPIC -o libkafka_client.dylib kafka_client.c $LIBRDKAFKA_LIBS
+gcc -I. -L/usr/local/lib -L/opt/homebrew/lib $LIBRDKAFKA_CFLAGS -shared -fPIC -o libkafka_client.dylib *.c $LIBRDKAFKA_LIBS -lpthread -lz -lcurl
 
 if [ $? -eq 0 ]; then
     echo "Successfully built libkafka_client.dylib"
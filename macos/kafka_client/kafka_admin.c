@@ -0,0 +1,193 @@
+#include "kafka_internal.h"
+
+// 共享管理客户端：每个集群（bootstrap servers）保持一个长连接，
+// 元数据缓存挂在这个连接上，所有Provider的元数据和Admin API查询都复用它，
+// 不再为每次查询重新建立连接、握手和拉取元数据。
+
+typedef struct AdminEntry {
+    char* bootstrap_servers;
+    KafkaProducer* client;
+    int32_t refs;
+    struct AdminEntry* next;
+} AdminEntry;
+
+static pthread_mutex_t admin_lock = PTHREAD_MUTEX_INITIALIZER;
+static AdminEntry* admin_entries = NULL;
+
+// 获取集群共享的管理客户端
+KafkaClientHandle acquire_kafka_admin_client(const char* bootstrap_servers) {
+    if (!bootstrap_servers) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&admin_lock);
+    for (AdminEntry* e = admin_entries; e; e = e->next) {
+        if (strcmp(e->bootstrap_servers, bootstrap_servers) == 0) {
+            e->refs++;
+            pthread_mutex_unlock(&admin_lock);
+            return e->client;
+        }
+    }
+
+    // rd_kafka_new不会阻塞等待连接，可以在锁内创建
+    AdminEntry* entry = calloc(1, sizeof(AdminEntry));
+    if (entry) {
+        entry->bootstrap_servers = strdup(bootstrap_servers);
+        entry->client = kafka_producer_new(bootstrap_servers, "flutter-kafka-admin");
+    }
+    if (!entry || !entry->bootstrap_servers || !entry->client) {
+        KLOG_ERROR("Failed to create admin client for %s", bootstrap_servers);
+        if (entry) {
+            free(entry->bootstrap_servers);
+            if (entry->client) {
+                close_kafka_client(entry->client);
+            }
+            free(entry);
+        }
+        pthread_mutex_unlock(&admin_lock);
+        return NULL;
+    }
+
+    entry->refs = 1;
+    entry->next = admin_entries;
+    admin_entries = entry;
+    pthread_mutex_unlock(&admin_lock);
+
+    KLOG_INFO("Created shared admin client for %s", bootstrap_servers);
+    return entry->client;
+}
+
+// 异步查询执行期间持有共享管理客户端，避免Dart侧断开连接时关闭正在使用的连接
+int kafka_admin_retain(KafkaClientHandle client) {
+    int found = 0;
+    pthread_mutex_lock(&admin_lock);
+    for (AdminEntry* e = admin_entries; e; e = e->next) {
+        if (e->client == client) {
+            e->refs++;
+            found = 1;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&admin_lock);
+    return found;
+}
+
+// 释放共享管理客户端的引用
+void release_kafka_admin_client(KafkaClientHandle client) {
+    if (!client) {
+        return;
+    }
+
+    pthread_mutex_lock(&admin_lock);
+    AdminEntry** link = &admin_entries;
+    while (*link && (*link)->client != client) {
+        link = &(*link)->next;
+    }
+
+    AdminEntry* entry = *link;
+    if (!entry) {
+        pthread_mutex_unlock(&admin_lock);
+        KLOG_ERROR("release_kafka_admin_client - Unknown client %p", client);
+        return;
+    }
+    if (--entry->refs > 0) {
+        pthread_mutex_unlock(&admin_lock);
+        return;
+    }
+    *link = entry->next;
+    pthread_mutex_unlock(&admin_lock);
+
+    // 关闭连接可能需要等待，放在锁外
+    close_kafka_client(entry->client);
+    KLOG_INFO("Closed shared admin client for %s", entry->bootstrap_servers);
+    free(entry->bootstrap_servers);
+    free(entry);
+}
+
+// Admin请求批次：一组请求共用一个结果队列，等待时按事件opaque找到发起方的处理函数。
+// 各模块的查询（水位、配置、消费者组）都通过批次发出，组合查询时可以放在同一个批次里并发执行。
+
+// 批次中的一个请求，事件的opaque指向它
+struct KafkaAdminRequest {
+    KafkaAdminHandler handler;
+    void* ctx;
+    KafkaAdminRequest* next;
+};
+
+KafkaAdminBatch* kafka_admin_batch_new(rd_kafka_t* rk, int timeout_ms) {
+    KafkaAdminBatch* batch = calloc(1, sizeof(KafkaAdminBatch));
+    if (!batch) {
+        return NULL;
+    }
+    batch->queue = rd_kafka_queue_new(rk);
+    if (!batch->queue) {
+        free(batch);
+        return NULL;
+    }
+    batch->rk = rk;
+    batch->timeout_ms = timeout_ms;
+    return batch;
+}
+
+rd_kafka_AdminOptions_t* kafka_admin_batch_options(
+    KafkaAdminBatch* batch,
+    rd_kafka_admin_op_t op,
+    KafkaAdminHandler handler,
+    void* ctx) {
+    KafkaAdminRequest* request = malloc(sizeof(KafkaAdminRequest));
+    if (!request) {
+        return NULL;
+    }
+    rd_kafka_AdminOptions_t* options = rd_kafka_AdminOptions_new(batch->rk, op);
+    if (!options) {
+        free(request);
+        return NULL;
+    }
+    char errstr[256];
+    rd_kafka_AdminOptions_set_request_timeout(options, batch->timeout_ms, errstr, sizeof(errstr));
+    rd_kafka_AdminOptions_set_opaque(options, request);
+
+    request->handler = handler;
+    request->ctx = ctx;
+    request->next = batch->requests;
+    batch->requests = request;
+    batch->pending++;
+    // librdkafka保证在请求超时后投递结果事件，这里多留一些余量
+    batch->deadline_ms = kafka_monotonic_ms() + batch->timeout_ms + 1000;
+    return options;
+}
+
+int32_t kafka_admin_batch_wait(KafkaAdminBatch* batch) {
+    while (batch->pending > 0) {
+        int64_t remaining = batch->deadline_ms - kafka_monotonic_ms();
+        rd_kafka_event_t* event = remaining > 0 ? rd_kafka_queue_poll(batch->queue, (int)remaining) : NULL;
+        if (!event) {
+            KLOG_ERROR("Admin requests timed out, %d pending", batch->pending);
+            break;
+        }
+        KafkaAdminRequest* request = rd_kafka_event_opaque(event);
+        if (!request) {
+            rd_kafka_event_destroy(event);
+            continue;
+        }
+        batch->pending--;
+        request->handler(batch, event, request->ctx);
+        rd_kafka_event_destroy(event);
+    }
+    return batch->pending;
+}
+
+void kafka_admin_batch_destroy(KafkaAdminBatch* batch) {
+    if (!batch) {
+        return;
+    }
+    // 超时未完成的请求的结果事件会随队列一起丢弃
+    rd_kafka_queue_destroy(batch->queue);
+    KafkaAdminRequest* request = batch->requests;
+    while (request) {
+        KafkaAdminRequest* next = request->next;
+        free(request);
+        request = next;
+    }
+    free(batch);
+}
@@ -0,0 +1,495 @@
+#include "kafka_internal.h"
+
+// 异步查询：元数据和Admin查询放到固定大小的后台线程池中执行，完成后通过回调通知调用方，
+// Dart侧用NativeCallable.listener接收回调，UI线程不再阻塞等待broker响应。
+// 每个被接受的请求恰好回调一次；取消或超过截止时间的请求回调KAFKA_ERROR_CANCELLED或
+// KAFKA_ERROR_TIMEOUT，已经算出的结果在原生侧释放。
+
+#define ASYNC_WORKERS 4
+
+typedef struct KafkaAsyncJob KafkaAsyncJob;
+
+// 执行同步查询，返回结果和数量；error初始为KAFKA_OK
+typedef void* (*KafkaAsyncRun)(KafkaAsyncJob* job, int32_t* count, KafkaErrorCode* error);
+typedef void (*KafkaAsyncFree)(void* result, int32_t count);
+
+struct KafkaAsyncJob {
+    int64_t id;
+    KafkaClientHandle client;
+    int retained;                   // 持有共享管理客户端的引用
+    KafkaTopicIndexHandle index;    // 索引刷新持有的索引引用
+    char* servers;                  // 连接请求的bootstrap servers
+    char* topic;
+    char** topics;
+    int32_t topic_count;
+    int64_t deadline_ms;            // 0表示不限
+    int cancelled;                  // 受async_lock保护
+    KafkaAsyncRun run;
+    KafkaAsyncFree free_result;
+    KafkaAsyncCallback callback;
+    KafkaAsyncJob* next;
+};
+
+static pthread_mutex_t async_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t async_cond = PTHREAD_COND_INITIALIZER;
+static KafkaAsyncJob* async_head = NULL;
+static KafkaAsyncJob* async_tail = NULL;
+static KafkaAsyncJob* async_active[ASYNC_WORKERS];     // 各工作线程正在执行的请求
+static int32_t async_thread_count = 0;
+
+static void async_job_free(KafkaAsyncJob* job) {
+    if (job->retained) {
+        release_kafka_admin_client(job->client);
+    }
+    if (job->index) {
+        destroy_kafka_topic_index(job->index);
+    }
+    free(job->topic);
+    free(job->servers);
+    if (job->topics) {
+        for (int32_t i = 0; i < job->topic_count; i++) {
+            free(job->topics[i]);
+        }
+        free(job->topics);
+    }
+    free(job);
+}
+
+static void* async_thread(void* arg) {
+    int32_t slot = (int32_t)(intptr_t)arg;
+    for (;;) {
+        pthread_mutex_lock(&async_lock);
+        while (!async_head) {
+            pthread_cond_wait(&async_cond, &async_lock);
+        }
+        KafkaAsyncJob* job = async_head;
+        async_head = job->next;
+        if (!async_head) {
+            async_tail = NULL;
+        }
+        async_active[slot] = job;
+        pthread_mutex_unlock(&async_lock);
+
+        void* result = NULL;
+        int32_t count = 0;
+        KafkaErrorCode error = KAFKA_OK;
+        // 排队期间已经过了截止时间的请求不再执行
+        int expired = job->deadline_ms > 0 && kafka_monotonic_ms() >= job->deadline_ms;
+        if (!expired) {
+            result = job->run(job, &count, &error);
+            expired = job->deadline_ms > 0 && kafka_monotonic_ms() > job->deadline_ms;
+        }
+
+        pthread_mutex_lock(&async_lock);
+        async_active[slot] = NULL;
+        int cancelled = job->cancelled;
+        pthread_mutex_unlock(&async_lock);
+
+        if (cancelled) {
+            error = KAFKA_ERROR_CANCELLED;
+        } else if (expired) {
+            error = KAFKA_ERROR_TIMEOUT;
+        }
+        if (error != KAFKA_OK && result) {
+            job->free_result(result, count);
+            result = NULL;
+        }
+        if (error != KAFKA_OK) {
+            count = 0;
+        }
+        job->callback(job->id, error, result, count);
+        async_job_free(job);
+    }
+    return NULL;
+}
+
+static KafkaAsyncJob* async_job_new(
+    KafkaClientHandle client,
+    int64_t request_id,
+    int32_t timeout_ms,
+    KafkaAsyncCallback callback,
+    KafkaAsyncRun run,
+    KafkaAsyncFree free_result) {
+    KafkaAsyncJob* job = calloc(1, sizeof(KafkaAsyncJob));
+    if (!job) {
+        return NULL;
+    }
+    job->id = request_id;
+    job->client = client;
+    job->deadline_ms = timeout_ms > 0 ? kafka_monotonic_ms() + timeout_ms : 0;
+    job->callback = callback;
+    job->run = run;
+    job->free_result = free_result;
+    return job;
+}
+
+// 放入队列（第一次提交时启动工作线程），失败时释放job
+static KafkaErrorCode async_submit(KafkaAsyncJob* job, const char* name) {
+    pthread_mutex_lock(&async_lock);
+    while (async_thread_count < ASYNC_WORKERS) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, async_thread, (void*)(intptr_t)async_thread_count) != 0) {
+            break;
+        }
+        pthread_detach(thread);
+        async_thread_count++;
+    }
+    if (async_thread_count == 0) {
+        pthread_mutex_unlock(&async_lock);
+        KLOG_ERROR("%s - Failed to start worker threads", name);
+        async_job_free(job);
+        return KAFKA_ERROR;
+    }
+
+    // 共享管理客户端在执行期间保持打开
+    job->retained = kafka_admin_retain(job->client);
+    job->next = NULL;
+    if (async_tail) {
+        async_tail->next = job;
+    } else {
+        async_head = job;
+    }
+    async_tail = job;
+    pthread_cond_signal(&async_cond);
+    pthread_mutex_unlock(&async_lock);
+    return KAFKA_OK;
+}
+
+// 提交单主题查询
+static KafkaErrorCode async_submit_topic(
+    const char* name,
+    KafkaClientHandle client,
+    const char* topic_name,
+    int64_t request_id,
+    int32_t timeout_ms,
+    KafkaAsyncCallback callback,
+    KafkaAsyncRun run,
+    KafkaAsyncFree free_result) {
+    if (!client || !topic_name || !callback) {
+        KLOG_ERROR("%s - Invalid parameters", name);
+        return KAFKA_ERROR;
+    }
+    KafkaAsyncJob* job = async_job_new(client, request_id, timeout_ms, callback, run, free_result);
+    if (!job || !(job->topic = strdup(topic_name))) {
+        free(job);
+        return KAFKA_ERROR;
+    }
+    return async_submit(job, name);
+}
+
+// 提交多主题查询（复制主题名，调用方提交后即可释放）
+static KafkaErrorCode async_submit_topics(
+    const char* name,
+    KafkaClientHandle client,
+    const char** topics,
+    int32_t topic_count,
+    int64_t request_id,
+    int32_t timeout_ms,
+    KafkaAsyncCallback callback,
+    KafkaAsyncRun run,
+    KafkaAsyncFree free_result) {
+    if (!client || !topics || topic_count <= 0 || !callback) {
+        KLOG_ERROR("%s - Invalid parameters", name);
+        return KAFKA_ERROR;
+    }
+    KafkaAsyncJob* job = async_job_new(client, request_id, timeout_ms, callback, run, free_result);
+    if (!job) {
+        return KAFKA_ERROR;
+    }
+    job->topics = calloc(topic_count, sizeof(char*));
+    if (!job->topics) {
+        free(job);
+        return KAFKA_ERROR;
+    }
+    for (int32_t i = 0; i < topic_count; i++) {
+        job->topics[i] = strdup(topics[i]);
+        job->topic_count = i + 1;
+        if (!job->topics[i]) {
+            async_job_free(job);
+            return KAFKA_ERROR;
+        }
+    }
+    return async_submit(job, name);
+}
+
+// 各查询的执行和释放函数
+
+static void* run_topics(KafkaAsyncJob* job, int32_t* count, KafkaErrorCode* error) {
+    // 失败时get_kafka_topics不写count，以此区分“没有主题”和“查询失败”
+    *count = -1;
+    char** topics = get_kafka_topics(job->client, count);
+    if (*count < 0) {
+        *count = 0;
+        *error = KAFKA_ERROR_TOPICS;
+    }
+    return topics;
+}
+
+static void free_topics(void* result, int32_t count) {
+    free_kafka_topics((char**)result, count);
+}
+
+static void* run_topic_info(KafkaAsyncJob* job, int32_t* count, KafkaErrorCode* error) {
+    (void)count;
+    KafkaTopicDescription* desc = calloc(1, sizeof(KafkaTopicDescription));
+    if (!desc) {
+        *error = KAFKA_ERROR;
+        return NULL;
+    }
+    desc->error = get_kafka_topic_info(job->client, job->topic, &desc->partition_count, &desc->replication_factor);
+    return desc;
+}
+
+static void* run_partitions(KafkaAsyncJob* job, int32_t* count, KafkaErrorCode* error) {
+    (void)error;
+    return get_kafka_topic_partitions(job->client, job->topic, count);
+}
+
+static void free_partitions(void* result, int32_t count) {
+    free_kafka_topic_partitions((KafkaPartitionInfo*)result, count);
+}
+
+static void* run_watermarks(KafkaAsyncJob* job, int32_t* count, KafkaErrorCode* error) {
+    (void)error;
+    return get_kafka_watermarks(job->client, (const char**)job->topics, job->topic_count, count);
+}
+
+static void free_watermarks(void* result, int32_t count) {
+    free_kafka_watermarks((KafkaPartitionOffsets*)result, count);
+}
+
+static void* run_config(KafkaAsyncJob* job, int32_t* count, KafkaErrorCode* error) {
+    (void)error;
+    return get_kafka_topic_config(job->client, job->topic, count);
+}
+
+static void free_config(void* result, int32_t count) {
+    free_kafka_topic_config((KafkaConfigParam*)result, count);
+}
+
+static void* run_config_summaries(KafkaAsyncJob* job, int32_t* count, KafkaErrorCode* error) {
+    (void)error;
+    return get_kafka_topic_config_summaries(job->client, (const char**)job->topics, job->topic_count, count);
+}
+
+static void free_config_summaries(void* result, int32_t count) {
+    free_kafka_topic_config_summaries((KafkaTopicConfigSummary*)result, count);
+}
+
+static void* run_consumer_groups(KafkaAsyncJob* job, int32_t* count, KafkaErrorCode* error) {
+    (void)error;
+    return get_kafka_topic_consumer_groups(job->client, job->topic, count);
+}
+
+static void free_consumer_groups(void* result, int32_t count) {
+    free_kafka_topic_consumer_groups((KafkaConsumerGroup*)result, count);
+}
+
+static void* run_describe(KafkaAsyncJob* job, int32_t* count, KafkaErrorCode* error) {
+    (void)count;
+    KafkaTopicDescription* desc = describe_kafka_topic_full(job->client, job->topic);
+    if (!desc) {
+        *error = KAFKA_ERROR;
+    }
+    return desc;
+}
+
+static void free_description(void* result, int32_t count) {
+    (void)count;
+    free_kafka_topic_description((KafkaTopicDescription*)result);
+}
+
+static void* run_index_refresh(KafkaAsyncJob* job, int32_t* count, KafkaErrorCode* error) {
+    (void)count;
+    KafkaTopicIndexDiff* diff = refresh_kafka_topic_index(job->index, job->client);
+    if (!diff) {
+        *error = KAFKA_ERROR_TOPICS;
+    }
+    return diff;
+}
+
+static void free_index_diff(void* result, int32_t count) {
+    (void)count;
+    free_kafka_topic_index_diff((KafkaTopicIndexDiff*)result);
+}
+
+static void* run_connect(KafkaAsyncJob* job, int32_t* count, KafkaErrorCode* error) {
+    // 连接检测自己按截止时间返回，剩余时间交给它（不限时使用默认超时）
+    int32_t timeout_ms = 0;
+    if (job->deadline_ms > 0) {
+        int64_t remaining = job->deadline_ms - kafka_monotonic_ms();
+        timeout_ms = remaining > 0 ? (int32_t)remaining : 1;
+    }
+    return kafka_connect_cluster(job->servers, timeout_ms, count, error);
+}
+
+static void free_connect(void* result, int32_t count) {
+    (void)count;
+    release_kafka_admin_client(result);
+}
+
+// 异步连接集群
+KafkaErrorCode connect_kafka_cluster_async(
+    const char* bootstrap_servers,
+    int64_t request_id,
+    int32_t timeout_ms,
+    KafkaAsyncCallback callback) {
+    if (!bootstrap_servers || !callback) {
+        KLOG_ERROR("connect_kafka_cluster_async - Invalid parameters");
+        return KAFKA_ERROR;
+    }
+    KafkaAsyncJob* job = async_job_new(NULL, request_id, timeout_ms, callback, run_connect, free_connect);
+    if (!job || !(job->servers = strdup(bootstrap_servers))) {
+        free(job);
+        return KAFKA_ERROR;
+    }
+    return async_submit(job, "connect_kafka_cluster_async");
+}
+
+// 异步获取主题列表
+KafkaErrorCode get_kafka_topics_async(
+    KafkaClientHandle client,
+    int64_t request_id,
+    int32_t timeout_ms,
+    KafkaAsyncCallback callback) {
+    if (!client || !callback) {
+        KLOG_ERROR("get_kafka_topics_async - Invalid parameters");
+        return KAFKA_ERROR;
+    }
+    KafkaAsyncJob* job = async_job_new(client, request_id, timeout_ms, callback, run_topics, free_topics);
+    if (!job) {
+        return KAFKA_ERROR;
+    }
+    return async_submit(job, "get_kafka_topics_async");
+}
+
+// 异步获取主题基本信息
+KafkaErrorCode get_kafka_topic_info_async(
+    KafkaClientHandle client,
+    const char* topic_name,
+    int64_t request_id,
+    int32_t timeout_ms,
+    KafkaAsyncCallback callback) {
+    return async_submit_topic("get_kafka_topic_info_async", client, topic_name,
+        request_id, timeout_ms, callback, run_topic_info, free_description);
+}
+
+// 异步获取主题分区详情
+KafkaErrorCode get_kafka_topic_partitions_async(
+    KafkaClientHandle client,
+    const char* topic_name,
+    int64_t request_id,
+    int32_t timeout_ms,
+    KafkaAsyncCallback callback) {
+    return async_submit_topic("get_kafka_topic_partitions_async", client, topic_name,
+        request_id, timeout_ms, callback, run_partitions, free_partitions);
+}
+
+// 异步批量获取水位
+KafkaErrorCode get_kafka_watermarks_async(
+    KafkaClientHandle client,
+    const char** topics,
+    int32_t topic_count,
+    int64_t request_id,
+    int32_t timeout_ms,
+    KafkaAsyncCallback callback) {
+    return async_submit_topics("get_kafka_watermarks_async", client, topics, topic_count,
+        request_id, timeout_ms, callback, run_watermarks, free_watermarks);
+}
+
+// 异步获取主题配置参数
+KafkaErrorCode get_kafka_topic_config_async(
+    KafkaClientHandle client,
+    const char* topic_name,
+    int64_t request_id,
+    int32_t timeout_ms,
+    KafkaAsyncCallback callback) {
+    return async_submit_topic("get_kafka_topic_config_async", client, topic_name,
+        request_id, timeout_ms, callback, run_config, free_config);
+}
+
+// 异步批量获取主题配置摘要
+KafkaErrorCode get_kafka_topic_config_summaries_async(
+    KafkaClientHandle client,
+    const char** topics,
+    int32_t topic_count,
+    int64_t request_id,
+    int32_t timeout_ms,
+    KafkaAsyncCallback callback) {
+    return async_submit_topics("get_kafka_topic_config_summaries_async", client, topics, topic_count,
+        request_id, timeout_ms, callback, run_config_summaries, free_config_summaries);
+}
+
+// 异步获取消费者组
+KafkaErrorCode get_kafka_topic_consumer_groups_async(
+    KafkaClientHandle client,
+    const char* topic_name,
+    int64_t request_id,
+    int32_t timeout_ms,
+    KafkaAsyncCallback callback) {
+    return async_submit_topic("get_kafka_topic_consumer_groups_async", client, topic_name,
+        request_id, timeout_ms, callback, run_consumer_groups, free_consumer_groups);
+}
+
+// 异步获取主题完整详情
+KafkaErrorCode describe_kafka_topic_full_async(
+    KafkaClientHandle client,
+    const char* topic_name,
+    int64_t request_id,
+    int32_t timeout_ms,
+    KafkaAsyncCallback callback) {
+    return async_submit_topic("describe_kafka_topic_full_async", client, topic_name,
+        request_id, timeout_ms, callback, run_describe, free_description);
+}
+
+// 异步刷新主题索引
+KafkaErrorCode refresh_kafka_topic_index_async(
+    KafkaTopicIndexHandle index,
+    KafkaClientHandle client,
+    int64_t request_id,
+    int32_t timeout_ms,
+    KafkaAsyncCallback callback) {
+    if (!index || !client || !callback) {
+        KLOG_ERROR("refresh_kafka_topic_index_async - Invalid parameters");
+        return KAFKA_ERROR;
+    }
+    KafkaAsyncJob* job = async_job_new(client, request_id, timeout_ms, callback, run_index_refresh, free_index_diff);
+    if (!job) {
+        return KAFKA_ERROR;
+    }
+    // 执行期间Dart侧可能销毁索引，持有一个引用
+    kafka_topic_index_retain(index);
+    job->index = index;
+    return async_submit(job, "refresh_kafka_topic_index_async");
+}
+
+// 取消异步请求
+void cancel_kafka_async(int64_t request_id) {
+    pthread_mutex_lock(&async_lock);
+    KafkaAsyncJob** link = &async_head;
+    KafkaAsyncJob* prev = NULL;
+    while (*link && (*link)->id != request_id) {
+        prev = *link;
+        link = &(*link)->next;
+    }
+    KafkaAsyncJob* job = *link;
+    if (job) {
+        // 还在排队：移出队列，直接回调
+        *link = job->next;
+        if (async_tail == job) {
+            async_tail = prev;
+        }
+        pthread_mutex_unlock(&async_lock);
+        job->callback(job->id, KAFKA_ERROR_CANCELLED, NULL, 0);
+        async_job_free(job);
+        return;
+    }
+
+    // 正在执行：查询本身无法中断，结束后丢弃结果
+    for (int32_t i = 0; i < ASYNC_WORKERS; i++) {
+        if (async_active[i] && async_active[i]->id == request_id) {
+            async_active[i]->cancelled = 1;
+        }
+    }
+    pthread_mutex_unlock(&async_lock);
+}
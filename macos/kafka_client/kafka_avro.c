@@ -0,0 +1,542 @@
+#include "kafka_internal.h"
+
+// Avro解码：解析.avsc schema，把Avro二进制编码转成JSON文本。
+// union直接输出选中分支的值（不包一层类型名），bytes/fixed按\u00XX转义输出。
+
+#define AVRO_MAX_DEPTH 64
+
+typedef enum {
+    AVRO_NULL,
+    AVRO_BOOLEAN,
+    AVRO_INT,
+    AVRO_LONG,
+    AVRO_FLOAT,
+    AVRO_DOUBLE,
+    AVRO_BYTES,
+    AVRO_STRING,
+    AVRO_RECORD,
+    AVRO_ENUM,
+    AVRO_ARRAY,
+    AVRO_MAP,
+    AVRO_UNION,
+    AVRO_FIXED,
+} AvroType;
+
+typedef struct AvroNode {
+    AvroType type;
+    char* name;                 // record/enum/fixed的全名
+    struct AvroNode** children; // record字段类型、union分支、array/map元素类型
+    char** field_names;         // record字段名
+    int32_t child_count;
+    char** symbols;             // enum
+    int32_t symbol_count;
+    int32_t fixed_size;
+} AvroNode;
+
+struct KafkaAvroSchema {
+    AvroNode* root;
+    AvroNode** nodes;           // 所有节点，统一释放（命名类型的引用不重复分配）
+    int32_t node_count;
+    int32_t node_cap;
+};
+
+static AvroNode* avro_new_node(KafkaAvroSchema* schema, AvroType type) {
+    if (schema->node_count == schema->node_cap) {
+        int32_t cap = schema->node_cap ? schema->node_cap * 2 : 16;
+        AvroNode** nodes = realloc(schema->nodes, (size_t)cap * sizeof(AvroNode*));
+        if (!nodes) {
+            return NULL;
+        }
+        schema->nodes = nodes;
+        schema->node_cap = cap;
+    }
+
+    AvroNode* node = calloc(1, sizeof(AvroNode));
+    if (!node) {
+        return NULL;
+    }
+    node->type = type;
+    schema->nodes[schema->node_count++] = node;
+    return node;
+}
+
+static int avro_add_child(AvroNode* node, AvroNode* child, const char* field_name) {
+    AvroNode** children = realloc(node->children, (size_t)(node->child_count + 1) * sizeof(AvroNode*));
+    if (!children) {
+        return 0;
+    }
+    node->children = children;
+
+    if (node->type == AVRO_RECORD) {
+        char** names = realloc(node->field_names, (size_t)(node->child_count + 1) * sizeof(char*));
+        if (!names) {
+            return 0;
+        }
+        node->field_names = names;
+        names[node->child_count] = strdup(field_name ? field_name : "");
+    }
+
+    children[node->child_count++] = child;
+    return 1;
+}
+
+// 按名字查找已定义的命名类型，支持全名和短名
+static AvroNode* avro_find_named(KafkaAvroSchema* schema, const char* name, const char* ns) {
+    for (int32_t i = 0; i < schema->node_count; i++) {
+        AvroNode* node = schema->nodes[i];
+        if (!node->name) {
+            continue;
+        }
+        if (strcmp(node->name, name) == 0) {
+            return node;
+        }
+        // 在当前命名空间下补全
+        if (ns && *ns) {
+            size_t ns_len = strlen(ns);
+            if (strncmp(node->name, ns, ns_len) == 0 && node->name[ns_len] == '.' &&
+                strcmp(node->name + ns_len + 1, name) == 0) {
+                return node;
+            }
+        }
+    }
+    // 最后按短名匹配
+    for (int32_t i = 0; i < schema->node_count; i++) {
+        AvroNode* node = schema->nodes[i];
+        if (!node->name) {
+            continue;
+        }
+        const char* dot = strrchr(node->name, '.');
+        if (dot && strcmp(dot + 1, name) == 0) {
+            return node;
+        }
+    }
+    return NULL;
+}
+
+static AvroNode* avro_parse_node(KafkaAvroSchema* schema, const KafkaJsonValue* v, const char* ns, int depth);
+
+static AvroNode* avro_parse_type_name(KafkaAvroSchema* schema, const char* name, const char* ns) {
+    static const struct {
+        const char* name;
+        AvroType type;
+    } primitives[] = {
+        { "null", AVRO_NULL },     { "boolean", AVRO_BOOLEAN }, { "int", AVRO_INT },
+        { "long", AVRO_LONG },     { "float", AVRO_FLOAT },     { "double", AVRO_DOUBLE },
+        { "bytes", AVRO_BYTES },   { "string", AVRO_STRING },
+    };
+
+    for (size_t i = 0; i < sizeof(primitives) / sizeof(primitives[0]); i++) {
+        if (strcmp(name, primitives[i].name) == 0) {
+            return avro_new_node(schema, primitives[i].type);
+        }
+    }
+    return avro_find_named(schema, name, ns);
+}
+
+// 计算命名类型的全名
+static char* avro_full_name(const KafkaJsonValue* v, const char* ns) {
+    const char* name = kafka_json_get_string(v, "name");
+    if (!name) {
+        return NULL;
+    }
+    if (strchr(name, '.')) {
+        return strdup(name);
+    }
+    const char* own_ns = kafka_json_get_string(v, "namespace");
+    if (!own_ns) {
+        own_ns = ns;
+    }
+    if (!own_ns || !*own_ns) {
+        return strdup(name);
+    }
+    size_t len = strlen(own_ns) + strlen(name) + 2;
+    char* full = malloc(len);
+    if (full) {
+        snprintf(full, len, "%s.%s", own_ns, name);
+    }
+    return full;
+}
+
+// 全名中的命名空间部分，供嵌套类型继承
+static char* avro_namespace_of(const char* full_name) {
+    const char* dot = full_name ? strrchr(full_name, '.') : NULL;
+    if (!dot) {
+        return strdup("");
+    }
+    size_t len = (size_t)(dot - full_name);
+    char* ns = malloc(len + 1);
+    if (ns) {
+        memcpy(ns, full_name, len);
+        ns[len] = '\0';
+    }
+    return ns;
+}
+
+static AvroNode* avro_parse_complex(KafkaAvroSchema* schema, const KafkaJsonValue* v, const char* ns, int depth) {
+    const KafkaJsonValue* type_value = kafka_json_get(v, "type");
+    if (!type_value) {
+        return NULL;
+    }
+    // {"type": {...}} 或 {"type": "string", "logicalType": ...}
+    if (type_value->type != KAFKA_JSON_STRING) {
+        return avro_parse_node(schema, type_value, ns, depth + 1);
+    }
+
+    const char* type = type_value->string;
+    if (strcmp(type, "record") == 0 || strcmp(type, "error") == 0) {
+        AvroNode* node = avro_new_node(schema, AVRO_RECORD);
+        if (!node) {
+            return NULL;
+        }
+        node->name = avro_full_name(v, ns);
+        char* child_ns = avro_namespace_of(node->name);
+        if (!child_ns) {
+            return NULL;
+        }
+
+        const KafkaJsonValue* fields = kafka_json_get(v, "fields");
+        int ok = fields && fields->type == KAFKA_JSON_ARRAY;
+        for (const KafkaJsonValue* f = ok ? fields->child : NULL; f && ok; f = f->next) {
+            const char* field_name = kafka_json_get_string(f, "name");
+            AvroNode* field_type = avro_parse_node(schema, kafka_json_get(f, "type"), child_ns, depth + 1);
+            ok = field_name && field_type && avro_add_child(node, field_type, field_name);
+        }
+        free(child_ns);
+        return ok ? node : NULL;
+    }
+
+    if (strcmp(type, "enum") == 0) {
+        AvroNode* node = avro_new_node(schema, AVRO_ENUM);
+        if (!node) {
+            return NULL;
+        }
+        node->name = avro_full_name(v, ns);
+        const KafkaJsonValue* symbols = kafka_json_get(v, "symbols");
+        if (!symbols || symbols->type != KAFKA_JSON_ARRAY) {
+            return NULL;
+        }
+        for (const KafkaJsonValue* s = symbols->child; s; s = s->next) {
+            node->symbol_count++;
+        }
+        node->symbols = calloc((size_t)node->symbol_count, sizeof(char*));
+        if (!node->symbols && node->symbol_count > 0) {
+            return NULL;
+        }
+        int32_t i = 0;
+        for (const KafkaJsonValue* s = symbols->child; s; s = s->next) {
+            node->symbols[i++] = strdup(s->type == KAFKA_JSON_STRING ? s->string : "");
+        }
+        return node;
+    }
+
+    if (strcmp(type, "array") == 0 || strcmp(type, "map") == 0) {
+        int is_array = type[0] == 'a';
+        AvroNode* node = avro_new_node(schema, is_array ? AVRO_ARRAY : AVRO_MAP);
+        AvroNode* item = avro_parse_node(schema, kafka_json_get(v, is_array ? "items" : "values"), ns, depth + 1);
+        if (!node || !item || !avro_add_child(node, item, NULL)) {
+            return NULL;
+        }
+        return node;
+    }
+
+    if (strcmp(type, "fixed") == 0) {
+        AvroNode* node = avro_new_node(schema, AVRO_FIXED);
+        const KafkaJsonValue* size = kafka_json_get(v, "size");
+        if (!node || !size || size->type != KAFKA_JSON_NUMBER || size->integer < 0) {
+            return NULL;
+        }
+        node->name = avro_full_name(v, ns);
+        node->fixed_size = (int32_t)size->integer;
+        return node;
+    }
+
+    // 原始类型（可能带logicalType，按底层类型解码）
+    return avro_parse_type_name(schema, type, ns);
+}
+
+static AvroNode* avro_parse_node(KafkaAvroSchema* schema, const KafkaJsonValue* v, const char* ns, int depth) {
+    if (!v || depth > AVRO_MAX_DEPTH) {
+        return NULL;
+    }
+
+    switch (v->type) {
+        case KAFKA_JSON_STRING:
+            return avro_parse_type_name(schema, v->string, ns);
+        case KAFKA_JSON_ARRAY: {
+            AvroNode* node = avro_new_node(schema, AVRO_UNION);
+            if (!node) {
+                return NULL;
+            }
+            for (const KafkaJsonValue* branch = v->child; branch; branch = branch->next) {
+                AvroNode* child = avro_parse_node(schema, branch, ns, depth + 1);
+                if (!child || !avro_add_child(node, child, NULL)) {
+                    return NULL;
+                }
+            }
+            return node;
+        }
+        case KAFKA_JSON_OBJECT:
+            return avro_parse_complex(schema, v, ns, depth);
+        default:
+            return NULL;
+    }
+}
+
+void kafka_avro_schema_free(KafkaAvroSchema* schema) {
+    if (!schema) {
+        return;
+    }
+
+    for (int32_t i = 0; i < schema->node_count; i++) {
+        AvroNode* node = schema->nodes[i];
+        if (node->field_names) {
+            for (int32_t j = 0; j < node->child_count; j++) {
+                free(node->field_names[j]);
+            }
+        }
+        for (int32_t j = 0; j < node->symbol_count; j++) {
+            free(node->symbols[j]);
+        }
+        free(node->name);
+        free(node->children);
+        free(node->field_names);
+        free(node->symbols);
+        free(node);
+    }
+    free(schema->nodes);
+    free(schema);
+}
+
+// 解析.avsc文本
+KafkaAvroSchema* kafka_avro_schema_parse(const char* text, size_t len) {
+    KafkaJsonValue* json = kafka_json_parse(text, len);
+    if (!json) {
+        return NULL;
+    }
+
+    KafkaAvroSchema* schema = calloc(1, sizeof(KafkaAvroSchema));
+    if (schema) {
+        schema->root = avro_parse_node(schema, json, "", 0);
+        if (!schema->root) {
+            kafka_avro_schema_free(schema);
+            schema = NULL;
+        }
+    }
+    kafka_json_free(json);
+    return schema;
+}
+
+// ---------- 二进制解码 ----------
+
+typedef struct {
+    const uint8_t* p;
+    const uint8_t* end;
+} AvroReader;
+
+static int avro_read_long(AvroReader* r, int64_t* out) {
+    uint64_t value = 0;
+    int shift = 0;
+    while (r->p < r->end && shift < 64) {
+        uint8_t b = *r->p++;
+        value |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *out = (int64_t)(value >> 1) ^ -(int64_t)(value & 1);  // zigzag
+            return 1;
+        }
+        shift += 7;
+    }
+    return 0;
+}
+
+static int avro_read_bytes(AvroReader* r, const uint8_t** data, size_t* len) {
+    int64_t n;
+    if (!avro_read_long(r, &n) || n < 0 || (uint64_t)n > (uint64_t)(r->end - r->p)) {
+        return 0;
+    }
+    *data = r->p;
+    *len = (size_t)n;
+    r->p += n;
+    return 1;
+}
+
+// bytes/fixed按Avro JSON编码输出：每个字节一个\u00XX（可打印ASCII原样输出）
+static void avro_write_bytes(KafkaBuffer* out, const uint8_t* data, size_t len) {
+    static const char hex[] = "0123456789abcdef";
+    kafka_buffer_append(out, "\"", 1);
+    for (size_t i = 0; i < len; i++) {
+        uint8_t c = data[i];
+        if (c >= 0x20 && c < 0x7F && c != '"' && c != '\\') {
+            kafka_buffer_append(out, &c, 1);
+        } else {
+            char esc[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+            kafka_buffer_append(out, esc, 6);
+        }
+    }
+    kafka_buffer_append(out, "\"", 1);
+}
+
+static void avro_write_double(KafkaBuffer* out, double value, int precision) {
+    if (value != value || value > 1.7976931348623157e308 || value < -1.7976931348623157e308) {
+        // JSON不支持NaN/Infinity
+        kafka_buffer_append_str(out, value != value ? "\"NaN\"" : (value > 0 ? "\"Infinity\"" : "\"-Infinity\""));
+        return;
+    }
+    kafka_buffer_printf(out, "%.*g", precision, value);
+}
+
+static int avro_decode_value(const AvroNode* node, AvroReader* r, KafkaBuffer* out, int depth) {
+    if (depth > AVRO_MAX_DEPTH) {
+        return 0;
+    }
+
+    switch (node->type) {
+        case AVRO_NULL:
+            kafka_buffer_append_str(out, "null");
+            return 1;
+        case AVRO_BOOLEAN:
+            if (r->p >= r->end) {
+                return 0;
+            }
+            kafka_buffer_append_str(out, *r->p++ ? "true" : "false");
+            return 1;
+        case AVRO_INT:
+        case AVRO_LONG: {
+            int64_t v;
+            if (!avro_read_long(r, &v)) {
+                return 0;
+            }
+            kafka_buffer_printf(out, "%lld", (long long)v);
+            return 1;
+        }
+        case AVRO_FLOAT: {
+            if (r->end - r->p < 4) {
+                return 0;
+            }
+            uint32_t bits = (uint32_t)r->p[0] | (uint32_t)r->p[1] << 8 | (uint32_t)r->p[2] << 16 | (uint32_t)r->p[3] << 24;
+            float v;
+            memcpy(&v, &bits, sizeof(v));
+            r->p += 4;
+            avro_write_double(out, v, 9);
+            return 1;
+        }
+        case AVRO_DOUBLE: {
+            if (r->end - r->p < 8) {
+                return 0;
+            }
+            uint64_t bits = 0;
+            for (int i = 7; i >= 0; i--) {
+                bits = bits << 8 | r->p[i];
+            }
+            double v;
+            memcpy(&v, &bits, sizeof(v));
+            r->p += 8;
+            avro_write_double(out, v, 17);
+            return 1;
+        }
+        case AVRO_BYTES:
+        case AVRO_STRING: {
+            const uint8_t* data;
+            size_t len;
+            if (!avro_read_bytes(r, &data, &len)) {
+                return 0;
+            }
+            if (node->type == AVRO_STRING) {
+                kafka_buffer_append_json_string(out, (const char*)data, len);
+            } else {
+                avro_write_bytes(out, data, len);
+            }
+            return 1;
+        }
+        case AVRO_FIXED:
+            if (r->end - r->p < node->fixed_size) {
+                return 0;
+            }
+            avro_write_bytes(out, r->p, (size_t)node->fixed_size);
+            r->p += node->fixed_size;
+            return 1;
+        case AVRO_ENUM: {
+            int64_t index;
+            if (!avro_read_long(r, &index) || index < 0 || index >= node->symbol_count) {
+                return 0;
+            }
+            const char* symbol = node->symbols[index];
+            kafka_buffer_append_json_string(out, symbol, strlen(symbol));
+            return 1;
+        }
+        case AVRO_UNION: {
+            int64_t index;
+            if (!avro_read_long(r, &index) || index < 0 || index >= node->child_count) {
+                return 0;
+            }
+            return avro_decode_value(node->children[index], r, out, depth + 1);
+        }
+        case AVRO_RECORD:
+            kafka_buffer_append(out, "{", 1);
+            for (int32_t i = 0; i < node->child_count; i++) {
+                if (i > 0) {
+                    kafka_buffer_append(out, ",", 1);
+                }
+                kafka_buffer_append_json_string(out, node->field_names[i], strlen(node->field_names[i]));
+                kafka_buffer_append(out, ":", 1);
+                if (!avro_decode_value(node->children[i], r, out, depth + 1)) {
+                    return 0;
+                }
+            }
+            kafka_buffer_append(out, "}", 1);
+            return 1;
+        case AVRO_ARRAY:
+        case AVRO_MAP: {
+            int is_map = node->type == AVRO_MAP;
+            int first = 1;
+            kafka_buffer_append(out, is_map ? "{" : "[", 1);
+            // 分块编码：count为0结束，负数时后面跟块的字节数
+            for (;;) {
+                int64_t count;
+                if (!avro_read_long(r, &count)) {
+                    return 0;
+                }
+                if (count == 0) {
+                    break;
+                }
+                if (count < 0) {
+                    int64_t block_size;
+                    if (!avro_read_long(r, &block_size)) {
+                        return 0;
+                    }
+                    count = -count;
+                }
+                for (int64_t i = 0; i < count; i++) {
+                    if (!first) {
+                        kafka_buffer_append(out, ",", 1);
+                    }
+                    first = 0;
+                    if (is_map) {
+                        const uint8_t* key;
+                        size_t key_len;
+                        if (!avro_read_bytes(r, &key, &key_len)) {
+                            return 0;
+                        }
+                        kafka_buffer_append_json_string(out, (const char*)key, key_len);
+                        kafka_buffer_append(out, ":", 1);
+                    }
+                    if (!avro_decode_value(node->children[0], r, out, depth + 1)) {
+                        return 0;
+                    }
+                }
+            }
+            kafka_buffer_append(out, is_map ? "}" : "]", 1);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// 解码Avro二进制数据，输出JSON文本追加到out
+int kafka_avro_decode(const KafkaAvroSchema* schema, const uint8_t* data, size_t len, KafkaBuffer* out) {
+    if (!schema || !schema->root) {
+        return 0;
+    }
+
+    AvroReader r = { data, data + len };
+    return avro_decode_value(schema->root, &r, out, 0) && !out->failed;
+}
@@ -0,0 +1,164 @@
+#include "kafka_internal.h"
+
+// 历史消息分页读取：按分区偏移量范围assign，读到每个分区的结束位置（或分区末尾、或超时）为止，
+// 然后取消分配。不订阅、不提交偏移量，同一个消费者可以反复向前或向后翻页。
+// 返回的消息按时间戳合并排序，超长内容和消费循环一样只返回预览，完整内容转入消息存储。
+
+#define BROWSE_MAX_PAGE_MESSAGES 100000
+
+typedef struct {
+    int32_t partition;
+    int64_t start;
+    int64_t end;        // 不包含
+    int done;
+} BrowseRange;
+
+static BrowseRange* find_range(BrowseRange* ranges, int32_t count, int32_t partition) {
+    for (int32_t i = 0; i < count; i++) {
+        if (ranges[i].partition == partition) {
+            return &ranges[i];
+        }
+    }
+    return NULL;
+}
+
+static int compare_records(const void* a, const void* b) {
+    const KafkaMessageRecord* x = (const KafkaMessageRecord*)a;
+    const KafkaMessageRecord* y = (const KafkaMessageRecord*)b;
+    if (x->timestamp != y->timestamp) {
+        return x->timestamp < y->timestamp ? -1 : 1;
+    }
+    if (x->partition != y->partition) {
+        return x->partition < y->partition ? -1 : 1;
+    }
+    return x->offset < y->offset ? -1 : x->offset > y->offset;
+}
+
+// 读取一页历史消息：partitions[i]的[start_offsets[i], end_offsets[i])
+KafkaMessageRecord* fetch_kafka_page(
+    KafkaClientHandle consumer,
+    const char* topic,
+    const int32_t* partitions,
+    const int64_t* start_offsets,
+    const int64_t* end_offsets,
+    int32_t partition_count,
+    KafkaStoreHandle store,
+    int32_t preview_bytes,
+    int32_t timeout_ms,
+    int32_t* count) {
+    if (!consumer || !topic || !partitions || !start_offsets || !end_offsets || partition_count <= 0 || !count) {
+        KLOG_ERROR("fetch_kafka_page - Invalid parameters");
+        return NULL;
+    }
+    *count = 0;
+
+    KafkaConsumer* c = (KafkaConsumer*)consumer;
+    if (c->loop) {
+        KLOG_ERROR("fetch_kafka_page - Consumer is running a consume loop");
+        return NULL;
+    }
+
+    BrowseRange* ranges = calloc(partition_count, sizeof(BrowseRange));
+    rd_kafka_topic_partition_list_t* assignment = rd_kafka_topic_partition_list_new(partition_count);
+    if (!ranges || !assignment) {
+        free(ranges);
+        if (assignment) {
+            rd_kafka_topic_partition_list_destroy(assignment);
+        }
+        return NULL;
+    }
+
+    int64_t capacity = 0;
+    int32_t pending = 0;
+    for (int32_t i = 0; i < partition_count; i++) {
+        ranges[i].partition = partitions[i];
+        ranges[i].start = start_offsets[i] > 0 ? start_offsets[i] : 0;
+        ranges[i].end = end_offsets[i];
+        if (ranges[i].end <= ranges[i].start) {
+            ranges[i].done = 1;
+            continue;
+        }
+        capacity += ranges[i].end - ranges[i].start;
+        rd_kafka_topic_partition_list_add(assignment, topic, partitions[i])->offset = ranges[i].start;
+        pending++;
+    }
+    if (pending == 0) {
+        free(ranges);
+        rd_kafka_topic_partition_list_destroy(assignment);
+        return NULL;
+    }
+    if (capacity > BROWSE_MAX_PAGE_MESSAGES) {
+        capacity = BROWSE_MAX_PAGE_MESSAGES;
+    }
+
+    KafkaMessageRecord* records = malloc(capacity * sizeof(KafkaMessageRecord));
+    rd_kafka_resp_err_t err = records ? rd_kafka_assign(c->rk, assignment) : RD_KAFKA_RESP_ERR__FAIL;
+    rd_kafka_topic_partition_list_destroy(assignment);
+    if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+        KLOG_ERROR("fetch_kafka_page - Failed to assign %s: %s", topic, rd_kafka_err2str(err));
+        free(records);
+        free(ranges);
+        return NULL;
+    }
+
+    int32_t n = 0;
+    int64_t deadline_ns = kafka_monotonic_ns() + (int64_t)timeout_ms * 1000000;
+    while (pending > 0 && n < capacity) {
+        int64_t remaining_ms = (deadline_ns - kafka_monotonic_ns()) / 1000000;
+        if (remaining_ms <= 0) {
+            KLOG_WARN("fetch_kafka_page - Timed out on %s with %d partitions pending", topic, pending);
+            break;
+        }
+
+        rd_kafka_message_t* rkmessage = rd_kafka_consumer_poll(c->rk, (int)remaining_ms);
+        if (!rkmessage) {
+            continue;
+        }
+        BrowseRange* range = rkmessage->rkt && strcmp(rd_kafka_topic_name(rkmessage->rkt), topic) == 0 ?
+            find_range(ranges, partition_count, rkmessage->partition) : NULL;
+        if (!range || range->done) {
+            rd_kafka_message_destroy(rkmessage);
+            continue;
+        }
+
+        if (rkmessage->err) {
+            // 到达分区末尾（需要enable.partition.eof），范围内剩下的偏移量还没有写入
+            if (rkmessage->err == RD_KAFKA_RESP_ERR__PARTITION_EOF) {
+                range->done = 1;
+                pending--;
+            } else {
+                KLOG_WARN("fetch_kafka_page - %s [%d]: %s", topic, range->partition, rd_kafka_message_errstr(rkmessage));
+            }
+            rd_kafka_message_destroy(rkmessage);
+            continue;
+        }
+
+        int64_t offset = rkmessage->offset;
+        if (offset >= range->start && offset < range->end) {
+            KafkaMessage* message = kafka_message_from_rd(rkmessage);
+            if (message) {
+                if (c->schemas && message->payload_type == KAFKA_PAYLOAD_CONFLUENT) {
+                    kafka_schema_decode(c->schemas, message);
+                }
+                kafka_record_from_message(store, &records[n++], message, preview_bytes);
+            }
+        }
+        // 偏移量可能因为压缩或事务标记不连续，到达或越过范围末尾即结束
+        if (offset >= range->end - 1) {
+            range->done = 1;
+            pending--;
+        }
+        rd_kafka_message_destroy(rkmessage);
+    }
+
+    rd_kafka_assign(c->rk, NULL);
+    free(ranges);
+
+    if (n == 0) {
+        free(records);
+        return NULL;
+    }
+    qsort(records, n, sizeof(KafkaMessageRecord), compare_records);
+    *count = n;
+    return records;
+}
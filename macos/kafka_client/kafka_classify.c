@@ -0,0 +1,167 @@
+#include "kafka_internal.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CLASSIFY_USE_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define CLASSIFY_USE_SSE2 1
+#endif
+
+// 消息类型识别：在消费线程里对每条消息只扫描一次，
+// 结果作为标签随消息返回，UI据此选择渲染方式，不需要再在Dart里猜。
+
+static int is_text_control(uint8_t c) {
+    return c < 0x20 && c != '\t' && c != '\n' && c != '\r';
+}
+
+// 16字节块是否全部是可打印ASCII（含\t \n \r）
+#if defined(CLASSIFY_USE_NEON)
+static int block_is_plain_ascii(const uint8_t* p) {
+    uint8x16_t v = vld1q_u8(p);
+    uint8x16_t high = vcgeq_u8(v, vdupq_n_u8(0x80));
+    uint8x16_t low = vcltq_u8(v, vdupq_n_u8(0x20));
+    uint8x16_t ws = vorrq_u8(vorrq_u8(vceqq_u8(v, vdupq_n_u8('\t')), vceqq_u8(v, vdupq_n_u8('\n'))),
+                             vceqq_u8(v, vdupq_n_u8('\r')));
+    uint8x16_t bad = vorrq_u8(high, vbicq_u8(low, ws));
+    return vmaxvq_u8(bad) == 0;
+}
+#elif defined(CLASSIFY_USE_SSE2)
+static int block_is_plain_ascii(const uint8_t* p) {
+    __m128i v = _mm_loadu_si128((const __m128i*)p);
+    // 有符号比较：>=0x80的字节是负数，会同时被判为<0x20，由movemask(v)兜底
+    __m128i low = _mm_cmplt_epi8(v, _mm_set1_epi8(0x20));
+    __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\t')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))),
+                              _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')));
+    __m128i bad = _mm_andnot_si128(ws, low);
+    return (_mm_movemask_epi8(v) | _mm_movemask_epi8(bad)) == 0;
+}
+#else
+static int block_is_plain_ascii(const uint8_t* p) {
+    for (int i = 0; i < 16; i++) {
+        if (p[i] >= 0x80 || is_text_control(p[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+#endif
+
+// 一个UTF-8字符（可能是多字节序列）的字节数，序列非法（过长编码、代理项、超出U+10FFFF、截断）时返回0
+size_t kafka_utf8_char_len(const char* data, size_t remaining) {
+    const uint8_t* p = (const uint8_t*)data;
+    uint8_t c = p[0];
+    if (c < 0x80) {
+        return 1;
+    }
+
+    size_t n;
+    uint8_t lo = 0x80, hi = 0xBF;  // 第二个字节的范围
+    if (c >= 0xC2 && c <= 0xDF) {
+        n = 2;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+        n = 3;
+        if (c == 0xE0) {
+            lo = 0xA0;   // 排除过长编码
+        } else if (c == 0xED) {
+            hi = 0x9F;   // 排除代理项
+        }
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        n = 4;
+        if (c == 0xF0) {
+            lo = 0x90;
+        } else if (c == 0xF4) {
+            hi = 0x8F;   // 不超过U+10FFFF
+        }
+    } else {
+        return 0;
+    }
+
+    if (remaining < n || p[1] < lo || p[1] > hi) {
+        return 0;
+    }
+    for (size_t i = 2; i < n; i++) {
+        if ((p[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+    }
+    return n;
+}
+
+// 校验一个字符，成功时返回字节数，非法或是控制字符返回0
+static size_t scan_utf8_char(const uint8_t* p, size_t remaining) {
+    if (p[0] < 0x80) {
+        return is_text_control(p[0]) ? 0 : 1;
+    }
+    return kafka_utf8_char_len((const char*)p, remaining);
+}
+
+// 是否是合法的UTF-8文本（不含\t \n \r以外的控制字符）
+int kafka_utf8_is_text(const char* data, size_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    size_t i = 0;
+
+    while (i < len) {
+        // 向量化快速路径：整块都是ASCII文本时直接跳过
+        if (len - i >= 16 && block_is_plain_ascii(p + i)) {
+            i += 16;
+            continue;
+        }
+
+        // 逐字符处理这一块，多字节序列可以跨块
+        size_t block_end = i + 16 < len ? i + 16 : len;
+        while (i < block_end) {
+            size_t n = scan_utf8_char(p + i, len - i);
+            if (n == 0) {
+                return 0;
+            }
+            i += n;
+        }
+    }
+    return 1;
+}
+
+static int is_ws(uint8_t c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// 识别消息类型（KAFKA_PAYLOAD_*）
+int32_t kafka_classify_payload(const char* data, size_t len) {
+    if (!data || len == 0) {
+        return KAFKA_PAYLOAD_EMPTY;
+    }
+
+    const uint8_t* p = (const uint8_t*)data;
+
+    // Confluent Schema Registry格式：0x00 + 4字节schema id
+    if (p[0] == 0x00 && len >= 5) {
+        return KAFKA_PAYLOAD_CONFLUENT;
+    }
+
+    if (!kafka_utf8_is_text(data, len)) {
+        return KAFKA_PAYLOAD_BINARY;
+    }
+
+    size_t start = 0;
+    if (len >= 3 && p[0] == 0xEF && p[1] == 0xBB && p[2] == 0xBF) {
+        start = 3;  // UTF-8 BOM
+    }
+    while (start < len && is_ws(p[start])) {
+        start++;
+    }
+    size_t end = len;
+    while (end > start && is_ws(p[end - 1])) {
+        end--;
+    }
+    if (start == end) {
+        return KAFKA_PAYLOAD_TEXT;
+    }
+
+    if ((p[start] == '{' || p[start] == '[') && kafka_json_validate(data + start, end - start)) {
+        return KAFKA_PAYLOAD_JSON;
+    }
+    if (p[start] == '<' && p[end - 1] == '>') {
+        return KAFKA_PAYLOAD_XML;
+    }
+    return KAFKA_PAYLOAD_TEXT;
+}
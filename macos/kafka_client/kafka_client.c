@@ -1,17 +1,4 @@
-#include "kafka_client.h"
-
-// 错误码定义
-enum {
-    KAFKA_OK = 0,
-    KAFKA_ERROR = 1,
-    KAFKA_ERROR_CREATE_CLIENT = 2,
-    KAFKA_ERROR_CONFIG = 3,
-    KAFKA_ERROR_CONNECT = 4,
-    KAFKA_ERROR_TOPICS = 5,
-    KAFKA_ERROR_SEND = 6,
-    KAFKA_ERROR_SUBSCRIBE = 7,
-    KAFKA_ERROR_CONSUME = 8,
-};
+#include "kafka_internal.h"
 
 // 错误信息
 static const char* error_messages[] = {
@@ -24,76 +11,96 @@ static const char* error_messages[] = {
     "Failed to send message",
     "Failed to subscribe to topic",
     "Failed to consume message",
+    "Failed to write file",
+    "Request cancelled",
+    "Request timed out",
 };
 
-// Kafka生产者上下文
-typedef struct {
-    rd_kafka_t* rk;
-} KafkaProducer;
-
-// Kafka消费者上下文
-typedef struct {
-    rd_kafka_t* rk;
-    rd_kafka_topic_partition_list_t* topic_list;
-} KafkaConsumer;
-
-// Kafka消息上下文
-typedef struct {
-    char* content;
-    char* key;
-    char* topic;
-    int64_t offset;
-    int32_t partition;
-    int64_t timestamp;
-} KafkaMessage;
-
 // 创建Kafka生产者
 KafkaClientHandle create_kafka_producer(const char* bootstrap_servers) {
+    KLOG_DEBUG("create_kafka_producer called with bootstrap_servers: %s", bootstrap_servers);
+    return kafka_producer_new(bootstrap_servers, "flutter-kafka-producer");
+}
+
+// 创建生产者类型的客户端（管理客户端也使用它）
+KafkaProducer* kafka_producer_new(const char* bootstrap_servers, const char* client_id) {
     rd_kafka_t* rk;
     rd_kafka_conf_t* conf;
     char errstr[512];
     
-    printf("🔧 C: create_kafka_producer called with bootstrap_servers: %s\n", bootstrap_servers);
-    
     // 创建配置
     conf = rd_kafka_conf_new();
     if (!conf) {
-        printf("❌ C: Failed to create Kafka configuration\n");
+        KLOG_ERROR("Failed to create Kafka configuration");
         return NULL;
     }
     
     // 设置bootstrap servers
     if (rd_kafka_conf_set(conf, "bootstrap.servers", bootstrap_servers, errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK) {
-        printf("❌ C: Failed to set bootstrap.servers: %s\n", errstr);
+        KLOG_ERROR("Failed to set bootstrap.servers: %s", errstr);
         rd_kafka_conf_destroy(conf);
         return NULL;
     }
     
     // 设置客户端ID
-    if (rd_kafka_conf_set(conf, "client.id", "flutter-kafka-producer", errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK) {
-        printf("❌ C: Failed to set client.id: %s\n", errstr);
+    if (rd_kafka_conf_set(conf, "client.id", client_id, errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK) {
+        KLOG_ERROR("Failed to set client.id: %s", errstr);
+        rd_kafka_conf_destroy(conf);
+        return NULL;
+    }
+
+    // 按主题查询元数据时不自动创建主题（默认true，输错的主题名会被broker创建出来）；
+    // 较旧的librdkafka不支持在生产者上设置，只记录警告
+    if (rd_kafka_conf_set(conf, "allow.auto.create.topics", "false", errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK) {
+        KLOG_WARN("Failed to set allow.auto.create.topics: %s", errstr);
+    }
+
+    // 分配生产者上下文（error_cb的opaque指向它，需要在创建实例之前分配）
+    KafkaProducer* producer = calloc(1, sizeof(KafkaProducer));
+    if (!producer) {
+        KLOG_ERROR("Failed to allocate memory for producer");
         rd_kafka_conf_destroy(conf);
         return NULL;
     }
+    producer->metadata = kafka_metadata_cache_create();
+    producer->configs = kafka_config_cache_create();
+    producer->stats = kafka_stats_create();
+    producer->connect = kafka_connect_state_create();
+    if (!producer->metadata || !producer->configs || !producer->stats || !producer->connect ||
+        !kafka_stats_configure(conf)) {
+        KLOG_ERROR("Failed to allocate connection caches");
+        kafka_metadata_cache_destroy(producer->metadata);
+        kafka_config_cache_destroy(producer->configs);
+        kafka_stats_destroy(producer->stats);
+        kafka_connect_state_destroy(producer->connect);
+        rd_kafka_conf_destroy(conf);
+        free(producer);
+        return NULL;
+    }
+
+    // 连接级错误由error_cb记录，连接就绪检测据此提前失败；统计由stats_cb解析保存
+    rd_kafka_conf_set_opaque(conf, producer);
+    rd_kafka_conf_set_error_cb(conf, kafka_connect_error_cb);
+    rd_kafka_conf_set_dr_msg_cb(conf, kafka_latency_dr_cb);
+    rd_kafka_conf_set_log_cb(conf, kafka_log_rdkafka_cb);
     
     // 创建生产者实例
     rk = rd_kafka_new(RD_KAFKA_PRODUCER, conf, errstr, sizeof(errstr));
     if (!rk) {
-        printf("❌ C: Failed to create Kafka producer: %s\n", errstr);
+        KLOG_ERROR("Failed to create Kafka producer: %s", errstr);
         rd_kafka_conf_destroy(conf);
+        kafka_metadata_cache_destroy(producer->metadata);
+        kafka_config_cache_destroy(producer->configs);
+        kafka_stats_destroy(producer->stats);
+        kafka_connect_state_destroy(producer->connect);
+        free(producer);
         return NULL;
     }
-    
-    // 分配生产者上下文
-    KafkaProducer* producer = malloc(sizeof(KafkaProducer));
-    if (!producer) {
-        printf("❌ C: Failed to allocate memory for producer\n");
-        rd_kafka_destroy(rk);
-        return NULL;
-    }
-    
     producer->rk = rk;
-    printf("✅ C: Successfully created Kafka producer\n");
+    kafka_stats_start(producer->stats, rk);
+    kafka_metadata_cache_set_owner(producer->metadata, rd_kafka_name(rk));
+    kafka_config_cache_set_owner(producer->configs, rd_kafka_name(rk));
+    KLOG_DEBUG("Successfully created Kafka producer");
     return producer;
 }
 
@@ -105,6 +112,34 @@ KafkaClientHandle create_kafka_consumer(const char* bootstrap_servers, const cha
 
 // 创建带消费位置配置的Kafka消费者
 KafkaClientHandle create_kafka_consumer_with_config(const char* bootstrap_servers, const char* group_id, const char* auto_offset_reset) {
+    return create_kafka_consumer_with_profile(bootstrap_servers, group_id, auto_offset_reset,
+                                              KAFKA_CONSUMER_PROFILE_DEFAULT, NULL, NULL, 0);
+}
+
+// 全量扫描配置：拉大每次fetch的数据量和本地预取队列，让broker攒满再返回，
+// 不提交偏移量、不校验CRC（librdkafka默认也不校验，这里显式关闭）
+static const char* scan_profile[][2] = {
+    { "fetch.max.bytes", "104857600" },
+    { "receive.message.max.bytes", "104858112" },   // 必须比fetch.max.bytes大512
+    { "max.partition.fetch.bytes", "10485760" },
+    { "fetch.min.bytes", "1048576" },
+    { "fetch.wait.max.ms", "1000" },
+    { "queued.min.messages", "1000000" },
+    { "queued.max.messages.kbytes", "262144" },
+    { "enable.auto.commit", "false" },
+    { "enable.auto.offset.store", "false" },
+    { "check.crcs", "false" },
+};
+
+// 按配置档创建消费者，config_keys/config_values在配置档之后逐项覆盖（任意librdkafka配置）
+KafkaClientHandle create_kafka_consumer_with_profile(
+    const char* bootstrap_servers,
+    const char* group_id,
+    const char* auto_offset_reset,
+    int32_t profile,
+    const char** config_keys,
+    const char** config_values,
+    int32_t config_count) {
     rd_kafka_t* rk;
     rd_kafka_conf_t* conf;
     char errstr[512];
@@ -144,23 +179,70 @@ KafkaClientHandle create_kafka_consumer_with_config(const char* bootstrap_server
         rd_kafka_conf_destroy(conf);
         return NULL;
     }
+
+    if (profile == KAFKA_CONSUMER_PROFILE_SCAN) {
+        for (size_t i = 0; i < sizeof(scan_profile) / sizeof(scan_profile[0]); i++) {
+            if (rd_kafka_conf_set(conf, scan_profile[i][0], scan_profile[i][1], errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK) {
+                KLOG_ERROR("Failed to set %s: %s", scan_profile[i][0], errstr);
+                rd_kafka_conf_destroy(conf);
+                return NULL;
+            }
+        }
+    }
+
+    for (int32_t i = 0; i < config_count; i++) {
+        if (!config_keys[i] || !config_values[i] ||
+            rd_kafka_conf_set(conf, config_keys[i], config_values[i], errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK) {
+            KLOG_ERROR("Failed to set %s: %s", config_keys[i] ? config_keys[i] : "(null)",
+                       config_keys[i] && config_values[i] ? errstr : "missing key or value");
+            rd_kafka_conf_destroy(conf);
+            return NULL;
+        }
+    }
     
-    // 创建消费者实例
-    rk = rd_kafka_new(RD_KAFKA_CONSUMER, conf, errstr, sizeof(errstr));
-    if (!rk) {
+    // 分配消费者上下文（stats_cb的opaque指向它，需要在创建实例之前分配）
+    KafkaConsumer* consumer = malloc(sizeof(KafkaConsumer));
+    if (!consumer) {
         rd_kafka_conf_destroy(conf);
         return NULL;
     }
     
-    // 分配消费者上下文
-    KafkaConsumer* consumer = malloc(sizeof(KafkaConsumer));
-    if (!consumer) {
-        rd_kafka_destroy(rk);
+    consumer->metadata = kafka_metadata_cache_create();
+    consumer->configs = kafka_config_cache_create();
+    consumer->stats = kafka_stats_create();
+    if (!consumer->metadata || !consumer->configs || !consumer->stats || !kafka_stats_configure(conf)) {
+        kafka_metadata_cache_destroy(consumer->metadata);
+        kafka_config_cache_destroy(consumer->configs);
+        kafka_stats_destroy(consumer->stats);
+        rd_kafka_conf_destroy(conf);
+        free(consumer);
+        return NULL;
+    }
+    rd_kafka_conf_set_opaque(conf, consumer);
+    rd_kafka_conf_set_log_cb(conf, kafka_log_rdkafka_cb);
+    
+    // 创建消费者实例
+    rk = rd_kafka_new(RD_KAFKA_CONSUMER, conf, errstr, sizeof(errstr));
+    if (!rk) {
+        kafka_metadata_cache_destroy(consumer->metadata);
+        kafka_config_cache_destroy(consumer->configs);
+        kafka_stats_destroy(consumer->stats);
+        rd_kafka_conf_destroy(conf);
+        free(consumer);
         return NULL;
     }
     
     consumer->rk = rk;
     consumer->topic_list = NULL;
+    consumer->loop = NULL;
+    consumer->writer = NULL;
+    pthread_mutex_init(&consumer->writer_lock, NULL);
+    consumer->schemas = NULL;
+    consumer->decode_threads = 0;
+    consumer->backpressure = (KafkaBackpressure){ 80, 50, NULL };
+    kafka_stats_start(consumer->stats, rk);
+    kafka_metadata_cache_set_owner(consumer->metadata, rd_kafka_name(rk));
+    kafka_config_cache_set_owner(consumer->configs, rd_kafka_name(rk));
     return consumer;
 }
 
@@ -175,13 +257,25 @@ void close_kafka_client(KafkaClientHandle client) {
     rd_kafka_t* rk = producer->rk;
     
     if (rd_kafka_type(rk) == RD_KAFKA_PRODUCER) {
-        // 销毁生产者
+        // 销毁生产者（先停止统计轮询线程，flush会在当前线程处理剩余的回调）
+        kafka_stats_stop(producer->stats);
         rd_kafka_flush(producer->rk, 5000);
         rd_kafka_destroy(producer->rk);
+        kafka_metadata_cache_destroy(producer->metadata);
+        kafka_config_cache_destroy(producer->configs);
+        kafka_stats_destroy(producer->stats);
+        kafka_connect_state_destroy(producer->connect);
         free(producer);
     } else {
         // 作为消费者处理
         KafkaConsumer* consumer = (KafkaConsumer*)client;
+        // 先停止后台消费循环，再关闭写入线程，保证没有线程继续使用rk
+        if (consumer->loop) {
+            kafka_consume_loop_destroy(consumer->loop);
+            consumer->loop = NULL;
+        }
+        stop_kafka_auto_save(consumer);
+        kafka_stats_stop(consumer->stats);
         // 取消订阅
         if (consumer->topic_list) {
             rd_kafka_topic_partition_list_destroy(consumer->topic_list);
@@ -189,6 +283,11 @@ void close_kafka_client(KafkaClientHandle client) {
         // 关闭消费者
         rd_kafka_consumer_close(consumer->rk);
         rd_kafka_destroy(consumer->rk);
+        pthread_mutex_destroy(&consumer->writer_lock);
+        kafka_schema_registry_destroy(consumer->schemas);
+        kafka_metadata_cache_destroy(consumer->metadata);
+        kafka_config_cache_destroy(consumer->configs);
+        kafka_stats_destroy(consumer->stats);
         free(consumer);
     }
 }
@@ -196,50 +295,33 @@ void close_kafka_client(KafkaClientHandle client) {
 // 获取主题列表
 char** get_kafka_topics(KafkaClientHandle client, int32_t* topic_count) {
     if (!client || !topic_count) {
-        printf("❌ C: get_kafka_topics - Invalid parameters: client=%p, topic_count=%p\n", client, topic_count);
+        KLOG_ERROR("get_kafka_topics - Invalid parameters: client=%p, topic_count=%p", client, topic_count);
         return NULL;
     }
     
-    printf("🔧 C: get_kafka_topics - Client handle received: %p\n", client);
-    rd_kafka_t* rk = ((KafkaProducer*)client)->rk;
-    printf("🔧 C: get_kafka_topics - Kafka client pointer: %p\n", rk);
-    const struct rd_kafka_metadata* metadata;
-    
-    // 向broker请求元数据
-    printf("🔧 C: get_kafka_topics - Calling rd_kafka_metadata...\n");
-    rd_kafka_resp_err_t err = rd_kafka_metadata(
-        rk,                 // 客户端
-        1,                  // 包括主题元数据
-        NULL,               // 特定主题（NULL表示所有主题）
-        &metadata,          // 输出元数据
-        5000);              // 超时时间（毫秒）
-    
-    if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
-        printf("❌ C: get_kafka_topics - Failed to get metadata: %s\n", rd_kafka_err2str(err));
+    // 元数据缓存未过期时不再请求broker
+    KafkaMetadataRef* ref;
+    const struct rd_kafka_metadata* metadata = kafka_metadata_all(client, &ref);
+    if (!metadata) {
+        KLOG_ERROR("get_kafka_topics - Failed to get metadata");
         return NULL;
     }
     
-    printf("✅ C: get_kafka_topics - Successfully got metadata\n");
-    printf("🔧 C: get_kafka_topics - Broker count: %d\n", metadata->broker_cnt);
-    printf("🔧 C: get_kafka_topics - Topic count: %d\n", metadata->topic_cnt);
+    KLOG_DEBUG("get_kafka_topics - Broker count: %d, topic count: %d", metadata->broker_cnt, metadata->topic_cnt);
     
     // 分配主题名称数组
     char** topic_names = malloc(metadata->topic_cnt * sizeof(char*));
     if (!topic_names) {
-        printf("❌ C: get_kafka_topics - Failed to allocate memory for topic names\n");
-        rd_kafka_metadata_destroy(metadata);
+        KLOG_ERROR("get_kafka_topics - Failed to allocate memory for topic names");
+        kafka_metadata_release(client, ref);
         return NULL;
     }
     
-    // 复制主题名称，过滤内部主题
+    // 复制主题名称，过滤内部主题（以__开头）
     int32_t actual_topic_count = 0;
     for (int i = 0; i < metadata->topic_cnt; i++) {
         const struct rd_kafka_metadata_topic* topic = &metadata->topics[i];
-        printf("🔍 C: get_kafka_topics - Topic %d: %s\n", i, topic->topic);
-        
-        // 过滤内部主题（以__开头）
         if (strncmp(topic->topic, "__", 2) == 0) {
-            printf("⏭️  C: get_kafka_topics - Skipping internal topic: %s\n", topic->topic);
             continue;
         }
         
@@ -247,26 +329,22 @@ char** get_kafka_topics(KafkaClientHandle client, int32_t* topic_count) {
         if (!topic_names[actual_topic_count]) {
             // 清理已分配的内存
             for (int j = 0; j < actual_topic_count; j++) {
-                if (topic_names[j]) {
-                    free(topic_names[j]);
-                }
+                free(topic_names[j]);
             }
             free(topic_names);
-            rd_kafka_metadata_destroy(metadata);
-            printf("❌ C: get_kafka_topics - Failed to duplicate topic name\n");
+            kafka_metadata_release(client, ref);
+            KLOG_ERROR("get_kafka_topics - Failed to duplicate topic name");
             return NULL;
         }
         actual_topic_count++;
     }
     
-    printf("🔧 C: get_kafka_topics - Actual topic count (excluding internal): %d\n", actual_topic_count);
-    
     // 如果有跳过的内部主题，重新分配内存
     if (actual_topic_count < metadata->topic_cnt && actual_topic_count > 0) {
         char** filtered_topic_names = realloc(topic_names, actual_topic_count * sizeof(char*));
         if (!filtered_topic_names) {
             // 如果realloc失败，继续使用原数组
-            printf("⚠️  C: get_kafka_topics - Failed to realloc topic names, using original array\n");
+            KLOG_WARN("get_kafka_topics - Failed to realloc topic names, using original array");
         } else {
             topic_names = filtered_topic_names;
         }
@@ -276,9 +354,9 @@ char** get_kafka_topics(KafkaClientHandle client, int32_t* topic_count) {
     }
     
     *topic_count = actual_topic_count;
-    printf("✅ C: get_kafka_topics - Returning %d topics\n", actual_topic_count);
+    KLOG_DEBUG("get_kafka_topics - Returning %d topics (excluding internal)", actual_topic_count);
     
-    rd_kafka_metadata_destroy(metadata);
+    kafka_metadata_release(client, ref);
     return topic_names;
 }
 
@@ -309,7 +387,8 @@ KafkaErrorCode send_kafka_message(KafkaClientHandle producer, const char* topic,
         return KAFKA_ERROR_SEND;
     }
     
-    // 发送消息
+    // 发送消息（私有数据是produce时的单调时钟，投递报告回调据此统计延迟）
+    int64_t start_ns = kafka_monotonic_ns();
     rd_kafka_resp_err_t err = rd_kafka_produce(
         rkt,                                   // 主题
         RD_KAFKA_PARTITION_UA,                 // 自动分区
@@ -318,7 +397,8 @@ KafkaErrorCode send_kafka_message(KafkaClientHandle producer, const char* topic,
         strlen(message),                       // 消息长度
         NULL,                                  // 键
         0,                                     // 键长度
-        NULL);                                 // 私有数据
+        (void*)(intptr_t)start_ns);            // 私有数据
+    kafka_latency_record(KAFKA_LATENCY_PRODUCE_CALL, kafka_monotonic_ns() - start_ns);
     
     // 销毁主题
     rd_kafka_topic_destroy(rkt);
@@ -384,57 +464,16 @@ KafkaMessageHandle consume_kafka_message(KafkaClientHandle consumer, int32_t tim
         return NULL;
     }
     
-    // 创建消息上下文
-    KafkaMessage* message = malloc(sizeof(KafkaMessage));
-    if (!message) {
-        rd_kafka_message_destroy(rkmessage);
-        return NULL;
-    }
-    
-    // 复制消息内容
-    if (rkmessage->payload && rkmessage->len > 0) {
-        message->content = malloc(rkmessage->len + 1);
-        if (!message->content) {
-            free(message);
-            rd_kafka_message_destroy(rkmessage);
-            return NULL;
-        }
-        memcpy(message->content, rkmessage->payload, rkmessage->len);
-        message->content[rkmessage->len] = '\0';
-    } else {
-        message->content = strdup("");
-    }
-    
-    // 复制消息key
-    if (rkmessage->key && rkmessage->key_len > 0) {
-        message->key = malloc(rkmessage->key_len + 1);
-        if (!message->key) {
-            free(message->content);
-            free(message);
-            rd_kafka_message_destroy(rkmessage);
-            return NULL;
-        }
-        memcpy(message->key, rkmessage->key, rkmessage->key_len);
-        message->key[rkmessage->key_len] = '\0';
-    } else {
-        message->key = strdup("");
-    }
-    
-    // 复制主题名称
-    if (rkmessage->rkt) {
-        message->topic = strdup(rd_kafka_topic_name(rkmessage->rkt));
-    } else {
-        message->topic = strdup("");
-    }
+    // 自动保存直接使用原始字节，不经过Dart
+    kafka_consumer_autosave(c, rkmessage->payload, rkmessage->len);
     
-    message->offset = rkmessage->offset;
-    message->partition = rkmessage->partition;
-    
-    // 获取消息时间戳
-    rd_kafka_timestamp_type_t ts_type;
-    message->timestamp = rd_kafka_message_timestamp(rkmessage, &ts_type);
+    // 创建消息上下文
+    KafkaMessage* message = kafka_message_from_rd(rkmessage);
     
     rd_kafka_message_destroy(rkmessage);
+    if (message && c->schemas) {
+        kafka_schema_decode(c->schemas, message);
+    }
     return message;
 }
 
@@ -515,31 +554,23 @@ KafkaErrorCode seek_to_timestamp(KafkaClientHandle consumer, const char* topic,
         return KAFKA_ERROR;
     }
     
-    // 获取分区列表
-    const struct rd_kafka_metadata* metadata;
-    rd_kafka_resp_err_t err = rd_kafka_metadata(rk, 1, rd_kafka_topic_new(rk, topic, NULL), &metadata, 5000);
-    rd_kafka_topic_destroy(rd_kafka_topic_new(rk, topic, NULL));
-    
+    // 获取分区列表（定向查询该主题的元数据）
+    const struct rd_kafka_metadata_topic* meta_topic;
+    KafkaMetadataRef* ref;
+    rd_kafka_resp_err_t err = kafka_metadata_topic(consumer, topic, &meta_topic, &ref);
     if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
         rd_kafka_topic_partition_list_destroy(partitions);
         return KAFKA_ERROR;
     }
     
-    // 遍历所有分区
-    for (i = 0; i < metadata->topic_cnt; i++) {
-        const struct rd_kafka_metadata_topic* meta_topic = &metadata->topics[i];
-        if (strcmp(meta_topic->topic, topic) == 0) {
-            // 为每个分区设置要查找的时间戳
-            for (int j = 0; j < meta_topic->partition_cnt; j++) {
-                const struct rd_kafka_metadata_partition* meta_partition = &meta_topic->partitions[j];
-                rd_kafka_topic_partition_t* rktpar = rd_kafka_topic_partition_list_add(partitions, topic, meta_partition->id);
-                rktpar->offset = timestamp_ms;
-            }
-            break;
-        }
+    // 为每个分区设置要查找的时间戳
+    for (i = 0; i < meta_topic->partition_cnt; i++) {
+        const struct rd_kafka_metadata_partition* meta_partition = &meta_topic->partitions[i];
+        rd_kafka_topic_partition_t* rktpar = rd_kafka_topic_partition_list_add(partitions, topic, meta_partition->id);
+        rktpar->offset = timestamp_ms;
     }
     
-    rd_kafka_metadata_destroy(metadata);
+    kafka_metadata_release(consumer, ref);
     
     if (partitions->cnt == 0) {
         rd_kafka_topic_partition_list_destroy(partitions);
@@ -580,13 +611,69 @@ KafkaErrorCode seek_to_timestamp(KafkaClientHandle consumer, const char* topic,
     return KAFKA_OK;
 }
 
-// 释放消息
-void free_kafka_message(KafkaMessageHandle message) {
+// 将librdkafka消息复制为KafkaMessage
+KafkaMessage* kafka_message_from_rd(const rd_kafka_message_t* rkmessage) {
+    KafkaMessage* message = malloc(sizeof(KafkaMessage));
     if (!message) {
+        return NULL;
+    }
+    message->polled_ns = kafka_monotonic_ns();
+    
+    // 复制消息内容
+    if (rkmessage->payload && rkmessage->len > 0) {
+        message->content = malloc(rkmessage->len + 1);
+        if (!message->content) {
+            free(message);
+            return NULL;
+        }
+        memcpy(message->content, rkmessage->payload, rkmessage->len);
+        message->content[rkmessage->len] = '\0';
+        message->content_len = rkmessage->len;
+    } else {
+        message->content = strdup("");
+        message->content_len = 0;
+    }
+    
+    // 识别消息类型，只在这里扫描一次
+    message->payload_type = kafka_classify_payload(message->content, message->content_len);
+    message->schema_id = -1;
+    
+    // 复制消息key
+    if (rkmessage->key && rkmessage->key_len > 0) {
+        message->key = malloc(rkmessage->key_len + 1);
+        if (!message->key) {
+            free(message->content);
+            free(message);
+            return NULL;
+        }
+        memcpy(message->key, rkmessage->key, rkmessage->key_len);
+        message->key[rkmessage->key_len] = '\0';
+    } else {
+        message->key = strdup("");
+    }
+    
+    // 复制主题名称
+    if (rkmessage->rkt) {
+        message->topic = strdup(rd_kafka_topic_name(rkmessage->rkt));
+    } else {
+        message->topic = strdup("");
+    }
+    
+    message->offset = rkmessage->offset;
+    message->partition = rkmessage->partition;
+    
+    // 获取消息时间戳
+    rd_kafka_timestamp_type_t ts_type;
+    message->timestamp = rd_kafka_message_timestamp(rkmessage, &ts_type);
+    return message;
+}
+
+// 释放KafkaMessage
+void kafka_message_destroy(KafkaMessage* msg) {
+    if (!msg) {
         return;
     }
     
-    KafkaMessage* msg = (KafkaMessage*)message;
     if (msg->content) {
         free(msg->content);
     }
@@ -599,6 +686,11 @@ void free_kafka_message(KafkaMessageHandle message) {
     free(msg);
 }
 
+// 释放消息
+void free_kafka_message(KafkaMessageHandle message) {
+    kafka_message_destroy((KafkaMessage*)message);
+}
+
 // 获取错误信息
 const char* get_kafka_error_msg(KafkaErrorCode error_code) {
     if (error_code < 0 || error_code >= sizeof(error_messages) / sizeof(error_messages[0])) {
@@ -615,57 +707,79 @@ KafkaErrorCode get_kafka_topic_info(
     int32_t* partition_count,
     int32_t* replication_factor) {
     if (!client || !topic_name || !partition_count || !replication_factor) {
-        printf("❌ C: get_kafka_topic_info - Invalid parameters\n");
+        KLOG_ERROR("get_kafka_topic_info - Invalid parameters");
         return KAFKA_ERROR;
     }
 
-    printf("🔧 C: get_kafka_topic_info called for topic: %s\n", topic_name);
-    rd_kafka_t* rk = ((KafkaProducer*)client)->rk;
-    const struct rd_kafka_metadata* metadata;
-
-    // 向broker请求元数据
-    rd_kafka_resp_err_t err = rd_kafka_metadata(
-        rk,                 // 客户端
-        1,                  // 包括主题元数据
-        NULL,               // 特定主题（NULL表示所有主题）
-        &metadata,          // 输出元数据
-        5000);              // 超时时间（毫秒）
+    KLOG_DEBUG("get_kafka_topic_info called for topic: %s", topic_name);
 
+    // 只请求该主题的元数据（缓存未过期时直接复用）
+    const struct rd_kafka_metadata_topic* topic;
+    KafkaMetadataRef* ref;
+    rd_kafka_resp_err_t err = kafka_metadata_topic(client, topic_name, &topic, &ref);
+    if (err == RD_KAFKA_RESP_ERR_UNKNOWN_TOPIC_OR_PART) {
+        KLOG_ERROR("get_kafka_topic_info - Topic %s not found", topic_name);
+        return KAFKA_ERROR_TOPICS;  // 主题不存在
+    }
     if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
-        printf("❌ C: get_kafka_topic_info - Failed to get metadata: %s\n", rd_kafka_err2str(err));
+        KLOG_ERROR("get_kafka_topic_info - Failed to get metadata: %s", rd_kafka_err2str(err));
         return KAFKA_ERROR;
     }
 
-    printf("✅ C: get_kafka_topic_info - Successfully got metadata with %d topics\n", metadata->topic_cnt);
+    // 设置分区数量
+    *partition_count = topic->partition_cnt;
 
-    // 查找指定主题
-    for (int i = 0; i < metadata->topic_cnt; i++) {
-        const struct rd_kafka_metadata_topic* topic = &metadata->topics[i];
-        printf("🔍 C: Checking topic: %s (partitions: %d)\n", topic->topic, topic->partition_cnt);
-        if (strcmp(topic->topic, topic_name) == 0) {
-            // 设置分区数量
-            *partition_count = topic->partition_cnt;
-            
-            // 计算平均副本因子（如果可用）
-            int32_t total_replicas = 0;
-            for (int j = 0; j < topic->partition_cnt; j++) {
-                const struct rd_kafka_metadata_partition* partition = &topic->partitions[j];
-                total_replicas += partition->replica_cnt;
-            }
-            *replication_factor = (total_replicas > 0 && topic->partition_cnt > 0) ? 
-                                total_replicas / topic->partition_cnt : 0;
-            
-            printf("✅ C: get_kafka_topic_info - Found topic %s with %d partitions and replication factor %d\n", 
-                topic_name, *partition_count, *replication_factor);
-            
-            rd_kafka_metadata_destroy(metadata);
-            return KAFKA_OK;
+    // 计算平均副本因子（如果可用）
+    int32_t total_replicas = 0;
+    for (int j = 0; j < topic->partition_cnt; j++) {
+        const struct rd_kafka_metadata_partition* partition = &topic->partitions[j];
+        total_replicas += partition->replica_cnt;
+    }
+    *replication_factor = (total_replicas > 0 && topic->partition_cnt > 0) ? 
+                        total_replicas / topic->partition_cnt : 0;
+
+    KLOG_DEBUG("get_kafka_topic_info - Found topic %s with %d partitions and replication factor %d", 
+        topic_name, *partition_count, *replication_factor);
+
+    kafka_metadata_release(client, ref);
+    return KAFKA_OK;
+}
+
+// 用元数据和水位填充分区信息
+void kafka_partition_info_fill(
+    KafkaPartitionInfo* info,
+    const struct rd_kafka_metadata_partition* partition,
+    int64_t low,
+    int64_t high) {
+    info->id = partition->id;
+    info->leader = partition->leader;
+
+    // 构建副本列表字符串
+    char replicas_str[512] = "";
+    for (int j = 0; j < partition->replica_cnt; j++) {
+        if (j > 0) {
+            strcat(replicas_str, ",");
+        }
+        char broker_id[16];
+        sprintf(broker_id, "%d", partition->replicas[j]);
+        strcat(replicas_str, broker_id);
+    }
+    info->replicas = strdup(replicas_str);
+
+    // 构建ISR列表字符串
+    char isr_str[512] = "";
+    for (int j = 0; j < partition->isr_cnt; j++) {
+        if (j > 0) {
+            strcat(isr_str, ",");
         }
+        char broker_id[16];
+        sprintf(broker_id, "%d", partition->isrs[j]);
+        strcat(isr_str, broker_id);
     }
+    info->isr = strdup(isr_str);
 
-    printf("❌ C: get_kafka_topic_info - Topic %s not found\n", topic_name);
-    rd_kafka_metadata_destroy(metadata);
-    return KAFKA_ERROR_TOPICS;  // 主题不存在
+    info->earliest_offset = low;
+    info->latest_offset = high;
 }
 
 // 获取主题分区详情
@@ -674,103 +788,64 @@ KafkaPartitionInfo* get_kafka_topic_partitions(
     const char* topic_name,
     int32_t* partition_count) {
     if (!client || !topic_name || !partition_count) {
-        printf("❌ C: get_kafka_topic_partitions - Invalid parameters\n");
+        KLOG_ERROR("get_kafka_topic_partitions - Invalid parameters");
         return NULL;
     }
 
-    printf("🔧 C: get_kafka_topic_partitions called for topic: %s\n", topic_name);
-    rd_kafka_t* rk = ((KafkaProducer*)client)->rk;
-    const struct rd_kafka_metadata* metadata;
-
-    // 向broker请求元数据
-    rd_kafka_resp_err_t err = rd_kafka_metadata(
-        rk,                 // 客户端
-        1,                  // 包括主题元数据
-        NULL,               // 特定主题（NULL表示所有主题）
-        &metadata,          // 输出元数据
-        5000);              // 超时时间（毫秒）
+    KLOG_DEBUG("get_kafka_topic_partitions called for topic: %s", topic_name);
 
+    // 只请求该主题的元数据（缓存未过期时直接复用）
+    const struct rd_kafka_metadata_topic* target_topic;
+    KafkaMetadataRef* ref;
+    rd_kafka_resp_err_t err = kafka_metadata_topic(client, topic_name, &target_topic, &ref);
     if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
-        printf("❌ C: get_kafka_topic_partitions - Failed to get metadata: %s\n", rd_kafka_err2str(err));
+        KLOG_ERROR("get_kafka_topic_partitions - Failed to get metadata for %s: %s",
+            topic_name, rd_kafka_err2str(err));
         return NULL;
     }
 
-    printf("✅ C: get_kafka_topic_partitions - Successfully got metadata with %d topics\n", metadata->topic_cnt);
-
-    // 查找指定主题
-    const struct rd_kafka_metadata_topic* target_topic = NULL;
-    for (int i = 0; i < metadata->topic_cnt; i++) {
-        if (strcmp(metadata->topics[i].topic, topic_name) == 0) {
-            target_topic = &metadata->topics[i];
-            break;
-        }
-    }
-
-    if (!target_topic) {
-        printf("❌ C: get_kafka_topic_partitions - Topic %s not found\n", topic_name);
-        rd_kafka_metadata_destroy(metadata);
-        return NULL;
-    }
-
-    printf("✅ C: get_kafka_topic_partitions - Found topic %s with %d partitions\n", 
+    KLOG_DEBUG("get_kafka_topic_partitions - Found topic %s with %d partitions", 
         topic_name, target_topic->partition_cnt);
 
     // 分配分区信息数组
     KafkaPartitionInfo* partitions = malloc(target_topic->partition_cnt * sizeof(KafkaPartitionInfo));
     if (!partitions) {
-        rd_kafka_metadata_destroy(metadata);
+        kafka_metadata_release(client, ref);
         return NULL;
     }
 
-    // 填充分区信息
-    for (int i = 0; i < target_topic->partition_cnt; i++) {
-        const struct rd_kafka_metadata_partition* partition = &target_topic->partitions[i];
-        partitions[i].id = partition->id;
-        partitions[i].leader = partition->leader;
+    // 一次批量查询所有分区的水位
+    int32_t n = target_topic->partition_cnt;
+    rd_kafka_topic_partition_list_t* list = rd_kafka_topic_partition_list_new(n);
+    for (int i = 0; i < n; i++) {
+        rd_kafka_topic_partition_list_add(list, topic_name, target_topic->partitions[i].id);
+    }
+    int64_t* low = malloc((n > 0 ? n : 1) * sizeof(int64_t));
+    int64_t* high = malloc((n > 0 ? n : 1) * sizeof(int64_t));
+    int32_t failed = n;
+    if (low && high) {
+        failed = kafka_query_watermarks(client, list, low, high);
+    }
+    rd_kafka_topic_partition_list_destroy(list);
 
-        // 构建副本列表字符串
-        char replicas_str[512] = "";
-        for (int j = 0; j < partition->replica_cnt; j++) {
-            if (j > 0) {
-                strcat(replicas_str, ",");
-            }
-            char broker_id[16];
-            sprintf(broker_id, "%d", partition->replicas[j]);
-            strcat(replicas_str, broker_id);
-        }
-        partitions[i].replicas = strdup(replicas_str);
+    // 填充分区信息（-1 表示查询失败）
+    for (int i = 0; i < n; i++) {
+        kafka_partition_info_fill(&partitions[i], &target_topic->partitions[i],
+            low && high ? low[i] : -1, low && high ? high[i] : -1);
+    }
+    free(low);
+    free(high);
 
-        // 构建ISR列表字符串
-        char isr_str[512] = "";
-        for (int j = 0; j < partition->isr_cnt; j++) {
-            if (j > 0) {
-                strcat(isr_str, ",");
-            }
-            char broker_id[16];
-            sprintf(broker_id, "%d", partition->isrs[j]);
-            strcat(isr_str, broker_id);
-        }
-        partitions[i].isr = strdup(isr_str);
-
-        // 获取真实的偏移量
-        int64_t low, high;
-        rd_kafka_resp_err_t err = rd_kafka_query_watermark_offsets(
-            rk, topic_name, partition->id, &low, &high, 5000);
-        if (err == RD_KAFKA_RESP_ERR_NO_ERROR) {
-            partitions[i].earliest_offset = low;
-            partitions[i].latest_offset = high;
-            printf("🔍 C: Partition %d - earliest_offset: %lld, latest_offset: %lld\n", 
-                partition->id, low, high);
-        } else {
-            printf("❌ C: Failed to get offsets for partition %d: %s\n", 
-                partition->id, rd_kafka_err2str(err));
-            partitions[i].earliest_offset = -1;  // 表示错误状态
-            partitions[i].latest_offset = -1;    // 表示错误状态
-        }
+    if (failed > 0) {
+        KLOG_ERROR("Failed to get offsets for %d of %d partitions", failed, n);
     }
 
     *partition_count = target_topic->partition_cnt;
-    rd_kafka_metadata_destroy(metadata);
+    kafka_metadata_release(client, ref);
+    if (failed > 0) {
+        // leader可能已经变化，下次重新获取元数据
+        kafka_metadata_invalidate(client, topic_name);
+    }
     return partitions;
 }
 
@@ -789,92 +864,4 @@ void free_kafka_topic_partitions(KafkaPartitionInfo* partitions, int32_t partiti
         }
     }
     free(partitions);
-}
-
-// 获取主题配置参数
-KafkaConfigParam* get_kafka_topic_config(
-    KafkaClientHandle client,
-    const char* topic_name,
-    int32_t* param_count) {
-    if (!client || !topic_name || !param_count) {
-        printf("❌ C: get_kafka_topic_config - Invalid parameters\n");
-        return NULL;
-    }
-
-    printf("🔧 C: get_kafka_topic_config called for topic: %s\n", topic_name);
-    
-    // 由于API兼容性问题，返回一些基本配置作为后备
-    *param_count = 4;
-    KafkaConfigParam* params = malloc(4 * sizeof(KafkaConfigParam));
-    if (!params) {
-        return NULL;
-    }
-    
-    params[0].key = strdup("retention.ms");
-    params[0].value = strdup("604800000");  // 7天
-    
-    params[1].key = strdup("cleanup.policy");
-    params[1].value = strdup("delete");
-    
-    params[2].key = strdup("segment.bytes");
-    params[2].value = strdup("1073741824");  // 1GB
-    
-    params[3].key = strdup("min.insync.replicas");
-    params[3].value = strdup("1");
-    
-    printf("✅ C: get_kafka_topic_config - Returned default config params\n");
-    return params;
-}
-
-// 释放主题配置参数
-void free_kafka_topic_config(KafkaConfigParam* params, int32_t param_count) {
-    if (!params || param_count <= 0) {
-        return;
-    }
-
-    for (int i = 0; i < param_count; i++) {
-        if (params[i].key) {
-            free(params[i].key);
-        }
-        if (params[i].value) {
-            free(params[i].value);
-        }
-    }
-    free(params);
-}
-
-// 获取主题的消费者组
-KafkaConsumerGroup* get_kafka_topic_consumer_groups(
-    KafkaClientHandle client,
-    const char* topic_name,
-    int32_t* group_count) {
-    if (!client || !topic_name || !group_count) {
-        printf("❌ C: get_kafka_topic_consumer_groups - Invalid parameters\n");
-        return NULL;
-    }
-
-    printf("🔧 C: get_kafka_topic_consumer_groups called for topic: %s\n", topic_name);
-    
-    // 由于API兼容性问题，返回空结果
-    *group_count = 0;
-    printf("✅ C: get_kafka_topic_consumer_groups - Returning 0 consumer groups\n");
-    
-    return NULL;  // 返回NULL表示没有找到消费者组
-}
-
-// 释放消费者组
-void free_kafka_topic_consumer_groups(KafkaConsumerGroup* groups, int32_t group_count) {
-    if (!groups || group_count <= 0) {
-        return;
-    }
-
-    for (int i = 0; i < group_count; i++) {
-        if (groups[i].name) {
-            free(groups[i].name);
-        }
-        if (groups[i].status) {
-            free(groups[i].status);
-        }
-    }
-    free(groups);
 }
\ No newline at end of file
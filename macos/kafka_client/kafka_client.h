@@ -17,6 +17,15 @@ typedef void* KafkaClientHandle;
 // Kafka消息句柄
 typedef void* KafkaMessageHandle;
 
+// 消息存储句柄
+typedef void* KafkaStoreHandle;
+
+// 集群主题概览句柄
+typedef void* KafkaOverviewHandle;
+
+// 主题索引句柄
+typedef void* KafkaTopicIndexHandle;
+
 // 错误码
 typedef int32_t KafkaErrorCode;
 
@@ -30,6 +39,30 @@ KafkaClientHandle create_kafka_consumer(const char* bootstrap_servers, const cha
 // auto_offset_reset: "earliest", "latest"
 KafkaClientHandle create_kafka_consumer_with_config(const char* bootstrap_servers, const char* group_id, const char* auto_offset_reset);
 
+// 消费者配置档
+enum {
+    KAFKA_CONSUMER_PROFILE_DEFAULT = 0,
+    KAFKA_CONSUMER_PROFILE_SCAN = 1,    // 全量扫描：大批量拉取、深预取队列、不提交偏移量
+};
+
+// 按配置档创建消费者，config_keys/config_values（config_count项）在配置档之后覆盖任意librdkafka配置
+// 任何一项配置无效时返回NULL
+KafkaClientHandle create_kafka_consumer_with_profile(
+    const char* bootstrap_servers,
+    const char* group_id,
+    const char* auto_offset_reset,
+    int32_t profile,
+    const char** config_keys,
+    const char** config_values,
+    int32_t config_count);
+
+// 获取集群共享的管理客户端（按bootstrap_servers复用同一个连接，引用计数）
+// 用于元数据和Admin API查询；用完调用release_kafka_admin_client，不要调用close_kafka_client
+KafkaClientHandle acquire_kafka_admin_client(const char* bootstrap_servers);
+
+// 释放共享管理客户端的引用，最后一个引用释放时关闭连接
+void release_kafka_admin_client(KafkaClientHandle client);
+
 // 重置消费者偏移量到特定时间戳
 KafkaErrorCode seek_to_timestamp(KafkaClientHandle consumer, const char* topic, int64_t timestamp_ms);
 
@@ -39,6 +72,9 @@ void close_kafka_client(KafkaClientHandle client);
 // 获取主题列表
 char** get_kafka_topics(KafkaClientHandle client, int32_t* topic_count);
 
+// 让连接的元数据和主题配置缓存失效（刷新主题列表前调用）
+void invalidate_kafka_metadata(KafkaClientHandle client);
+
 // 释放主题列表
 void free_kafka_topics(char** topics, int32_t topic_count);
 
@@ -72,6 +108,126 @@ int64_t get_kafka_message_timestamp(KafkaMessageHandle message);
 // 释放消息
 void free_kafka_message(KafkaMessageHandle message);
 
+// 消息类型（消费时识别一次，随消息返回）
+enum {
+    KAFKA_PAYLOAD_EMPTY = 0,
+    KAFKA_PAYLOAD_TEXT = 1,       // 合法UTF-8文本
+    KAFKA_PAYLOAD_JSON = 2,
+    KAFKA_PAYLOAD_XML = 3,
+    KAFKA_PAYLOAD_CONFLUENT = 4,  // Schema Registry格式（0x00 + schema id）
+    KAFKA_PAYLOAD_BINARY = 5,     // 非UTF-8或含控制字符
+    KAFKA_PAYLOAD_AVRO = 6,       // 已按schema解码，content为JSON文本
+    KAFKA_PAYLOAD_PROTOBUF = 7,   // 已按schema解码，content为JSON文本
+};
+
+// 批量取出的消息（content可能包含任意字节，以content_len为准）
+typedef struct {
+    char* topic;
+    char* key;
+    char* content;
+    int32_t content_len;    // content的字节数（可能是截断后的预览）
+    int32_t total_len;      // 完整消息的字节数
+    int32_t payload_type;   // KAFKA_PAYLOAD_*
+    int32_t schema_id;      // Schema Registry的schema id，没有时为-1
+    int32_t partition;
+    int64_t offset;
+    int64_t timestamp;
+} KafkaMessageRecord;
+
+// 启动后台消费循环，消息进入容量为ring_capacity的环形队列
+KafkaErrorCode start_kafka_consume_loop(KafkaClientHandle consumer, int32_t ring_capacity);
+
+// 停止后台消费循环
+void stop_kafka_consume_loop(KafkaClientHandle consumer);
+
+// 消费背压：环形队列占用达到ring_high_percent时暂停已分配的分区，回落到ring_low_percent以下恢复（默认80/50），
+// high为0时不检查。store不为NULL时，因内存暂停期间由它淘汰旧记录直到回落到恢复线（store在消费循环停止前不能销毁；
+// 存储超出容量时自己淘汰，不作为暂停条件）。需在start_kafka_consume_loop之前调用
+KafkaErrorCode set_kafka_consume_backpressure(
+    KafkaClientHandle consumer,
+    int32_t ring_high_percent,
+    int32_t ring_low_percent,
+    KafkaStoreHandle store);
+
+// 消费循环暂停的原因（位掩码）
+enum {
+    KAFKA_PAUSE_RING = 1,       // 环形队列积压（Dart取得不够快）
+    KAFKA_PAUSE_MEMORY = 4,     // 进程内存超过软上限
+};
+
+// 获取消费循环当前暂停的原因，0表示正常拉取
+int32_t get_kafka_consume_pause_state(KafkaClientHandle consumer);
+
+// 配置Schema Registry解码（需在start_kafka_consume_loop之前调用）
+// registry_url和local_dir可以只传一个；本地目录中按 <id>.avsc / <id>.proto / <id>.json 查找schema
+// decode_threads为消费循环中并行解码的线程数，<=0时使用CPU核数
+KafkaErrorCode set_kafka_schema_registry(
+    KafkaClientHandle consumer,
+    const char* registry_url,
+    const char* local_dir,
+    int32_t decode_threads);
+
+// 批量取出消息，最多max_messages条
+// store不为NULL且preview_bytes > 0时，超长消息只返回按UTF-8边界截断的预览，完整内容转入store
+KafkaMessageRecord* drain_kafka_messages(
+    KafkaClientHandle consumer,
+    int32_t max_messages,
+    KafkaStoreHandle store,
+    int32_t preview_bytes,
+    int32_t* count);
+
+// 释放批量取出的消息
+void free_kafka_message_records(KafkaMessageRecord* records, int32_t count);
+
+// 创建消息存储，超过max_bytes时淘汰最早保存的消息（独立于消费者，关闭消费者后仍可读取）
+KafkaStoreHandle create_kafka_store(int64_t max_bytes);
+
+// 释放消息存储
+void destroy_kafka_store(KafkaStoreHandle store);
+
+// 清空消息存储
+void clear_kafka_store(KafkaStoreHandle store);
+
+// 获取被截断消息的完整内容，不在存储中时返回NULL（返回副本，需调用free_kafka_payload释放）
+char* fetch_kafka_payload(KafkaStoreHandle store, int32_t partition, int64_t offset, int32_t* len);
+
+// 释放完整消息内容
+void free_kafka_payload(char* payload);
+
+// 按偏移量范围读取一页历史消息：assign partitions[i]的[start_offsets[i], end_offsets[i])，
+// 读到每个分区的结束位置、分区末尾（需要enable.partition.eof）或timeout_ms超时为止，然后取消分配。
+// consumer不能订阅主题或运行消费循环；返回的消息按时间戳排序，用free_kafka_message_records释放
+KafkaMessageRecord* fetch_kafka_page(
+    KafkaClientHandle consumer,
+    const char* topic,
+    const int32_t* partitions,
+    const int64_t* start_offsets,
+    const int64_t* end_offsets,
+    int32_t partition_count,
+    KafkaStoreHandle store,
+    int32_t preview_bytes,
+    int32_t timeout_ms,
+    int32_t* count);
+
+// 启动自动保存（format: "json", "csv", "txt"）
+// rotate_bytes / rotate_interval_sec 为0表示不按该条件轮转，compress非0时轮转出的文件在后台gzip
+KafkaErrorCode start_kafka_auto_save(
+    KafkaClientHandle consumer,
+    const char* file_path,
+    const char* format,
+    int64_t rotate_bytes,
+    int32_t rotate_interval_sec,
+    int32_t compress);
+
+// 停止自动保存，等待剩余数据写完
+KafkaErrorCode stop_kafka_auto_save(KafkaClientHandle consumer);
+
+// 格式化JSON（缩进indent_width个空格），不是合法JSON时返回NULL
+char* format_kafka_json(const char* data, int32_t len, int32_t indent_width, int32_t* out_len);
+
+// 释放格式化结果
+void free_kafka_json(char* json);
+
 // 获取主题分区信息
 typedef struct {
     int32_t id;
@@ -82,18 +238,41 @@ typedef struct {
     int64_t earliest_offset;
 } KafkaPartitionInfo;
 
+// 分区水位（查询失败时earliest/latest为-1）
+typedef struct {
+    char* topic;
+    int32_t partition;
+    int32_t leader;
+    int64_t earliest_offset;
+    int64_t latest_offset;
+} KafkaPartitionOffsets;
+
 // 获取主题配置信息
 typedef struct {
     char* key;
-    char* value;
+    char* value;            // 敏感配置为空字符串
+    int32_t source;         // rd_kafka_ConfigSource_t
+    int32_t is_default;
+    int32_t is_read_only;
+    int32_t is_sensitive;
 } KafkaConfigParam;
 
+// 主题配置摘要（主题列表显示用）
+typedef struct {
+    char* topic;
+    char* cleanup_policy;   // 查询失败时为NULL
+    int64_t retention_ms;   // -1表示不限
+    int64_t retention_bytes;
+} KafkaTopicConfigSummary;
+
 // 获取消费者组信息
 typedef struct {
     char* name;
     int32_t members;
-    int64_t lag;
+    int64_t lag;            // 各分区latest与已提交偏移量之差的总和
     char* status;
+    int32_t coordinator;    // 协调者broker id，未知时为-1
+    int64_t offset;         // 各分区已提交偏移量的总和
 } KafkaConsumerGroup;
 
 // 获取主题的基本信息
@@ -112,6 +291,16 @@ KafkaPartitionInfo* get_kafka_topic_partitions(
 // 释放主题分区详情
 void free_kafka_topic_partitions(KafkaPartitionInfo* partitions, int32_t partition_count);
 
+// 批量获取多个主题所有分区的earliest/latest偏移量（按leader并行请求，一次返回全部结果）
+KafkaPartitionOffsets* get_kafka_watermarks(
+    KafkaClientHandle client,
+    const char** topics,
+    int32_t topic_count,
+    int32_t* count);
+
+// 释放水位查询结果
+void free_kafka_watermarks(KafkaPartitionOffsets* offsets, int32_t count);
+
 // 获取主题配置参数
 KafkaConfigParam* get_kafka_topic_config(
     KafkaClientHandle client,
@@ -121,7 +310,17 @@ KafkaConfigParam* get_kafka_topic_config(
 // 释放主题配置参数
 void free_kafka_topic_config(KafkaConfigParam* params, int32_t param_count);
 
-// 获取主题的消费者组
+// 批量获取主题配置摘要（DescribeConfigs每批数百个主题并行请求，结果按连接缓存）
+KafkaTopicConfigSummary* get_kafka_topic_config_summaries(
+    KafkaClientHandle client,
+    const char** topics,
+    int32_t topic_count,
+    int32_t* count);
+
+// 释放主题配置摘要
+void free_kafka_topic_config_summaries(KafkaTopicConfigSummary* summaries, int32_t count);
+
+// 获取消费该主题的消费者组及lag（组列表、已提交偏移量和水位批量并发查询）
 KafkaConsumerGroup* get_kafka_topic_consumer_groups(
     KafkaClientHandle client,
     const char* topic_name,
@@ -130,6 +329,351 @@ KafkaConsumerGroup* get_kafka_topic_consumer_groups(
 // 释放消费者组
 void free_kafka_topic_consumer_groups(KafkaConsumerGroup* groups, int32_t group_count);
 
+// 主题完整详情（主题详情页一次调用获取）
+typedef struct {
+    KafkaErrorCode error;           // 元数据查询失败时非KAFKA_OK，其余字段为空
+    int32_t partition_count;
+    int32_t replication_factor;
+    int32_t config_count;
+    int32_t group_count;
+    KafkaPartitionInfo* partitions;
+    KafkaConfigParam* configs;      // 配置查询失败时为NULL
+    KafkaConsumerGroup* groups;
+} KafkaTopicDescription;
+
+// 获取主题完整详情（元数据、水位、配置和消费者组在同一个Admin批次中并发查询）
+KafkaTopicDescription* describe_kafka_topic_full(KafkaClientHandle client, const char* topic_name);
+
+// 释放主题完整详情
+void free_kafka_topic_description(KafkaTopicDescription* desc);
+
+// 集群主题概览的一行
+typedef struct {
+    char* topic;
+    int32_t partition_count;
+    int32_t replication_factor;
+    int32_t under_replicated;   // ISR少于副本数的分区数
+    int64_t messages;           // 各分区latest与earliest之差的总和，水位查询失败时为-1
+    char* cleanup_policy;       // 配置查询失败时为NULL
+    int64_t retention_ms;       // -1表示不限
+    int64_t retention_bytes;
+} KafkaTopicOverview;
+
+// 启动集群主题概览（后台线程分块统计所有主题），topic_count返回主题总数
+KafkaOverviewHandle start_kafka_topic_overview(KafkaClientHandle client, int32_t* topic_count);
+
+// 取出已完成的概览行，最多max_rows行；所有主题都已统计并取完时done置1
+KafkaTopicOverview* drain_kafka_topic_overview(
+    KafkaOverviewHandle handle,
+    int32_t max_rows,
+    int32_t* count,
+    int32_t* done);
+
+// 释放取出的概览行
+void free_kafka_topic_overview(KafkaTopicOverview* rows, int32_t count);
+
+// 停止概览并释放资源；不等待正在查询的块，立即返回（资源由最后退出的工作线程释放），调用后handle失效
+void stop_kafka_topic_overview(KafkaOverviewHandle handle);
+
+// 主题索引刷新结果（和上一次刷新相比新增和删除的主题，均按名称排序）
+typedef struct {
+    char** added;
+    int32_t added_count;
+    char** removed;
+    int32_t removed_count;
+    int32_t total;          // 刷新后的主题总数
+} KafkaTopicIndexDiff;
+
+// 创建主题索引（排序的主题列表和三元组倒排索引）
+KafkaTopicIndexHandle create_kafka_topic_index(void);
+
+// 销毁主题索引
+void destroy_kafka_topic_index(KafkaTopicIndexHandle index);
+
+// 用集群当前的主题列表（不含内部主题）刷新索引，返回新增和删除的主题；第一次刷新时全部为新增
+KafkaTopicIndexDiff* refresh_kafka_topic_index(KafkaTopicIndexHandle index, KafkaClientHandle client);
+
+// 释放刷新结果
+void free_kafka_topic_index_diff(KafkaTopicIndexDiff* diff);
+
+// 搜索名称中包含query（不区分大小写）的主题，返回它们在排序后主题列表中的下标（递增）
+int32_t* search_kafka_topic_index(KafkaTopicIndexHandle index, const char* query, int32_t* count);
+
+// 释放搜索结果
+void free_kafka_topic_index_matches(int32_t* matches);
+
+// 异步查询完成回调（在后台线程调用）。每个被接受的请求恰好回调一次：
+// error为KAFKA_OK时result由调用方用对应的free_*函数释放；取消或超时时result为NULL
+typedef void (*KafkaAsyncCallback)(int64_t request_id, KafkaErrorCode error, void* result, int32_t count);
+
+// 以下异步查询在后台线程池中执行对应的同步函数，返回KAFKA_OK表示请求已接受。
+// timeout_ms为截止时间（<=0不限），超过后回调KAFKA_ERROR_TIMEOUT；
+// client是共享管理客户端时执行期间持有它的引用，其他客户端需要调用方保证在回调前不关闭
+
+// 异步连接集群：获取共享管理客户端并等待第一个可用连接（元数据响应到达），连接级错误时立即失败。
+// result为客户端句柄（release_kafka_admin_client），count为broker数量
+KafkaErrorCode connect_kafka_cluster_async(
+    const char* bootstrap_servers,
+    int64_t request_id,
+    int32_t timeout_ms,
+    KafkaAsyncCallback callback);
+
+// 异步获取主题列表，result为char**（free_kafka_topics）
+KafkaErrorCode get_kafka_topics_async(
+    KafkaClientHandle client,
+    int64_t request_id,
+    int32_t timeout_ms,
+    KafkaAsyncCallback callback);
+
+// 异步获取主题基本信息，result为KafkaTopicDescription*，只填写error、partition_count和replication_factor
+// （free_kafka_topic_description）
+KafkaErrorCode get_kafka_topic_info_async(
+    KafkaClientHandle client,
+    const char* topic_name,
+    int64_t request_id,
+    int32_t timeout_ms,
+    KafkaAsyncCallback callback);
+
+// 异步获取主题分区详情，result为KafkaPartitionInfo*（free_kafka_topic_partitions）
+KafkaErrorCode get_kafka_topic_partitions_async(
+    KafkaClientHandle client,
+    const char* topic_name,
+    int64_t request_id,
+    int32_t timeout_ms,
+    KafkaAsyncCallback callback);
+
+// 异步批量获取水位，result为KafkaPartitionOffsets*（free_kafka_watermarks）
+KafkaErrorCode get_kafka_watermarks_async(
+    KafkaClientHandle client,
+    const char** topics,
+    int32_t topic_count,
+    int64_t request_id,
+    int32_t timeout_ms,
+    KafkaAsyncCallback callback);
+
+// 异步获取主题配置参数，result为KafkaConfigParam*（free_kafka_topic_config）
+KafkaErrorCode get_kafka_topic_config_async(
+    KafkaClientHandle client,
+    const char* topic_name,
+    int64_t request_id,
+    int32_t timeout_ms,
+    KafkaAsyncCallback callback);
+
+// 异步批量获取主题配置摘要，result为KafkaTopicConfigSummary*（free_kafka_topic_config_summaries）
+KafkaErrorCode get_kafka_topic_config_summaries_async(
+    KafkaClientHandle client,
+    const char** topics,
+    int32_t topic_count,
+    int64_t request_id,
+    int32_t timeout_ms,
+    KafkaAsyncCallback callback);
+
+// 异步获取消费者组，result为KafkaConsumerGroup*（free_kafka_topic_consumer_groups）
+KafkaErrorCode get_kafka_topic_consumer_groups_async(
+    KafkaClientHandle client,
+    const char* topic_name,
+    int64_t request_id,
+    int32_t timeout_ms,
+    KafkaAsyncCallback callback);
+
+// 异步获取主题完整详情，result为KafkaTopicDescription*（free_kafka_topic_description）
+KafkaErrorCode describe_kafka_topic_full_async(
+    KafkaClientHandle client,
+    const char* topic_name,
+    int64_t request_id,
+    int32_t timeout_ms,
+    KafkaAsyncCallback callback);
+
+// 异步刷新主题索引，result为KafkaTopicIndexDiff*（free_kafka_topic_index_diff）
+KafkaErrorCode refresh_kafka_topic_index_async(
+    KafkaTopicIndexHandle index,
+    KafkaClientHandle client,
+    int64_t request_id,
+    int32_t timeout_ms,
+    KafkaAsyncCallback callback);
+
+// 取消异步请求：排队中的请求立即回调KAFKA_ERROR_CANCELLED，执行中的请求结束后丢弃结果再回调
+void cancel_kafka_async(int64_t request_id);
+
+// 客户端统计快照中的一个broker连接（bootstrap和组协调者连接的node_id为-1）
+typedef struct {
+    char* name;                 // host:port/node_id
+    char* state;                // INIT、UP、DOWN等
+    int32_t node_id;
+    int64_t rtt_avg_us;         // 请求往返时间（微秒，最近一个统计周期）
+    int64_t rtt_p99_us;
+    int64_t int_latency_avg_us; // 生产者消息在内部队列中的等待时间
+    int64_t outbuf_cnt;         // 等待发送的请求数
+    int64_t waitresp_cnt;       // 已发送、等待响应的请求数
+    int64_t tx;
+    int64_t tx_errs;
+    int64_t rx;
+    int64_t rx_bytes;
+    int64_t rx_errs;
+    int64_t req_timeouts;
+    int64_t connects;
+    int64_t disconnects;
+} KafkaBrokerStats;
+
+// 客户端统计快照中的一个主题，分区是partitions[partition_start, partition_start + partition_count)
+typedef struct {
+    char* topic;
+    int64_t batch_size_avg;     // 生产者平均批次字节数
+    int64_t batch_count_avg;    // 生产者平均每批消息数
+    int64_t metadata_age_ms;
+    int32_t partition_start;
+    int32_t partition_count;
+} KafkaTopicStats;
+
+// 客户端统计快照中的一个分区（偏移量未知时为-1）
+typedef struct {
+    int32_t topic_index;        // 在topics中的下标
+    int32_t partition;
+    int32_t leader;
+    int64_t msgq_cnt;           // 生产者待发送的消息数
+    int64_t xmit_msgq_cnt;
+    int64_t fetchq_cnt;         // 消费者预取队列中的消息数
+    int64_t app_offset;
+    int64_t committed_offset;
+    int64_t hi_offset;
+    int64_t consumer_lag;
+    int64_t tx_msgs;
+    int64_t rx_msgs;
+} KafkaPartitionStats;
+
+// 客户端统计快照（librdkafka statistics JSON解析后的结果）
+typedef struct {
+    char* name;                 // 客户端实例名
+    char* type;                 // producer / consumer
+    int64_t time;               // 采集时间（Unix秒）
+    int64_t ts_us;              // librdkafka单调时钟（微秒），两个快照之差就是间隔
+    int64_t replyq;             // 等待应用处理的事件数
+    int64_t msg_cnt;            // 生产者队列中的消息数
+    int64_t msg_size;
+    int64_t tx;                 // 发往所有broker的请求数
+    int64_t tx_bytes;
+    int64_t rx;
+    int64_t rx_bytes;
+    int64_t tx_msgs;
+    int64_t rx_msgs;
+    char* group_state;          // 消费者组状态，非消费者为NULL
+    int64_t rebalance_cnt;
+    KafkaBrokerStats* brokers;
+    int32_t broker_count;
+    KafkaTopicStats* topics;
+    int32_t topic_count;
+    KafkaPartitionStats* partitions;
+    int32_t partition_count;
+} KafkaStatsSnapshot;
+
+// 读取客户端统计快照：ts_us大于since_ts_us的快照中最新的max_count个，按时间从旧到新排列
+KafkaStatsSnapshot** get_kafka_stats(
+    KafkaClientHandle client,
+    int64_t since_ts_us,
+    int32_t max_count,
+    int32_t* count);
+
+// 释放取出的统计快照
+void free_kafka_stats(KafkaStatsSnapshot** snapshots, int32_t count);
+
+// 一个broker最近一个统计周期的接收速率
+typedef struct {
+    char* name;
+    int32_t node_id;
+    double bytes_per_sec;
+} KafkaBrokerRate;
+
+// 扫描速率：由最近两个统计快照计算
+typedef struct {
+    double interval_sec;        // 两个快照的间隔
+    double bytes_per_sec;       // 从所有broker收到的字节数/秒
+    double msgs_per_sec;        // 消费的消息数/秒
+    KafkaBrokerRate* brokers;   // 只包含有node_id的broker
+    int32_t broker_count;
+} KafkaScanRate;
+
+// 计算客户端的扫描速率，统计快照不足两个时返回KAFKA_ERROR；成功后调用free_kafka_scan_rate释放
+KafkaErrorCode get_kafka_scan_rate(KafkaClientHandle client, KafkaScanRate* rate);
+
+// 释放扫描速率中的broker列表
+void free_kafka_scan_rate(KafkaScanRate* rate);
+
+// 延迟直方图指标
+enum {
+    KAFKA_LATENCY_PRODUCE_CALL = 0,     // rd_kafka_produce调用耗时
+    KAFKA_LATENCY_DELIVERY = 1,         // 从produce到收到投递报告
+    KAFKA_LATENCY_POLL_TO_DRAIN = 2,    // 消息从librdkafka取出到被Dart批量取走
+    KAFKA_LATENCY_FFI_DECODE = 3,       // Dart解码一批取出的消息（由Dart记录）
+    KAFKA_LATENCY_METRIC_COUNT = 4,
+};
+
+// 一个指标的延迟分布（纳秒，分位数为所在桶的上界，相对误差约3%）
+typedef struct {
+    int64_t count;
+    int64_t min_ns;
+    int64_t mean_ns;
+    int64_t p50_ns;
+    int64_t p90_ns;
+    int64_t p99_ns;
+    int64_t p999_ns;
+    int64_t max_ns;
+} KafkaLatencySummary;
+
+// 获取上次重置以来的延迟分布，summaries按KAFKA_LATENCY_*下标填充，最多count项
+void get_kafka_latency_snapshot(KafkaLatencySummary* summaries, int32_t count);
+
+// 重置延迟直方图
+void reset_kafka_latency(void);
+
+// 记录一次延迟（Dart侧测量的指标用这个接口）
+void record_kafka_latency(int32_t metric, int64_t value_ns);
+
+// 定时把每个周期的延迟分布追加到CSV文件（已有定时输出时换成新的文件和周期）
+KafkaErrorCode start_kafka_latency_dump(const char* path, int32_t interval_ms);
+
+// 停止定时输出
+void stop_kafka_latency_dump(void);
+
+// 日志级别
+enum {
+    KAFKA_LOG_ERROR = 0,
+    KAFKA_LOG_WARN = 1,
+    KAFKA_LOG_INFO = 2,
+    KAFKA_LOG_DEBUG = 3,
+};
+
+// 设置运行时日志级别（默认KAFKA_LOG_INFO），低于该级别的日志不会格式化
+void set_kafka_log_level(int32_t level);
+
+// 获取运行时日志级别
+int32_t get_kafka_log_level(void);
+
+// 日志改写到文件（追加），path为NULL时恢复stdout
+KafkaErrorCode set_kafka_log_file(const char* path);
+
+// 等待此前写入的日志全部输出
+void flush_kafka_log(void);
+
+// 一个内存账户的占用（kind：store / consume_queue / autosave / metadata_cache / config_cache / librdkafka）
+typedef struct {
+    char* kind;
+    char* name;             // 所属客户端的名称，消息存储为store-N
+    int64_t bytes;
+    int64_t peak_bytes;
+} KafkaMemoryUsage;
+
+// 读取各账户的内存占用，total_bytes返回总和（可为NULL），需调用free_kafka_memory_usage释放
+KafkaMemoryUsage* get_kafka_memory_usage(int32_t* count, int64_t* total_bytes);
+
+// 释放内存占用明细
+void free_kafka_memory_usage(KafkaMemoryUsage* usage, int32_t count);
+
+// 设置内存软上限（字节，<= 0 表示不限制）；超过时消息存储淘汰旧payload，消费者暂停拉取
+void set_kafka_memory_soft_limit(int64_t bytes);
+
+// 获取内存软上限
+int64_t get_kafka_memory_soft_limit(void);
+
 // 获取错误信息
 const char* get_kafka_error_msg(KafkaErrorCode error_code);
 
@@ -0,0 +1,471 @@
+#include "kafka_internal.h"
+
+// 主题配置：用DescribeConfigs批量查询，每个请求最多CONFIG_BATCH_SIZE个主题，所有请求通过Admin批次同时发出。
+// 结果按连接缓存：每个主题都保留主题列表要用的摘要（保留时间、清理策略），
+// 完整配置只保留最近单独查询过的主题，几万个主题时也不会占用太多内存。
+
+#define CONFIG_TTL_MS 60000
+#define CONFIG_TIMEOUT_MS 10000
+#define CONFIG_BATCH_SIZE 500
+#define CONFIG_BUCKETS 4096
+#define CONFIG_MAX_FULL_ENTRIES 256
+
+typedef struct TopicConfig {
+    char* topic;
+    char* cleanup_policy;
+    int64_t retention_ms;
+    int64_t retention_bytes;
+    int64_t fetched_ms;
+    KafkaConfigParam* params;   // 完整配置，没有单独查询过时为NULL
+    int32_t param_count;
+    int64_t params_fetched_ms;
+    struct TopicConfig* next;
+} TopicConfig;
+
+struct KafkaConfigCache {
+    pthread_mutex_t lock;
+    TopicConfig* buckets[CONFIG_BUCKETS];
+    int32_t full_count;
+    KafkaMemoryAccount* memory;
+};
+
+static int64_t params_bytes(const KafkaConfigParam* params, int32_t count) {
+    if (!params) {
+        return 0;
+    }
+    int64_t n = count * (int64_t)sizeof(KafkaConfigParam);
+    for (int32_t i = 0; i < count; i++) {
+        n += strlen(params[i].key) + strlen(params[i].value) + 2;
+    }
+    return n;
+}
+
+static int64_t config_bytes(const TopicConfig* tc) {
+    return sizeof(TopicConfig) + strlen(tc->topic) + 1 +
+           (tc->cleanup_policy ? strlen(tc->cleanup_policy) + 1 : 0) +
+           params_bytes(tc->params, tc->param_count);
+}
+
+static void params_free(KafkaConfigParam* params, int32_t count) {
+    if (!params) {
+        return;
+    }
+    for (int32_t i = 0; i < count; i++) {
+        free(params[i].key);
+        free(params[i].value);
+    }
+    free(params);
+}
+
+static KafkaConfigParam* params_copy(const KafkaConfigParam* src, int32_t count) {
+    KafkaConfigParam* params = calloc(count > 0 ? count : 1, sizeof(KafkaConfigParam));
+    if (!params) {
+        return NULL;
+    }
+    for (int32_t i = 0; i < count; i++) {
+        params[i] = src[i];
+        params[i].key = strdup(src[i].key);
+        params[i].value = strdup(src[i].value);
+        if (!params[i].key || !params[i].value) {
+            params_free(params, i + 1);
+            return NULL;
+        }
+    }
+    return params;
+}
+
+static TopicConfig** config_slot(KafkaConfigCache* cache, const char* topic) {
+    TopicConfig** slot = &cache->buckets[kafka_hash_string(topic) % CONFIG_BUCKETS];
+    while (*slot && strcmp((*slot)->topic, topic) != 0) {
+        slot = &(*slot)->next;
+    }
+    return slot;
+}
+
+// 丢弃所有主题的完整配置（摘要保留），调用方需持有cache->lock
+static void params_clear_locked(KafkaConfigCache* cache) {
+    for (int i = 0; i < CONFIG_BUCKETS; i++) {
+        for (TopicConfig* tc = cache->buckets[i]; tc; tc = tc->next) {
+            kafka_memory_charge(cache->memory, -params_bytes(tc->params, tc->param_count));
+            params_free(tc->params, tc->param_count);
+            tc->params = NULL;
+            tc->param_count = 0;
+        }
+    }
+    cache->full_count = 0;
+}
+
+static void entries_clear_locked(KafkaConfigCache* cache) {
+    for (int i = 0; i < CONFIG_BUCKETS; i++) {
+        TopicConfig* tc = cache->buckets[i];
+        while (tc) {
+            TopicConfig* next = tc->next;
+            params_free(tc->params, tc->param_count);
+            free(tc->cleanup_policy);
+            free(tc->topic);
+            free(tc);
+            tc = next;
+        }
+        cache->buckets[i] = NULL;
+    }
+    cache->full_count = 0;
+    kafka_memory_set(cache->memory, sizeof(KafkaConfigCache));
+}
+
+KafkaConfigCache* kafka_config_cache_create(void) {
+    KafkaConfigCache* cache = calloc(1, sizeof(KafkaConfigCache));
+    if (!cache) {
+        return NULL;
+    }
+    pthread_mutex_init(&cache->lock, NULL);
+    cache->memory = kafka_memory_account_create("config_cache", NULL);
+    kafka_memory_charge(cache->memory, sizeof(KafkaConfigCache));
+    return cache;
+}
+
+void kafka_config_cache_set_owner(KafkaConfigCache* cache, const char* owner) {
+    if (cache) {
+        kafka_memory_account_set_name(cache->memory, owner);
+    }
+}
+
+void kafka_config_cache_destroy(KafkaConfigCache* cache) {
+    if (!cache) {
+        return;
+    }
+    pthread_mutex_lock(&cache->lock);
+    entries_clear_locked(cache);
+    pthread_mutex_unlock(&cache->lock);
+    kafka_memory_account_destroy(cache->memory);
+    pthread_mutex_destroy(&cache->lock);
+    free(cache);
+}
+
+void kafka_configs_invalidate(KafkaClientHandle client) {
+    if (!client) {
+        return;
+    }
+    KafkaConfigCache* cache = ((KafkaProducer*)client)->configs;
+    pthread_mutex_lock(&cache->lock);
+    entries_clear_locked(cache);
+    pthread_mutex_unlock(&cache->lock);
+}
+
+// 把一个主题的DescribeConfigs结果写入缓存，调用方需持有cache->lock
+// 已经缓存了完整配置的主题即使这次只要摘要也一并刷新
+static void store_entry_locked(KafkaConfigCache* cache, const rd_kafka_ConfigResource_t* resource, int keep_params) {
+    const char* topic = rd_kafka_ConfigResource_name(resource);
+    TopicConfig** slot = config_slot(cache, topic);
+    TopicConfig* tc = *slot;
+    if (!tc) {
+        tc = calloc(1, sizeof(TopicConfig));
+        if (!tc || !(tc->topic = strdup(topic))) {
+            free(tc);
+            return;
+        }
+        *slot = tc;
+    }
+
+    size_t count;
+    const rd_kafka_ConfigEntry_t** entries = rd_kafka_ConfigResource_configs(resource, &count);
+
+    free(tc->cleanup_policy);
+    tc->cleanup_policy = NULL;
+    tc->retention_ms = -1;
+    tc->retention_bytes = -1;
+    for (size_t i = 0; i < count; i++) {
+        const char* name = rd_kafka_ConfigEntry_name(entries[i]);
+        const char* value = rd_kafka_ConfigEntry_value(entries[i]);
+        if (!value) {
+            continue;
+        }
+        if (strcmp(name, "retention.ms") == 0) {
+            tc->retention_ms = strtoll(value, NULL, 10);
+        } else if (strcmp(name, "retention.bytes") == 0) {
+            tc->retention_bytes = strtoll(value, NULL, 10);
+        } else if (strcmp(name, "cleanup.policy") == 0) {
+            tc->cleanup_policy = strdup(value);
+        }
+    }
+    if (!tc->cleanup_policy) {
+        tc->cleanup_policy = strdup("");
+    }
+    tc->fetched_ms = kafka_monotonic_ms();
+
+    if (!keep_params && !tc->params) {
+        return;
+    }
+
+    KafkaConfigParam* params = calloc(count > 0 ? count : 1, sizeof(KafkaConfigParam));
+    if (!params) {
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        const char* value = rd_kafka_ConfigEntry_value(entries[i]);
+        params[i].key = strdup(rd_kafka_ConfigEntry_name(entries[i]));
+        params[i].value = strdup(value ? value : "");  // 敏感配置broker不返回值
+        params[i].source = (int32_t)rd_kafka_ConfigEntry_source(entries[i]);
+        params[i].is_default = rd_kafka_ConfigEntry_is_default(entries[i]);
+        params[i].is_read_only = rd_kafka_ConfigEntry_is_read_only(entries[i]);
+        params[i].is_sensitive = rd_kafka_ConfigEntry_is_sensitive(entries[i]);
+        if (!params[i].key || !params[i].value) {
+            params_free(params, (int32_t)i + 1);
+            return;
+        }
+    }
+
+    if (tc->params) {
+        params_free(tc->params, tc->param_count);
+    } else {
+        if (cache->full_count >= CONFIG_MAX_FULL_ENTRIES) {
+            params_clear_locked(cache);
+        }
+        cache->full_count++;
+    }
+    tc->params = params;
+    tc->param_count = (int32_t)count;
+    tc->params_fetched_ms = tc->fetched_ms;
+}
+
+// 写入缓存并按前后大小之差记账
+static void store_locked(KafkaConfigCache* cache, const rd_kafka_ConfigResource_t* resource, int keep_params) {
+    const char* topic = rd_kafka_ConfigResource_name(resource);
+    TopicConfig* tc = *config_slot(cache, topic);
+    int64_t before = tc ? config_bytes(tc) : 0;
+    store_entry_locked(cache, resource, keep_params);
+    tc = *config_slot(cache, topic);
+    kafka_memory_charge(cache->memory, (tc ? config_bytes(tc) : 0) - before);
+}
+
+static int compare_names(const void* a, const void* b) {
+    return strcmp(*(const char* const*)a, *(const char* const*)b);
+}
+
+// 一次配置查询（可能拆成多个DescribeConfigs请求）
+struct KafkaConfigQuery {
+    KafkaConfigCache* cache;
+    const char** stale;
+    int32_t count;
+    int32_t described;
+    int keep_params;
+};
+
+static void on_describe_configs(KafkaAdminBatch* batch, rd_kafka_event_t* event, void* ctx) {
+    (void)batch;
+    KafkaConfigQuery* query = ctx;
+    if (rd_kafka_event_error(event) != RD_KAFKA_RESP_ERR_NO_ERROR) {
+        KLOG_ERROR("DescribeConfigs failed: %s", rd_kafka_event_error_string(event));
+        return;
+    }
+
+    size_t count;
+    const rd_kafka_ConfigResource_t** resources =
+        rd_kafka_DescribeConfigs_result_resources(rd_kafka_event_DescribeConfigs_result(event), &count);
+    pthread_mutex_lock(&query->cache->lock);
+    for (size_t i = 0; i < count; i++) {
+        if (rd_kafka_ConfigResource_error(resources[i]) == RD_KAFKA_RESP_ERR_NO_ERROR) {
+            store_locked(query->cache, resources[i], query->keep_params);
+            query->described++;
+        }
+    }
+    pthread_mutex_unlock(&query->cache->lock);
+}
+
+// 在批次中查询缓存中没有或已过期的主题配置（keep_params非0时同时缓存完整配置）
+// 批次完成后调用kafka_configs_finish
+KafkaConfigQuery* kafka_configs_request(
+    KafkaAdminBatch* batch,
+    KafkaClientHandle client,
+    const char** topics,
+    int32_t topic_count,
+    int keep_params) {
+    KafkaConfigQuery* query = calloc(1, sizeof(KafkaConfigQuery));
+    if (!query) {
+        return NULL;
+    }
+    query->cache = ((KafkaProducer*)client)->configs;
+    query->keep_params = keep_params;
+    query->stale = malloc((topic_count > 0 ? topic_count : 1) * sizeof(char*));
+    if (!query->stale) {
+        free(query);
+        return NULL;
+    }
+
+    KafkaConfigCache* cache = query->cache;
+    int32_t n = 0;
+    int64_t now = kafka_monotonic_ms();
+    pthread_mutex_lock(&cache->lock);
+    for (int32_t i = 0; i < topic_count; i++) {
+        TopicConfig* tc = *config_slot(cache, topics[i]);
+        int fresh = tc && now - tc->fetched_ms < CONFIG_TTL_MS &&
+            (!keep_params || (tc->params && now - tc->params_fetched_ms < CONFIG_TTL_MS));
+        if (!fresh) {
+            query->stale[n++] = topics[i];
+        }
+    }
+    pthread_mutex_unlock(&cache->lock);
+    if (n == 0) {
+        return query;
+    }
+
+    // 同一个请求里不能有重复的资源
+    qsort(query->stale, n, sizeof(char*), compare_names);
+    int32_t unique = 1;
+    for (int32_t i = 1; i < n; i++) {
+        if (strcmp(query->stale[i], query->stale[unique - 1]) != 0) {
+            query->stale[unique++] = query->stale[i];
+        }
+    }
+    query->count = unique;
+
+    // 所有批次同时发出
+    for (int32_t start = 0; start < query->count; start += CONFIG_BATCH_SIZE) {
+        int32_t size = query->count - start < CONFIG_BATCH_SIZE ? query->count - start : CONFIG_BATCH_SIZE;
+        rd_kafka_ConfigResource_t** resources = malloc(size * sizeof(rd_kafka_ConfigResource_t*));
+        rd_kafka_AdminOptions_t* options = resources ? kafka_admin_batch_options(
+            batch, RD_KAFKA_ADMIN_OP_DESCRIBECONFIGS, on_describe_configs, query) : NULL;
+        if (!options) {
+            free(resources);
+            break;
+        }
+        for (int32_t i = 0; i < size; i++) {
+            resources[i] = rd_kafka_ConfigResource_new(RD_KAFKA_RESOURCE_TOPIC, query->stale[start + i]);
+        }
+        rd_kafka_DescribeConfigs(batch->rk, resources, size, options, batch->queue);
+        rd_kafka_ConfigResource_destroy_array(resources, size);
+        free(resources);
+        rd_kafka_AdminOptions_destroy(options);
+    }
+    return query;
+}
+
+// 释放查询状态，返回失败的主题数
+int32_t kafka_configs_finish(KafkaConfigQuery* query) {
+    int32_t failed = query->count - query->described;
+    if (failed > 0) {
+        KLOG_WARN("DescribeConfigs - %d of %d topics failed", failed, query->count);
+    }
+    free(query->stale);
+    free(query);
+    return failed;
+}
+
+// 查询缓存中没有或已过期的主题配置，返回失败的主题数
+int32_t kafka_configs_describe(
+    KafkaClientHandle client,
+    const char** topics,
+    int32_t topic_count,
+    int keep_params) {
+    KafkaAdminBatch* batch = kafka_admin_batch_new(((KafkaProducer*)client)->rk, CONFIG_TIMEOUT_MS);
+    KafkaConfigQuery* query = batch ? kafka_configs_request(batch, client, topics, topic_count, keep_params) : NULL;
+    if (!query) {
+        kafka_admin_batch_destroy(batch);
+        return topic_count;
+    }
+    kafka_admin_batch_wait(batch);
+    kafka_admin_batch_destroy(batch);
+    return kafka_configs_finish(query);
+}
+
+// 从缓存复制主题的完整配置，没有时返回NULL
+KafkaConfigParam* kafka_configs_copy(KafkaClientHandle client, const char* topic, int32_t* count) {
+    KafkaConfigCache* cache = ((KafkaProducer*)client)->configs;
+    KafkaConfigParam* params = NULL;
+    *count = 0;
+    pthread_mutex_lock(&cache->lock);
+    TopicConfig* tc = *config_slot(cache, topic);
+    if (tc && tc->params) {
+        params = params_copy(tc->params, tc->param_count);
+        if (params) {
+            *count = tc->param_count;
+        }
+    }
+    pthread_mutex_unlock(&cache->lock);
+    return params;
+}
+
+// 从缓存填充主题配置摘要，缓存中没有的主题cleanup_policy为NULL
+void kafka_configs_summarize(
+    KafkaClientHandle client,
+    const char** topics,
+    int32_t topic_count,
+    KafkaTopicConfigSummary* summaries) {
+    KafkaConfigCache* cache = ((KafkaProducer*)client)->configs;
+    pthread_mutex_lock(&cache->lock);
+    for (int32_t i = 0; i < topic_count; i++) {
+        summaries[i].topic = strdup(topics[i]);
+        summaries[i].retention_ms = -1;
+        summaries[i].retention_bytes = -1;
+        TopicConfig* tc = *config_slot(cache, topics[i]);
+        if (tc && tc->cleanup_policy) {
+            summaries[i].cleanup_policy = strdup(tc->cleanup_policy);
+            summaries[i].retention_ms = tc->retention_ms;
+            summaries[i].retention_bytes = tc->retention_bytes;
+        }
+    }
+    pthread_mutex_unlock(&cache->lock);
+}
+
+// 获取主题配置参数
+KafkaConfigParam* get_kafka_topic_config(
+    KafkaClientHandle client,
+    const char* topic_name,
+    int32_t* param_count) {
+    if (!client || !topic_name || !param_count) {
+        KLOG_ERROR("get_kafka_topic_config - Invalid parameters");
+        return NULL;
+    }
+    *param_count = 0;
+
+    if (kafka_configs_describe(client, &topic_name, 1, 1) > 0) {
+        KLOG_ERROR("get_kafka_topic_config - Failed to describe topic %s", topic_name);
+        return NULL;
+    }
+
+    return kafka_configs_copy(client, topic_name, param_count);
+}
+
+// 释放主题配置参数
+void free_kafka_topic_config(KafkaConfigParam* params, int32_t param_count) {
+    if (!params || param_count <= 0) {
+        return;
+    }
+    params_free(params, param_count);
+}
+
+// 批量获取主题配置摘要
+KafkaTopicConfigSummary* get_kafka_topic_config_summaries(
+    KafkaClientHandle client,
+    const char** topics,
+    int32_t topic_count,
+    int32_t* count) {
+    if (!client || !topics || topic_count <= 0 || !count) {
+        KLOG_ERROR("get_kafka_topic_config_summaries - Invalid parameters");
+        return NULL;
+    }
+    *count = 0;
+
+    kafka_configs_describe(client, topics, topic_count, 0);
+
+    KafkaTopicConfigSummary* summaries = calloc(topic_count, sizeof(KafkaTopicConfigSummary));
+    if (!summaries) {
+        return NULL;
+    }
+    kafka_configs_summarize(client, topics, topic_count, summaries);
+
+    *count = topic_count;
+    return summaries;
+}
+
+// 释放主题配置摘要
+void free_kafka_topic_config_summaries(KafkaTopicConfigSummary* summaries, int32_t count) {
+    if (!summaries || count <= 0) {
+        return;
+    }
+
+    for (int32_t i = 0; i < count; i++) {
+        free(summaries[i].topic);
+        free(summaries[i].cleanup_policy);
+    }
+    free(summaries);
+}
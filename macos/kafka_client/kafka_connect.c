@@ -0,0 +1,210 @@
+#include "kafka_internal.h"
+#include <time.h>
+
+// 连接就绪检测：管理客户端创建后立即在探测线程中发出元数据请求，第一个响应到达即认为连接可用，
+// 响应同时写入元数据缓存，随后的主题列表查询直接命中，不再额外往返。
+// 等待期间轮询客户端主队列，error_cb报告的连接级错误（所有broker不可达、DNS解析失败、
+// 认证失败）让连接立即失败，不必等到元数据请求超时。
+
+#define CONNECT_POLL_MS 20
+#define CONNECT_DEFAULT_TIMEOUT_MS 10000
+
+struct KafkaConnectState {
+    pthread_mutex_t lock;
+    rd_kafka_resp_err_t error;      // 最近一次连接级错误，开始新的连接检测时清除
+    char reason[256];
+};
+
+// 探测线程和等待方共享，最后一个使用者释放
+typedef struct {
+    KafkaClientHandle client;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int32_t refs;
+    int done;
+    int ok;
+    int32_t broker_count;
+} ConnectProbe;
+
+KafkaConnectState* kafka_connect_state_create(void) {
+    KafkaConnectState* state = calloc(1, sizeof(KafkaConnectState));
+    if (state) {
+        pthread_mutex_init(&state->lock, NULL);
+    }
+    return state;
+}
+
+void kafka_connect_state_destroy(KafkaConnectState* state) {
+    if (!state) {
+        return;
+    }
+    pthread_mutex_destroy(&state->lock);
+    free(state);
+}
+
+// error_cb（在rd_kafka_poll中调用），opaque为KafkaProducer
+void kafka_connect_error_cb(rd_kafka_t* rk, int err, const char* reason, void* opaque) {
+    KafkaProducer* p = (KafkaProducer*)opaque;
+    int fatal = err == RD_KAFKA_RESP_ERR__FATAL;
+    if (fatal) {
+        char fatal_reason[256];
+        err = rd_kafka_fatal_error(rk, fatal_reason, sizeof(fatal_reason));
+    }
+    KLOG_WARN("Kafka client error: %s (%s)", rd_kafka_err2str(err), reason);
+    if (!p || !p->connect) {
+        return;
+    }
+    if (!fatal &&
+        err != RD_KAFKA_RESP_ERR__ALL_BROKERS_DOWN &&
+        err != RD_KAFKA_RESP_ERR__RESOLVE &&
+        err != RD_KAFKA_RESP_ERR__AUTHENTICATION &&
+        err != RD_KAFKA_RESP_ERR__SSL) {
+        // 单个broker的断线会自动重连，不影响连接状态
+        return;
+    }
+    pthread_mutex_lock(&p->connect->lock);
+    p->connect->error = err;
+    snprintf(p->connect->reason, sizeof(p->connect->reason), "%s", reason);
+    pthread_mutex_unlock(&p->connect->lock);
+}
+
+// 处理生产者类型客户端主队列中的错误事件（消费者的主队列可能已转到消费队列，不能在这里轮询）
+void kafka_connect_poll(KafkaClientHandle client) {
+    KafkaProducer* p = (KafkaProducer*)client;
+    if (p->connect && rd_kafka_type(p->rk) == RD_KAFKA_PRODUCER) {
+        rd_kafka_poll(p->rk, 0);
+    }
+}
+
+static void probe_release(ConnectProbe* probe) {
+    pthread_mutex_lock(&probe->lock);
+    int32_t refs = --probe->refs;
+    pthread_mutex_unlock(&probe->lock);
+    if (refs > 0) {
+        return;
+    }
+    release_kafka_admin_client(probe->client);
+    pthread_cond_destroy(&probe->cond);
+    pthread_mutex_destroy(&probe->lock);
+    free(probe);
+}
+
+static void* probe_thread(void* arg) {
+    ConnectProbe* probe = (ConnectProbe*)arg;
+    KafkaMetadataRef* ref;
+    const struct rd_kafka_metadata* md = kafka_metadata_all(probe->client, &ref);
+
+    pthread_mutex_lock(&probe->lock);
+    probe->done = 1;
+    probe->ok = md != NULL;
+    probe->broker_count = md ? md->broker_cnt : 0;
+    pthread_cond_signal(&probe->cond);
+    pthread_mutex_unlock(&probe->lock);
+
+    if (md) {
+        kafka_metadata_release(probe->client, ref);
+    }
+    probe_release(probe);
+    return NULL;
+}
+
+// 获取共享管理客户端并等待第一个可用连接，成功时返回客户端（用release_kafka_admin_client释放）
+KafkaClientHandle kafka_connect_cluster(
+    const char* bootstrap_servers,
+    int32_t timeout_ms,
+    int32_t* broker_count,
+    KafkaErrorCode* error) {
+    *broker_count = 0;
+    KafkaClientHandle client = acquire_kafka_admin_client(bootstrap_servers);
+    if (!client) {
+        *error = KAFKA_ERROR_CREATE_CLIENT;
+        return NULL;
+    }
+    KafkaProducer* p = (KafkaProducer*)client;
+    // 先处理之前积压的错误事件，再清除状态，避免旧的错误让这次检测失败
+    kafka_connect_poll(client);
+    if (p->connect) {
+        pthread_mutex_lock(&p->connect->lock);
+        p->connect->error = RD_KAFKA_RESP_ERR_NO_ERROR;
+        p->connect->reason[0] = '\0';
+        pthread_mutex_unlock(&p->connect->lock);
+    }
+
+    ConnectProbe* probe = calloc(1, sizeof(ConnectProbe));
+    if (!probe) {
+        release_kafka_admin_client(client);
+        *error = KAFKA_ERROR;
+        return NULL;
+    }
+    probe->client = client;
+    probe->refs = 2;
+    pthread_mutex_init(&probe->lock, NULL);
+    pthread_cond_init(&probe->cond, NULL);
+    // 探测线程持有自己的客户端引用，连接提前失败时它还可以继续使用客户端直到元数据请求结束
+    kafka_admin_retain(client);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, probe_thread, probe) != 0) {
+        probe_thread(probe);
+    } else {
+        pthread_detach(thread);
+    }
+
+    int64_t deadline = kafka_monotonic_ms() + (timeout_ms > 0 ? timeout_ms : CONNECT_DEFAULT_TIMEOUT_MS);
+    rd_kafka_resp_err_t conn_err = RD_KAFKA_RESP_ERR_NO_ERROR;
+    char reason[256] = "";
+    int done = 0;
+    int ok = 0;
+    for (;;) {
+        kafka_connect_poll(client);
+        if (p->connect) {
+            pthread_mutex_lock(&p->connect->lock);
+            conn_err = p->connect->error;
+            snprintf(reason, sizeof(reason), "%s", p->connect->reason);
+            pthread_mutex_unlock(&p->connect->lock);
+        }
+
+        pthread_mutex_lock(&probe->lock);
+        int64_t remaining = deadline - kafka_monotonic_ms();
+        if (!probe->done && conn_err == RD_KAFKA_RESP_ERR_NO_ERROR && remaining > 0) {
+            int64_t wait_ms = remaining < CONNECT_POLL_MS ? remaining : CONNECT_POLL_MS;
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_sec += wait_ms / 1000;
+            ts.tv_nsec += (wait_ms % 1000) * 1000000;
+            if (ts.tv_nsec >= 1000000000) {
+                ts.tv_sec++;
+                ts.tv_nsec -= 1000000000;
+            }
+            pthread_cond_timedwait(&probe->cond, &probe->lock, &ts);
+        }
+        done = probe->done;
+        ok = probe->ok;
+        *broker_count = probe->broker_count;
+        pthread_mutex_unlock(&probe->lock);
+
+        if (done || conn_err != RD_KAFKA_RESP_ERR_NO_ERROR || kafka_monotonic_ms() >= deadline) {
+            break;
+        }
+    }
+    probe_release(probe);
+
+    if (done && ok) {
+        KLOG_INFO("Connected to %s (%d brokers)", bootstrap_servers, *broker_count);
+        *error = KAFKA_OK;
+        return client;
+    }
+    if (conn_err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+        KLOG_ERROR("Failed to connect to %s: %s (%s)", bootstrap_servers, rd_kafka_err2str(conn_err), reason);
+        *error = KAFKA_ERROR_CONNECT;
+    } else if (done) {
+        KLOG_ERROR("Failed to connect to %s: metadata request failed", bootstrap_servers);
+        *error = KAFKA_ERROR_CONNECT;
+    } else {
+        KLOG_ERROR("Failed to connect to %s: timed out", bootstrap_servers);
+        *error = KAFKA_ERROR_TIMEOUT;
+    }
+    *broker_count = 0;
+    release_kafka_admin_client(client);
+    return NULL;
+}
@@ -0,0 +1,528 @@
+#include "kafka_internal.h"
+
+// 后台消费循环：独立线程调用rd_kafka_consumer_poll，把消息放入有界环形队列，
+// Dart侧按批次取走。自动保存在这个线程里直接拿到原始字节，不经过UI isolate。
+// 配置了Schema Registry时，每批Confluent格式的消息交给解码线程池并行解码，入队顺序不变。
+// 背压：环形队列或消息存储超过高水位、或进程内存超过软上限时暂停已分配的分区，全部回落到低水位以下再恢复。
+// 暂停期间继续poll（处理重平衡，不会因为超过max.poll.interval.ms被踢出消费组），librdkafka停止拉取并丢弃
+// 已预取的消息，恢复后从最后交给应用的位置继续，不丢失也不跳过。队列中的消息计入内存账户。
+
+#include <unistd.h>
+
+#define CONSUME_LOOP_POLL_TIMEOUT_MS 100
+#define CONSUME_LOOP_DEFAULT_CAPACITY 10000
+#define CONSUME_LOOP_BATCH_SIZE 256
+
+// 解码线程池：消费线程发布一批消息，工作线程和消费线程一起按下标领取
+typedef struct {
+    KafkaSchemaRegistry* schemas;
+    pthread_t* threads;
+    int32_t thread_count;
+    pthread_mutex_t lock;
+    pthread_cond_t work;
+    pthread_cond_t done;
+    KafkaMessage** batch;
+    int32_t batch_count;
+    int32_t next;
+    int32_t remaining;
+    int stopping;
+} DecodePool;
+
+struct KafkaConsumeLoop {
+    KafkaConsumer* consumer;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t not_full;
+    int running;
+
+    // 环形队列
+    KafkaMessage** ring;
+    int32_t capacity;
+    int32_t head;
+    int32_t count;
+
+    DecodePool* decoder;  // 未配置schema时为NULL
+    KafkaBackpressure backpressure;
+    KafkaMemoryAccount* memory;
+    int32_t paused;       // 暂停原因（KAFKA_PAUSE_*），只有消费线程写入
+};
+
+// 消息在队列中占用的内存
+static int64_t message_bytes(const KafkaMessage* message) {
+    int64_t n = sizeof(KafkaMessage) + (int64_t)message->content_len;
+    if (message->key) {
+        n += strlen(message->key) + 1;
+    }
+    if (message->topic) {
+        n += strlen(message->topic) + 1;
+    }
+    return n;
+}
+
+static void* decode_pool_thread(void* arg) {
+    DecodePool* pool = (DecodePool*)arg;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->stopping && pool->next >= pool->batch_count) {
+            pthread_cond_wait(&pool->work, &pool->lock);
+        }
+        if (pool->stopping) {
+            break;
+        }
+        KafkaMessage* message = pool->batch[pool->next++];
+        pthread_mutex_unlock(&pool->lock);
+
+        kafka_schema_decode(pool->schemas, message);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->remaining == 0) {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+// thread_count <= 0 时使用CPU核数；消费线程自己也参与解码，所以额外只开 n-1 个线程
+static DecodePool* decode_pool_create(KafkaSchemaRegistry* schemas, int32_t thread_count) {
+    if (thread_count <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = cpus > 0 ? (int32_t)cpus : 1;
+    }
+
+    DecodePool* pool = calloc(1, sizeof(DecodePool));
+    if (!pool) {
+        return NULL;
+    }
+    pool->schemas = schemas;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    if (thread_count > 1) {
+        pool->threads = calloc(thread_count - 1, sizeof(pthread_t));
+        for (int32_t i = 0; pool->threads && i < thread_count - 1; i++) {
+            if (pthread_create(&pool->threads[pool->thread_count], NULL, decode_pool_thread, pool) != 0) {
+                KLOG_ERROR("Failed to start decode thread %d", i);
+                break;
+            }
+            pool->thread_count++;
+        }
+    }
+    return pool;
+}
+
+static void decode_pool_destroy(DecodePool* pool) {
+    if (!pool) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = 1;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+    for (int32_t i = 0; i < pool->thread_count; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->work);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->threads);
+    free(pool);
+}
+
+// 并行解码一批消息，全部完成后返回
+static void decode_pool_run(DecodePool* pool, KafkaMessage** batch, int32_t count) {
+    if (count <= 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->batch = batch;
+    pool->batch_count = count;
+    pool->next = 0;
+    pool->remaining = count;
+    pthread_cond_broadcast(&pool->work);
+
+    while (pool->next < pool->batch_count) {
+        KafkaMessage* message = pool->batch[pool->next++];
+        pthread_mutex_unlock(&pool->lock);
+
+        kafka_schema_decode(pool->schemas, message);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->remaining--;
+    }
+    while (pool->remaining > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pool->batch = NULL;
+    pool->batch_count = 0;
+    pool->next = 0;
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// 入队，队列满时阻塞等待Dart取走（让librdkafka在自己的队列里缓冲）
+static int ring_push(KafkaConsumeLoop* loop, KafkaMessage* message) {
+    pthread_mutex_lock(&loop->lock);
+    while (loop->running && loop->count == loop->capacity) {
+        pthread_cond_wait(&loop->not_full, &loop->lock);
+    }
+    if (!loop->running) {
+        pthread_mutex_unlock(&loop->lock);
+        return 0;
+    }
+    int32_t tail = (loop->head + loop->count) % loop->capacity;
+    loop->ring[tail] = message;
+    loop->count++;
+    pthread_mutex_unlock(&loop->lock);
+    kafka_memory_charge(loop->memory, message_bytes(message));
+    return 1;
+}
+
+// 按水位更新一种暂停原因：达到high时置位，回落到low以下时清除，中间保持不变
+static int32_t update_reason(int32_t reasons, int32_t reason, int32_t percent, int32_t high, int32_t low) {
+    if (high <= 0) {
+        return reasons & ~reason;
+    }
+    if (percent >= high) {
+        return reasons | reason;
+    }
+    if (percent <= low) {
+        return reasons & ~reason;
+    }
+    return reasons;
+}
+
+// 检查下游占用，需要时暂停或恢复当前分配的全部分区；
+// 暂停期间每轮重新暂停一次，重平衡后新分配的分区也不会开始拉取
+static void apply_backpressure(KafkaConsumeLoop* loop) {
+    const KafkaBackpressure* bp = &loop->backpressure;
+    int32_t reasons = loop->paused;
+
+    pthread_mutex_lock(&loop->lock);
+    int32_t ring_percent = loop->count * 100 / loop->capacity;
+    pthread_mutex_unlock(&loop->lock);
+    reasons = update_reason(reasons, KAFKA_PAUSE_RING, ring_percent, bp->ring_high, bp->ring_low);
+    if (kafka_memory_over_limit()) {
+        reasons |= KAFKA_PAUSE_MEMORY;
+    } else if (kafka_memory_below_resume_mark()) {
+        reasons &= ~KAFKA_PAUSE_MEMORY;
+    }
+    // 暂停后队列排空、存储不再写入，占用会停在恢复线和软上限之间；由存储主动淘汰到恢复线
+    if ((reasons & KAFKA_PAUSE_MEMORY) && bp->store) {
+        kafka_store_shed(bp->store);
+        if (kafka_memory_below_resume_mark()) {
+            reasons &= ~KAFKA_PAUSE_MEMORY;
+        }
+    }
+
+    if (!reasons && !loop->paused) {
+        return;
+    }
+
+    rd_kafka_t* rk = loop->consumer->rk;
+    rd_kafka_topic_partition_list_t* assignment = NULL;
+    if (rd_kafka_assignment(rk, &assignment) != RD_KAFKA_RESP_ERR_NO_ERROR) {
+        return;
+    }
+    if (reasons) {
+        rd_kafka_pause_partitions(rk, assignment);
+        if (reasons != loop->paused) {
+            KLOG_INFO("Pausing %d partitions of %s (ring %d%%, reasons 0x%x)",
+                      assignment->cnt, rd_kafka_name(rk), ring_percent, reasons);
+        }
+    } else {
+        rd_kafka_resume_partitions(rk, assignment);
+        KLOG_INFO("Resuming %d partitions of %s", assignment->cnt, rd_kafka_name(rk));
+    }
+    __atomic_store_n(&loop->paused, reasons, __ATOMIC_RELAXED);
+    rd_kafka_topic_partition_list_destroy(assignment);
+}
+
+static void* consume_loop_thread(void* arg) {
+    KafkaConsumeLoop* loop = (KafkaConsumeLoop*)arg;
+    KafkaConsumer* c = loop->consumer;
+    KafkaMessage* batch[CONSUME_LOOP_BATCH_SIZE];
+    KafkaMessage* pending[CONSUME_LOOP_BATCH_SIZE];
+
+    for (;;) {
+        pthread_mutex_lock(&loop->lock);
+        int running = loop->running;
+        pthread_mutex_unlock(&loop->lock);
+        if (!running) {
+            break;
+        }
+
+        // 第一条等待超时，之后把librdkafka队列里已有的消息一次取完（最多一批）
+        int32_t count = 0;
+        int timeout_ms = CONSUME_LOOP_POLL_TIMEOUT_MS;
+        while (count < CONSUME_LOOP_BATCH_SIZE) {
+            rd_kafka_message_t* rkmessage = rd_kafka_consumer_poll(c->rk, timeout_ms);
+            if (!rkmessage) {
+                break;  // 超时或队列已空
+            }
+            timeout_ms = 0;
+
+            if (rkmessage->err) {
+                rd_kafka_message_destroy(rkmessage);
+                continue;
+            }
+
+            // 自动保存直接使用原始字节
+            kafka_consumer_autosave(c, rkmessage->payload, rkmessage->len);
+
+            KafkaMessage* message = kafka_message_from_rd(rkmessage);
+            rd_kafka_message_destroy(rkmessage);
+            if (message) {
+                batch[count++] = message;
+            }
+        }
+
+        if (loop->decoder) {
+            int32_t pending_count = 0;
+            for (int32_t i = 0; i < count; i++) {
+                if (batch[i]->payload_type == KAFKA_PAYLOAD_CONFLUENT) {
+                    pending[pending_count++] = batch[i];
+                }
+            }
+            decode_pool_run(loop->decoder, pending, pending_count);
+        }
+
+        for (int32_t i = 0; i < count; i++) {
+            if (!ring_push(loop, batch[i])) {
+                for (int32_t j = i; j < count; j++) {
+                    kafka_message_destroy(batch[j]);
+                }
+                return NULL;
+            }
+        }
+
+        apply_backpressure(loop);
+    }
+
+    return NULL;
+}
+
+// 启动后台消费循环
+KafkaErrorCode start_kafka_consume_loop(KafkaClientHandle consumer, int32_t ring_capacity) {
+    if (!consumer) {
+        return KAFKA_ERROR;
+    }
+
+    KafkaConsumer* c = (KafkaConsumer*)consumer;
+    if (c->loop) {
+        return KAFKA_OK;  // 已经在运行
+    }
+
+    KafkaConsumeLoop* loop = calloc(1, sizeof(KafkaConsumeLoop));
+    if (!loop) {
+        return KAFKA_ERROR;
+    }
+
+    loop->consumer = c;
+    loop->backpressure = c->backpressure;
+    loop->capacity = ring_capacity > 0 ? ring_capacity : CONSUME_LOOP_DEFAULT_CAPACITY;
+    loop->ring = calloc(loop->capacity, sizeof(KafkaMessage*));
+    if (!loop->ring) {
+        free(loop);
+        return KAFKA_ERROR;
+    }
+
+    if (c->schemas) {
+        loop->decoder = decode_pool_create(c->schemas, c->decode_threads);
+    }
+
+    pthread_mutex_init(&loop->lock, NULL);
+    pthread_cond_init(&loop->not_full, NULL);
+    loop->memory = kafka_memory_account_create("consume_queue", rd_kafka_name(c->rk));
+    loop->running = 1;
+
+    if (pthread_create(&loop->thread, NULL, consume_loop_thread, loop) != 0) {
+        kafka_memory_account_destroy(loop->memory);
+        decode_pool_destroy(loop->decoder);
+        pthread_cond_destroy(&loop->not_full);
+        pthread_mutex_destroy(&loop->lock);
+        free(loop->ring);
+        free(loop);
+        return KAFKA_ERROR_CONSUME;
+    }
+
+    c->loop = loop;
+    return KAFKA_OK;
+}
+
+// 停止并释放消费循环，未取走的消息一并释放
+void kafka_consume_loop_destroy(KafkaConsumeLoop* loop) {
+    if (!loop) {
+        return;
+    }
+
+    pthread_mutex_lock(&loop->lock);
+    loop->running = 0;
+    pthread_cond_broadcast(&loop->not_full);
+    pthread_mutex_unlock(&loop->lock);
+    pthread_join(loop->thread, NULL);
+    decode_pool_destroy(loop->decoder);
+
+    for (int32_t i = 0; i < loop->count; i++) {
+        kafka_message_destroy(loop->ring[(loop->head + i) % loop->capacity]);
+    }
+
+    // 暂停的分区交给下一次启动的消费循环之前先恢复
+    if (loop->paused) {
+        rd_kafka_topic_partition_list_t* assignment = NULL;
+        if (rd_kafka_assignment(loop->consumer->rk, &assignment) == RD_KAFKA_RESP_ERR_NO_ERROR) {
+            rd_kafka_resume_partitions(loop->consumer->rk, assignment);
+            rd_kafka_topic_partition_list_destroy(assignment);
+        }
+    }
+
+    kafka_memory_account_destroy(loop->memory);
+    pthread_cond_destroy(&loop->not_full);
+    pthread_mutex_destroy(&loop->lock);
+    free(loop->ring);
+    free(loop);
+}
+
+// 配置消费背压水位（需在start_kafka_consume_loop之前调用）
+KafkaErrorCode set_kafka_consume_backpressure(
+    KafkaClientHandle consumer,
+    int32_t ring_high_percent,
+    int32_t ring_low_percent,
+    KafkaStoreHandle store) {
+    if (!consumer || ring_low_percent > ring_high_percent) {
+        return KAFKA_ERROR_CONFIG;
+    }
+
+    KafkaConsumer* c = (KafkaConsumer*)consumer;
+    c->backpressure.ring_high = ring_high_percent;
+    c->backpressure.ring_low = ring_low_percent;
+    c->backpressure.store = store;
+    return KAFKA_OK;
+}
+
+// 获取消费循环当前暂停的原因（KAFKA_PAUSE_*位掩码）
+int32_t get_kafka_consume_pause_state(KafkaClientHandle consumer) {
+    if (!consumer) {
+        return 0;
+    }
+    KafkaConsumeLoop* loop = ((KafkaConsumer*)consumer)->loop;
+    return loop ? __atomic_load_n(&loop->paused, __ATOMIC_RELAXED) : 0;
+}
+
+// 停止后台消费循环
+void stop_kafka_consume_loop(KafkaClientHandle consumer) {
+    if (!consumer) {
+        return;
+    }
+
+    KafkaConsumer* c = (KafkaConsumer*)consumer;
+    kafka_consume_loop_destroy(c->loop);
+    c->loop = NULL;
+}
+
+// 把超过预览长度的内容截断，完整payload转入消息存储
+static void record_set_preview(KafkaStoreHandle store, KafkaMessageRecord* record, KafkaMessage* message, int32_t preview_bytes) {
+    record->total_len = (int32_t)message->content_len;
+    record->payload_type = message->payload_type;
+    record->schema_id = message->schema_id;
+
+    if (!store || preview_bytes <= 0 || message->content_len <= (size_t)preview_bytes || !message->content) {
+        record->content = message->content;
+        record->content_len = (int32_t)message->content_len;
+        return;
+    }
+
+    size_t n = kafka_utf8_prefix_len(message->content, message->content_len, (size_t)preview_bytes);
+    char* preview = malloc(n + 1);
+    if (!preview) {
+        // 内存不足时退回完整内容
+        record->content = message->content;
+        record->content_len = (int32_t)message->content_len;
+        return;
+    }
+    memcpy(preview, message->content, n);
+    preview[n] = '\0';
+
+    record->content = preview;
+    record->content_len = (int32_t)n;
+    kafka_store_put(store, message->partition, message->offset, message->content, message->content_len);
+}
+
+// 把KafkaMessage转成交给Dart的记录，字段所有权转移到record，message本身被释放
+void kafka_record_from_message(KafkaStoreHandle store, KafkaMessageRecord* record, KafkaMessage* message, int32_t preview_bytes) {
+    record->topic = message->topic;
+    record->key = message->key;
+    record_set_preview(store, record, message, preview_bytes);
+    record->partition = message->partition;
+    record->offset = message->offset;
+    record->timestamp = message->timestamp;
+    free(message);
+}
+
+// 批量取出消息，所有权转交给调用方
+// 指定store时content只包含前preview_bytes字节，完整内容用fetch_kafka_payload获取
+KafkaMessageRecord* drain_kafka_messages(
+    KafkaClientHandle consumer,
+    int32_t max_messages,
+    KafkaStoreHandle store,
+    int32_t preview_bytes,
+    int32_t* count) {
+    if (!consumer || !count) {
+        return NULL;
+    }
+    *count = 0;
+
+    KafkaConsumer* c = (KafkaConsumer*)consumer;
+    KafkaConsumeLoop* loop = c->loop;
+    if (!loop || max_messages <= 0) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&loop->lock);
+    int32_t n = loop->count < max_messages ? loop->count : max_messages;
+    if (n == 0) {
+        pthread_mutex_unlock(&loop->lock);
+        return NULL;
+    }
+
+    KafkaMessageRecord* records = malloc(n * sizeof(KafkaMessageRecord));
+    if (!records) {
+        pthread_mutex_unlock(&loop->lock);
+        return NULL;
+    }
+
+    int64_t now_ns = kafka_monotonic_ns();
+    int64_t drained_bytes = 0;
+    for (int32_t i = 0; i < n; i++) {
+        KafkaMessage* message = loop->ring[loop->head];
+        loop->head = (loop->head + 1) % loop->capacity;
+        kafka_latency_record(KAFKA_LATENCY_POLL_TO_DRAIN, now_ns - message->polled_ns);
+        drained_bytes += message_bytes(message);
+        kafka_record_from_message(store, &records[i], message, preview_bytes);
+    }
+    loop->count -= n;
+    pthread_cond_signal(&loop->not_full);
+    pthread_mutex_unlock(&loop->lock);
+    kafka_memory_charge(loop->memory, -drained_bytes);
+
+    *count = n;
+    return records;
+}
+
+// 释放批量取出的消息
+void free_kafka_message_records(KafkaMessageRecord* records, int32_t count) {
+    if (!records || count <= 0) {
+        return;
+    }
+
+    for (int32_t i = 0; i < count; i++) {
+        free(records[i].topic);
+        free(records[i].key);
+        free(records[i].content);
+    }
+    free(records);
+}
@@ -0,0 +1,120 @@
+#include "kafka_internal.h"
+
+// 主题详情组合查询：主题详情页需要的元数据、分区水位、配置和消费者组一次调用返回。
+// 配置请求不依赖元数据，最先发出；元数据（通常命中缓存）返回后水位和消费者组请求
+// 放进同一个Admin批次，整体只等待一次，耗时取决于最慢的一条请求链。
+
+#define DESCRIBE_TIMEOUT_MS 10000
+
+// 获取主题完整详情
+KafkaTopicDescription* describe_kafka_topic_full(KafkaClientHandle client, const char* topic_name) {
+    if (!client || !topic_name) {
+        KLOG_ERROR("describe_kafka_topic_full - Invalid parameters");
+        return NULL;
+    }
+
+    KafkaTopicDescription* desc = calloc(1, sizeof(KafkaTopicDescription));
+    if (!desc) {
+        return NULL;
+    }
+
+    KafkaAdminBatch* batch = kafka_admin_batch_new(((KafkaProducer*)client)->rk, DESCRIBE_TIMEOUT_MS);
+    if (!batch) {
+        desc->error = KAFKA_ERROR;
+        return desc;
+    }
+    KafkaConfigQuery* configs = kafka_configs_request(batch, client, &topic_name, 1, 1);
+
+    const struct rd_kafka_metadata_topic* topic;
+    KafkaMetadataRef* ref;
+    rd_kafka_resp_err_t err = kafka_metadata_topic(client, topic_name, &topic, &ref);
+    if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+        KLOG_ERROR("describe_kafka_topic_full - Failed to get metadata for %s: %s",
+            topic_name, rd_kafka_err2str(err));
+        desc->error = err == RD_KAFKA_RESP_ERR_UNKNOWN_TOPIC_OR_PART ? KAFKA_ERROR_TOPICS : KAFKA_ERROR;
+        // 已发出的配置请求等它结束，避免结果事件引用已释放的查询状态
+        kafka_admin_batch_wait(batch);
+        kafka_admin_batch_destroy(batch);
+        if (configs) {
+            kafka_configs_finish(configs);
+        }
+        return desc;
+    }
+
+    int32_t n = topic->partition_cnt;
+    rd_kafka_topic_partition_list_t* partitions = rd_kafka_topic_partition_list_new(n);
+    int32_t total_replicas = 0;
+    for (int32_t i = 0; i < n; i++) {
+        rd_kafka_topic_partition_list_add(partitions, topic_name, topic->partitions[i].id);
+        total_replicas += topic->partitions[i].replica_cnt;
+    }
+    desc->partition_count = n;
+    desc->replication_factor = n > 0 ? total_replicas / n : 0;
+
+    int64_t* low = malloc((n > 0 ? n : 1) * sizeof(int64_t));
+    int64_t* high = malloc((n > 0 ? n : 1) * sizeof(int64_t));
+    KafkaWatermarkQuery* watermarks = NULL;
+    KafkaGroupLagQuery* groups = NULL;
+    if (low && high) {
+        watermarks = kafka_watermarks_request(batch, partitions, low, high);
+        groups = kafka_group_lag_request(batch, partitions);
+    }
+
+    int32_t pending = kafka_admin_batch_wait(batch);
+    kafka_admin_batch_destroy(batch);
+    if (pending > 0) {
+        KLOG_WARN("describe_kafka_topic_full - %d requests timed out, results may be incomplete", pending);
+    }
+
+    int32_t failed = watermarks ? kafka_watermarks_finish(watermarks) : n;
+    if (!watermarks && low && high) {
+        for (int32_t i = 0; i < n; i++) {
+            low[i] = -1;
+            high[i] = -1;
+        }
+    }
+
+    desc->partitions = n > 0 ? malloc(n * sizeof(KafkaPartitionInfo)) : NULL;
+    if (desc->partitions) {
+        for (int32_t i = 0; i < n; i++) {
+            kafka_partition_info_fill(&desc->partitions[i], &topic->partitions[i],
+                low && high ? low[i] : -1, low && high ? high[i] : -1);
+        }
+    } else {
+        desc->partition_count = 0;
+    }
+    kafka_metadata_release(client, ref);
+
+    if (groups) {
+        desc->groups = kafka_group_lag_finish(groups, high, &desc->group_count);
+    }
+    if (configs) {
+        kafka_configs_finish(configs);
+    }
+    desc->configs = kafka_configs_copy(client, topic_name, &desc->config_count);
+
+    free(low);
+    free(high);
+    rd_kafka_topic_partition_list_destroy(partitions);
+
+    if (failed > 0) {
+        KLOG_ERROR("describe_kafka_topic_full - Failed to get offsets for %d of %d partitions", failed, n);
+        // leader可能已经变化，下次重新获取元数据
+        kafka_metadata_invalidate(client, topic_name);
+    }
+
+    KLOG_DEBUG("describe_kafka_topic_full - %s: %d partitions, %d configs, %d groups",
+        topic_name, desc->partition_count, desc->config_count, desc->group_count);
+    return desc;
+}
+
+// 释放主题完整详情
+void free_kafka_topic_description(KafkaTopicDescription* desc) {
+    if (!desc) {
+        return;
+    }
+    free_kafka_topic_partitions(desc->partitions, desc->partition_count);
+    free_kafka_topic_config(desc->configs, desc->config_count);
+    free_kafka_topic_consumer_groups(desc->groups, desc->group_count);
+    free(desc);
+}
@@ -0,0 +1,315 @@
+#include "kafka_internal.h"
+
+// 消费者组lag：列出所有组，查询每个组在主题各分区上的已提交偏移量，和latest水位相减。
+// 所有请求放在一个Admin批次里：ListConsumerGroups和ListOffsets同时发出，
+// 组列表返回后按窗口并发查询已提交偏移量（librdkafka每个请求只能带一个组），
+// 确认消费该主题的组攒够一批后一次DescribeConsumerGroups取成员数和状态。
+
+#define GROUPS_TIMEOUT_MS 10000
+#define GROUPS_OFFSETS_CONCURRENCY 256
+#define GROUPS_DESCRIBE_BATCH 64
+
+typedef struct {
+    KafkaGroupLagQuery* query;
+    char* name;
+    const char* state;      // librdkafka的静态字符串
+    int32_t members;
+    int32_t coordinator;
+    int64_t* committed;     // 每个分区的已提交偏移量，没有提交时为-1
+    int consumes;           // 在这个主题上有已提交的偏移量
+} GroupLag;
+
+struct KafkaGroupLagQuery {
+    const rd_kafka_topic_partition_list_t* partitions;
+    GroupLag* groups;
+    int32_t group_count;
+    int32_t next_offsets;       // 下一个要查询已提交偏移量的组
+    int32_t offsets_inflight;
+    const char* describe[GROUPS_DESCRIBE_BATCH];
+    int32_t describe_count;
+};
+
+static int compare_groups(const void* a, const void* b) {
+    return strcmp(((const GroupLag*)a)->name, ((const GroupLag*)b)->name);
+}
+
+static GroupLag* find_group(KafkaGroupLagQuery* query, const char* name) {
+    GroupLag key = { .name = (char*)name };
+    return bsearch(&key, query->groups, query->group_count, sizeof(GroupLag), compare_groups);
+}
+
+static void on_groups_described(KafkaAdminBatch* batch, rd_kafka_event_t* event, void* ctx) {
+    (void)batch;
+    KafkaGroupLagQuery* query = ctx;
+    if (rd_kafka_event_error(event) != RD_KAFKA_RESP_ERR_NO_ERROR) {
+        KLOG_ERROR("DescribeConsumerGroups failed: %s", rd_kafka_event_error_string(event));
+        return;
+    }
+
+    size_t count;
+    const rd_kafka_ConsumerGroupDescription_t** descriptions =
+        rd_kafka_DescribeConsumerGroups_result_groups(rd_kafka_event_DescribeConsumerGroups_result(event), &count);
+    for (size_t i = 0; i < count; i++) {
+        if (rd_kafka_ConsumerGroupDescription_error(descriptions[i])) {
+            continue;
+        }
+        GroupLag* group = find_group(query, rd_kafka_ConsumerGroupDescription_group_id(descriptions[i]));
+        if (!group) {
+            continue;
+        }
+        group->members = (int32_t)rd_kafka_ConsumerGroupDescription_member_count(descriptions[i]);
+        group->state = rd_kafka_consumer_group_state_name(rd_kafka_ConsumerGroupDescription_state(descriptions[i]));
+        const rd_kafka_Node_t* coordinator = rd_kafka_ConsumerGroupDescription_coordinator(descriptions[i]);
+        if (coordinator) {
+            group->coordinator = rd_kafka_Node_id(coordinator);
+        }
+    }
+}
+
+static void flush_describe(KafkaAdminBatch* batch, KafkaGroupLagQuery* query) {
+    if (query->describe_count == 0) {
+        return;
+    }
+    rd_kafka_AdminOptions_t* options = kafka_admin_batch_options(
+        batch, RD_KAFKA_ADMIN_OP_DESCRIBECONSUMERGROUPS, on_groups_described, query);
+    if (options) {
+        rd_kafka_DescribeConsumerGroups(batch->rk, query->describe, query->describe_count, options, batch->queue);
+        rd_kafka_AdminOptions_destroy(options);
+    }
+    query->describe_count = 0;
+}
+
+static void on_group_offsets(KafkaAdminBatch* batch, rd_kafka_event_t* event, void* ctx);
+
+// 补满已提交偏移量查询的并发窗口；全部完成后把剩下的组一起describe
+static void issue_offsets(KafkaAdminBatch* batch, KafkaGroupLagQuery* query) {
+    while (query->offsets_inflight < GROUPS_OFFSETS_CONCURRENCY && query->next_offsets < query->group_count) {
+        GroupLag* group = &query->groups[query->next_offsets++];
+        rd_kafka_AdminOptions_t* options = kafka_admin_batch_options(
+            batch, RD_KAFKA_ADMIN_OP_LISTCONSUMERGROUPOFFSETS, on_group_offsets, group);
+        if (!options) {
+            continue;
+        }
+        rd_kafka_ListConsumerGroupOffsets_t* request =
+            rd_kafka_ListConsumerGroupOffsets_new(group->name, query->partitions);
+        rd_kafka_ListConsumerGroupOffsets(batch->rk, &request, 1, options, batch->queue);
+        rd_kafka_ListConsumerGroupOffsets_destroy(request);
+        rd_kafka_AdminOptions_destroy(options);
+        query->offsets_inflight++;
+    }
+    if (query->offsets_inflight == 0 && query->next_offsets == query->group_count) {
+        flush_describe(batch, query);
+    }
+}
+
+static void on_group_offsets(KafkaAdminBatch* batch, rd_kafka_event_t* event, void* ctx) {
+    GroupLag* group = ctx;
+    KafkaGroupLagQuery* query = group->query;
+    query->offsets_inflight--;
+
+    size_t count = 0;
+    const rd_kafka_group_result_t** results = NULL;
+    if (rd_kafka_event_error(event) == RD_KAFKA_RESP_ERR_NO_ERROR) {
+        results = rd_kafka_ListConsumerGroupOffsets_result_groups(
+            rd_kafka_event_ListConsumerGroupOffsets_result(event), &count);
+    }
+    const rd_kafka_topic_partition_list_t* committed =
+        count > 0 && !rd_kafka_group_result_error(results[0]) ? rd_kafka_group_result_partitions(results[0]) : NULL;
+
+    const rd_kafka_topic_partition_list_t* partitions = query->partitions;
+    for (int32_t i = 0; committed && i < committed->cnt; i++) {
+        const rd_kafka_topic_partition_t* tp = &committed->elems[i];
+        if (tp->err != RD_KAFKA_RESP_ERR_NO_ERROR || tp->offset < 0) {
+            continue;
+        }
+        // 分区列表按分区号排列，通常可以直接定位
+        int32_t at = tp->partition;
+        if (at < 0 || at >= partitions->cnt || partitions->elems[at].partition != tp->partition) {
+            for (at = 0; at < partitions->cnt && partitions->elems[at].partition != tp->partition; at++) {
+            }
+        }
+        if (at < partitions->cnt) {
+            group->committed[at] = tp->offset;
+            group->consumes = 1;
+        }
+    }
+
+    if (group->consumes) {
+        query->describe[query->describe_count++] = group->name;
+        if (query->describe_count == GROUPS_DESCRIBE_BATCH) {
+            flush_describe(batch, query);
+        }
+    }
+    issue_offsets(batch, query);
+}
+
+static void on_groups_listed(KafkaAdminBatch* batch, rd_kafka_event_t* event, void* ctx) {
+    KafkaGroupLagQuery* query = ctx;
+    if (rd_kafka_event_error(event) != RD_KAFKA_RESP_ERR_NO_ERROR) {
+        KLOG_ERROR("ListConsumerGroups failed: %s", rd_kafka_event_error_string(event));
+        return;
+    }
+
+    size_t count;
+    const rd_kafka_ConsumerGroupListing_t** listings =
+        rd_kafka_ListConsumerGroups_result_valid(rd_kafka_event_ListConsumerGroups_result(event), &count);
+    if (count == 0) {
+        return;
+    }
+    query->groups = calloc(count, sizeof(GroupLag));
+    if (!query->groups) {
+        return;
+    }
+
+    int32_t n = query->partitions->cnt;
+    for (size_t i = 0; i < count; i++) {
+        GroupLag* group = &query->groups[query->group_count];
+        group->name = strdup(rd_kafka_ConsumerGroupListing_group_id(listings[i]));
+        group->committed = malloc((n > 0 ? n : 1) * sizeof(int64_t));
+        if (!group->name || !group->committed) {
+            free(group->name);
+            free(group->committed);
+            continue;
+        }
+        for (int32_t j = 0; j < n; j++) {
+            group->committed[j] = -1;
+        }
+        group->query = query;
+        group->state = rd_kafka_consumer_group_state_name(rd_kafka_ConsumerGroupListing_state(listings[i]));
+        group->coordinator = -1;
+        query->group_count++;
+    }
+    // 按组名排序，DescribeConsumerGroups的结果用二分查找匹配
+    qsort(query->groups, query->group_count, sizeof(GroupLag), compare_groups);
+
+    issue_offsets(batch, query);
+}
+
+// 在批次中发出组列表请求，后续的已提交偏移量和describe请求由处理函数继续发出
+KafkaGroupLagQuery* kafka_group_lag_request(KafkaAdminBatch* batch, const rd_kafka_topic_partition_list_t* partitions) {
+    KafkaGroupLagQuery* query = calloc(1, sizeof(KafkaGroupLagQuery));
+    if (!query) {
+        return NULL;
+    }
+    query->partitions = partitions;
+
+    rd_kafka_AdminOptions_t* options = kafka_admin_batch_options(
+        batch, RD_KAFKA_ADMIN_OP_LISTCONSUMERGROUPS, on_groups_listed, query);
+    if (options) {
+        rd_kafka_ListConsumerGroups(batch->rk, options, batch->queue);
+        rd_kafka_AdminOptions_destroy(options);
+    }
+    return query;
+}
+
+// 批次完成后调用：用latest水位计算每个组的lag，只返回在该主题上有已提交偏移量的组
+KafkaConsumerGroup* kafka_group_lag_finish(KafkaGroupLagQuery* query, const int64_t* high, int32_t* count) {
+    int32_t n = query->partitions->cnt;
+    int32_t consuming = 0;
+    for (int32_t i = 0; i < query->group_count; i++) {
+        consuming += query->groups[i].consumes;
+    }
+    KafkaConsumerGroup* result = consuming > 0 ? calloc(consuming, sizeof(KafkaConsumerGroup)) : NULL;
+    int32_t out = 0;
+    for (int32_t i = 0; result && i < query->group_count; i++) {
+        GroupLag* group = &query->groups[i];
+        if (!group->consumes) {
+            continue;
+        }
+        int64_t lag = 0;
+        int64_t offset = 0;
+        for (int32_t j = 0; j < n; j++) {
+            if (group->committed[j] < 0) {
+                continue;
+            }
+            offset += group->committed[j];
+            if (high[j] > group->committed[j]) {
+                lag += high[j] - group->committed[j];
+            }
+        }
+        KafkaConsumerGroup* g = &result[out++];
+        g->name = strdup(group->name);
+        g->status = strdup(group->state ? group->state : "Unknown");
+        g->members = group->members;
+        g->coordinator = group->coordinator;
+        g->lag = lag;
+        g->offset = offset;
+    }
+
+    for (int32_t i = 0; i < query->group_count; i++) {
+        free(query->groups[i].name);
+        free(query->groups[i].committed);
+    }
+    free(query->groups);
+    free(query);
+
+    *count = out;
+    return result;
+}
+
+// 获取主题的消费者组
+KafkaConsumerGroup* get_kafka_topic_consumer_groups(
+    KafkaClientHandle client,
+    const char* topic_name,
+    int32_t* group_count) {
+    if (!client || !topic_name || !group_count) {
+        KLOG_ERROR("get_kafka_topic_consumer_groups - Invalid parameters");
+        return NULL;
+    }
+    *group_count = 0;
+
+    const struct rd_kafka_metadata_topic* topic;
+    KafkaMetadataRef* ref;
+    if (kafka_metadata_topic(client, topic_name, &topic, &ref) != RD_KAFKA_RESP_ERR_NO_ERROR) {
+        KLOG_ERROR("get_kafka_topic_consumer_groups - Unknown topic %s", topic_name);
+        return NULL;
+    }
+    rd_kafka_topic_partition_list_t* partitions = rd_kafka_topic_partition_list_new(topic->partition_cnt);
+    for (int i = 0; i < topic->partition_cnt; i++) {
+        rd_kafka_topic_partition_list_add(partitions, topic_name, topic->partitions[i].id);
+    }
+    kafka_metadata_release(client, ref);
+
+    int32_t n = partitions->cnt;
+    int64_t* high = malloc((n > 0 ? n : 1) * sizeof(int64_t));
+    KafkaAdminBatch* batch = high ? kafka_admin_batch_new(((KafkaProducer*)client)->rk, GROUPS_TIMEOUT_MS) : NULL;
+    KafkaGroupLagQuery* query = batch ? kafka_group_lag_request(batch, partitions) : NULL;
+    if (!query) {
+        kafka_admin_batch_destroy(batch);
+        free(high);
+        rd_kafka_topic_partition_list_destroy(partitions);
+        return NULL;
+    }
+
+    // 组列表和latest水位互不依赖，同时发出
+    KafkaWatermarkQuery* watermarks = kafka_watermarks_request(batch, partitions, NULL, high);
+
+    int32_t pending = kafka_admin_batch_wait(batch);
+    kafka_admin_batch_destroy(batch);
+    if (watermarks) {
+        kafka_watermarks_finish(watermarks);
+    }
+    if (pending > 0) {
+        KLOG_WARN("get_kafka_topic_consumer_groups - %d requests timed out, results may be incomplete", pending);
+    }
+
+    KafkaConsumerGroup* result = kafka_group_lag_finish(query, high, group_count);
+    free(high);
+    rd_kafka_topic_partition_list_destroy(partitions);
+
+    KLOG_DEBUG("get_kafka_topic_consumer_groups - %d groups consume topic %s", *group_count, topic_name);
+    return result;
+}
+
+// 释放消费者组
+void free_kafka_topic_consumer_groups(KafkaConsumerGroup* groups, int32_t group_count) {
+    if (!groups || group_count <= 0) {
+        return;
+    }
+
+    for (int i = 0; i < group_count; i++) {
+        free(groups[i].name);
+        free(groups[i].status);
+    }
+    free(groups);
+}
@@ -0,0 +1,354 @@
+#ifndef KAFKA_INTERNAL_H
+#define KAFKA_INTERNAL_H
+
+// 动态库内部共享的结构体与函数，不对Dart暴露
+
+#include <pthread.h>
+#include "kafka_client.h"
+
+// 日志：KLOG_*宏先检查级别再格式化，编译期级别以下的调用会被整个去掉（Makefile中LOG_LEVEL）
+#ifndef KAFKA_LOG_COMPILE_LEVEL
+#define KAFKA_LOG_COMPILE_LEVEL KAFKA_LOG_DEBUG
+#endif
+
+extern int kafka_log_level;
+void kafka_log_write(int level, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+// librdkafka的log_cb，转到原生日志
+void kafka_log_rdkafka_cb(const rd_kafka_t* rk, int level, const char* fac, const char* buf);
+
+#define KLOG(level, ...) do { \
+        if ((level) <= KAFKA_LOG_COMPILE_LEVEL && \
+            (level) <= __atomic_load_n(&kafka_log_level, __ATOMIC_RELAXED)) { \
+            kafka_log_write((level), __VA_ARGS__); \
+        } \
+    } while (0)
+#define KLOG_ERROR(...) KLOG(KAFKA_LOG_ERROR, __VA_ARGS__)
+#define KLOG_WARN(...) KLOG(KAFKA_LOG_WARN, __VA_ARGS__)
+#define KLOG_INFO(...) KLOG(KAFKA_LOG_INFO, __VA_ARGS__)
+#define KLOG_DEBUG(...) KLOG(KAFKA_LOG_DEBUG, __VA_ARGS__)
+
+// 错误码定义
+enum {
+    KAFKA_OK = 0,
+    KAFKA_ERROR = 1,
+    KAFKA_ERROR_CREATE_CLIENT = 2,
+    KAFKA_ERROR_CONFIG = 3,
+    KAFKA_ERROR_CONNECT = 4,
+    KAFKA_ERROR_TOPICS = 5,
+    KAFKA_ERROR_SEND = 6,
+    KAFKA_ERROR_SUBSCRIBE = 7,
+    KAFKA_ERROR_CONSUME = 8,
+    KAFKA_ERROR_FILE = 9,
+    KAFKA_ERROR_CANCELLED = 10,
+    KAFKA_ERROR_TIMEOUT = 11,
+};
+
+typedef struct KafkaConsumeLoop KafkaConsumeLoop;
+typedef struct KafkaWriter KafkaWriter;
+typedef struct KafkaSchemaRegistry KafkaSchemaRegistry;
+typedef struct KafkaMetadataCache KafkaMetadataCache;
+typedef struct KafkaMetadataRef KafkaMetadataRef;
+typedef struct KafkaConfigCache KafkaConfigCache;
+typedef struct KafkaConnectState KafkaConnectState;
+typedef struct KafkaStats KafkaStats;
+
+// 消费背压水位（百分比，high为0表示不检查）
+typedef struct {
+    int32_t ring_high;
+    int32_t ring_low;
+    KafkaStoreHandle store;     // 因内存暂停时淘汰旧记录
+} KafkaBackpressure;
+
+// Kafka生产者上下文（主题/元数据查询把任意客户端句柄当作KafkaProducer读取rk和连接级缓存）
+typedef struct {
+    rd_kafka_t* rk;
+    KafkaMetadataCache* metadata;   // 连接级元数据缓存
+    KafkaConfigCache* configs;      // 连接级主题配置缓存
+    KafkaStats* stats;              // 客户端统计快照和主队列轮询线程
+    KafkaConnectState* connect;     // error_cb记录的连接级错误（仅生产者类型客户端有这个字段）
+} KafkaProducer;
+
+// Kafka消费者上下文（前四个字段与KafkaProducer一致；close_kafka_client依赖rk判断类型）
+typedef struct {
+    rd_kafka_t* rk;
+    KafkaMetadataCache* metadata;
+    KafkaConfigCache* configs;
+    KafkaStats* stats;
+    rd_kafka_topic_partition_list_t* topic_list;
+    KafkaConsumeLoop* loop;     // 后台消费循环，未启动时为NULL
+    KafkaWriter* writer;        // 自动保存写入线程，未启用时为NULL
+    pthread_mutex_t writer_lock;
+    KafkaSchemaRegistry* schemas;   // Schema Registry解码，未配置时为NULL
+    int32_t decode_threads;         // 消费循环的解码线程数
+    KafkaBackpressure backpressure; // 消费循环暂停/恢复分区的水位
+} KafkaConsumer;
+
+// Kafka消息上下文
+typedef struct {
+    char* content;
+    size_t content_len;
+    int32_t payload_type;       // KAFKA_PAYLOAD_*
+    int32_t schema_id;          // Confluent格式的schema id，其他为-1
+    char* key;
+    char* topic;
+    int64_t offset;
+    int32_t partition;
+    int64_t timestamp;
+    int64_t polled_ns;          // 从librdkafka取出的时间（单调时钟），统计交给Dart的延迟
+} KafkaMessage;
+
+// 创建生产者类型的客户端，client_id用来区分普通生产者和共享管理客户端
+KafkaProducer* kafka_producer_new(const char* bootstrap_servers, const char* client_id);
+
+// 将librdkafka消息复制为KafkaMessage（不销毁rkmessage）
+KafkaMessage* kafka_message_from_rd(const rd_kafka_message_t* rkmessage);
+
+// 释放KafkaMessage
+void kafka_message_destroy(KafkaMessage* message);
+
+// 停止并释放消费循环（close_kafka_client调用）
+void kafka_consume_loop_destroy(KafkaConsumeLoop* loop);
+
+// 把KafkaMessage转成交给Dart的记录（超长内容截断为预览，完整payload转入store），释放message
+void kafka_record_from_message(KafkaStoreHandle store, KafkaMessageRecord* record, KafkaMessage* message, int32_t preview_bytes);
+
+// 自动保存：消费路径把原始字节交给写入线程（内部只做内存拷贝）
+void kafka_consumer_autosave(KafkaConsumer* consumer, const void* payload, size_t len);
+
+// 消息存储：保存完整payload，接管data的所有权
+void kafka_store_put(KafkaStoreHandle store, int32_t partition, int64_t offset, char* data, size_t len);
+
+// 淘汰存储中最旧的记录，直到进程内存回落到恢复线以下
+void kafka_store_shed(KafkaStoreHandle store);
+
+// 按UTF-8字符边界截断，返回不超过max_bytes的长度
+size_t kafka_utf8_prefix_len(const char* data, size_t len, size_t max_bytes);
+
+// 消息类型识别（KAFKA_PAYLOAD_*）
+int32_t kafka_classify_payload(const char* data, size_t len);
+
+// 是否是合法的UTF-8文本（不含\t \n \r以外的控制字符）
+int kafka_utf8_is_text(const char* data, size_t len);
+
+// 一个UTF-8字符的字节数，序列非法时返回0
+size_t kafka_utf8_char_len(const char* data, size_t remaining);
+
+// JSON：非分配的语法校验，合法返回1
+int kafka_json_validate(const char* data, size_t len);
+
+// 可增长的输出缓冲区，分配失败后failed置1，后续追加全部忽略
+typedef struct {
+    char* data;
+    size_t len;
+    size_t cap;
+    int failed;
+} KafkaBuffer;
+
+int kafka_buffer_reserve(KafkaBuffer* b, size_t extra);
+void kafka_buffer_append(KafkaBuffer* b, const void* data, size_t len);
+void kafka_buffer_append_str(KafkaBuffer* b, const char* s);
+void kafka_buffer_printf(KafkaBuffer* b, const char* fmt, ...);
+void kafka_buffer_append_json_string(KafkaBuffer* b, const char* s, size_t len);
+char* kafka_buffer_detach(KafkaBuffer* b, size_t* len);
+void kafka_buffer_free(KafkaBuffer* b);
+
+// JSON文档树（用于schema、registry响应等小文档）
+typedef enum {
+    KAFKA_JSON_NULL,
+    KAFKA_JSON_BOOL,
+    KAFKA_JSON_NUMBER,
+    KAFKA_JSON_STRING,
+    KAFKA_JSON_ARRAY,
+    KAFKA_JSON_OBJECT,
+} KafkaJsonType;
+
+typedef struct KafkaJsonValue {
+    KafkaJsonType type;
+    char* key;                      // 作为对象成员时的key
+    char* string;
+    double number;
+    int64_t integer;                // 整数值（避免大整数经过double丢精度）
+    int boolean;
+    struct KafkaJsonValue* child;   // 数组/对象的第一个成员
+    struct KafkaJsonValue* next;
+} KafkaJsonValue;
+
+KafkaJsonValue* kafka_json_parse(const char* data, size_t len);
+void kafka_json_free(KafkaJsonValue* value);
+const KafkaJsonValue* kafka_json_get(const KafkaJsonValue* object, const char* key);
+const char* kafka_json_get_string(const KafkaJsonValue* object, const char* key);
+
+// Avro
+typedef struct KafkaAvroSchema KafkaAvroSchema;
+KafkaAvroSchema* kafka_avro_schema_parse(const char* text, size_t len);
+void kafka_avro_schema_free(KafkaAvroSchema* schema);
+int kafka_avro_decode(const KafkaAvroSchema* schema, const uint8_t* data, size_t len, KafkaBuffer* out);
+
+// Schema Registry
+KafkaSchemaRegistry* kafka_schema_registry_create(const char* url, const char* local_dir);
+void kafka_schema_registry_destroy(KafkaSchemaRegistry* registry);
+// 解码Confluent格式的消息：成功时content替换为JSON文本，payload_type改为AVRO/PROTOBUF/JSON
+int kafka_schema_decode(KafkaSchemaRegistry* registry, KafkaMessage* message);
+
+// 共享管理客户端：client是共享管理客户端时增加一次引用并返回1（之后用release_kafka_admin_client释放），否则返回0
+int kafka_admin_retain(KafkaClientHandle client);
+
+// 主题索引引用计数：异步刷新期间持有索引，destroy_kafka_topic_index只释放调用方的引用
+void kafka_topic_index_retain(KafkaTopicIndexHandle index);
+
+// 连接就绪检测
+KafkaConnectState* kafka_connect_state_create(void);
+void kafka_connect_state_destroy(KafkaConnectState* state);
+void kafka_connect_error_cb(rd_kafka_t* rk, int err, const char* reason, void* opaque);
+// 处理生产者类型客户端主队列中的错误事件
+void kafka_connect_poll(KafkaClientHandle client);
+// 获取共享管理客户端并等待第一个可用连接（元数据响应），连接级错误时立即失败
+KafkaClientHandle kafka_connect_cluster(
+    const char* bootstrap_servers,
+    int32_t timeout_ms,
+    int32_t* broker_count,
+    KafkaErrorCode* error);
+
+// 客户端统计（stats_cb的opaque必须是KafkaProducer或KafkaConsumer）
+KafkaStats* kafka_stats_create(void);
+// 在配置中开启统计并设置stats_cb，失败返回0
+int kafka_stats_configure(rd_kafka_conf_t* conf);
+// 创建实例后启动轮询线程，统计和错误回调都在这个线程中触发
+void kafka_stats_start(KafkaStats* stats, rd_kafka_t* rk);
+// 停止轮询线程（销毁实例之前调用）
+void kafka_stats_stop(KafkaStats* stats);
+void kafka_stats_destroy(KafkaStats* stats);
+
+// 延迟直方图：记录一次延迟（KAFKA_LATENCY_*，纳秒），不加锁
+void kafka_latency_record(int32_t metric, int64_t value_ns);
+// dr_msg_cb：produce时把单调时钟放在消息的opaque中，投递报告到达时记录延迟
+void kafka_latency_dr_cb(rd_kafka_t* rk, const rd_kafka_message_t* rkmessage, void* opaque);
+
+// 内存记账：每个存储/队列/缓存持有一个账户，分配和释放时记账（原子操作，不加锁）
+typedef struct KafkaMemoryAccount KafkaMemoryAccount;
+KafkaMemoryAccount* kafka_memory_account_create(const char* kind, const char* name);
+// 客户端创建完成后再用rd_kafka_name命名（缓存在rd_kafka_new之前创建）
+void kafka_memory_account_set_name(KafkaMemoryAccount* account, const char* name);
+void kafka_memory_account_destroy(KafkaMemoryAccount* account);
+void kafka_memory_charge(KafkaMemoryAccount* account, int64_t delta);
+void kafka_memory_set(KafkaMemoryAccount* account, int64_t bytes);
+// 总量超过软上限
+int kafka_memory_over_limit(void);
+// 没有软上限，或总量已回落到可以恢复消费的水位
+int kafka_memory_below_resume_mark(void);
+
+// 单调时钟毫秒数、字符串哈希（各个缓存共用）
+int64_t kafka_monotonic_ms(void);
+int64_t kafka_monotonic_ns(void);
+uint32_t kafka_hash_string(const char* s);
+
+// 元数据缓存（按TTL复用，单主题走定向请求）
+KafkaMetadataCache* kafka_metadata_cache_create(void);
+void kafka_metadata_cache_destroy(KafkaMetadataCache* cache);
+void kafka_metadata_cache_set_owner(KafkaMetadataCache* cache, const char* owner);
+// 全量元数据，失败返回NULL
+const struct rd_kafka_metadata* kafka_metadata_all(KafkaClientHandle client, KafkaMetadataRef** ref);
+// 单个主题的元数据，不存在时返回RD_KAFKA_RESP_ERR_UNKNOWN_TOPIC_OR_PART
+rd_kafka_resp_err_t kafka_metadata_topic(
+    KafkaClientHandle client,
+    const char* topic,
+    const struct rd_kafka_metadata_topic** out,
+    KafkaMetadataRef** ref);
+// 释放kafka_metadata_all / kafka_metadata_topic返回的引用
+void kafka_metadata_release(KafkaClientHandle client, KafkaMetadataRef* ref);
+// 让缓存失效，topic为NULL时清空全部
+void kafka_metadata_invalidate(KafkaClientHandle client, const char* topic);
+
+// 主题配置缓存（DescribeConfigs批量查询）
+KafkaConfigCache* kafka_config_cache_create(void);
+void kafka_config_cache_destroy(KafkaConfigCache* cache);
+void kafka_config_cache_set_owner(KafkaConfigCache* cache, const char* owner);
+void kafka_configs_invalidate(KafkaClientHandle client);
+
+// Admin请求批次：多个请求共用一个队列同时发出，结果事件按opaque分发给各自的处理函数，
+// 处理函数中可以继续发出后续请求（同一个批次内的请求总耗时取决于最慢的一条链）
+typedef struct KafkaAdminBatch KafkaAdminBatch;
+typedef void (*KafkaAdminHandler)(KafkaAdminBatch* batch, rd_kafka_event_t* event, void* ctx);
+
+typedef struct KafkaAdminRequest KafkaAdminRequest;
+
+struct KafkaAdminBatch {
+    rd_kafka_t* rk;
+    rd_kafka_queue_t* queue;
+    int timeout_ms;
+    int64_t deadline_ms;
+    int32_t pending;
+    KafkaAdminRequest* requests;
+};
+
+KafkaAdminBatch* kafka_admin_batch_new(rd_kafka_t* rk, int timeout_ms);
+// 为一个请求创建AdminOptions（带超时和分发用的opaque），发出请求后由调用方销毁
+rd_kafka_AdminOptions_t* kafka_admin_batch_options(
+    KafkaAdminBatch* batch,
+    rd_kafka_admin_op_t op,
+    KafkaAdminHandler handler,
+    void* ctx);
+// 等待批次中所有请求（包括处理函数追加的）完成或超时，返回未完成的请求数
+int32_t kafka_admin_batch_wait(KafkaAdminBatch* batch);
+void kafka_admin_batch_destroy(KafkaAdminBatch* batch);
+
+// 分区水位查询，可以和其他请求放在同一个批次中
+typedef struct KafkaWatermarkQuery KafkaWatermarkQuery;
+// 结果按partitions顺序写入low/high（不需要的一侧传NULL），批次完成后调用kafka_watermarks_finish
+KafkaWatermarkQuery* kafka_watermarks_request(
+    KafkaAdminBatch* batch,
+    const rd_kafka_topic_partition_list_t* partitions,
+    int64_t* low,
+    int64_t* high);
+// 释放查询状态，查询失败的分区写入-1，返回失败的分区数
+int32_t kafka_watermarks_finish(KafkaWatermarkQuery* query);
+
+// 主题配置查询（keep_params非0时同时缓存完整配置），可以和其他请求放在同一个批次中
+typedef struct KafkaConfigQuery KafkaConfigQuery;
+KafkaConfigQuery* kafka_configs_request(
+    KafkaAdminBatch* batch,
+    KafkaClientHandle client,
+    const char** topics,
+    int32_t topic_count,
+    int keep_params);
+// 释放查询状态，返回失败的主题数
+int32_t kafka_configs_finish(KafkaConfigQuery* query);
+// 单独查询缓存中没有或已过期的主题配置，返回失败的主题数
+int32_t kafka_configs_describe(KafkaClientHandle client, const char** topics, int32_t topic_count, int keep_params);
+// 从缓存复制主题的完整配置，没有时返回NULL
+KafkaConfigParam* kafka_configs_copy(KafkaClientHandle client, const char* topic, int32_t* count);
+// 从缓存填充主题配置摘要（topic和cleanup_policy由调用方释放），缓存中没有的主题cleanup_policy为NULL
+void kafka_configs_summarize(
+    KafkaClientHandle client,
+    const char** topics,
+    int32_t topic_count,
+    KafkaTopicConfigSummary* summaries);
+
+// 消费者组lag查询，可以和水位查询放在同一个批次中
+typedef struct KafkaGroupLagQuery KafkaGroupLagQuery;
+KafkaGroupLagQuery* kafka_group_lag_request(KafkaAdminBatch* batch, const rd_kafka_topic_partition_list_t* partitions);
+// 用partitions的latest水位计算lag，返回消费该主题的组并释放查询状态
+KafkaConsumerGroup* kafka_group_lag_finish(KafkaGroupLagQuery* query, const int64_t* high, int32_t* count);
+
+// 用元数据和水位填充分区信息（high/low为NULL时偏移量为-1）
+void kafka_partition_info_fill(
+    KafkaPartitionInfo* info,
+    const struct rd_kafka_metadata_partition* partition,
+    int64_t low,
+    int64_t high);
+
+// 批量查询分区水位，结果按partitions顺序写入low/high（失败为-1），返回失败的分区数
+int32_t kafka_query_watermarks(
+    KafkaClientHandle client,
+    const rd_kafka_topic_partition_list_t* partitions,
+    int64_t* low,
+    int64_t* high);
+
+// Protobuf
+typedef struct KafkaProtoFile KafkaProtoFile;
+KafkaProtoFile* kafka_proto_parse(const char* text, size_t len);
+void kafka_proto_free(KafkaProtoFile* file);
+int kafka_proto_decode(const KafkaProtoFile* file, const int32_t* indexes, int32_t index_count,
+                       const uint8_t* data, size_t len, KafkaBuffer* out);
+
+#endif // KAFKA_INTERNAL_H
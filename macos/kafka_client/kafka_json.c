@@ -0,0 +1,676 @@
+#include <stdarg.h>
+#include "kafka_internal.h"
+
+// JSON工具：只做语法扫描，不构建对象，不分配内存
+
+#define JSON_MAX_DEPTH 512
+
+typedef struct {
+    const char* p;
+    const char* end;
+} JsonScanner;
+
+static void skip_ws(JsonScanner* s) {
+    while (s->p < s->end && (*s->p == ' ' || *s->p == '\t' || *s->p == '\n' || *s->p == '\r')) {
+        s->p++;
+    }
+}
+
+static int scan_literal(JsonScanner* s, const char* literal, size_t len) {
+    if ((size_t)(s->end - s->p) < len || memcmp(s->p, literal, len) != 0) {
+        return 0;
+    }
+    s->p += len;
+    return 1;
+}
+
+static int is_hex(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+static int scan_string(JsonScanner* s) {
+    s->p++;  // 跳过开头的引号
+    while (s->p < s->end) {
+        unsigned char c = (unsigned char)*s->p++;
+        if (c == '"') {
+            return 1;
+        }
+        if (c < 0x20) {
+            return 0;
+        }
+        // 字符串内容必须是合法UTF-8，否则不能原样当作JSON输出
+        if (c >= 0x80) {
+            size_t n = kafka_utf8_char_len(s->p - 1, (size_t)(s->end - s->p) + 1);
+            if (n == 0) {
+                return 0;
+            }
+            s->p += n - 1;
+            continue;
+        }
+        if (c == '\\') {
+            if (s->p >= s->end) {
+                return 0;
+            }
+            char e = *s->p++;
+            if (e == 'u') {
+                if (s->end - s->p < 4 || !is_hex(s->p[0]) || !is_hex(s->p[1]) ||
+                    !is_hex(s->p[2]) || !is_hex(s->p[3])) {
+                    return 0;
+                }
+                s->p += 4;
+            } else if (!strchr("\"\\/bfnrt", e)) {
+                return 0;
+            }
+        }
+    }
+    return 0;
+}
+
+static int scan_number(JsonScanner* s) {
+    const char* start = s->p;
+    if (s->p < s->end && *s->p == '-') {
+        s->p++;
+    }
+    if (s->p >= s->end) {
+        return 0;
+    }
+    if (*s->p == '0') {
+        s->p++;
+    } else if (*s->p >= '1' && *s->p <= '9') {
+        while (s->p < s->end && *s->p >= '0' && *s->p <= '9') {
+            s->p++;
+        }
+    } else {
+        return 0;
+    }
+    if (s->p < s->end && *s->p == '.') {
+        s->p++;
+        if (s->p >= s->end || *s->p < '0' || *s->p > '9') {
+            return 0;
+        }
+        while (s->p < s->end && *s->p >= '0' && *s->p <= '9') {
+            s->p++;
+        }
+    }
+    if (s->p < s->end && (*s->p == 'e' || *s->p == 'E')) {
+        s->p++;
+        if (s->p < s->end && (*s->p == '+' || *s->p == '-')) {
+            s->p++;
+        }
+        if (s->p >= s->end || *s->p < '0' || *s->p > '9') {
+            return 0;
+        }
+        while (s->p < s->end && *s->p >= '0' && *s->p <= '9') {
+            s->p++;
+        }
+    }
+    return s->p > start;
+}
+
+static int scan_value(JsonScanner* s, int depth) {
+    if (depth > JSON_MAX_DEPTH) {
+        return 0;
+    }
+
+    skip_ws(s);
+    if (s->p >= s->end) {
+        return 0;
+    }
+
+    switch (*s->p) {
+        case '{':
+            s->p++;
+            skip_ws(s);
+            if (s->p < s->end && *s->p == '}') {
+                s->p++;
+                return 1;
+            }
+            for (;;) {
+                skip_ws(s);
+                if (s->p >= s->end || *s->p != '"' || !scan_string(s)) {
+                    return 0;
+                }
+                skip_ws(s);
+                if (s->p >= s->end || *s->p != ':') {
+                    return 0;
+                }
+                s->p++;
+                if (!scan_value(s, depth + 1)) {
+                    return 0;
+                }
+                skip_ws(s);
+                if (s->p >= s->end) {
+                    return 0;
+                }
+                if (*s->p == ',') {
+                    s->p++;
+                    continue;
+                }
+                if (*s->p == '}') {
+                    s->p++;
+                    return 1;
+                }
+                return 0;
+            }
+        case '[':
+            s->p++;
+            skip_ws(s);
+            if (s->p < s->end && *s->p == ']') {
+                s->p++;
+                return 1;
+            }
+            for (;;) {
+                if (!scan_value(s, depth + 1)) {
+                    return 0;
+                }
+                skip_ws(s);
+                if (s->p >= s->end) {
+                    return 0;
+                }
+                if (*s->p == ',') {
+                    s->p++;
+                    continue;
+                }
+                if (*s->p == ']') {
+                    s->p++;
+                    return 1;
+                }
+                return 0;
+            }
+        case '"':
+            return scan_string(s);
+        case 't':
+            return scan_literal(s, "true", 4);
+        case 'f':
+            return scan_literal(s, "false", 5);
+        case 'n':
+            return scan_literal(s, "null", 4);
+        default:
+            return scan_number(s);
+    }
+}
+
+// 非分配的JSON语法校验，合法返回1
+int kafka_json_validate(const char* data, size_t len) {
+    if (!data || len == 0) {
+        return 0;
+    }
+
+    JsonScanner s = { data, data + len };
+    if (!scan_value(&s, 0)) {
+        return 0;
+    }
+    skip_ws(&s);
+    return s.p == s.end;
+}
+
+// 可增长的输出缓冲区
+int kafka_buffer_reserve(KafkaBuffer* b, size_t extra) {
+    if (b->failed) {
+        return 0;
+    }
+    if (b->len + extra <= b->cap) {
+        return 1;
+    }
+    size_t cap = b->cap ? b->cap : 256;
+    while (cap < b->len + extra) {
+        cap *= 2;
+    }
+    char* data = realloc(b->data, cap);
+    if (!data) {
+        b->failed = 1;
+        return 0;
+    }
+    b->data = data;
+    b->cap = cap;
+    return 1;
+}
+
+void kafka_buffer_append(KafkaBuffer* b, const void* data, size_t len) {
+    if (!kafka_buffer_reserve(b, len)) {
+        return;
+    }
+    memcpy(b->data + b->len, data, len);
+    b->len += len;
+}
+
+void kafka_buffer_append_str(KafkaBuffer* b, const char* s) {
+    kafka_buffer_append(b, s, strlen(s));
+}
+
+void kafka_buffer_printf(KafkaBuffer* b, const char* fmt, ...) {
+    char small[128];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(small, sizeof(small), fmt, args);
+    va_end(args);
+    if (n < 0) {
+        b->failed = 1;
+        return;
+    }
+    if ((size_t)n < sizeof(small)) {
+        kafka_buffer_append(b, small, (size_t)n);
+        return;
+    }
+    if (!kafka_buffer_reserve(b, (size_t)n + 1)) {
+        return;
+    }
+    va_start(args, fmt);
+    vsnprintf(b->data + b->len, (size_t)n + 1, fmt, args);
+    va_end(args);
+    b->len += (size_t)n;
+}
+
+// 追加带引号的JSON字符串，控制字符转义，非法UTF-8序列的每个字节替换为U+FFFD，其余字节原样输出
+void kafka_buffer_append_json_string(KafkaBuffer* b, const char* s, size_t len) {
+    static const char hex[] = "0123456789abcdef";
+    if (!kafka_buffer_reserve(b, len + 2)) {
+        return;
+    }
+    b->data[b->len++] = '"';
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)s[i];
+        if (c == '"' || c == '\\') {
+            char esc[2] = { '\\', (char)c };
+            kafka_buffer_append(b, esc, 2);
+        } else if (c < 0x20) {
+            char esc[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+            switch (c) {
+                case '\n': kafka_buffer_append(b, "\\n", 2); break;
+                case '\r': kafka_buffer_append(b, "\\r", 2); break;
+                case '\t': kafka_buffer_append(b, "\\t", 2); break;
+                default: kafka_buffer_append(b, esc, 6); break;
+            }
+        } else if (c >= 0x80) {
+            size_t n = kafka_utf8_char_len(s + i, len - i);
+            if (n == 0) {
+                kafka_buffer_append(b, "\xEF\xBF\xBD", 3);
+            } else {
+                kafka_buffer_append(b, s + i, n);
+                i += n - 1;
+            }
+        } else {
+            if (kafka_buffer_reserve(b, 1)) {
+                b->data[b->len++] = (char)c;
+            }
+        }
+    }
+    if (kafka_buffer_reserve(b, 1)) {
+        b->data[b->len++] = '"';
+    }
+}
+
+// 取出NUL结尾的结果，缓冲区交出所有权；分配失败时返回NULL
+char* kafka_buffer_detach(KafkaBuffer* b, size_t* len) {
+    if (!kafka_buffer_reserve(b, 1)) {
+        free(b->data);
+        b->data = NULL;
+        b->len = b->cap = 0;
+        return NULL;
+    }
+    b->data[b->len] = '\0';
+    char* data = b->data;
+    if (len) {
+        *len = b->len;
+    }
+    b->data = NULL;
+    b->len = b->cap = 0;
+    return data;
+}
+
+void kafka_buffer_free(KafkaBuffer* b) {
+    free(b->data);
+    b->data = NULL;
+    b->len = b->cap = 0;
+    b->failed = 0;
+}
+
+static int buffer_newline(KafkaBuffer* b, int32_t indent_width, int level) {
+    size_t n = 1 + (size_t)indent_width * (size_t)level;
+    if (!kafka_buffer_reserve(b, n)) {
+        return 0;
+    }
+    b->data[b->len++] = '\n';
+    memset(b->data + b->len, ' ', n - 1);
+    b->len += n - 1;
+    return 1;
+}
+
+// 格式化JSON（缩进indent_width个空格），非法JSON返回NULL
+char* format_kafka_json(const char* data, int32_t len, int32_t indent_width, int32_t* out_len) {
+    if (out_len) {
+        *out_len = 0;
+    }
+    if (!data || len <= 0 || !kafka_json_validate(data, (size_t)len)) {
+        return NULL;
+    }
+    if (indent_width < 0) {
+        indent_width = 2;
+    }
+
+    // 输入已校验过，这里只需按token重排空白
+    KafkaBuffer b = { 0 };
+    if (!kafka_buffer_reserve(&b, (size_t)len + (size_t)len / 2 + 1)) {
+        return NULL;
+    }
+
+    const char* p = data;
+    const char* end = data + len;
+    int level = 0;
+
+    while (p < end) {
+        char c = *p;
+        switch (c) {
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+                p++;
+                continue;
+            case '"': {
+                // 字符串原样复制
+                const char* start = p++;
+                while (p < end && *p != '"') {
+                    p += (*p == '\\') ? 2 : 1;
+                }
+                p++;
+                size_t n = (size_t)(p - start);
+                if (!kafka_buffer_reserve(&b, n)) {
+                    goto fail;
+                }
+                memcpy(b.data + b.len, start, n);
+                b.len += n;
+                continue;
+            }
+            case '{':
+            case '[': {
+                p++;
+                const char* q = p;
+                while (q < end && (*q == ' ' || *q == '\t' || *q == '\n' || *q == '\r')) {
+                    q++;
+                }
+                if (!kafka_buffer_reserve(&b, 2)) {
+                    goto fail;
+                }
+                b.data[b.len++] = c;
+                if (q < end && (*q == '}' || *q == ']')) {
+                    // 空对象/空数组保持在一行
+                    b.data[b.len++] = *q;
+                    p = q + 1;
+                    continue;
+                }
+                level++;
+                if (!buffer_newline(&b, indent_width, level)) {
+                    goto fail;
+                }
+                continue;
+            }
+            case '}':
+            case ']':
+                p++;
+                level--;
+                if (!buffer_newline(&b, indent_width, level) || !kafka_buffer_reserve(&b, 1)) {
+                    goto fail;
+                }
+                b.data[b.len++] = c;
+                continue;
+            case ',':
+                p++;
+                if (!kafka_buffer_reserve(&b, 1)) {
+                    goto fail;
+                }
+                b.data[b.len++] = ',';
+                if (!buffer_newline(&b, indent_width, level)) {
+                    goto fail;
+                }
+                continue;
+            case ':':
+                p++;
+                if (!kafka_buffer_reserve(&b, 2)) {
+                    goto fail;
+                }
+                b.data[b.len++] = ':';
+                b.data[b.len++] = ' ';
+                continue;
+            default:
+                // 数字和字面量
+                if (!kafka_buffer_reserve(&b, 1)) {
+                    goto fail;
+                }
+                b.data[b.len++] = c;
+                p++;
+                continue;
+        }
+    }
+
+    if (!kafka_buffer_reserve(&b, 1)) {
+        goto fail;
+    }
+    b.data[b.len] = '\0';
+    if (out_len) {
+        *out_len = (int32_t)b.len;
+    }
+    return b.data;
+
+fail:
+    free(b.data);
+    return NULL;
+}
+
+// 释放格式化结果
+void free_kafka_json(char* json) {
+    free(json);
+}
+
+// ---------- JSON解析（用于schema、registry响应等小文档） ----------
+
+static void json_append_utf8(KafkaBuffer* b, uint32_t cp) {
+    char out[4];
+    size_t n;
+    if (cp < 0x80) {
+        out[0] = (char)cp;
+        n = 1;
+    } else if (cp < 0x800) {
+        out[0] = (char)(0xC0 | (cp >> 6));
+        out[1] = (char)(0x80 | (cp & 0x3F));
+        n = 2;
+    } else if (cp < 0x10000) {
+        out[0] = (char)(0xE0 | (cp >> 12));
+        out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (cp & 0x3F));
+        n = 3;
+    } else {
+        out[0] = (char)(0xF0 | (cp >> 18));
+        out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+        out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[3] = (char)(0x80 | (cp & 0x3F));
+        n = 4;
+    }
+    kafka_buffer_append(b, out, n);
+}
+
+static uint32_t json_hex4(const char* p) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = p[i];
+        v <<= 4;
+        if (c >= '0' && c <= '9') {
+            v |= (uint32_t)(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            v |= (uint32_t)(c - 'a' + 10);
+        } else {
+            v |= (uint32_t)(c - 'A' + 10);
+        }
+    }
+    return v;
+}
+
+// 解析已校验过的字符串，返回去掉转义后的副本
+static char* json_parse_string(JsonScanner* s) {
+    KafkaBuffer b = { 0 };
+    s->p++;
+    while (*s->p != '"') {
+        const char* start = s->p;
+        while (*s->p != '"' && *s->p != '\\') {
+            s->p++;
+        }
+        kafka_buffer_append(&b, start, (size_t)(s->p - start));
+        if (*s->p != '\\') {
+            break;
+        }
+        s->p++;
+        char e = *s->p++;
+        switch (e) {
+            case 'b': kafka_buffer_append(&b, "\b", 1); break;
+            case 'f': kafka_buffer_append(&b, "\f", 1); break;
+            case 'n': kafka_buffer_append(&b, "\n", 1); break;
+            case 'r': kafka_buffer_append(&b, "\r", 1); break;
+            case 't': kafka_buffer_append(&b, "\t", 1); break;
+            case 'u': {
+                uint32_t cp = json_hex4(s->p);
+                s->p += 4;
+                // 代理对
+                if (cp >= 0xD800 && cp <= 0xDBFF && s->p[0] == '\\' && s->p[1] == 'u') {
+                    uint32_t low = json_hex4(s->p + 2);
+                    if (low >= 0xDC00 && low <= 0xDFFF) {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                        s->p += 6;
+                    }
+                }
+                json_append_utf8(&b, cp);
+                break;
+            }
+            default:
+                kafka_buffer_append(&b, &e, 1);
+                break;
+        }
+    }
+    s->p++;  // 结尾的引号
+    return kafka_buffer_detach(&b, NULL);
+}
+
+static KafkaJsonValue* json_parse_value(JsonScanner* s) {
+    skip_ws(s);
+    KafkaJsonValue* v = calloc(1, sizeof(KafkaJsonValue));
+    if (!v) {
+        return NULL;
+    }
+
+    switch (*s->p) {
+        case '{':
+        case '[': {
+            int is_object = *s->p == '{';
+            char close = is_object ? '}' : ']';
+            v->type = is_object ? KAFKA_JSON_OBJECT : KAFKA_JSON_ARRAY;
+            s->p++;
+            KafkaJsonValue** tail = &v->child;
+            for (;;) {
+                skip_ws(s);
+                if (*s->p == close) {
+                    s->p++;
+                    break;
+                }
+                if (*s->p == ',') {
+                    s->p++;
+                    continue;
+                }
+                char* key = NULL;
+                if (is_object) {
+                    key = json_parse_string(s);
+                    skip_ws(s);
+                    s->p++;  // ':'
+                }
+                KafkaJsonValue* child = json_parse_value(s);
+                if (!child) {
+                    free(key);
+                    kafka_json_free(v);
+                    return NULL;
+                }
+                child->key = key;
+                *tail = child;
+                tail = &child->next;
+            }
+            break;
+        }
+        case '"':
+            v->type = KAFKA_JSON_STRING;
+            v->string = json_parse_string(s);
+            if (!v->string) {
+                free(v);
+                return NULL;
+            }
+            break;
+        case 't':
+            v->type = KAFKA_JSON_BOOL;
+            v->boolean = 1;
+            s->p += 4;
+            break;
+        case 'f':
+            v->type = KAFKA_JSON_BOOL;
+            s->p += 5;
+            break;
+        case 'n':
+            v->type = KAFKA_JSON_NULL;
+            s->p += 4;
+            break;
+        default: {
+            v->type = KAFKA_JSON_NUMBER;
+            char* end = NULL;
+            v->number = strtod(s->p, &end);
+            v->integer = strtoll(s->p, NULL, 10);
+            s->p = end;
+            break;
+        }
+    }
+    return v;
+}
+
+// 解析JSON文档，非法时返回NULL
+KafkaJsonValue* kafka_json_parse(const char* data, size_t len) {
+    if (!kafka_json_validate(data, len)) {
+        return NULL;
+    }
+
+    // strtod需要NUL结尾，复制一份
+    char* copy = malloc(len + 1);
+    if (!copy) {
+        return NULL;
+    }
+    memcpy(copy, data, len);
+    copy[len] = '\0';
+
+    JsonScanner s = { copy, copy + len };
+    KafkaJsonValue* root = json_parse_value(&s);
+    free(copy);
+    return root;
+}
+
+void kafka_json_free(KafkaJsonValue* value) {
+    while (value) {
+        KafkaJsonValue* next = value->next;
+        kafka_json_free(value->child);
+        free(value->key);
+        free(value->string);
+        free(value);
+        value = next;
+    }
+}
+
+// 查找对象成员
+const KafkaJsonValue* kafka_json_get(const KafkaJsonValue* object, const char* key) {
+    if (!object || object->type != KAFKA_JSON_OBJECT) {
+        return NULL;
+    }
+    for (const KafkaJsonValue* v = object->child; v; v = v->next) {
+        if (v->key && strcmp(v->key, key) == 0) {
+            return v;
+        }
+    }
+    return NULL;
+}
+
+// 查找字符串成员，不存在或不是字符串时返回NULL
+const char* kafka_json_get_string(const KafkaJsonValue* object, const char* key) {
+    const KafkaJsonValue* v = kafka_json_get(object, key);
+    return v && v->type == KAFKA_JSON_STRING ? v->string : NULL;
+}
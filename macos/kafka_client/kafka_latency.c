@@ -0,0 +1,344 @@
+#include "kafka_internal.h"
+#include <time.h>
+
+// 延迟直方图：produce调用耗时、produce到投递报告、消息poll出来到被Dart取走、Dart解码取出的一批消息。
+// 每个记录线程有自己的直方图，只有它自己写，记录时不加锁；汇总时把所有线程的计数相加。
+// 桶按HDR方式划分：每个2的幂区间再分32个子桶，相对误差不超过约3%，覆盖整个int64范围。
+// 重置不清零各线程的计数（其他线程可能正在写），只记录当前总数作为基线，快照返回与基线的差；
+// 定时输出到文件的线程用自己的基线，每次输出上一个周期内的分布。
+
+#define LATENCY_SUB_BITS 5
+#define LATENCY_SUB_COUNT (1 << LATENCY_SUB_BITS)
+#define LATENCY_BUCKETS ((64 - LATENCY_SUB_BITS + 1) * LATENCY_SUB_COUNT)
+
+typedef struct LatencyThread {
+    uint64_t counts[KAFKA_LATENCY_METRIC_COUNT][LATENCY_BUCKETS];
+    uint64_t sums[KAFKA_LATENCY_METRIC_COUNT];
+    int in_use;                     // 线程退出后置0，新线程可以接着使用
+    struct LatencyThread* next;
+} LatencyThread;
+
+typedef struct {
+    uint64_t counts[KAFKA_LATENCY_METRIC_COUNT][LATENCY_BUCKETS];
+    uint64_t sums[KAFKA_LATENCY_METRIC_COUNT];
+} LatencyTotals;
+
+static pthread_mutex_t latency_lock = PTHREAD_MUTEX_INITIALIZER;
+static LatencyThread* latency_threads;      // 只增不减
+static pthread_key_t latency_key;
+static pthread_once_t latency_once = PTHREAD_ONCE_INIT;
+static LatencyTotals reset_base;            // reset_kafka_latency记录的基线
+static LatencyTotals dump_base;             // 定时输出的基线
+static LatencyTotals scratch;               // 汇总用，持有latency_lock时使用
+
+static const char* metric_names[KAFKA_LATENCY_METRIC_COUNT] = {
+    "produce_call",
+    "delivery",
+    "poll_to_drain",
+    "ffi_decode",
+};
+
+// 定时输出
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int stopping;
+    char* path;
+    int32_t interval_ms;
+} LatencyDump;
+
+static LatencyDump* latency_dump;
+static pthread_mutex_t dump_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void latency_thread_exit(void* arg) {
+    __atomic_store_n(&((LatencyThread*)arg)->in_use, 0, __ATOMIC_RELEASE);
+}
+
+static void latency_init(void) {
+    pthread_key_create(&latency_key, latency_thread_exit);
+}
+
+// 当前线程的直方图，第一次记录时领取一个空闲的或新建
+static LatencyThread* latency_thread(void) {
+    pthread_once(&latency_once, latency_init);
+    LatencyThread* t = pthread_getspecific(latency_key);
+    if (t) {
+        return t;
+    }
+
+    pthread_mutex_lock(&latency_lock);
+    for (LatencyThread* it = latency_threads; it; it = it->next) {
+        int expected = 0;
+        if (__atomic_compare_exchange_n(&it->in_use, &expected, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            t = it;
+            break;
+        }
+    }
+    if (!t) {
+        t = calloc(1, sizeof(LatencyThread));
+        if (t) {
+            t->in_use = 1;
+            t->next = latency_threads;
+            latency_threads = t;
+        }
+    }
+    pthread_mutex_unlock(&latency_lock);
+
+    if (t) {
+        pthread_setspecific(latency_key, t);
+    }
+    return t;
+}
+
+static int32_t bucket_index(uint64_t v) {
+    if (v < 2 * LATENCY_SUB_COUNT) {
+        return (int32_t)v;
+    }
+    int32_t shift = 63 - __builtin_clzll(v) - LATENCY_SUB_BITS;
+    return shift * LATENCY_SUB_COUNT + (int32_t)(v >> shift);
+}
+
+static uint64_t bucket_low(int32_t index) {
+    if (index < 2 * LATENCY_SUB_COUNT) {
+        return (uint64_t)index;
+    }
+    int32_t shift = index / LATENCY_SUB_COUNT - 1;
+    return (uint64_t)(index % LATENCY_SUB_COUNT + LATENCY_SUB_COUNT) << shift;
+}
+
+// 桶内的最大值（和HDR一样，分位数报告桶的上界）
+static uint64_t bucket_high(int32_t index) {
+    if (index < 2 * LATENCY_SUB_COUNT) {
+        return (uint64_t)index;
+    }
+    int32_t shift = index / LATENCY_SUB_COUNT - 1;
+    return bucket_low(index) + ((uint64_t)1 << shift) - 1;
+}
+
+void kafka_latency_record(int32_t metric, int64_t value_ns) {
+    if (metric < 0 || metric >= KAFKA_LATENCY_METRIC_COUNT) {
+        return;
+    }
+    LatencyThread* t = latency_thread();
+    if (!t) {
+        return;
+    }
+    uint64_t v = value_ns > 0 ? (uint64_t)value_ns : 0;
+    uint64_t* count = &t->counts[metric][bucket_index(v)];
+    // 只有本线程写，汇总线程用原子读，不需要读-改-写原子操作
+    __atomic_store_n(count, *count + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&t->sums[metric], t->sums[metric] + v, __ATOMIC_RELAXED);
+}
+
+// dr_msg_cb：消息的_private是produce时的单调时钟
+void kafka_latency_dr_cb(rd_kafka_t* rk, const rd_kafka_message_t* rkmessage, void* opaque) {
+    (void)rk;
+    (void)opaque;
+    if (rkmessage->err == RD_KAFKA_RESP_ERR_NO_ERROR && rkmessage->_private) {
+        kafka_latency_record(KAFKA_LATENCY_DELIVERY, kafka_monotonic_ns() - (int64_t)(intptr_t)rkmessage->_private);
+    }
+}
+
+// 把所有线程的计数汇总到scratch（调用方持有latency_lock）
+static void collect_locked(void) {
+    memset(&scratch, 0, sizeof(scratch));
+    for (LatencyThread* t = latency_threads; t; t = t->next) {
+        for (int32_t m = 0; m < KAFKA_LATENCY_METRIC_COUNT; m++) {
+            for (int32_t b = 0; b < LATENCY_BUCKETS; b++) {
+                scratch.counts[m][b] += __atomic_load_n(&t->counts[m][b], __ATOMIC_RELAXED);
+            }
+            scratch.sums[m] += __atomic_load_n(&t->sums[m], __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static int64_t percentile(const uint64_t* diff, uint64_t total, double p) {
+    uint64_t target = (uint64_t)(p * (double)total);
+    if (target == 0) {
+        target = 1;
+    }
+    uint64_t seen = 0;
+    for (int32_t b = 0; b < LATENCY_BUCKETS; b++) {
+        seen += diff[b];
+        if (seen >= target) {
+            return (int64_t)bucket_high(b);
+        }
+    }
+    return 0;
+}
+
+// 用scratch和基线的差计算一个指标的汇总（调用方持有latency_lock）
+static void summarize_locked(const LatencyTotals* base, int32_t m, KafkaLatencySummary* out) {
+    static uint64_t diff[LATENCY_BUCKETS];
+    memset(out, 0, sizeof(*out));
+    uint64_t total = 0;
+    int32_t first = -1;
+    int32_t last = -1;
+    for (int32_t b = 0; b < LATENCY_BUCKETS; b++) {
+        diff[b] = scratch.counts[m][b] - base->counts[m][b];
+        if (diff[b] > 0) {
+            total += diff[b];
+            if (first < 0) {
+                first = b;
+            }
+            last = b;
+        }
+    }
+    if (total == 0) {
+        return;
+    }
+    out->count = (int64_t)total;
+    out->min_ns = (int64_t)bucket_low(first);
+    out->max_ns = (int64_t)bucket_high(last);
+    out->mean_ns = (int64_t)((scratch.sums[m] - base->sums[m]) / total);
+    out->p50_ns = percentile(diff, total, 0.50);
+    out->p90_ns = percentile(diff, total, 0.90);
+    out->p99_ns = percentile(diff, total, 0.99);
+    out->p999_ns = percentile(diff, total, 0.999);
+}
+
+// 获取上次重置以来的延迟分布，summaries按KAFKA_LATENCY_*下标填充，最多count项
+void get_kafka_latency_snapshot(KafkaLatencySummary* summaries, int32_t count) {
+    if (!summaries || count <= 0) {
+        KLOG_ERROR("get_kafka_latency_snapshot - Invalid parameters");
+        return;
+    }
+    if (count > KAFKA_LATENCY_METRIC_COUNT) {
+        count = KAFKA_LATENCY_METRIC_COUNT;
+    }
+    pthread_mutex_lock(&latency_lock);
+    collect_locked();
+    for (int32_t m = 0; m < count; m++) {
+        summarize_locked(&reset_base, m, &summaries[m]);
+    }
+    pthread_mutex_unlock(&latency_lock);
+}
+
+// 重置延迟直方图（之后的快照只包含重置之后的记录）
+void reset_kafka_latency(void) {
+    pthread_mutex_lock(&latency_lock);
+    collect_locked();
+    memcpy(&reset_base, &scratch, sizeof(scratch));
+    pthread_mutex_unlock(&latency_lock);
+}
+
+// 记录一次延迟（Dart侧测量的指标用这个接口）
+void record_kafka_latency(int32_t metric, int64_t value_ns) {
+    kafka_latency_record(metric, value_ns);
+}
+
+static void dump_write(FILE* f) {
+    KafkaLatencySummary summaries[KAFKA_LATENCY_METRIC_COUNT];
+    pthread_mutex_lock(&latency_lock);
+    collect_locked();
+    for (int32_t m = 0; m < KAFKA_LATENCY_METRIC_COUNT; m++) {
+        summarize_locked(&dump_base, m, &summaries[m]);
+    }
+    memcpy(&dump_base, &scratch, sizeof(scratch));
+    pthread_mutex_unlock(&latency_lock);
+
+    long long now = (long long)time(NULL);
+    for (int32_t m = 0; m < KAFKA_LATENCY_METRIC_COUNT; m++) {
+        const KafkaLatencySummary* s = &summaries[m];
+        if (s->count == 0) {
+            continue;
+        }
+        fprintf(f, "%lld,%s,%lld,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n",
+            now, metric_names[m], (long long)s->count,
+            s->min_ns / 1000.0, s->mean_ns / 1000.0, s->p50_ns / 1000.0, s->p90_ns / 1000.0,
+            s->p99_ns / 1000.0, s->p999_ns / 1000.0, s->max_ns / 1000.0);
+    }
+    fflush(f);
+}
+
+static void* dump_thread(void* arg) {
+    LatencyDump* dump = (LatencyDump*)arg;
+    FILE* f = fopen(dump->path, "a");
+    if (!f) {
+        KLOG_ERROR("Failed to open latency dump file: %s", dump->path);
+        return NULL;
+    }
+    if (ftell(f) == 0) {
+        fprintf(f, "time,metric,count,min_us,mean_us,p50_us,p90_us,p99_us,p999_us,max_us\n");
+    }
+
+    pthread_mutex_lock(&latency_lock);
+    collect_locked();
+    memcpy(&dump_base, &scratch, sizeof(scratch));
+    pthread_mutex_unlock(&latency_lock);
+
+    pthread_mutex_lock(&dump->lock);
+    while (!dump->stopping) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_sec += dump->interval_ms / 1000;
+        ts.tv_nsec += (long)(dump->interval_ms % 1000) * 1000000;
+        if (ts.tv_nsec >= 1000000000) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000;
+        }
+        pthread_cond_timedwait(&dump->cond, &dump->lock, &ts);
+        pthread_mutex_unlock(&dump->lock);
+        dump_write(f);
+        pthread_mutex_lock(&dump->lock);
+    }
+    pthread_mutex_unlock(&dump->lock);
+    fclose(f);
+    return NULL;
+}
+
+static void dump_stop_locked(void) {
+    LatencyDump* dump = latency_dump;
+    if (!dump) {
+        return;
+    }
+    pthread_mutex_lock(&dump->lock);
+    dump->stopping = 1;
+    pthread_cond_signal(&dump->cond);
+    pthread_mutex_unlock(&dump->lock);
+    pthread_join(dump->thread, NULL);
+    pthread_cond_destroy(&dump->cond);
+    pthread_mutex_destroy(&dump->lock);
+    free(dump->path);
+    free(dump);
+    latency_dump = NULL;
+}
+
+// 定时把每个周期的延迟分布追加到CSV文件（已有定时输出时换成新的文件和周期）
+KafkaErrorCode start_kafka_latency_dump(const char* path, int32_t interval_ms) {
+    if (!path || interval_ms <= 0) {
+        KLOG_ERROR("start_kafka_latency_dump - Invalid parameters");
+        return KAFKA_ERROR;
+    }
+    LatencyDump* dump = calloc(1, sizeof(LatencyDump));
+    if (!dump || !(dump->path = strdup(path))) {
+        free(dump);
+        return KAFKA_ERROR;
+    }
+    dump->interval_ms = interval_ms;
+    pthread_mutex_init(&dump->lock, NULL);
+    pthread_cond_init(&dump->cond, NULL);
+
+    pthread_mutex_lock(&dump_lock);
+    dump_stop_locked();
+    if (pthread_create(&dump->thread, NULL, dump_thread, dump) != 0) {
+        pthread_mutex_unlock(&dump_lock);
+        pthread_cond_destroy(&dump->cond);
+        pthread_mutex_destroy(&dump->lock);
+        free(dump->path);
+        free(dump);
+        return KAFKA_ERROR;
+    }
+    latency_dump = dump;
+    pthread_mutex_unlock(&dump_lock);
+    KLOG_INFO("Dumping latency histograms to %s every %d ms", path, interval_ms);
+    return KAFKA_OK;
+}
+
+// 停止定时输出（停止前输出最后一个周期）
+void stop_kafka_latency_dump(void) {
+    pthread_mutex_lock(&dump_lock);
+    dump_stop_locked();
+    pthread_mutex_unlock(&dump_lock);
+}
@@ -0,0 +1,218 @@
+#include "kafka_internal.h"
+#include <stdarg.h>
+#include <stdlib.h>
+#include <time.h>
+
+// 原生日志：调用方把格式化好的一行放进无锁环形队列，后台线程批量写到stdout（或日志文件）。
+// 级别检查在宏里完成，低于运行时级别的日志不会格式化；低于编译期级别的调用直接被编译器去掉。
+// 队列满时丢弃新日志并计数，调用方永远不会阻塞。librdkafka自己的日志也通过log_cb转到这里。
+
+#define LOG_RING_SIZE 1024          // 必须是2的幂
+#define LOG_MESSAGE_MAX 512
+#define LOG_IDLE_SLEEP_MS 5
+#define LOG_FLUSH_TIMEOUT_MS 1000
+
+typedef struct {
+    size_t seq;                     // 槽位序号：等于写入位置时可写，等于写入位置+1时可读
+    int32_t level;
+    int32_t len;
+    char text[LOG_MESSAGE_MAX];
+} LogSlot;
+
+int kafka_log_level = KAFKA_LOG_INFO;
+
+static LogSlot log_ring[LOG_RING_SIZE];
+static size_t log_enqueue_pos;
+static size_t log_dequeue_pos;      // 只有写出线程修改
+static int64_t log_dropped;
+
+static pthread_once_t log_once = PTHREAD_ONCE_INIT;
+static pthread_t log_thread;
+static int log_thread_running;
+static int log_stopping;
+static pthread_mutex_t log_sink_lock = PTHREAD_MUTEX_INITIALIZER;
+static FILE* log_file;              // NULL时写stdout
+
+static const char* level_prefix[] = {
+    "❌ C: ",
+    "⚠️  C: ",
+    "✅ C: ",
+    "🔧 C: ",
+};
+
+static FILE* log_sink(void) {
+    return log_file ? log_file : stdout;
+}
+
+// 写出队列中所有已完成的日志，返回写出的条数
+static int32_t log_drain(void) {
+    int32_t n = 0;
+    pthread_mutex_lock(&log_sink_lock);
+    FILE* out = log_sink();
+    for (;;) {
+        LogSlot* slot = &log_ring[log_dequeue_pos & (LOG_RING_SIZE - 1)];
+        size_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        if (seq != log_dequeue_pos + 1) {
+            break;  // 队列为空，或者这个槽位还在格式化
+        }
+        fputs(level_prefix[slot->level], out);
+        fwrite(slot->text, 1, slot->len, out);
+        fputc('\n', out);
+        __atomic_store_n(&slot->seq, log_dequeue_pos + LOG_RING_SIZE, __ATOMIC_RELEASE);
+        __atomic_store_n(&log_dequeue_pos, log_dequeue_pos + 1, __ATOMIC_RELEASE);
+        n++;
+    }
+    int64_t dropped = __atomic_exchange_n(&log_dropped, 0, __ATOMIC_RELAXED);
+    if (dropped > 0) {
+        fprintf(out, "%s%lld log messages dropped (queue full)\n", level_prefix[KAFKA_LOG_WARN], (long long)dropped);
+    }
+    if (n > 0 || dropped > 0) {
+        fflush(out);
+    }
+    pthread_mutex_unlock(&log_sink_lock);
+    return n;
+}
+
+static void log_sleep_ms(int32_t ms) {
+    struct timespec ts = { ms / 1000, (long)(ms % 1000) * 1000000 };
+    nanosleep(&ts, NULL);
+}
+
+static void* log_thread_main(void* arg) {
+    (void)arg;
+    for (;;) {
+        int32_t n = log_drain();
+        if (__atomic_load_n(&log_stopping, __ATOMIC_ACQUIRE)) {
+            log_drain();
+            return NULL;
+        }
+        if (n == 0) {
+            log_sleep_ms(LOG_IDLE_SLEEP_MS);
+        }
+    }
+}
+
+// 进程退出时写完剩余的日志
+static void log_shutdown(void) {
+    if (!log_thread_running) {
+        return;
+    }
+    __atomic_store_n(&log_stopping, 1, __ATOMIC_RELEASE);
+    pthread_join(log_thread, NULL);
+    log_thread_running = 0;
+}
+
+static void log_init(void) {
+    for (size_t i = 0; i < LOG_RING_SIZE; i++) {
+        log_ring[i].seq = i;
+    }
+    if (pthread_create(&log_thread, NULL, log_thread_main, NULL) == 0) {
+        log_thread_running = 1;
+        atexit(log_shutdown);
+    }
+}
+
+void kafka_log_write(int level, const char* fmt, ...) {
+    pthread_once(&log_once, log_init);
+    if (level < KAFKA_LOG_ERROR || level > KAFKA_LOG_DEBUG) {
+        level = KAFKA_LOG_ERROR;
+    }
+
+    // 领取一个槽位（Vyukov有界队列），队列满时丢弃
+    size_t pos = __atomic_load_n(&log_enqueue_pos, __ATOMIC_RELAXED);
+    LogSlot* slot;
+    for (;;) {
+        slot = &log_ring[pos & (LOG_RING_SIZE - 1)];
+        size_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&log_enqueue_pos, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            __atomic_add_fetch(&log_dropped, 1, __ATOMIC_RELAXED);
+            return;
+        } else {
+            pos = __atomic_load_n(&log_enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(slot->text, sizeof(slot->text), fmt, args);
+    va_end(args);
+    if (len < 0) {
+        len = 0;
+    } else if (len >= (int)sizeof(slot->text)) {
+        len = sizeof(slot->text) - 1;
+    }
+    // 调用方的格式串可能还带着换行，输出时统一加
+    while (len > 0 && slot->text[len - 1] == '\n') {
+        len--;
+    }
+    slot->level = level;
+    slot->len = len;
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+
+    if (!log_thread_running) {
+        log_drain();  // 写出线程没有启动时直接写
+    }
+}
+
+// librdkafka的log_cb（在librdkafka内部线程中调用），syslog级别映射到KAFKA_LOG_*
+void kafka_log_rdkafka_cb(const rd_kafka_t* rk, int level, const char* fac, const char* buf) {
+    int mapped = level <= 3 ? KAFKA_LOG_ERROR :
+        level == 4 ? KAFKA_LOG_WARN :
+        level <= 6 ? KAFKA_LOG_INFO : KAFKA_LOG_DEBUG;
+    KLOG(mapped, "librdkafka %s %s: %s", rk ? rd_kafka_name(rk) : "-", fac, buf);
+}
+
+// 设置运行时日志级别（KAFKA_LOG_*），低于该级别的日志不会格式化
+void set_kafka_log_level(int32_t level) {
+    if (level < KAFKA_LOG_ERROR) {
+        level = KAFKA_LOG_ERROR;
+    } else if (level > KAFKA_LOG_DEBUG) {
+        level = KAFKA_LOG_DEBUG;
+    }
+    __atomic_store_n(&kafka_log_level, level, __ATOMIC_RELAXED);
+}
+
+int32_t get_kafka_log_level(void) {
+    return __atomic_load_n(&kafka_log_level, __ATOMIC_RELAXED);
+}
+
+// 日志改写到文件（追加），path为NULL时恢复stdout
+KafkaErrorCode set_kafka_log_file(const char* path) {
+    FILE* f = NULL;
+    if (path) {
+        f = fopen(path, "a");
+        if (!f) {
+            KLOG_ERROR("Failed to open log file: %s", path);
+            return KAFKA_ERROR_FILE;
+        }
+    }
+    flush_kafka_log();
+    pthread_mutex_lock(&log_sink_lock);
+    FILE* old = log_file;
+    log_file = f;
+    pthread_mutex_unlock(&log_sink_lock);
+    if (old) {
+        fclose(old);
+    }
+    return KAFKA_OK;
+}
+
+// 等待此前写入的日志全部输出（最多等待1秒）
+void flush_kafka_log(void) {
+    pthread_once(&log_once, log_init);
+    size_t target = __atomic_load_n(&log_enqueue_pos, __ATOMIC_ACQUIRE);
+    for (int32_t waited = 0; waited < LOG_FLUSH_TIMEOUT_MS; waited++) {
+        if (!log_thread_running) {
+            log_drain();
+        }
+        if (__atomic_load_n(&log_dequeue_pos, __ATOMIC_ACQUIRE) >= target) {
+            return;
+        }
+        log_sleep_ms(1);
+    }
+}
@@ -0,0 +1,161 @@
+#include "kafka_internal.h"
+
+// 内存记账：消息存储、消费队列、自动保存缓冲区、元数据/配置缓存各自持有一个账户，
+// 分配和释放时按字节记账（计数器原子更新，不加锁）；librdkafka内部队列的大小由统计回调定期写入。
+// Dart按账户读取明细。设置软上限后，总量超过上限时消息存储淘汰旧的完整payload、
+// 消费循环暂停已分配的分区，回落到上限的90%以下再恢复。
+
+#define MEMORY_RESUME_PERCENT 90
+
+struct KafkaMemoryAccount {
+    char kind[32];
+    char name[128];
+    int64_t bytes;
+    int64_t peak_bytes;
+    struct KafkaMemoryAccount* next;
+};
+
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static KafkaMemoryAccount* accounts;
+static int32_t account_count;
+static int64_t memory_total;
+static int64_t memory_soft_limit;   // 0表示不限制
+
+static void account_set_name(KafkaMemoryAccount* account, const char* name) {
+    snprintf(account->name, sizeof(account->name), "%s", name ? name : "-");
+}
+
+KafkaMemoryAccount* kafka_memory_account_create(const char* kind, const char* name) {
+    KafkaMemoryAccount* account = calloc(1, sizeof(KafkaMemoryAccount));
+    if (!account) {
+        return NULL;
+    }
+    snprintf(account->kind, sizeof(account->kind), "%s", kind);
+    account_set_name(account, name);
+
+    pthread_mutex_lock(&registry_lock);
+    account->next = accounts;
+    accounts = account;
+    account_count++;
+    pthread_mutex_unlock(&registry_lock);
+    return account;
+}
+
+void kafka_memory_account_set_name(KafkaMemoryAccount* account, const char* name) {
+    if (!account) {
+        return;
+    }
+    pthread_mutex_lock(&registry_lock);
+    account_set_name(account, name);
+    pthread_mutex_unlock(&registry_lock);
+}
+
+// 注销账户，账户上剩余的字节从总量中扣除
+void kafka_memory_account_destroy(KafkaMemoryAccount* account) {
+    if (!account) {
+        return;
+    }
+    pthread_mutex_lock(&registry_lock);
+    KafkaMemoryAccount** slot = &accounts;
+    while (*slot && *slot != account) {
+        slot = &(*slot)->next;
+    }
+    if (*slot) {
+        *slot = account->next;
+        account_count--;
+    }
+    pthread_mutex_unlock(&registry_lock);
+
+    __atomic_sub_fetch(&memory_total, __atomic_load_n(&account->bytes, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    free(account);
+}
+
+void kafka_memory_charge(KafkaMemoryAccount* account, int64_t delta) {
+    if (!account || delta == 0) {
+        return;
+    }
+    int64_t bytes = __atomic_add_fetch(&account->bytes, delta, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&memory_total, delta, __ATOMIC_RELAXED);
+
+    int64_t peak = __atomic_load_n(&account->peak_bytes, __ATOMIC_RELAXED);
+    while (bytes > peak &&
+           !__atomic_compare_exchange_n(&account->peak_bytes, &peak, bytes, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+// 直接设置账户的字节数（外部统计来源，如librdkafka队列）
+void kafka_memory_set(KafkaMemoryAccount* account, int64_t bytes) {
+    if (!account) {
+        return;
+    }
+    int64_t old = __atomic_load_n(&account->bytes, __ATOMIC_RELAXED);
+    kafka_memory_charge(account, bytes - old);
+}
+
+int kafka_memory_over_limit(void) {
+    int64_t limit = __atomic_load_n(&memory_soft_limit, __ATOMIC_RELAXED);
+    return limit > 0 && __atomic_load_n(&memory_total, __ATOMIC_RELAXED) > limit;
+}
+
+int kafka_memory_below_resume_mark(void) {
+    int64_t limit = __atomic_load_n(&memory_soft_limit, __ATOMIC_RELAXED);
+    return limit <= 0 ||
+           __atomic_load_n(&memory_total, __ATOMIC_RELAXED) <= limit / 100 * MEMORY_RESUME_PERCENT;
+}
+
+// 设置内存软上限（字节），<= 0 表示不限制
+void set_kafka_memory_soft_limit(int64_t bytes) {
+    __atomic_store_n(&memory_soft_limit, bytes > 0 ? bytes : 0, __ATOMIC_RELAXED);
+}
+
+int64_t get_kafka_memory_soft_limit(void) {
+    return __atomic_load_n(&memory_soft_limit, __ATOMIC_RELAXED);
+}
+
+// 读取各账户的内存占用，total_bytes返回所有账户的总和
+KafkaMemoryUsage* get_kafka_memory_usage(int32_t* count, int64_t* total_bytes) {
+    if (!count) {
+        KLOG_ERROR("get_kafka_memory_usage - Invalid parameters");
+        return NULL;
+    }
+    *count = 0;
+
+    pthread_mutex_lock(&registry_lock);
+    KafkaMemoryUsage* usage = calloc(account_count > 0 ? account_count : 1, sizeof(KafkaMemoryUsage));
+    if (!usage) {
+        pthread_mutex_unlock(&registry_lock);
+        return NULL;
+    }
+    int32_t n = 0;
+    for (KafkaMemoryAccount* a = accounts; a; a = a->next) {
+        usage[n].kind = strdup(a->kind);
+        usage[n].name = strdup(a->name);
+        usage[n].bytes = __atomic_load_n(&a->bytes, __ATOMIC_RELAXED);
+        usage[n].peak_bytes = __atomic_load_n(&a->peak_bytes, __ATOMIC_RELAXED);
+        n++;
+        if (!usage[n - 1].kind || !usage[n - 1].name) {
+            pthread_mutex_unlock(&registry_lock);
+            free_kafka_memory_usage(usage, n);
+            return NULL;
+        }
+    }
+    pthread_mutex_unlock(&registry_lock);
+
+    if (total_bytes) {
+        *total_bytes = __atomic_load_n(&memory_total, __ATOMIC_RELAXED);
+    }
+    *count = n;
+    return usage;
+}
+
+// 释放内存占用明细
+void free_kafka_memory_usage(KafkaMemoryUsage* usage, int32_t count) {
+    if (!usage) {
+        return;
+    }
+    for (int32_t i = 0; i < count; i++) {
+        free(usage[i].kind);
+        free(usage[i].name);
+    }
+    free(usage);
+}
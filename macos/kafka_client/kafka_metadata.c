@@ -0,0 +1,434 @@
+#include "kafka_internal.h"
+#include <time.h>
+
+// 元数据缓存：每个连接一份，结果按TTL复用。
+// 全量元数据带主题名哈希索引；查询单个主题时只发定向metadata请求，不再拉取整个集群。
+// 请求出错或调用方发现结果已过期（如分区leader变化）时让缓存失效；单个主题失效时只把它在全量快照中
+// 标记为过期（之后单独定向查询），不丢弃整个快照。
+
+#define METADATA_TTL_MS 30000
+#define METADATA_TIMEOUT_MS 5000
+#define METADATA_BUCKETS 256
+#define METADATA_MAX_TOPIC_ENTRIES 1024
+
+// 引用计数的元数据快照，缓存替换时正在使用的调用方不受影响
+struct KafkaMetadataRef {
+    const struct rd_kafka_metadata* md;
+    int32_t refs;
+    int32_t* index;         // 主题名哈希索引（开放寻址，存topics下标，-1为空），只有全量快照有
+    uint32_t index_mask;
+    KafkaMemoryAccount* memory;
+    int64_t charged;        // 记在账户上的估算大小
+};
+
+// 单主题定向查询的结果
+typedef struct TopicEntry {
+    char* name;
+    KafkaMetadataRef* ref;
+    int64_t fetched_ms;
+    struct TopicEntry* next;
+} TopicEntry;
+
+// 全量快照中已失效的主题名
+typedef struct StaleName {
+    char* name;
+    struct StaleName* next;
+} StaleName;
+
+struct KafkaMetadataCache {
+    pthread_mutex_t lock;
+    KafkaMetadataRef* all;
+    int64_t all_fetched_ms;
+    StaleName* stale[METADATA_BUCKETS];    // 只对当前的all有效，all替换或释放时清空
+    int32_t stale_count;
+    TopicEntry* buckets[METADATA_BUCKETS];
+    int32_t entry_count;
+    KafkaMemoryAccount* memory;
+};
+
+// 单调时钟毫秒数（缓存TTL用）
+int64_t kafka_monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// 单调时钟纳秒数（延迟直方图用）
+int64_t kafka_monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// 字符串哈希（FNV-1a）
+uint32_t kafka_hash_string(const char* name) {
+    uint32_t h = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        h ^= *p;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// librdkafka分配的元数据大小（估算：结构体、主题名、副本和ISR列表）
+static int64_t metadata_bytes(const struct rd_kafka_metadata* md) {
+    int64_t n = sizeof(*md) + md->broker_cnt * (sizeof(struct rd_kafka_metadata_broker) + 64) +
+                md->topic_cnt * sizeof(struct rd_kafka_metadata_topic);
+    for (int32_t i = 0; i < md->topic_cnt; i++) {
+        const struct rd_kafka_metadata_topic* t = &md->topics[i];
+        n += strlen(t->topic) + 1 + t->partition_cnt * sizeof(struct rd_kafka_metadata_partition);
+        for (int32_t j = 0; j < t->partition_cnt; j++) {
+            n += (t->partitions[j].replica_cnt + t->partitions[j].isr_cnt) * sizeof(int32_t);
+        }
+    }
+    return n;
+}
+
+static KafkaMetadataRef* ref_create(KafkaMetadataCache* cache, const struct rd_kafka_metadata* md, int with_index) {
+    KafkaMetadataRef* ref = calloc(1, sizeof(KafkaMetadataRef));
+    if (!ref) {
+        return NULL;
+    }
+    ref->md = md;
+    ref->refs = 1;
+    ref->memory = cache->memory;
+
+    if (with_index) {
+        uint32_t cap = 16;
+        while (cap < (uint32_t)md->topic_cnt * 2) {
+            cap <<= 1;
+        }
+        ref->index = malloc(cap * sizeof(int32_t));
+        if (!ref->index) {
+            free(ref);
+            return NULL;
+        }
+        memset(ref->index, 0xff, cap * sizeof(int32_t));
+        ref->index_mask = cap - 1;
+
+        for (int32_t i = 0; i < md->topic_cnt; i++) {
+            uint32_t slot = kafka_hash_string(md->topics[i].topic) & ref->index_mask;
+            while (ref->index[slot] >= 0) {
+                slot = (slot + 1) & ref->index_mask;
+            }
+            ref->index[slot] = i;
+        }
+    }
+    ref->charged = sizeof(KafkaMetadataRef) + metadata_bytes(md) + (ref->index ? (ref->index_mask + 1) * sizeof(int32_t) : 0);
+    kafka_memory_charge(ref->memory, ref->charged);
+    return ref;
+}
+
+// 调用方需持有cache->lock
+static void ref_release_locked(KafkaMetadataRef* ref) {
+    if (!ref || --ref->refs > 0) {
+        return;
+    }
+    kafka_memory_charge(ref->memory, -ref->charged);
+    rd_kafka_metadata_destroy(ref->md);
+    free(ref->index);
+    free(ref);
+}
+
+static const struct rd_kafka_metadata_topic* ref_find(const KafkaMetadataRef* ref, const char* topic) {
+    if (ref->index) {
+        uint32_t slot = kafka_hash_string(topic) & ref->index_mask;
+        while (ref->index[slot] >= 0) {
+            const struct rd_kafka_metadata_topic* t = &ref->md->topics[ref->index[slot]];
+            if (strcmp(t->topic, topic) == 0) {
+                return t;
+            }
+            slot = (slot + 1) & ref->index_mask;
+        }
+        return NULL;
+    }
+
+    for (int32_t i = 0; i < ref->md->topic_cnt; i++) {
+        if (strcmp(ref->md->topics[i].topic, topic) == 0) {
+            return &ref->md->topics[i];
+        }
+    }
+    return NULL;
+}
+
+static TopicEntry** entry_slot(KafkaMetadataCache* cache, const char* topic) {
+    TopicEntry** slot = &cache->buckets[kafka_hash_string(topic) % METADATA_BUCKETS];
+    while (*slot && strcmp((*slot)->name, topic) != 0) {
+        slot = &(*slot)->next;
+    }
+    return slot;
+}
+
+static void entries_clear_locked(KafkaMetadataCache* cache) {
+    for (int i = 0; i < METADATA_BUCKETS; i++) {
+        TopicEntry* e = cache->buckets[i];
+        while (e) {
+            TopicEntry* next = e->next;
+            ref_release_locked(e->ref);
+            free(e->name);
+            free(e);
+            e = next;
+        }
+        cache->buckets[i] = NULL;
+    }
+    cache->entry_count = 0;
+}
+
+static int stale_contains_locked(KafkaMetadataCache* cache, const char* topic) {
+    for (StaleName* n = cache->stale[kafka_hash_string(topic) % METADATA_BUCKETS]; n; n = n->next) {
+        if (strcmp(n->name, topic) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void stale_clear_locked(KafkaMetadataCache* cache) {
+    for (int i = 0; i < METADATA_BUCKETS; i++) {
+        StaleName* n = cache->stale[i];
+        while (n) {
+            StaleName* next = n->next;
+            free(n->name);
+            free(n);
+            n = next;
+        }
+        cache->stale[i] = NULL;
+    }
+    cache->stale_count = 0;
+}
+
+// 释放全量快照，过期标记随之清空
+static void all_release_locked(KafkaMetadataCache* cache) {
+    ref_release_locked(cache->all);
+    cache->all = NULL;
+    stale_clear_locked(cache);
+}
+
+// 在全量快照中把主题标记为过期；标记过多（或分配失败）时直接释放快照
+static void stale_add_locked(KafkaMetadataCache* cache, const char* topic) {
+    if (!cache->all || stale_contains_locked(cache, topic)) {
+        return;
+    }
+    if (cache->stale_count >= METADATA_MAX_TOPIC_ENTRIES) {
+        all_release_locked(cache);
+        return;
+    }
+    StaleName* n = malloc(sizeof(StaleName));
+    char* name = strdup(topic);
+    if (!n || !name) {
+        free(n);
+        free(name);
+        all_release_locked(cache);
+        return;
+    }
+    uint32_t b = kafka_hash_string(topic) % METADATA_BUCKETS;
+    n->name = name;
+    n->next = cache->stale[b];
+    cache->stale[b] = n;
+    cache->stale_count++;
+}
+
+KafkaMetadataCache* kafka_metadata_cache_create(void) {
+    KafkaMetadataCache* cache = calloc(1, sizeof(KafkaMetadataCache));
+    if (!cache) {
+        return NULL;
+    }
+    pthread_mutex_init(&cache->lock, NULL);
+    cache->memory = kafka_memory_account_create("metadata_cache", NULL);
+    return cache;
+}
+
+void kafka_metadata_cache_set_owner(KafkaMetadataCache* cache, const char* owner) {
+    if (cache) {
+        kafka_memory_account_set_name(cache->memory, owner);
+    }
+}
+
+void kafka_metadata_cache_destroy(KafkaMetadataCache* cache) {
+    if (!cache) {
+        return;
+    }
+    pthread_mutex_lock(&cache->lock);
+    entries_clear_locked(cache);
+    all_release_locked(cache);
+    pthread_mutex_unlock(&cache->lock);
+    kafka_memory_account_destroy(cache->memory);
+    pthread_mutex_destroy(&cache->lock);
+    free(cache);
+}
+
+void kafka_metadata_release(KafkaClientHandle client, KafkaMetadataRef* ref) {
+    if (!client || !ref) {
+        return;
+    }
+    KafkaMetadataCache* cache = ((KafkaProducer*)client)->metadata;
+    pthread_mutex_lock(&cache->lock);
+    ref_release_locked(ref);
+    pthread_mutex_unlock(&cache->lock);
+}
+
+void kafka_metadata_invalidate(KafkaClientHandle client, const char* topic) {
+    if (!client) {
+        return;
+    }
+    KafkaMetadataCache* cache = ((KafkaProducer*)client)->metadata;
+    pthread_mutex_lock(&cache->lock);
+    if (topic) {
+        TopicEntry** slot = entry_slot(cache, topic);
+        TopicEntry* e = *slot;
+        if (e) {
+            *slot = e->next;
+            ref_release_locked(e->ref);
+            free(e->name);
+            free(e);
+            cache->entry_count--;
+        }
+        // 全量快照里其他主题仍然有效，只标记这个主题，下次查询时单独定向请求
+        stale_add_locked(cache, topic);
+    } else {
+        entries_clear_locked(cache);
+        all_release_locked(cache);
+    }
+    pthread_mutex_unlock(&cache->lock);
+}
+
+// 全量元数据（所有主题），失败返回NULL；用完调用kafka_metadata_release
+const struct rd_kafka_metadata* kafka_metadata_all(KafkaClientHandle client, KafkaMetadataRef** ref) {
+    KafkaProducer* p = (KafkaProducer*)client;
+    KafkaMetadataCache* cache = p->metadata;
+
+    pthread_mutex_lock(&cache->lock);
+    if (cache->all && kafka_monotonic_ms() - cache->all_fetched_ms < METADATA_TTL_MS) {
+        cache->all->refs++;
+        *ref = cache->all;
+        pthread_mutex_unlock(&cache->lock);
+        return (*ref)->md;
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    // 管理客户端没有其他地方轮询主队列，顺便处理积压的错误事件
+    kafka_connect_poll(client);
+    const struct rd_kafka_metadata* md;
+    rd_kafka_resp_err_t err = rd_kafka_metadata(p->rk, 1, NULL, &md, METADATA_TIMEOUT_MS);
+    if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+        KLOG_ERROR("Failed to get metadata: %s", rd_kafka_err2str(err));
+        kafka_metadata_invalidate(client, NULL);
+        return NULL;
+    }
+
+    KafkaMetadataRef* fresh = ref_create(cache, md, 1);
+    if (!fresh) {
+        rd_kafka_metadata_destroy(md);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&cache->lock);
+    all_release_locked(cache);
+    cache->all = fresh;
+    cache->all_fetched_ms = kafka_monotonic_ms();
+    fresh->refs++;  // 缓存一份，调用方一份
+    pthread_mutex_unlock(&cache->lock);
+
+    *ref = fresh;
+    return md;
+}
+
+// 单个主题的元数据：优先用未过期（且主题没有被标记为过期）的全量快照，否则发定向请求
+// 主题不存在时返回RD_KAFKA_RESP_ERR_UNKNOWN_TOPIC_OR_PART；成功时用完调用kafka_metadata_release
+rd_kafka_resp_err_t kafka_metadata_topic(
+    KafkaClientHandle client,
+    const char* topic,
+    const struct rd_kafka_metadata_topic** out,
+    KafkaMetadataRef** ref) {
+    KafkaProducer* p = (KafkaProducer*)client;
+    KafkaMetadataCache* cache = p->metadata;
+    int64_t now = kafka_monotonic_ms();
+
+    pthread_mutex_lock(&cache->lock);
+    if (cache->all && now - cache->all_fetched_ms < METADATA_TTL_MS && !stale_contains_locked(cache, topic)) {
+        const struct rd_kafka_metadata_topic* t = ref_find(cache->all, topic);
+        if (t && t->err == RD_KAFKA_RESP_ERR_NO_ERROR) {
+            cache->all->refs++;
+            *ref = cache->all;
+            *out = t;
+            pthread_mutex_unlock(&cache->lock);
+            return RD_KAFKA_RESP_ERR_NO_ERROR;
+        }
+    }
+    TopicEntry* e = *entry_slot(cache, topic);
+    if (e && now - e->fetched_ms < METADATA_TTL_MS) {
+        e->ref->refs++;
+        *ref = e->ref;
+        *out = ref_find(e->ref, topic);
+        pthread_mutex_unlock(&cache->lock);
+        return RD_KAFKA_RESP_ERR_NO_ERROR;
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    rd_kafka_topic_t* rkt = rd_kafka_topic_new(p->rk, topic, NULL);
+    if (!rkt) {
+        return RD_KAFKA_RESP_ERR__UNKNOWN_TOPIC;
+    }
+    const struct rd_kafka_metadata* md;
+    rd_kafka_resp_err_t err = rd_kafka_metadata(p->rk, 0, rkt, &md, METADATA_TIMEOUT_MS);
+    rd_kafka_topic_destroy(rkt);
+    if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+        KLOG_ERROR("Failed to get metadata for topic %s: %s", topic, rd_kafka_err2str(err));
+        kafka_metadata_invalidate(client, topic);
+        return err;
+    }
+
+    KafkaMetadataRef* fresh = ref_create(cache, md, 0);
+    if (!fresh) {
+        rd_kafka_metadata_destroy(md);
+        return RD_KAFKA_RESP_ERR__FAIL;
+    }
+    const struct rd_kafka_metadata_topic* t = ref_find(fresh, topic);
+    if (!t || t->err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+        err = t ? t->err : RD_KAFKA_RESP_ERR_UNKNOWN_TOPIC_OR_PART;
+        pthread_mutex_lock(&cache->lock);
+        ref_release_locked(fresh);
+        pthread_mutex_unlock(&cache->lock);
+        kafka_metadata_invalidate(client, topic);
+        return err;
+    }
+
+    pthread_mutex_lock(&cache->lock);
+    TopicEntry** slot = entry_slot(cache, topic);
+    if (*slot) {
+        ref_release_locked((*slot)->ref);
+        (*slot)->ref = fresh;
+        (*slot)->fetched_ms = kafka_monotonic_ms();
+        fresh->refs++;
+    } else {
+        if (cache->entry_count >= METADATA_MAX_TOPIC_ENTRIES) {
+            entries_clear_locked(cache);
+            slot = entry_slot(cache, topic);
+        }
+        TopicEntry* entry = malloc(sizeof(TopicEntry));
+        char* name = strdup(topic);
+        if (entry && name) {
+            entry->name = name;
+            entry->ref = fresh;
+            entry->fetched_ms = kafka_monotonic_ms();
+            entry->next = NULL;
+            *slot = entry;
+            cache->entry_count++;
+            fresh->refs++;
+        } else {
+            free(entry);
+            free(name);
+        }
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    *ref = fresh;
+    *out = t;
+    return RD_KAFKA_RESP_ERR_NO_ERROR;
+}
+
+// 让连接的元数据和主题配置缓存失效，下次查询重新请求broker
+void invalidate_kafka_metadata(KafkaClientHandle client) {
+    kafka_metadata_invalidate(client, NULL);
+    kafka_configs_invalidate(client);
+}
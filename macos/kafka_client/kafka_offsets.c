@@ -0,0 +1,272 @@
+#include "kafka_internal.h"
+
+// 批量查询分区水位：earliest和latest各发一次ListOffsets，
+// librdkafka按分区leader拆分成每个broker一个请求并行发送，整体只等待一个超时。
+// 请求通过Admin批次发出，可以和配置、消费者组等查询并发。
+
+#define WATERMARK_TIMEOUT_MS 5000
+#define WATERMARK_METADATA_PREFETCH 16  // 主题数超过该值时先拉全量元数据，避免逐个定向请求
+
+// (topic, partition) -> 下标的开放寻址索引，用来匹配ListOffsets结果
+typedef struct {
+    const rd_kafka_topic_partition_list_t* partitions;
+    int32_t* slots;
+    uint32_t mask;
+} PartitionIndex;
+
+static uint32_t hash_partition(const char* topic, int32_t partition) {
+    return (kafka_hash_string(topic) ^ (uint32_t)partition) * 16777619u;
+}
+
+static int index_build(PartitionIndex* index, const rd_kafka_topic_partition_list_t* partitions) {
+    uint32_t cap = 16;
+    while (cap < (uint32_t)partitions->cnt * 2) {
+        cap <<= 1;
+    }
+    index->slots = malloc(cap * sizeof(int32_t));
+    if (!index->slots) {
+        return 0;
+    }
+    memset(index->slots, 0xff, cap * sizeof(int32_t));
+    index->mask = cap - 1;
+    index->partitions = partitions;
+
+    for (int32_t i = 0; i < partitions->cnt; i++) {
+        const rd_kafka_topic_partition_t* tp = &partitions->elems[i];
+        uint32_t slot = hash_partition(tp->topic, tp->partition) & index->mask;
+        while (index->slots[slot] >= 0) {
+            slot = (slot + 1) & index->mask;
+        }
+        index->slots[slot] = i;
+    }
+    return 1;
+}
+
+static int32_t index_find(const PartitionIndex* index, const char* topic, int32_t partition) {
+    uint32_t slot = hash_partition(topic, partition) & index->mask;
+    while (index->slots[slot] >= 0) {
+        const rd_kafka_topic_partition_t* tp = &index->partitions->elems[index->slots[slot]];
+        if (tp->partition == partition && strcmp(tp->topic, topic) == 0) {
+            return index->slots[slot];
+        }
+        slot = (slot + 1) & index->mask;
+    }
+    return -1;
+}
+
+// 一次水位查询：earliest和latest各一个ListOffsets请求
+struct KafkaWatermarkQuery {
+    PartitionIndex index;
+    int32_t count;
+    struct WatermarkSide {
+        KafkaWatermarkQuery* query;
+        int64_t* out;
+    } sides[2];
+};
+
+static void on_list_offsets(KafkaAdminBatch* batch, rd_kafka_event_t* event, void* ctx) {
+    (void)batch;
+    struct WatermarkSide* side = ctx;
+    if (rd_kafka_event_error(event) != RD_KAFKA_RESP_ERR_NO_ERROR) {
+        KLOG_ERROR("ListOffsets failed: %s", rd_kafka_event_error_string(event));
+        return;
+    }
+
+    size_t count;
+    const rd_kafka_ListOffsetsResultInfo_t** infos =
+        rd_kafka_ListOffsets_result_infos(rd_kafka_event_ListOffsets_result(event), &count);
+    for (size_t i = 0; i < count; i++) {
+        const rd_kafka_topic_partition_t* tp = rd_kafka_ListOffsetsResultInfo_topic_partition(infos[i]);
+        int32_t at = index_find(&side->query->index, tp->topic, tp->partition);
+        if (at >= 0 && tp->err == RD_KAFKA_RESP_ERR_NO_ERROR) {
+            side->out[at] = tp->offset;
+        }
+    }
+}
+
+// 在批次中发出水位查询，low/high中不需要的一侧传NULL
+KafkaWatermarkQuery* kafka_watermarks_request(
+    KafkaAdminBatch* batch,
+    const rd_kafka_topic_partition_list_t* partitions,
+    int64_t* low,
+    int64_t* high) {
+    int32_t n = partitions->cnt;
+    for (int32_t i = 0; i < n; i++) {
+        if (low) {
+            low[i] = -1;
+        }
+        if (high) {
+            high[i] = -1;
+        }
+    }
+
+    KafkaWatermarkQuery* query = calloc(1, sizeof(KafkaWatermarkQuery));
+    if (!query) {
+        return NULL;
+    }
+    query->count = n;
+    query->sides[0].query = query;
+    query->sides[0].out = low;
+    query->sides[1].query = query;
+    query->sides[1].out = high;
+    if (n == 0) {
+        return query;
+    }
+    if (!index_build(&query->index, partitions)) {
+        free(query);
+        return NULL;
+    }
+
+    static const int64_t specs[2] = { RD_KAFKA_OFFSET_SPEC_EARLIEST, RD_KAFKA_OFFSET_SPEC_LATEST };
+    for (int which = 0; which < 2; which++) {
+        if (!query->sides[which].out) {
+            continue;
+        }
+        rd_kafka_AdminOptions_t* options = kafka_admin_batch_options(
+            batch, RD_KAFKA_ADMIN_OP_LISTOFFSETS, on_list_offsets, &query->sides[which]);
+        if (!options) {
+            continue;
+        }
+        rd_kafka_topic_partition_list_t* request = rd_kafka_topic_partition_list_copy(partitions);
+        for (int32_t i = 0; i < request->cnt; i++) {
+            request->elems[i].offset = specs[which];
+        }
+        rd_kafka_ListOffsets(batch->rk, request, options, batch->queue);
+        rd_kafka_topic_partition_list_destroy(request);
+        rd_kafka_AdminOptions_destroy(options);
+    }
+    return query;
+}
+
+// 批次完成后调用：查询失败的分区两侧都写入-1，返回失败的分区数
+int32_t kafka_watermarks_finish(KafkaWatermarkQuery* query) {
+    int64_t* low = query->sides[0].out;
+    int64_t* high = query->sides[1].out;
+    int32_t failed = 0;
+    for (int32_t i = 0; i < query->count; i++) {
+        if ((low && low[i] < 0) || (high && high[i] < 0)) {
+            if (low) {
+                low[i] = -1;
+            }
+            if (high) {
+                high[i] = -1;
+            }
+            failed++;
+        }
+    }
+    free(query->index.slots);
+    free(query);
+    return failed;
+}
+
+// 查询partitions中每个分区的earliest/latest，结果按partitions的顺序写入low/high
+// 两个请求同时发出，librdkafka按分区leader拆分成每个broker一个请求，整体只等待一个超时
+// 失败的分区写入-1，返回失败的分区数（整体失败时为partitions->cnt）
+int32_t kafka_query_watermarks(
+    KafkaClientHandle client,
+    const rd_kafka_topic_partition_list_t* partitions,
+    int64_t* low,
+    int64_t* high) {
+    int32_t n = partitions->cnt;
+    KafkaAdminBatch* batch = kafka_admin_batch_new(((KafkaProducer*)client)->rk, WATERMARK_TIMEOUT_MS);
+    KafkaWatermarkQuery* query = batch ? kafka_watermarks_request(batch, partitions, low, high) : NULL;
+    if (!query) {
+        kafka_admin_batch_destroy(batch);
+        for (int32_t i = 0; i < n; i++) {
+            low[i] = -1;
+            high[i] = -1;
+        }
+        return n;
+    }
+
+    kafka_admin_batch_wait(batch);
+    kafka_admin_batch_destroy(batch);
+    return kafka_watermarks_finish(query);
+}
+
+// 批量获取多个主题所有分区的水位
+KafkaPartitionOffsets* get_kafka_watermarks(
+    KafkaClientHandle client,
+    const char** topics,
+    int32_t topic_count,
+    int32_t* count) {
+    if (!client || !topics || topic_count <= 0 || !count) {
+        KLOG_ERROR("get_kafka_watermarks - Invalid parameters");
+        return NULL;
+    }
+    *count = 0;
+
+    // 主题较多时一次拉全量元数据，后续按主题名走哈希索引
+    if (topic_count > WATERMARK_METADATA_PREFETCH) {
+        KafkaMetadataRef* all;
+        if (kafka_metadata_all(client, &all)) {
+            kafka_metadata_release(client, all);
+        }
+    }
+
+    rd_kafka_topic_partition_list_t* partitions = rd_kafka_topic_partition_list_new(topic_count);
+    KafkaBuffer leaders = { 0 };
+    for (int32_t i = 0; i < topic_count; i++) {
+        const struct rd_kafka_metadata_topic* topic;
+        KafkaMetadataRef* ref;
+        if (kafka_metadata_topic(client, topics[i], &topic, &ref) != RD_KAFKA_RESP_ERR_NO_ERROR) {
+            KLOG_ERROR("get_kafka_watermarks - Skipping topic %s", topics[i]);
+            continue;
+        }
+        for (int j = 0; j < topic->partition_cnt; j++) {
+            rd_kafka_topic_partition_list_add(partitions, topics[i], topic->partitions[j].id);
+            kafka_buffer_append(&leaders, &topic->partitions[j].leader, sizeof(int32_t));
+        }
+        kafka_metadata_release(client, ref);
+    }
+
+    int32_t n = partitions->cnt;
+    KafkaPartitionOffsets* result = NULL;
+    int64_t* low = malloc((n > 0 ? n : 1) * sizeof(int64_t));
+    int64_t* high = malloc((n > 0 ? n : 1) * sizeof(int64_t));
+    if (n > 0 && low && high && !leaders.failed) {
+        result = calloc(n, sizeof(KafkaPartitionOffsets));
+    }
+
+    if (result) {
+        int32_t failed = kafka_query_watermarks(client, partitions, low, high);
+        const int32_t* leader_ids = (const int32_t*)leaders.data;
+        for (int32_t i = 0; i < n; i++) {
+            result[i].topic = strdup(partitions->elems[i].topic);
+            result[i].partition = partitions->elems[i].partition;
+            result[i].leader = leader_ids[i];
+            result[i].earliest_offset = low[i];
+            result[i].latest_offset = high[i];
+        }
+        if (failed > 0) {
+            KLOG_WARN("get_kafka_watermarks - %d of %d partitions failed", failed, n);
+            // leader可能已经变化，让这些主题的元数据失效（同一主题的分区是连续的）
+            const char* last = NULL;
+            for (int32_t i = 0; i < n; i++) {
+                if (low[i] < 0 && (!last || strcmp(last, result[i].topic) != 0)) {
+                    last = partitions->elems[i].topic;
+                    kafka_metadata_invalidate(client, last);
+                }
+            }
+        }
+        *count = n;
+    }
+
+    free(low);
+    free(high);
+    kafka_buffer_free(&leaders);
+    rd_kafka_topic_partition_list_destroy(partitions);
+    return result;
+}
+
+// 释放水位查询结果
+void free_kafka_watermarks(KafkaPartitionOffsets* offsets, int32_t count) {
+    if (!offsets || count <= 0) {
+        return;
+    }
+
+    for (int32_t i = 0; i < count; i++) {
+        free(offsets[i].topic);
+    }
+    free(offsets);
+}
@@ -0,0 +1,285 @@
+#include "kafka_internal.h"
+
+// 集群主题概览：后台线程按块统计所有主题的分区数、副本因子、消息数、未同步分区和保留策略。
+// 每块主题的水位和配置在同一个Admin批次中并发查询，几个工作线程同时处理不同的块；
+// 算好的行进入队列，Dart侧按批次取走，大集群也能先显示已完成的部分。
+// 停止时不等待工作线程（正在查询的块可能要等到超时），最后退出的一方释放资源；
+// 期间持有共享管理客户端的引用，调用方可以立即释放客户端。
+
+#define OVERVIEW_WORKERS 4
+#define OVERVIEW_CHUNK_TOPICS 200
+#define OVERVIEW_TIMEOUT_MS 5000
+
+typedef struct {
+    KafkaClientHandle client;
+    int retained;               // 持有共享管理客户端的引用
+    KafkaMetadataRef* ref;
+    const struct rd_kafka_metadata* md;
+    int32_t thread_count;
+
+    pthread_mutex_t lock;
+    int32_t next_topic;         // 下一个待领取块的起始主题下标
+    int32_t running_workers;
+    int stopping;
+
+    // 已完成、尚未被取走的行
+    KafkaTopicOverview* ready;
+    int32_t ready_count;
+    int32_t ready_capacity;
+} KafkaOverview;
+
+// 统计一块主题，结果追加到待取队列
+static void overview_chunk(KafkaOverview* ov, int32_t start, int32_t n) {
+    const struct rd_kafka_metadata_topic* topics = &ov->md->topics[start];
+    const char** names = malloc(n * sizeof(char*));
+    KafkaTopicOverview* rows = calloc(n, sizeof(KafkaTopicOverview));
+    KafkaTopicConfigSummary* summaries = calloc(n, sizeof(KafkaTopicConfigSummary));
+    rd_kafka_topic_partition_list_t* partitions = rd_kafka_topic_partition_list_new(n);
+    if (!names || !rows || !summaries) {
+        free(names);
+        free(rows);
+        free(summaries);
+        rd_kafka_topic_partition_list_destroy(partitions);
+        return;
+    }
+    for (int32_t i = 0; i < n; i++) {
+        names[i] = topics[i].topic;
+        for (int j = 0; j < topics[i].partition_cnt; j++) {
+            rd_kafka_topic_partition_list_add(partitions, topics[i].topic, topics[i].partitions[j].id);
+        }
+    }
+
+    int32_t pc = partitions->cnt;
+    int64_t* low = malloc((pc > 0 ? pc : 1) * sizeof(int64_t));
+    int64_t* high = malloc((pc > 0 ? pc : 1) * sizeof(int64_t));
+    KafkaAdminBatch* batch = low && high ?
+        kafka_admin_batch_new(((KafkaProducer*)ov->client)->rk, OVERVIEW_TIMEOUT_MS) : NULL;
+    KafkaConfigQuery* configs = batch ? kafka_configs_request(batch, ov->client, names, n, 0) : NULL;
+    KafkaWatermarkQuery* watermarks = batch ? kafka_watermarks_request(batch, partitions, low, high) : NULL;
+    if (batch) {
+        kafka_admin_batch_wait(batch);
+        kafka_admin_batch_destroy(batch);
+    }
+    if (configs) {
+        kafka_configs_finish(configs);
+    }
+    if (watermarks) {
+        kafka_watermarks_finish(watermarks);
+    }
+    kafka_configs_summarize(ov->client, names, n, summaries);
+
+    // 同一主题的分区在partitions中是连续的
+    int32_t at = 0;
+    for (int32_t i = 0; i < n; i++) {
+        const struct rd_kafka_metadata_topic* topic = &topics[i];
+        KafkaTopicOverview* row = &rows[i];
+        row->topic = summaries[i].topic;
+        row->cleanup_policy = summaries[i].cleanup_policy;
+        row->retention_ms = summaries[i].retention_ms;
+        row->retention_bytes = summaries[i].retention_bytes;
+        row->partition_count = topic->partition_cnt;
+
+        int32_t total_replicas = 0;
+        int64_t messages = 0;
+        for (int j = 0; j < topic->partition_cnt; j++, at++) {
+            const struct rd_kafka_metadata_partition* partition = &topic->partitions[j];
+            total_replicas += partition->replica_cnt;
+            if (partition->isr_cnt < partition->replica_cnt) {
+                row->under_replicated++;
+            }
+            if (!watermarks || messages < 0 || low[at] < 0 || high[at] < 0) {
+                messages = -1;
+            } else {
+                messages += high[at] - low[at];
+            }
+        }
+        row->replication_factor = topic->partition_cnt > 0 ? total_replicas / topic->partition_cnt : 0;
+        row->messages = messages;
+    }
+
+    free(names);
+    free(summaries);
+    free(low);
+    free(high);
+    rd_kafka_topic_partition_list_destroy(partitions);
+
+    pthread_mutex_lock(&ov->lock);
+    if (ov->ready_count + n > ov->ready_capacity) {
+        int32_t capacity = ov->ready_capacity > 0 ? ov->ready_capacity : OVERVIEW_CHUNK_TOPICS;
+        while (capacity < ov->ready_count + n) {
+            capacity *= 2;
+        }
+        KafkaTopicOverview* grown = realloc(ov->ready, capacity * sizeof(KafkaTopicOverview));
+        if (!grown) {
+            pthread_mutex_unlock(&ov->lock);
+            free_kafka_topic_overview(rows, n);
+            return;
+        }
+        ov->ready = grown;
+        ov->ready_capacity = capacity;
+    }
+    memcpy(&ov->ready[ov->ready_count], rows, n * sizeof(KafkaTopicOverview));
+    ov->ready_count += n;
+    pthread_mutex_unlock(&ov->lock);
+    free(rows);
+}
+
+// 释放概览：工作线程都已退出且调用方已停止
+static void overview_destroy(KafkaOverview* ov) {
+    free_kafka_topic_overview(ov->ready, ov->ready_count);
+    if (ov->ready_count == 0) {
+        free(ov->ready);
+    }
+    kafka_metadata_release(ov->client, ov->ref);
+    if (ov->retained) {
+        release_kafka_admin_client(ov->client);
+    }
+    pthread_mutex_destroy(&ov->lock);
+    free(ov);
+}
+
+static void* overview_thread(void* arg) {
+    KafkaOverview* ov = (KafkaOverview*)arg;
+    for (;;) {
+        pthread_mutex_lock(&ov->lock);
+        int32_t start = ov->next_topic;
+        int32_t n = ov->md->topic_cnt - start;
+        if (ov->stopping || n <= 0) {
+            // 已经停止时最后一个退出的线程负责释放
+            int last = --ov->running_workers == 0 && ov->stopping;
+            pthread_mutex_unlock(&ov->lock);
+            if (last) {
+                overview_destroy(ov);
+                KLOG_INFO("Topic overview stopped");
+            }
+            return NULL;
+        }
+        if (n > OVERVIEW_CHUNK_TOPICS) {
+            n = OVERVIEW_CHUNK_TOPICS;
+        }
+        ov->next_topic += n;
+        pthread_mutex_unlock(&ov->lock);
+
+        overview_chunk(ov, start, n);
+    }
+}
+
+// 启动集群主题概览
+KafkaOverviewHandle start_kafka_topic_overview(KafkaClientHandle client, int32_t* topic_count) {
+    if (!client || !topic_count) {
+        KLOG_ERROR("start_kafka_topic_overview - Invalid parameters");
+        return NULL;
+    }
+    *topic_count = 0;
+
+    KafkaOverview* ov = calloc(1, sizeof(KafkaOverview));
+    if (!ov) {
+        return NULL;
+    }
+    ov->client = client;
+    ov->md = kafka_metadata_all(client, &ov->ref);
+    if (!ov->md) {
+        KLOG_ERROR("start_kafka_topic_overview - Failed to get metadata");
+        free(ov);
+        return NULL;
+    }
+    pthread_mutex_init(&ov->lock, NULL);
+    ov->retained = kafka_admin_retain(client);
+
+    // 先占满计数，避免早退出的线程让drain误判为已结束
+    ov->running_workers = OVERVIEW_WORKERS;
+    for (int32_t i = 0; i < OVERVIEW_WORKERS; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, overview_thread, ov) != 0) {
+            break;
+        }
+        pthread_detach(thread);
+        ov->thread_count++;
+    }
+    pthread_mutex_lock(&ov->lock);
+    ov->running_workers -= OVERVIEW_WORKERS - ov->thread_count;
+    pthread_mutex_unlock(&ov->lock);
+    if (ov->thread_count == 0) {
+        KLOG_ERROR("start_kafka_topic_overview - Failed to start worker threads");
+        overview_destroy(ov);
+        return NULL;
+    }
+
+    *topic_count = ov->md->topic_cnt;
+    KLOG_INFO("Started topic overview for %d topics with %d workers", *topic_count, ov->thread_count);
+    return ov;
+}
+
+// 取出已完成的概览行，最多max_rows行；所有主题都已统计并取完时done置1
+KafkaTopicOverview* drain_kafka_topic_overview(
+    KafkaOverviewHandle handle,
+    int32_t max_rows,
+    int32_t* count,
+    int32_t* done) {
+    if (!handle || max_rows <= 0 || !count || !done) {
+        KLOG_ERROR("drain_kafka_topic_overview - Invalid parameters");
+        return NULL;
+    }
+    KafkaOverview* ov = (KafkaOverview*)handle;
+    KafkaTopicOverview* rows = NULL;
+    *count = 0;
+
+    pthread_mutex_lock(&ov->lock);
+    int32_t n = ov->ready_count < max_rows ? ov->ready_count : max_rows;
+    if (n == ov->ready_count) {
+        // 全部取走时直接交出队列，不用复制
+        rows = ov->ready;
+        ov->ready = NULL;
+        ov->ready_count = 0;
+        ov->ready_capacity = 0;
+    } else {
+        rows = malloc(n * sizeof(KafkaTopicOverview));
+        if (rows) {
+            memcpy(rows, ov->ready, n * sizeof(KafkaTopicOverview));
+            memmove(ov->ready, &ov->ready[n], (ov->ready_count - n) * sizeof(KafkaTopicOverview));
+            ov->ready_count -= n;
+        } else {
+            n = 0;
+        }
+    }
+    *done = ov->running_workers == 0 && ov->ready_count == 0;
+    pthread_mutex_unlock(&ov->lock);
+
+    if (n == 0) {
+        free(rows);
+        return NULL;
+    }
+    *count = n;
+    return rows;
+}
+
+// 释放取出的概览行
+void free_kafka_topic_overview(KafkaTopicOverview* rows, int32_t count) {
+    if (!rows || count <= 0) {
+        return;
+    }
+
+    for (int32_t i = 0; i < count; i++) {
+        free(rows[i].topic);
+        free(rows[i].cleanup_policy);
+    }
+    free(rows);
+}
+
+// 停止概览，立即返回：工作线程做完手头的块（结果返回或超时）后退出，最后一个释放资源；
+// 调用后handle不能再使用
+void stop_kafka_topic_overview(KafkaOverviewHandle handle) {
+    if (!handle) {
+        return;
+    }
+    KafkaOverview* ov = (KafkaOverview*)handle;
+
+    pthread_mutex_lock(&ov->lock);
+    ov->stopping = 1;
+    int idle = ov->running_workers == 0;
+    pthread_mutex_unlock(&ov->lock);
+    if (idle) {
+        overview_destroy(ov);
+        KLOG_INFO("Topic overview stopped");
+    }
+}
@@ -0,0 +1,1009 @@
+#include "kafka_internal.h"
+
+// Protobuf解码：解析.proto文本（message/enum/oneof/map，忽略service和option），
+// 按字段定义把wire格式转成JSON文本。未知字段以字段号为key输出，bytes按base64输出。
+// import的类型无法解析时按bytes输出。
+
+#define PROTO_MAX_DEPTH 64
+
+typedef enum {
+    PB_DOUBLE, PB_FLOAT, PB_INT32, PB_INT64, PB_UINT32, PB_UINT64,
+    PB_SINT32, PB_SINT64, PB_FIXED32, PB_FIXED64, PB_SFIXED32, PB_SFIXED64,
+    PB_BOOL, PB_STRING, PB_BYTES,
+    PB_NAMED,    // 解析完成前的引用类型
+    PB_MESSAGE,
+    PB_ENUM,
+} PbKind;
+
+typedef struct PbEnum {
+    char* full_name;
+    char** value_names;
+    int32_t* values;
+    int32_t count;
+} PbEnum;
+
+struct PbMessage;
+
+typedef struct {
+    char* name;
+    int32_t number;
+    PbKind kind;
+    int repeated;
+    char* type_name;
+    struct PbMessage* message;
+    PbEnum* enum_type;
+} PbField;
+
+typedef struct PbMessage {
+    char* full_name;              // 不含package的全名，例如Outer.Inner
+    struct PbMessage* parent;
+    PbField* fields;
+    int32_t field_count;
+    struct PbMessage** nested;    // 按声明顺序（包含map生成的entry类型，与descriptor一致）
+    int32_t nested_count;
+    int is_map_entry;
+} PbMessage;
+
+struct KafkaProtoFile {
+    char* package;
+    PbMessage** messages;         // 顶层message
+    int32_t message_count;
+    PbMessage** all_messages;
+    int32_t all_message_count;
+    PbEnum** all_enums;
+    int32_t all_enum_count;
+};
+
+// ---------- 词法 ----------
+
+typedef enum { TOK_EOF, TOK_IDENT, TOK_NUMBER, TOK_STRING, TOK_SYMBOL } PbTokenType;
+
+typedef struct {
+    const char* p;
+    const char* end;
+    PbTokenType type;
+    char text[256];
+} PbLexer;
+
+static void lex_skip_space(PbLexer* lx) {
+    while (lx->p < lx->end) {
+        char c = *lx->p;
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            lx->p++;
+        } else if (c == '/' && lx->p + 1 < lx->end && lx->p[1] == '/') {
+            while (lx->p < lx->end && *lx->p != '\n') {
+                lx->p++;
+            }
+        } else if (c == '/' && lx->p + 1 < lx->end && lx->p[1] == '*') {
+            lx->p += 2;
+            while (lx->p + 1 < lx->end && !(lx->p[0] == '*' && lx->p[1] == '/')) {
+                lx->p++;
+            }
+            lx->p = lx->p + 2 <= lx->end ? lx->p + 2 : lx->end;
+        } else {
+            break;
+        }
+    }
+}
+
+static int is_ident_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '.';
+}
+
+static void lex_next(PbLexer* lx) {
+    lex_skip_space(lx);
+    lx->text[0] = '\0';
+    if (lx->p >= lx->end) {
+        lx->type = TOK_EOF;
+        return;
+    }
+
+    char c = *lx->p;
+    size_t n = 0;
+    if (c == '"' || c == '\'') {
+        lx->type = TOK_STRING;
+        lx->p++;
+        while (lx->p < lx->end && *lx->p != c) {
+            if (*lx->p == '\\' && lx->p + 1 < lx->end) {
+                lx->p++;
+            }
+            if (n + 1 < sizeof(lx->text)) {
+                lx->text[n++] = *lx->p;
+            }
+            lx->p++;
+        }
+        lx->p = lx->p < lx->end ? lx->p + 1 : lx->end;
+    } else if ((c >= '0' && c <= '9') || c == '-') {
+        lx->type = TOK_NUMBER;
+        while (lx->p < lx->end && (is_ident_char(*lx->p) || *lx->p == '-' || *lx->p == '+')) {
+            if (n + 1 < sizeof(lx->text)) {
+                lx->text[n++] = *lx->p;
+            }
+            lx->p++;
+        }
+    } else if (is_ident_char(c)) {
+        lx->type = TOK_IDENT;
+        while (lx->p < lx->end && is_ident_char(*lx->p)) {
+            if (n + 1 < sizeof(lx->text)) {
+                lx->text[n++] = *lx->p;
+            }
+            lx->p++;
+        }
+    } else {
+        lx->type = TOK_SYMBOL;
+        lx->text[n++] = c;
+        lx->p++;
+    }
+    lx->text[n] = '\0';
+}
+
+static int tok_is(PbLexer* lx, const char* text) {
+    return lx->type != TOK_EOF && lx->type != TOK_STRING && strcmp(lx->text, text) == 0;
+}
+
+// 跳过到分号（含分号），中间遇到的块一并跳过
+static void skip_statement(PbLexer* lx) {
+    int depth = 0;
+    while (lx->type != TOK_EOF) {
+        if (tok_is(lx, "{") || tok_is(lx, "[") || tok_is(lx, "(")) {
+            depth++;
+        } else if (tok_is(lx, "}") || tok_is(lx, "]") || tok_is(lx, ")")) {
+            depth--;
+            if (depth <= 0 && tok_is(lx, "}")) {
+                lex_next(lx);
+                return;
+            }
+        } else if (depth == 0 && tok_is(lx, ";")) {
+            lex_next(lx);
+            return;
+        }
+        lex_next(lx);
+    }
+}
+
+// ---------- 语法 ----------
+
+typedef struct {
+    PbLexer lx;
+    KafkaProtoFile* file;
+    int failed;
+} PbParser;
+
+static int push_ptr(void*** array, int32_t* count, void* item) {
+    void** items = realloc(*array, (size_t)(*count + 1) * sizeof(void*));
+    if (!items) {
+        return 0;
+    }
+    items[(*count)++] = item;
+    *array = items;
+    return 1;
+}
+
+static char* join_name(const PbMessage* parent, const char* name) {
+    if (!parent) {
+        return strdup(name);
+    }
+    size_t len = strlen(parent->full_name) + strlen(name) + 2;
+    char* full = malloc(len);
+    if (full) {
+        snprintf(full, len, "%s.%s", parent->full_name, name);
+    }
+    return full;
+}
+
+static PbKind scalar_kind(const char* type) {
+    static const struct {
+        const char* name;
+        PbKind kind;
+    } scalars[] = {
+        { "double", PB_DOUBLE },     { "float", PB_FLOAT },       { "int32", PB_INT32 },
+        { "int64", PB_INT64 },       { "uint32", PB_UINT32 },     { "uint64", PB_UINT64 },
+        { "sint32", PB_SINT32 },     { "sint64", PB_SINT64 },     { "fixed32", PB_FIXED32 },
+        { "fixed64", PB_FIXED64 },   { "sfixed32", PB_SFIXED32 }, { "sfixed64", PB_SFIXED64 },
+        { "bool", PB_BOOL },         { "string", PB_STRING },     { "bytes", PB_BYTES },
+    };
+    for (size_t i = 0; i < sizeof(scalars) / sizeof(scalars[0]); i++) {
+        if (strcmp(type, scalars[i].name) == 0) {
+            return scalars[i].kind;
+        }
+    }
+    return PB_NAMED;
+}
+
+static PbField* add_field(PbMessage* msg, const char* name, int32_t number, const char* type, int repeated) {
+    PbField* fields = realloc(msg->fields, (size_t)(msg->field_count + 1) * sizeof(PbField));
+    if (!fields) {
+        return NULL;
+    }
+    msg->fields = fields;
+
+    PbField* f = &fields[msg->field_count++];
+    memset(f, 0, sizeof(*f));
+    f->name = strdup(name);
+    f->number = number;
+    f->repeated = repeated;
+    f->kind = scalar_kind(type);
+    if (f->kind == PB_NAMED) {
+        f->type_name = strdup(type);
+    }
+    return f;
+}
+
+static PbMessage* new_message(PbParser* ps, PbMessage* parent, const char* name) {
+    PbMessage* msg = calloc(1, sizeof(PbMessage));
+    if (!msg) {
+        return NULL;
+    }
+    msg->full_name = join_name(parent, name);
+    msg->parent = parent;
+
+    KafkaProtoFile* file = ps->file;
+    if (!push_ptr((void***)&file->all_messages, &file->all_message_count, msg)) {
+        free(msg->full_name);
+        free(msg);
+        return NULL;
+    }
+    int ok = parent ? push_ptr((void***)&parent->nested, &parent->nested_count, msg)
+                    : push_ptr((void***)&file->messages, &file->message_count, msg);
+    return ok ? msg : NULL;
+}
+
+static void parse_enum(PbParser* ps, PbMessage* parent) {
+    PbLexer* lx = &ps->lx;
+    lex_next(lx);  // 名字
+    PbEnum* e = calloc(1, sizeof(PbEnum));
+    if (!e || !push_ptr((void***)&ps->file->all_enums, &ps->file->all_enum_count, e)) {
+        free(e);
+        ps->failed = 1;
+        return;
+    }
+    e->full_name = join_name(parent, lx->text);
+
+    lex_next(lx);
+    if (!tok_is(lx, "{")) {
+        ps->failed = 1;
+        return;
+    }
+    lex_next(lx);
+
+    while (lx->type != TOK_EOF && !tok_is(lx, "}")) {
+        if (tok_is(lx, "option") || tok_is(lx, "reserved")) {
+            skip_statement(lx);
+            continue;
+        }
+        if (lx->type != TOK_IDENT) {
+            lex_next(lx);
+            continue;
+        }
+        char name[256];
+        snprintf(name, sizeof(name), "%s", lx->text);
+        lex_next(lx);
+        if (!tok_is(lx, "=")) {
+            skip_statement(lx);
+            continue;
+        }
+        lex_next(lx);
+        int32_t value = (int32_t)strtol(lx->text, NULL, 0);
+        skip_statement(lx);
+
+        char** names = realloc(e->value_names, (size_t)(e->count + 1) * sizeof(char*));
+        int32_t* values = names ? realloc(e->values, (size_t)(e->count + 1) * sizeof(int32_t)) : NULL;
+        if (names) {
+            e->value_names = names;
+        }
+        if (!values) {
+            ps->failed = 1;
+            return;
+        }
+        e->values = values;
+        e->value_names[e->count] = strdup(name);
+        e->values[e->count] = value;
+        e->count++;
+    }
+    lex_next(lx);  // '}'
+}
+
+static void parse_message(PbParser* ps, PbMessage* parent, int depth);
+
+// 字段：[label] type name = number [options];
+static void parse_field(PbParser* ps, PbMessage* msg) {
+    PbLexer* lx = &ps->lx;
+    int repeated = 0;
+    if (tok_is(lx, "repeated")) {
+        repeated = 1;
+        lex_next(lx);
+    } else if (tok_is(lx, "optional") || tok_is(lx, "required")) {
+        lex_next(lx);
+    }
+
+    char type[256];
+    snprintf(type, sizeof(type), "%s", lx->text);
+    lex_next(lx);
+    char name[256];
+    snprintf(name, sizeof(name), "%s", lx->text);
+    lex_next(lx);
+    if (!tok_is(lx, "=")) {
+        skip_statement(lx);
+        return;
+    }
+    lex_next(lx);
+    int32_t number = (int32_t)strtol(lx->text, NULL, 0);
+    skip_statement(lx);
+
+    if (!add_field(msg, name, number, type, repeated)) {
+        ps->failed = 1;
+    }
+}
+
+// map<K, V> name = number;  等价于 repeated NameEntry { K key = 1; V value = 2; }
+static void parse_map_field(PbParser* ps, PbMessage* msg) {
+    PbLexer* lx = &ps->lx;
+    char key_type[256], value_type[256], name[256];
+
+    lex_next(lx);  // '<'
+    lex_next(lx);
+    snprintf(key_type, sizeof(key_type), "%s", lx->text);
+    lex_next(lx);  // ','
+    lex_next(lx);
+    snprintf(value_type, sizeof(value_type), "%s", lx->text);
+    lex_next(lx);  // '>'
+    lex_next(lx);
+    snprintf(name, sizeof(name), "%s", lx->text);
+    lex_next(lx);
+    if (!tok_is(lx, "=")) {
+        skip_statement(lx);
+        return;
+    }
+    lex_next(lx);
+    int32_t number = (int32_t)strtol(lx->text, NULL, 0);
+    skip_statement(lx);
+
+    char entry_name[300];
+    snprintf(entry_name, sizeof(entry_name), "%sEntry", name);
+    PbMessage* entry = new_message(ps, msg, entry_name);
+    if (!entry || !add_field(entry, "key", 1, key_type, 0) || !add_field(entry, "value", 2, value_type, 0)) {
+        ps->failed = 1;
+        return;
+    }
+    entry->is_map_entry = 1;
+
+    PbField* f = add_field(msg, name, number, entry->full_name, 1);
+    if (!f) {
+        ps->failed = 1;
+        return;
+    }
+    f->kind = PB_MESSAGE;
+    f->message = entry;
+}
+
+static void parse_body(PbParser* ps, PbMessage* msg, int depth, int in_oneof) {
+    PbLexer* lx = &ps->lx;
+    while (!ps->failed && lx->type != TOK_EOF && !tok_is(lx, "}")) {
+        if (tok_is(lx, ";")) {
+            lex_next(lx);
+        } else if (!in_oneof && tok_is(lx, "message")) {
+            parse_message(ps, msg, depth + 1);
+        } else if (!in_oneof && tok_is(lx, "enum")) {
+            parse_enum(ps, msg);
+        } else if (!in_oneof && tok_is(lx, "oneof")) {
+            lex_next(lx);  // 名字
+            lex_next(lx);  // '{'
+            lex_next(lx);
+            parse_body(ps, msg, depth, 1);
+            lex_next(lx);  // '}'
+        } else if (tok_is(lx, "option") || tok_is(lx, "reserved") || tok_is(lx, "extensions") ||
+                   tok_is(lx, "extend") || tok_is(lx, "group")) {
+            skip_statement(lx);
+        } else if (tok_is(lx, "map") && lx->p < lx->end && *lx->p == '<') {
+            parse_map_field(ps, msg);
+        } else if (lx->type == TOK_IDENT) {
+            parse_field(ps, msg);
+        } else {
+            lex_next(lx);
+        }
+    }
+}
+
+static void parse_message(PbParser* ps, PbMessage* parent, int depth) {
+    PbLexer* lx = &ps->lx;
+    if (depth > PROTO_MAX_DEPTH) {
+        ps->failed = 1;
+        return;
+    }
+
+    lex_next(lx);  // 名字
+    PbMessage* msg = new_message(ps, parent, lx->text);
+    if (!msg) {
+        ps->failed = 1;
+        return;
+    }
+    lex_next(lx);
+    if (!tok_is(lx, "{")) {
+        ps->failed = 1;
+        return;
+    }
+    lex_next(lx);
+    parse_body(ps, msg, depth, 0);
+    lex_next(lx);  // '}'
+}
+
+// 在作用域链上解析类型名
+static void resolve_field(KafkaProtoFile* file, PbMessage* scope, PbField* f) {
+    const char* name = f->type_name;
+    if (name[0] == '.') {
+        name++;
+    }
+    size_t pkg_len = file->package ? strlen(file->package) : 0;
+    if (pkg_len && strncmp(name, file->package, pkg_len) == 0 && name[pkg_len] == '.') {
+        name += pkg_len + 1;
+    }
+
+    char candidate[512];
+    for (PbMessage* s = scope; ; s = s->parent) {
+        if (s) {
+            snprintf(candidate, sizeof(candidate), "%s.%s", s->full_name, name);
+        } else {
+            snprintf(candidate, sizeof(candidate), "%s", name);
+        }
+        for (int32_t i = 0; i < file->all_message_count; i++) {
+            if (strcmp(file->all_messages[i]->full_name, candidate) == 0) {
+                f->kind = PB_MESSAGE;
+                f->message = file->all_messages[i];
+                return;
+            }
+        }
+        for (int32_t i = 0; i < file->all_enum_count; i++) {
+            if (strcmp(file->all_enums[i]->full_name, candidate) == 0) {
+                f->kind = PB_ENUM;
+                f->enum_type = file->all_enums[i];
+                return;
+            }
+        }
+        if (!s) {
+            break;
+        }
+    }
+
+    // 找不到（例如import的类型）按bytes处理
+    f->kind = PB_BYTES;
+}
+
+void kafka_proto_free(KafkaProtoFile* file) {
+    if (!file) {
+        return;
+    }
+
+    for (int32_t i = 0; i < file->all_message_count; i++) {
+        PbMessage* msg = file->all_messages[i];
+        for (int32_t j = 0; j < msg->field_count; j++) {
+            free(msg->fields[j].name);
+            free(msg->fields[j].type_name);
+        }
+        free(msg->fields);
+        free(msg->nested);
+        free(msg->full_name);
+        free(msg);
+    }
+    for (int32_t i = 0; i < file->all_enum_count; i++) {
+        PbEnum* e = file->all_enums[i];
+        for (int32_t j = 0; j < e->count; j++) {
+            free(e->value_names[j]);
+        }
+        free(e->value_names);
+        free(e->values);
+        free(e->full_name);
+        free(e);
+    }
+    free(file->messages);
+    free(file->all_messages);
+    free(file->all_enums);
+    free(file->package);
+    free(file);
+}
+
+// 解析.proto文本
+KafkaProtoFile* kafka_proto_parse(const char* text, size_t len) {
+    KafkaProtoFile* file = calloc(1, sizeof(KafkaProtoFile));
+    if (!file) {
+        return NULL;
+    }
+
+    PbParser ps;
+    memset(&ps, 0, sizeof(ps));
+    ps.lx.p = text;
+    ps.lx.end = text + len;
+    ps.file = file;
+    lex_next(&ps.lx);
+
+    while (!ps.failed && ps.lx.type != TOK_EOF) {
+        if (tok_is(&ps.lx, "package")) {
+            lex_next(&ps.lx);
+            free(file->package);
+            file->package = strdup(ps.lx.text);
+            skip_statement(&ps.lx);
+        } else if (tok_is(&ps.lx, "message")) {
+            parse_message(&ps, NULL, 0);
+        } else if (tok_is(&ps.lx, "enum")) {
+            parse_enum(&ps, NULL);
+        } else {
+            // syntax/import/option/service/extend
+            skip_statement(&ps.lx);
+        }
+    }
+
+    if (ps.failed || file->message_count == 0) {
+        kafka_proto_free(file);
+        return NULL;
+    }
+
+    for (int32_t i = 0; i < file->all_message_count; i++) {
+        PbMessage* msg = file->all_messages[i];
+        for (int32_t j = 0; j < msg->field_count; j++) {
+            if (msg->fields[j].kind == PB_NAMED) {
+                resolve_field(file, msg, &msg->fields[j]);
+            }
+        }
+    }
+    return file;
+}
+
+// ---------- wire格式解码 ----------
+
+enum { WIRE_VARINT = 0, WIRE_FIXED64 = 1, WIRE_LEN = 2, WIRE_FIXED32 = 5 };
+
+typedef struct {
+    int32_t number;
+    int wire_type;
+    uint64_t value;         // varint/fixed
+    const uint8_t* data;    // len-delimited
+    size_t len;
+} PbEntry;
+
+static int read_varint(const uint8_t** p, const uint8_t* end, uint64_t* out) {
+    uint64_t value = 0;
+    for (int shift = 0; *p < end && shift < 64; shift += 7) {
+        uint8_t b = *(*p)++;
+        value |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *out = value;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static uint64_t read_le(const uint8_t* p, int n) {
+    uint64_t v = 0;
+    for (int i = n - 1; i >= 0; i--) {
+        v = v << 8 | p[i];
+    }
+    return v;
+}
+
+// 读取一个字段（tag + 值）
+static int read_entry(const uint8_t** p, const uint8_t* end, PbEntry* e) {
+    uint64_t tag;
+    if (!read_varint(p, end, &tag) || (tag >> 3) == 0) {
+        return 0;
+    }
+    e->number = (int32_t)(tag >> 3);
+    e->wire_type = (int)(tag & 7);
+    e->value = 0;
+    e->data = NULL;
+    e->len = 0;
+
+    switch (e->wire_type) {
+        case WIRE_VARINT:
+            return read_varint(p, end, &e->value);
+        case WIRE_FIXED64:
+        case WIRE_FIXED32: {
+            int n = e->wire_type == WIRE_FIXED64 ? 8 : 4;
+            if (end - *p < n) {
+                return 0;
+            }
+            e->value = read_le(*p, n);
+            *p += n;
+            return 1;
+        }
+        case WIRE_LEN: {
+            uint64_t n;
+            if (!read_varint(p, end, &n) || n > (uint64_t)(end - *p)) {
+                return 0;
+            }
+            e->data = *p;
+            e->len = (size_t)n;
+            *p += n;
+            return 1;
+        }
+        default:
+            return 0;  // 不支持group
+    }
+}
+
+static void write_base64(KafkaBuffer* out, const uint8_t* data, size_t len) {
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    kafka_buffer_append(out, "\"", 1);
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t)data[i] << 16;
+        if (i + 1 < len) {
+            v |= (uint32_t)data[i + 1] << 8;
+        }
+        if (i + 2 < len) {
+            v |= data[i + 2];
+        }
+        char chunk[4] = {
+            table[(v >> 18) & 0x3F],
+            table[(v >> 12) & 0x3F],
+            i + 1 < len ? table[(v >> 6) & 0x3F] : '=',
+            i + 2 < len ? table[v & 0x3F] : '=',
+        };
+        kafka_buffer_append(out, chunk, 4);
+    }
+    kafka_buffer_append(out, "\"", 1);
+}
+
+static void write_float(KafkaBuffer* out, double v, int precision) {
+    if (v != v || v > 1.7976931348623157e308 || v < -1.7976931348623157e308) {
+        kafka_buffer_append_str(out, v != v ? "\"NaN\"" : (v > 0 ? "\"Infinity\"" : "\"-Infinity\""));
+        return;
+    }
+    kafka_buffer_printf(out, "%.*g", precision, v);
+}
+
+static int decode_message(const PbMessage* msg, const uint8_t* data, size_t len, KafkaBuffer* out, int depth);
+
+static int kind_wire_type(PbKind kind) {
+    switch (kind) {
+        case PB_DOUBLE:
+        case PB_FIXED64:
+        case PB_SFIXED64:
+            return WIRE_FIXED64;
+        case PB_FLOAT:
+        case PB_FIXED32:
+        case PB_SFIXED32:
+            return WIRE_FIXED32;
+        case PB_STRING:
+        case PB_BYTES:
+        case PB_MESSAGE:
+            return WIRE_LEN;
+        default:
+            return WIRE_VARINT;
+    }
+}
+
+// 输出数值类字段
+static void write_scalar(const PbField* f, uint64_t v, KafkaBuffer* out) {
+    switch (f->kind) {
+        case PB_INT32:
+        case PB_SFIXED32:
+            kafka_buffer_printf(out, "%d", (int32_t)(uint32_t)v);
+            break;
+        case PB_INT64:
+        case PB_SFIXED64:
+            kafka_buffer_printf(out, "%lld", (long long)(int64_t)v);
+            break;
+        case PB_UINT32:
+        case PB_FIXED32:
+            kafka_buffer_printf(out, "%u", (uint32_t)v);
+            break;
+        case PB_UINT64:
+        case PB_FIXED64:
+            kafka_buffer_printf(out, "%llu", (unsigned long long)v);
+            break;
+        case PB_SINT32:
+        case PB_SINT64:
+            kafka_buffer_printf(out, "%lld", (long long)((int64_t)(v >> 1) ^ -(int64_t)(v & 1)));
+            break;
+        case PB_BOOL:
+            kafka_buffer_append_str(out, v ? "true" : "false");
+            break;
+        case PB_FLOAT: {
+            uint32_t bits = (uint32_t)v;
+            float fv;
+            memcpy(&fv, &bits, sizeof(fv));
+            write_float(out, fv, 9);
+            break;
+        }
+        case PB_DOUBLE: {
+            double dv;
+            memcpy(&dv, &v, sizeof(dv));
+            write_float(out, dv, 17);
+            break;
+        }
+        case PB_ENUM: {
+            const PbEnum* e = f->enum_type;
+            for (int32_t i = 0; e && i < e->count; i++) {
+                if (e->values[i] == (int32_t)v) {
+                    kafka_buffer_append_json_string(out, e->value_names[i], strlen(e->value_names[i]));
+                    return;
+                }
+            }
+            kafka_buffer_printf(out, "%d", (int32_t)v);
+            break;
+        }
+        default:
+            kafka_buffer_printf(out, "%llu", (unsigned long long)v);
+            break;
+    }
+}
+
+// 输出一个值；wire类型与定义不一致时返回0
+static int write_value(const PbField* f, const PbEntry* e, KafkaBuffer* out, int depth) {
+    switch (f->kind) {
+        case PB_STRING:
+            if (e->wire_type != WIRE_LEN) {
+                return 0;
+            }
+            kafka_buffer_append_json_string(out, (const char*)e->data, e->len);
+            return 1;
+        case PB_BYTES:
+            if (e->wire_type != WIRE_LEN) {
+                return 0;
+            }
+            write_base64(out, e->data, e->len);
+            return 1;
+        case PB_MESSAGE:
+            if (e->wire_type != WIRE_LEN) {
+                return 0;
+            }
+            return decode_message(f->message, e->data, e->len, out, depth + 1);
+        default:
+            if (e->wire_type != kind_wire_type(f->kind)) {
+                return 0;
+            }
+            write_scalar(f, e->value, out);
+            return 1;
+    }
+}
+
+// map entry输出为 "key": value（JSON的key必须是字符串）
+static int write_map_entry(const PbMessage* entry, const uint8_t* data, size_t len, KafkaBuffer* out, int depth) {
+    PbEntry key = { 0, -1, 0, NULL, 0 };
+    PbEntry value = { 0, -1, 0, NULL, 0 };
+    const uint8_t* p = data;
+    const uint8_t* end = data + len;
+    while (p < end) {
+        PbEntry e;
+        if (!read_entry(&p, end, &e)) {
+            return 0;
+        }
+        if (e.number == 1) {
+            key = e;
+        } else if (e.number == 2) {
+            value = e;
+        }
+    }
+
+    const PbField* key_field = &entry->fields[0];
+    if (key.wire_type < 0) {
+        kafka_buffer_append_str(out, key_field->kind == PB_BOOL ? "\"false\"" : (key_field->kind == PB_STRING ? "\"\"" : "\"0\""));
+    } else if (key_field->kind == PB_STRING) {
+        if (!write_value(key_field, &key, out, depth)) {
+            return 0;
+        }
+    } else {
+        KafkaBuffer tmp = { 0 };
+        int ok = write_value(key_field, &key, &tmp, depth);
+        if (ok) {
+            kafka_buffer_append_json_string(out, tmp.data ? tmp.data : "", tmp.len);
+        }
+        kafka_buffer_free(&tmp);
+        if (!ok) {
+            return 0;
+        }
+    }
+    kafka_buffer_append(out, ":", 1);
+
+    if (value.wire_type < 0) {
+        kafka_buffer_append_str(out, "null");
+        return 1;
+    }
+    return write_value(&entry->fields[1], &value, out, depth);
+}
+
+// packed编码的repeated数值字段
+static int write_packed(const PbField* f, const PbEntry* e, KafkaBuffer* out, int* first) {
+    const uint8_t* p = e->data;
+    const uint8_t* end = e->data + e->len;
+    int wire = kind_wire_type(f->kind);
+    while (p < end) {
+        uint64_t v;
+        if (wire == WIRE_VARINT) {
+            if (!read_varint(&p, end, &v)) {
+                return 0;
+            }
+        } else {
+            int n = wire == WIRE_FIXED64 ? 8 : 4;
+            if (end - p < n) {
+                return 0;
+            }
+            v = read_le(p, n);
+            p += n;
+        }
+        if (!*first) {
+            kafka_buffer_append(out, ",", 1);
+        }
+        *first = 0;
+        write_scalar(f, v, out);
+    }
+    return 1;
+}
+
+// 未知字段：varint/fixed输出数字，len按文本或base64输出
+static void write_unknown(const PbEntry* e, KafkaBuffer* out) {
+    if (e->wire_type == WIRE_LEN) {
+        if (kafka_utf8_is_text((const char*)e->data, e->len)) {
+            kafka_buffer_append_json_string(out, (const char*)e->data, e->len);
+        } else {
+            write_base64(out, e->data, e->len);
+        }
+    } else {
+        kafka_buffer_printf(out, "%llu", (unsigned long long)e->value);
+    }
+}
+
+static int decode_message(const PbMessage* msg, const uint8_t* data, size_t len, KafkaBuffer* out, int depth) {
+    if (depth > PROTO_MAX_DEPTH) {
+        return 0;
+    }
+
+    // 先扫描出所有字段
+    PbEntry stack_entries[64];
+    PbEntry* entries = stack_entries;
+    size_t count = 0, cap = sizeof(stack_entries) / sizeof(stack_entries[0]);
+    const uint8_t* p = data;
+    const uint8_t* end = data + len;
+    int ok = 1;
+
+    while (p < end) {
+        PbEntry e;
+        if (!read_entry(&p, end, &e)) {
+            ok = 0;
+            break;
+        }
+
+        if (count == cap) {
+            size_t new_cap = cap * 2;
+            PbEntry* grown = entries == stack_entries ? malloc(new_cap * sizeof(PbEntry))
+                                                      : realloc(entries, new_cap * sizeof(PbEntry));
+            if (!grown) {
+                ok = 0;
+                break;
+            }
+            if (entries == stack_entries) {
+                memcpy(grown, stack_entries, sizeof(stack_entries));
+            }
+            entries = grown;
+            cap = new_cap;
+        }
+        entries[count++] = e;
+    }
+
+    int first_member = 1;
+    if (ok) {
+        kafka_buffer_append(out, "{", 1);
+    }
+
+    // 按字段定义顺序输出，repeated字段合并为数组
+    for (int32_t i = 0; ok && i < msg->field_count; i++) {
+        const PbField* f = &msg->fields[i];
+        size_t last = count;
+        int found = 0;
+        for (size_t j = 0; j < count; j++) {
+            if (entries[j].number == f->number) {
+                found = 1;
+                last = j;
+            }
+        }
+        if (!found) {
+            continue;
+        }
+
+        if (!first_member) {
+            kafka_buffer_append(out, ",", 1);
+        }
+        first_member = 0;
+        kafka_buffer_append_json_string(out, f->name, strlen(f->name));
+        kafka_buffer_append(out, ":", 1);
+
+        if (!f->repeated) {
+            // 非repeated字段以最后一次出现为准
+            ok = write_value(f, &entries[last], out, depth);
+            continue;
+        }
+
+        int is_map = f->kind == PB_MESSAGE && f->message->is_map_entry;
+        int first = 1;
+        kafka_buffer_append(out, is_map ? "{" : "[", 1);
+        for (size_t j = 0; ok && j < count; j++) {
+            const PbEntry* e = &entries[j];
+            if (e->number != f->number) {
+                continue;
+            }
+            if (e->wire_type == WIRE_LEN && kind_wire_type(f->kind) != WIRE_LEN) {
+                ok = write_packed(f, e, out, &first);
+                continue;
+            }
+            if (!first) {
+                kafka_buffer_append(out, ",", 1);
+            }
+            first = 0;
+            if (is_map) {
+                ok = e->wire_type == WIRE_LEN && write_map_entry(f->message, e->data, e->len, out, depth);
+            } else {
+                ok = write_value(f, e, out, depth);
+            }
+        }
+        kafka_buffer_append(out, is_map ? "}" : "]", 1);
+    }
+
+    // 未知字段按字段号输出
+    for (size_t j = 0; ok && j < count; j++) {
+        int known = 0;
+        for (int32_t i = 0; i < msg->field_count && !known; i++) {
+            known = msg->fields[i].number == entries[j].number;
+        }
+        int seen = 0;
+        for (size_t k = 0; k < j && !seen; k++) {
+            seen = entries[k].number == entries[j].number;
+        }
+        if (known || seen) {
+            continue;
+        }
+
+        if (!first_member) {
+            kafka_buffer_append(out, ",", 1);
+        }
+        first_member = 0;
+        kafka_buffer_printf(out, "\"%d\":", entries[j].number);
+
+        int repeated = 0;
+        for (size_t k = j + 1; k < count && !repeated; k++) {
+            repeated = entries[k].number == entries[j].number;
+        }
+        if (!repeated) {
+            write_unknown(&entries[j], out);
+            continue;
+        }
+        kafka_buffer_append(out, "[", 1);
+        for (size_t k = j; k < count; k++) {
+            if (entries[k].number == entries[j].number) {
+                if (k != j) {
+                    kafka_buffer_append(out, ",", 1);
+                }
+                write_unknown(&entries[k], out);
+            }
+        }
+        kafka_buffer_append(out, "]", 1);
+    }
+
+    if (ok) {
+        kafka_buffer_append(out, "}", 1);
+    }
+    if (entries != stack_entries) {
+        free(entries);
+    }
+    return ok;
+}
+
+// 解码Protobuf数据；indexes是Confluent格式中的message索引路径（空表示第一个顶层message）
+int kafka_proto_decode(const KafkaProtoFile* file, const int32_t* indexes, int32_t index_count,
+                       const uint8_t* data, size_t len, KafkaBuffer* out) {
+    if (!file || file->message_count == 0) {
+        return 0;
+    }
+
+    int32_t first = index_count > 0 ? indexes[0] : 0;
+    if (first < 0 || first >= file->message_count) {
+        return 0;
+    }
+    const PbMessage* msg = file->messages[first];
+    for (int32_t i = 1; i < index_count; i++) {
+        if (indexes[i] < 0 || indexes[i] >= msg->nested_count) {
+            return 0;
+        }
+        msg = msg->nested[indexes[i]];
+    }
+
+    return decode_message(msg, data, len, out, 0) && !out->failed;
+}
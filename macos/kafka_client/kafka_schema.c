@@ -0,0 +1,376 @@
+#include <curl/curl.h>
+#include <time.h>
+#include "kafka_internal.h"
+
+// Schema Registry：按schema id缓存解析好的schema，解码Confluent格式的消息
+// （0x00 + 4字节大端schema id + 数据；Protobuf在数据前还有message索引）。
+// schema先从本地目录找 <id>.avsc / <id>.proto / <id>.json，找不到再请求registry的
+// GET /schemas/ids/<id>，所以离线时放好本地文件或起一个stub registry就能测试。
+
+#define SCHEMA_BUCKETS 256
+#define SCHEMA_RETRY_SECONDS 60     // 获取失败后多久重试
+#define SCHEMA_HTTP_TIMEOUT_MS 5000
+#define SCHEMA_MAX_INDEXES 32
+
+typedef enum {
+    SCHEMA_FAILED,
+    SCHEMA_AVRO,
+    SCHEMA_PROTOBUF,
+    SCHEMA_JSON,
+} SchemaKind;
+
+typedef struct SchemaEntry {
+    int32_t id;
+    SchemaKind kind;
+    KafkaAvroSchema* avro;
+    KafkaProtoFile* proto;
+    time_t failed_at;
+    struct SchemaEntry* next;
+} SchemaEntry;
+
+struct KafkaSchemaRegistry {
+    char* url;
+    char* local_dir;
+    pthread_mutex_t lock;
+    SchemaEntry* buckets[SCHEMA_BUCKETS];
+};
+
+static pthread_once_t curl_once = PTHREAD_ONCE_INIT;
+
+static void curl_init_once(void) {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+}
+
+static char* read_file(const char* path, size_t* len) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) {
+        return NULL;
+    }
+
+    KafkaBuffer b = { 0 };
+    char chunk[8192];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), fp)) > 0) {
+        kafka_buffer_append(&b, chunk, n);
+    }
+    fclose(fp);
+    return kafka_buffer_detach(&b, len);
+}
+
+static size_t curl_write(char* data, size_t size, size_t nmemb, void* userdata) {
+    KafkaBuffer* b = (KafkaBuffer*)userdata;
+    kafka_buffer_append(b, data, size * nmemb);
+    return b->failed ? 0 : size * nmemb;
+}
+
+// 请求registry，返回响应体
+static char* http_get(const char* url, size_t* len) {
+    pthread_once(&curl_once, curl_init_once);
+
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        return NULL;
+    }
+
+    KafkaBuffer b = { 0 };
+    curl_easy_setopt(curl, CURLOPT_URL, url);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curl_write);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &b);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, (long)SCHEMA_HTTP_TIMEOUT_MS);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+
+    CURLcode res = curl_easy_perform(curl);
+    long status = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+    curl_easy_cleanup(curl);
+
+    if (res != CURLE_OK || status != 200) {
+        KLOG_ERROR("Schema registry request failed: %s (HTTP %ld)", url, status);
+        kafka_buffer_free(&b);
+        return NULL;
+    }
+    return kafka_buffer_detach(&b, len);
+}
+
+static void entry_set_schema(SchemaEntry* entry, SchemaKind kind, const char* text, size_t len) {
+    switch (kind) {
+        case SCHEMA_AVRO:
+            entry->avro = kafka_avro_schema_parse(text, len);
+            entry->kind = entry->avro ? SCHEMA_AVRO : SCHEMA_FAILED;
+            break;
+        case SCHEMA_PROTOBUF:
+            entry->proto = kafka_proto_parse(text, len);
+            entry->kind = entry->proto ? SCHEMA_PROTOBUF : SCHEMA_FAILED;
+            break;
+        default:
+            entry->kind = kind;
+            break;
+    }
+}
+
+// 从本地目录加载
+static int load_local(KafkaSchemaRegistry* registry, SchemaEntry* entry) {
+    static const struct {
+        const char* ext;
+        SchemaKind kind;
+    } candidates[] = {
+        { "avsc", SCHEMA_AVRO },
+        { "proto", SCHEMA_PROTOBUF },
+        { "json", SCHEMA_JSON },
+    };
+
+    if (!registry->local_dir) {
+        return 0;
+    }
+
+    for (size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++) {
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/%d.%s", registry->local_dir, entry->id, candidates[i].ext);
+        size_t len;
+        char* text = read_file(path, &len);
+        if (!text) {
+            continue;
+        }
+        entry_set_schema(entry, candidates[i].kind, text, len);
+        free(text);
+        if (entry->kind == SCHEMA_FAILED) {
+            KLOG_ERROR("Failed to parse schema file %s", path);
+        }
+        return 1;
+    }
+    return 0;
+}
+
+// 从registry加载：{"schema": "...", "schemaType": "AVRO" | "PROTOBUF" | "JSON"}
+static int load_remote(KafkaSchemaRegistry* registry, SchemaEntry* entry) {
+    if (!registry->url) {
+        return 0;
+    }
+
+    char url[4096];
+    size_t url_len = strlen(registry->url);
+    const char* sep = url_len > 0 && registry->url[url_len - 1] == '/' ? "" : "/";
+    snprintf(url, sizeof(url), "%s%sschemas/ids/%d", registry->url, sep, entry->id);
+
+    size_t len;
+    char* body = http_get(url, &len);
+    if (!body) {
+        return 0;
+    }
+
+    KafkaJsonValue* json = kafka_json_parse(body, len);
+    free(body);
+    const char* schema = kafka_json_get_string(json, "schema");
+    if (!schema) {
+        kafka_json_free(json);
+        return 0;
+    }
+
+    const char* type = kafka_json_get_string(json, "schemaType");
+    SchemaKind kind = SCHEMA_AVRO;  // 没有schemaType时默认Avro
+    if (type && strcmp(type, "PROTOBUF") == 0) {
+        kind = SCHEMA_PROTOBUF;
+    } else if (type && strcmp(type, "JSON") == 0) {
+        kind = SCHEMA_JSON;
+    }
+    entry_set_schema(entry, kind, schema, strlen(schema));
+    kafka_json_free(json);
+    return 1;
+}
+
+static void entry_free(SchemaEntry* entry) {
+    kafka_avro_schema_free(entry->avro);
+    kafka_proto_free(entry->proto);
+    free(entry);
+}
+
+// 查找schema，缓存里没有时加载（加载不持锁，并发加载同一个id时保留先写入的）。
+// 只返回加载成功的记录：成功的记录在registry销毁前不会释放，解码时不需要持锁。
+static SchemaEntry* registry_get(KafkaSchemaRegistry* registry, int32_t id) {
+    size_t bucket = (uint32_t)id % SCHEMA_BUCKETS;
+    time_t now = time(NULL);
+
+    pthread_mutex_lock(&registry->lock);
+    SchemaEntry* entry = registry->buckets[bucket];
+    while (entry && entry->id != id) {
+        entry = entry->next;
+    }
+    if (entry && (entry->kind != SCHEMA_FAILED || now - entry->failed_at < SCHEMA_RETRY_SECONDS)) {
+        pthread_mutex_unlock(&registry->lock);
+        return entry->kind != SCHEMA_FAILED ? entry : NULL;
+    }
+    pthread_mutex_unlock(&registry->lock);
+
+    SchemaEntry* loaded = calloc(1, sizeof(SchemaEntry));
+    if (!loaded) {
+        return NULL;
+    }
+    loaded->id = id;
+    loaded->kind = SCHEMA_FAILED;
+    if (!load_local(registry, loaded)) {
+        load_remote(registry, loaded);
+    }
+    loaded->failed_at = loaded->kind == SCHEMA_FAILED ? now : 0;
+
+    pthread_mutex_lock(&registry->lock);
+    SchemaEntry** slot = &registry->buckets[bucket];
+    while (*slot && (*slot)->id != id) {
+        slot = &(*slot)->next;
+    }
+    if (*slot && (*slot)->kind != SCHEMA_FAILED) {
+        // 别的线程已经加载成功
+        entry_free(loaded);
+        entry = *slot;
+    } else {
+        if (*slot) {
+            // 替换之前失败的记录，失败的记录不会被返回给调用方，可以直接释放
+            SchemaEntry* old = *slot;
+            loaded->next = old->next;
+            entry_free(old);
+        }
+        *slot = loaded;
+        entry = loaded;
+    }
+    if (entry->kind == SCHEMA_FAILED) {
+        entry = NULL;
+    }
+    pthread_mutex_unlock(&registry->lock);
+    return entry;
+}
+
+KafkaSchemaRegistry* kafka_schema_registry_create(const char* url, const char* local_dir) {
+    KafkaSchemaRegistry* registry = calloc(1, sizeof(KafkaSchemaRegistry));
+    if (!registry) {
+        return NULL;
+    }
+    registry->url = url && *url ? strdup(url) : NULL;
+    registry->local_dir = local_dir && *local_dir ? strdup(local_dir) : NULL;
+    pthread_mutex_init(&registry->lock, NULL);
+    return registry;
+}
+
+void kafka_schema_registry_destroy(KafkaSchemaRegistry* registry) {
+    if (!registry) {
+        return;
+    }
+
+    for (size_t i = 0; i < SCHEMA_BUCKETS; i++) {
+        SchemaEntry* entry = registry->buckets[i];
+        while (entry) {
+            SchemaEntry* next = entry->next;
+            entry_free(entry);
+            entry = next;
+        }
+    }
+    pthread_mutex_destroy(&registry->lock);
+    free(registry->url);
+    free(registry->local_dir);
+    free(registry);
+}
+
+static int read_zigzag(const uint8_t** p, const uint8_t* end, int32_t* out) {
+    uint32_t value = 0;
+    for (int shift = 0; *p < end && shift < 35; shift += 7) {
+        uint8_t b = *(*p)++;
+        value |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *out = (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// 解码Confluent格式的消息：成功时把content替换为JSON文本并更新payload_type
+int kafka_schema_decode(KafkaSchemaRegistry* registry, KafkaMessage* message) {
+    if (!registry || message->payload_type != KAFKA_PAYLOAD_CONFLUENT || message->content_len < 5) {
+        return 0;
+    }
+
+    const uint8_t* data = (const uint8_t*)message->content;
+    int32_t id = (int32_t)((uint32_t)data[1] << 24 | (uint32_t)data[2] << 16 | (uint32_t)data[3] << 8 | data[4]);
+    message->schema_id = id;
+
+    SchemaEntry* entry = registry_get(registry, id);
+    if (!entry) {
+        return 0;
+    }
+
+    const uint8_t* p = data + 5;
+    const uint8_t* end = data + message->content_len;
+    KafkaBuffer out = { 0 };
+    int ok = 0;
+    int32_t payload_type = KAFKA_PAYLOAD_JSON;
+
+    switch (entry->kind) {
+        case SCHEMA_AVRO:
+            ok = kafka_avro_decode(entry->avro, p, (size_t)(end - p), &out);
+            payload_type = KAFKA_PAYLOAD_AVRO;
+            break;
+        case SCHEMA_PROTOBUF: {
+            // message索引：个数 + 索引（zigzag varint），个数为0表示[0]
+            int32_t indexes[SCHEMA_MAX_INDEXES];
+            int32_t count;
+            ok = read_zigzag(&p, end, &count) && count >= 0 && count <= SCHEMA_MAX_INDEXES;
+            for (int32_t i = 0; ok && i < count; i++) {
+                ok = read_zigzag(&p, end, &indexes[i]);
+            }
+            if (ok) {
+                ok = kafka_proto_decode(entry->proto, indexes, count, p, (size_t)(end - p), &out);
+            }
+            payload_type = KAFKA_PAYLOAD_PROTOBUF;
+            break;
+        }
+        case SCHEMA_JSON:
+            // JSON Schema格式的数据本身就是JSON
+            ok = kafka_json_validate((const char*)p, (size_t)(end - p));
+            if (ok) {
+                kafka_buffer_append(&out, p, (size_t)(end - p));
+            }
+            break;
+        default:
+            break;
+    }
+
+    size_t len = 0;
+    char* decoded = ok ? kafka_buffer_detach(&out, &len) : NULL;
+    kafka_buffer_free(&out);
+    if (!decoded) {
+        return 0;
+    }
+
+    free(message->content);
+    message->content = decoded;
+    message->content_len = len;
+    message->payload_type = payload_type;
+    return 1;
+}
+
+// 配置Schema Registry解码
+KafkaErrorCode set_kafka_schema_registry(
+    KafkaClientHandle consumer,
+    const char* registry_url,
+    const char* local_dir,
+    int32_t decode_threads) {
+    if (!consumer) {
+        return KAFKA_ERROR;
+    }
+
+    KafkaConsumer* c = (KafkaConsumer*)consumer;
+    if (c->loop) {
+        KLOG_ERROR("Schema registry must be configured before starting the consume loop");
+        return KAFKA_ERROR_CONFIG;
+    }
+
+    kafka_schema_registry_destroy(c->schemas);
+    c->schemas = NULL;
+    c->decode_threads = decode_threads;
+
+    if ((!registry_url || !*registry_url) && (!local_dir || !*local_dir)) {
+        return KAFKA_OK;  // 都为空表示关闭解码
+    }
+
+    c->schemas = kafka_schema_registry_create(registry_url, local_dir);
+    return c->schemas ? KAFKA_OK : KAFKA_ERROR;
+}
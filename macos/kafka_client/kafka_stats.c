@@ -0,0 +1,410 @@
+#include "kafka_internal.h"
+
+// 客户端统计：开启librdkafka的statistics.interval.ms，stats_cb收到的JSON在原生层解析成
+// 按broker、主题、分区组织的定长结构体，保存在每个客户端最近若干个快照的环形缓冲区中。
+// 统计和错误回调都在rd_kafka_poll中触发，每个客户端有一个轮询线程专门处理主队列。
+// Dart一次调用取回某个时间点之后的全部快照；快照带引用计数，取出时不复制，环形缓冲区
+// 覆盖旧快照时只释放自己的引用。
+// librdkafka内部队列的字节数（生产者待发送的msg_size加上各分区预取队列的fetchq_size）计入内存账户。
+
+#define STATS_INTERVAL_MS "2000"
+#define STATS_RING 150          // 约5分钟
+#define STATS_POLL_MS 200
+
+typedef struct {
+    KafkaStatsSnapshot snapshot;    // 必须是第一个字段，交给Dart的指针就是它
+    int32_t refs;
+} StatsEntry;
+
+struct KafkaStats {
+    pthread_mutex_t lock;
+    StatsEntry* ring[STATS_RING];
+    int32_t head;           // 下一个写入位置
+    int32_t count;
+    rd_kafka_t* rk;
+    pthread_t thread;
+    int running;
+    int stopping;
+    KafkaMemoryAccount* memory;     // librdkafka内部队列
+};
+
+// 快照取出后可能在客户端关闭之后才释放，引用计数不能用客户端自己的锁
+static pthread_mutex_t entry_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static int64_t json_int(const KafkaJsonValue* object, const char* key, int64_t fallback) {
+    const KafkaJsonValue* v = kafka_json_get(object, key);
+    return v && v->type == KAFKA_JSON_NUMBER ? v->integer : fallback;
+}
+
+// 滑动窗口统计（rtt、int_latency、batchsize等对象）中的一项
+static int64_t json_window(const KafkaJsonValue* object, const char* window, const char* key) {
+    return json_int(kafka_json_get(object, window), key, 0);
+}
+
+static char* json_strdup(const KafkaJsonValue* object, const char* key) {
+    const char* s = kafka_json_get_string(object, key);
+    return s ? strdup(s) : NULL;
+}
+
+static int32_t json_count(const KafkaJsonValue* object) {
+    int32_t n = 0;
+    if (object && object->type == KAFKA_JSON_OBJECT) {
+        for (const KafkaJsonValue* v = object->child; v; v = v->next) {
+            n++;
+        }
+    }
+    return n;
+}
+
+static void entry_free(StatsEntry* entry) {
+    KafkaStatsSnapshot* s = &entry->snapshot;
+    for (int32_t i = 0; i < s->broker_count; i++) {
+        free(s->brokers[i].name);
+        free(s->brokers[i].state);
+    }
+    for (int32_t i = 0; i < s->topic_count; i++) {
+        free(s->topics[i].topic);
+    }
+    free(s->brokers);
+    free(s->topics);
+    free(s->partitions);
+    free(s->name);
+    free(s->type);
+    free(s->group_state);
+    free(entry);
+}
+
+static void entry_release(StatsEntry* entry) {
+    pthread_mutex_lock(&entry_lock);
+    int32_t refs = --entry->refs;
+    pthread_mutex_unlock(&entry_lock);
+    if (refs == 0) {
+        entry_free(entry);
+    }
+}
+
+static void parse_broker(const KafkaJsonValue* b, KafkaBrokerStats* out) {
+    out->name = json_strdup(b, "name");
+    out->state = json_strdup(b, "state");
+    out->node_id = (int32_t)json_int(b, "nodeid", -1);
+    out->rtt_avg_us = json_window(b, "rtt", "avg");
+    out->rtt_p99_us = json_window(b, "rtt", "p99");
+    out->int_latency_avg_us = json_window(b, "int_latency", "avg");
+    out->outbuf_cnt = json_int(b, "outbuf_cnt", 0);
+    out->waitresp_cnt = json_int(b, "waitresp_cnt", 0);
+    out->tx = json_int(b, "tx", 0);
+    out->tx_errs = json_int(b, "txerrs", 0);
+    out->rx = json_int(b, "rx", 0);
+    out->rx_bytes = json_int(b, "rxbytes", 0);
+    out->rx_errs = json_int(b, "rxerrs", 0);
+    out->req_timeouts = json_int(b, "req_timeouts", 0);
+    out->connects = json_int(b, "connects", 0);
+    out->disconnects = json_int(b, "disconnects", 0);
+}
+
+static void parse_partition(const KafkaJsonValue* p, int32_t topic_index, KafkaPartitionStats* out) {
+    out->topic_index = topic_index;
+    out->partition = (int32_t)json_int(p, "partition", -1);
+    out->leader = (int32_t)json_int(p, "leader", -1);
+    out->msgq_cnt = json_int(p, "msgq_cnt", 0);
+    out->xmit_msgq_cnt = json_int(p, "xmit_msgq_cnt", 0);
+    out->fetchq_cnt = json_int(p, "fetchq_cnt", 0);
+    out->app_offset = json_int(p, "app_offset", -1);
+    out->committed_offset = json_int(p, "committed_offset", -1);
+    out->hi_offset = json_int(p, "hi_offset", -1);
+    out->consumer_lag = json_int(p, "consumer_lag", -1);
+    out->tx_msgs = json_int(p, "txmsgs", 0);
+    out->rx_msgs = json_int(p, "rxmsgs", 0);
+}
+
+// 把一份统计JSON解析成快照，queued_bytes返回librdkafka内部队列的字节数，失败返回NULL
+static StatsEntry* parse_stats(const char* json, size_t len, int64_t* queued_bytes) {
+    KafkaJsonValue* root = kafka_json_parse(json, len);
+    if (!root) {
+        return NULL;
+    }
+    StatsEntry* entry = calloc(1, sizeof(StatsEntry));
+    if (!entry) {
+        kafka_json_free(root);
+        return NULL;
+    }
+    KafkaStatsSnapshot* s = &entry->snapshot;
+    s->name = json_strdup(root, "name");
+    s->type = json_strdup(root, "type");
+    s->time = json_int(root, "time", 0);
+    s->ts_us = json_int(root, "ts", 0);
+    s->replyq = json_int(root, "replyq", 0);
+    s->msg_cnt = json_int(root, "msg_cnt", 0);
+    s->msg_size = json_int(root, "msg_size", 0);
+    *queued_bytes = s->msg_size;
+    s->tx = json_int(root, "tx", 0);
+    s->tx_bytes = json_int(root, "tx_bytes", 0);
+    s->rx = json_int(root, "rx", 0);
+    s->rx_bytes = json_int(root, "rx_bytes", 0);
+    s->tx_msgs = json_int(root, "txmsgs", 0);
+    s->rx_msgs = json_int(root, "rxmsgs", 0);
+    const KafkaJsonValue* cgrp = kafka_json_get(root, "cgrp");
+    s->group_state = json_strdup(cgrp, "state");
+    s->rebalance_cnt = json_int(cgrp, "rebalance_cnt", 0);
+
+    const KafkaJsonValue* brokers = kafka_json_get(root, "brokers");
+    const KafkaJsonValue* topics = kafka_json_get(root, "topics");
+    int32_t broker_cap = json_count(brokers);
+    int32_t topic_cap = json_count(topics);
+    int32_t partition_cap = 0;
+    for (const KafkaJsonValue* t = topic_cap > 0 ? topics->child : NULL; t; t = t->next) {
+        partition_cap += json_count(kafka_json_get(t, "partitions"));
+    }
+    s->brokers = calloc(broker_cap > 0 ? broker_cap : 1, sizeof(KafkaBrokerStats));
+    s->topics = calloc(topic_cap > 0 ? topic_cap : 1, sizeof(KafkaTopicStats));
+    s->partitions = calloc(partition_cap > 0 ? partition_cap : 1, sizeof(KafkaPartitionStats));
+    if (!s->brokers || !s->topics || !s->partitions) {
+        kafka_json_free(root);
+        entry_free(entry);
+        return NULL;
+    }
+
+    for (const KafkaJsonValue* b = broker_cap > 0 ? brokers->child : NULL; b; b = b->next) {
+        parse_broker(b, &s->brokers[s->broker_count++]);
+    }
+    for (const KafkaJsonValue* t = topic_cap > 0 ? topics->child : NULL; t; t = t->next) {
+        KafkaTopicStats* topic = &s->topics[s->topic_count];
+        topic->topic = json_strdup(t, "topic");
+        topic->batch_size_avg = json_window(t, "batchsize", "avg");
+        topic->batch_count_avg = json_window(t, "batchcnt", "avg");
+        topic->metadata_age_ms = json_int(t, "metadata_age", 0);
+        topic->partition_start = s->partition_count;
+        const KafkaJsonValue* partitions = kafka_json_get(t, "partitions");
+        for (const KafkaJsonValue* p = json_count(partitions) > 0 ? partitions->child : NULL; p; p = p->next) {
+            // -1是librdkafka内部的未分配分区
+            if (json_int(p, "partition", -1) < 0) {
+                continue;
+            }
+            parse_partition(p, s->topic_count, &s->partitions[s->partition_count++]);
+            *queued_bytes += json_int(p, "fetchq_size", 0);
+            topic->partition_count++;
+        }
+        s->topic_count++;
+    }
+    kafka_json_free(root);
+    entry->refs = 1;
+    return entry;
+}
+
+// stats_cb（在轮询线程的rd_kafka_poll中调用），opaque为客户端上下文
+static int stats_cb(rd_kafka_t* rk, char* json, size_t json_len, void* opaque) {
+    (void)rk;
+    KafkaProducer* p = (KafkaProducer*)opaque;
+    KafkaStats* stats = p ? p->stats : NULL;
+    if (!stats) {
+        return 0;
+    }
+    int64_t queued_bytes = 0;
+    StatsEntry* entry = parse_stats(json, json_len, &queued_bytes);
+    if (!entry) {
+        KLOG_WARN("Failed to parse client statistics (%zu bytes)", json_len);
+        return 0;
+    }
+    kafka_memory_set(stats->memory, queued_bytes);
+
+    pthread_mutex_lock(&stats->lock);
+    StatsEntry* evicted = stats->ring[stats->head];
+    stats->ring[stats->head] = entry;
+    stats->head = (stats->head + 1) % STATS_RING;
+    if (stats->count < STATS_RING) {
+        stats->count++;
+    }
+    pthread_mutex_unlock(&stats->lock);
+
+    if (evicted) {
+        entry_release(evicted);
+    }
+    // 返回0，JSON由librdkafka释放
+    return 0;
+}
+
+KafkaStats* kafka_stats_create(void) {
+    KafkaStats* stats = calloc(1, sizeof(KafkaStats));
+    if (stats) {
+        pthread_mutex_init(&stats->lock, NULL);
+    }
+    return stats;
+}
+
+int kafka_stats_configure(rd_kafka_conf_t* conf) {
+    char errstr[512];
+    if (rd_kafka_conf_set(conf, "statistics.interval.ms", STATS_INTERVAL_MS, errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK) {
+        KLOG_ERROR("Failed to set statistics.interval.ms: %s", errstr);
+        return 0;
+    }
+    rd_kafka_conf_set_stats_cb(conf, stats_cb);
+    return 1;
+}
+
+static void* stats_poll_thread(void* arg) {
+    KafkaStats* stats = (KafkaStats*)arg;
+    for (;;) {
+        pthread_mutex_lock(&stats->lock);
+        int stopping = stats->stopping;
+        pthread_mutex_unlock(&stats->lock);
+        if (stopping) {
+            return NULL;
+        }
+        rd_kafka_poll(stats->rk, STATS_POLL_MS);
+    }
+}
+
+void kafka_stats_start(KafkaStats* stats, rd_kafka_t* rk) {
+    stats->rk = rk;
+    stats->memory = kafka_memory_account_create("librdkafka", rd_kafka_name(rk));
+    if (pthread_create(&stats->thread, NULL, stats_poll_thread, stats) != 0) {
+        KLOG_WARN("Failed to start statistics poll thread");
+        return;
+    }
+    stats->running = 1;
+}
+
+void kafka_stats_stop(KafkaStats* stats) {
+    if (!stats || !stats->running) {
+        return;
+    }
+    pthread_mutex_lock(&stats->lock);
+    stats->stopping = 1;
+    pthread_mutex_unlock(&stats->lock);
+    pthread_join(stats->thread, NULL);
+    stats->running = 0;
+}
+
+void kafka_stats_destroy(KafkaStats* stats) {
+    if (!stats) {
+        return;
+    }
+    kafka_stats_stop(stats);
+    for (int32_t i = 0; i < STATS_RING; i++) {
+        if (stats->ring[i]) {
+            entry_release(stats->ring[i]);
+        }
+    }
+    kafka_memory_account_destroy(stats->memory);
+    pthread_mutex_destroy(&stats->lock);
+    free(stats);
+}
+
+// 读取客户端统计快照：ts_us大于since_ts_us的快照中最新的max_count个，按时间从旧到新排列
+KafkaStatsSnapshot** get_kafka_stats(
+    KafkaClientHandle client,
+    int64_t since_ts_us,
+    int32_t max_count,
+    int32_t* count) {
+    if (!client || !count) {
+        KLOG_ERROR("get_kafka_stats - Invalid parameters");
+        return NULL;
+    }
+    *count = 0;
+    KafkaStats* stats = ((KafkaProducer*)client)->stats;
+    if (!stats || max_count <= 0) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&stats->lock);
+    // 从最新的往回数，找出要返回的最早一个
+    int32_t n = 0;
+    while (n < stats->count && n < max_count) {
+        StatsEntry* entry = stats->ring[(stats->head - 1 - n + STATS_RING) % STATS_RING];
+        if (entry->snapshot.ts_us <= since_ts_us) {
+            break;
+        }
+        n++;
+    }
+    KafkaStatsSnapshot** snapshots = n > 0 ? malloc(n * sizeof(KafkaStatsSnapshot*)) : NULL;
+    if (snapshots) {
+        pthread_mutex_lock(&entry_lock);
+        for (int32_t i = 0; i < n; i++) {
+            StatsEntry* entry = stats->ring[(stats->head - n + i + STATS_RING) % STATS_RING];
+            entry->refs++;
+            snapshots[i] = &entry->snapshot;
+        }
+        pthread_mutex_unlock(&entry_lock);
+        *count = n;
+    }
+    pthread_mutex_unlock(&stats->lock);
+    return snapshots;
+}
+
+// 释放取出的统计快照
+void free_kafka_stats(KafkaStatsSnapshot** snapshots, int32_t count) {
+    if (!snapshots) {
+        return;
+    }
+    for (int32_t i = 0; i < count; i++) {
+        entry_release((StatsEntry*)snapshots[i]);
+    }
+    free(snapshots);
+}
+
+// 计算扫描速率：比较最近两个快照中每个broker的rxbytes和客户端的rxmsgs
+KafkaErrorCode get_kafka_scan_rate(KafkaClientHandle client, KafkaScanRate* rate) {
+    if (!client || !rate) {
+        KLOG_ERROR("get_kafka_scan_rate - Invalid parameters");
+        return KAFKA_ERROR;
+    }
+    memset(rate, 0, sizeof(*rate));
+    KafkaStats* stats = ((KafkaProducer*)client)->stats;
+    if (!stats) {
+        return KAFKA_ERROR;
+    }
+
+    pthread_mutex_lock(&stats->lock);
+    if (stats->count < 2) {
+        pthread_mutex_unlock(&stats->lock);
+        return KAFKA_ERROR;
+    }
+    const KafkaStatsSnapshot* cur = &stats->ring[(stats->head - 1 + STATS_RING) % STATS_RING]->snapshot;
+    const KafkaStatsSnapshot* prev = &stats->ring[(stats->head - 2 + STATS_RING) % STATS_RING]->snapshot;
+    double dt = (double)(cur->ts_us - prev->ts_us) / 1e6;
+    if (dt <= 0) {
+        pthread_mutex_unlock(&stats->lock);
+        return KAFKA_ERROR;
+    }
+    rate->interval_sec = dt;
+    rate->bytes_per_sec = (double)(cur->rx_bytes - prev->rx_bytes) / dt;
+    rate->msgs_per_sec = (double)(cur->rx_msgs - prev->rx_msgs) / dt;
+
+    rate->brokers = calloc(cur->broker_count > 0 ? cur->broker_count : 1, sizeof(KafkaBrokerRate));
+    for (int32_t i = 0; rate->brokers && i < cur->broker_count; i++) {
+        const KafkaBrokerStats* b = &cur->brokers[i];
+        if (b->node_id < 0 || !b->name) {
+            continue;
+        }
+        int64_t prev_bytes = b->rx_bytes;   // 上一个快照里没有的broker（新连接）速率为0
+        for (int32_t j = 0; j < prev->broker_count; j++) {
+            if (prev->brokers[j].name && strcmp(prev->brokers[j].name, b->name) == 0) {
+                prev_bytes = prev->brokers[j].rx_bytes;
+                break;
+            }
+        }
+        KafkaBrokerRate* r = &rate->brokers[rate->broker_count];
+        r->name = strdup(b->name);
+        if (!r->name) {
+            break;
+        }
+        r->node_id = b->node_id;
+        r->bytes_per_sec = (double)(b->rx_bytes - prev_bytes) / dt;
+        rate->broker_count++;
+    }
+    pthread_mutex_unlock(&stats->lock);
+    return KAFKA_OK;
+}
+
+// 释放扫描速率中的broker列表
+void free_kafka_scan_rate(KafkaScanRate* rate) {
+    if (!rate || !rate->brokers) {
+        return;
+    }
+    for (int32_t i = 0; i < rate->broker_count; i++) {
+        free(rate->brokers[i].name);
+    }
+    free(rate->brokers);
+    rate->brokers = NULL;
+    rate->broker_count = 0;
+}
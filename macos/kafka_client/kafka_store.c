@@ -0,0 +1,290 @@
+#include "kafka_internal.h"
+
+// 消息存储：保存被截断记录的完整payload，按(partition, offset)索引。
+// Dart侧只拿预览，展开或复制时再按需取完整内容。超过容量时按写入顺序淘汰最旧的记录。
+// 存储独立于消费者，停止消费后列表里的消息仍然可以取到完整内容。
+// 超过进程的内存软上限时，写入新记录前先淘汰旧记录直到回到上限以内（或者存储已空）。
+
+#define STORE_INITIAL_BUCKETS 1024
+
+typedef struct StoreEntry {
+    int32_t partition;
+    int64_t offset;
+    char* data;
+    size_t len;
+    struct StoreEntry* bucket_next;  // 同一个桶的链表
+    struct StoreEntry* order_next;   // 写入顺序链表，用于淘汰
+} StoreEntry;
+
+typedef struct {
+    pthread_mutex_t lock;
+    StoreEntry** buckets;
+    size_t bucket_count;
+    size_t entry_count;
+    size_t total_bytes;
+    size_t max_bytes;
+    StoreEntry* oldest;
+    StoreEntry* newest;
+    KafkaMemoryAccount* memory;
+} KafkaStore;
+
+static int32_t store_seq;
+
+static size_t store_hash(int32_t partition, int64_t offset, size_t bucket_count) {
+    uint64_t h = (uint64_t)offset * 0x9E3779B97F4A7C15ULL ^ (uint64_t)(uint32_t)partition * 0xC2B2AE3D27D4EB4FULL;
+    h ^= h >> 29;
+    return (size_t)(h & (bucket_count - 1));
+}
+
+static StoreEntry** store_find_slot(KafkaStore* store, int32_t partition, int64_t offset) {
+    StoreEntry** slot = &store->buckets[store_hash(partition, offset, store->bucket_count)];
+    while (*slot && ((*slot)->partition != partition || (*slot)->offset != offset)) {
+        slot = &(*slot)->bucket_next;
+    }
+    return slot;
+}
+
+static void store_grow(KafkaStore* store) {
+    size_t bucket_count = store->bucket_count * 2;
+    StoreEntry** buckets = calloc(bucket_count, sizeof(StoreEntry*));
+    if (!buckets) {
+        return;  // 扩容失败时继续使用较长的链表
+    }
+
+    for (size_t i = 0; i < store->bucket_count; i++) {
+        StoreEntry* e = store->buckets[i];
+        while (e) {
+            StoreEntry* next = e->bucket_next;
+            size_t b = store_hash(e->partition, e->offset, bucket_count);
+            e->bucket_next = buckets[b];
+            buckets[b] = e;
+            e = next;
+        }
+    }
+
+    free(store->buckets);
+    kafka_memory_charge(store->memory, (int64_t)(bucket_count - store->bucket_count) * sizeof(StoreEntry*));
+    store->buckets = buckets;
+    store->bucket_count = bucket_count;
+}
+
+// 淘汰最旧的记录
+static void store_evict_oldest(KafkaStore* store) {
+    StoreEntry* e = store->oldest;
+    if (!e) {
+        return;
+    }
+
+    // 按指针在桶链表中查找，不依赖(partition, offset)唯一
+    StoreEntry** slot = &store->buckets[store_hash(e->partition, e->offset, store->bucket_count)];
+    while (*slot && *slot != e) {
+        slot = &(*slot)->bucket_next;
+    }
+    if (*slot) {
+        *slot = e->bucket_next;
+    }
+
+    store->oldest = e->order_next;
+    if (!store->oldest) {
+        store->newest = NULL;
+    }
+    store->entry_count--;
+    store->total_bytes -= e->len;
+    kafka_memory_charge(store->memory, -(int64_t)(e->len + sizeof(StoreEntry)));
+    free(e->data);
+    free(e);
+}
+
+static void store_clear_locked(KafkaStore* store) {
+    while (store->oldest) {
+        store_evict_oldest(store);
+    }
+}
+
+// 创建消息存储
+KafkaStoreHandle create_kafka_store(int64_t max_bytes) {
+    if (max_bytes <= 0) {
+        return NULL;
+    }
+
+    KafkaStore* store = calloc(1, sizeof(KafkaStore));
+    if (!store) {
+        return NULL;
+    }
+
+    store->bucket_count = STORE_INITIAL_BUCKETS;
+    store->buckets = calloc(store->bucket_count, sizeof(StoreEntry*));
+    if (!store->buckets) {
+        free(store);
+        return NULL;
+    }
+    store->max_bytes = (size_t)max_bytes;
+    pthread_mutex_init(&store->lock, NULL);
+
+    char name[32];
+    snprintf(name, sizeof(name), "store-%d", __atomic_add_fetch(&store_seq, 1, __ATOMIC_RELAXED));
+    store->memory = kafka_memory_account_create("store", name);
+    kafka_memory_charge(store->memory, (int64_t)(sizeof(KafkaStore) + store->bucket_count * sizeof(StoreEntry*)));
+    return store;
+}
+
+// 释放消息存储
+void destroy_kafka_store(KafkaStoreHandle handle) {
+    if (!handle) {
+        return;
+    }
+
+    KafkaStore* store = (KafkaStore*)handle;
+    store_clear_locked(store);
+    kafka_memory_account_destroy(store->memory);
+    pthread_mutex_destroy(&store->lock);
+    free(store->buckets);
+    free(store);
+}
+
+// 清空消息存储
+void clear_kafka_store(KafkaStoreHandle handle) {
+    if (!handle) {
+        return;
+    }
+
+    KafkaStore* store = (KafkaStore*)handle;
+    pthread_mutex_lock(&store->lock);
+    store_clear_locked(store);
+    pthread_mutex_unlock(&store->lock);
+}
+
+// 保存完整payload，接管data的所有权
+void kafka_store_put(KafkaStoreHandle handle, int32_t partition, int64_t offset, char* data, size_t len) {
+    KafkaStore* store = (KafkaStore*)handle;
+    if (!store || !data) {
+        free(data);
+        return;
+    }
+
+    // 单条记录超过总容量时不保存
+    if (len > store->max_bytes) {
+        free(data);
+        return;
+    }
+
+    StoreEntry* e = malloc(sizeof(StoreEntry));
+    if (!e) {
+        free(data);
+        return;
+    }
+    e->partition = partition;
+    e->offset = offset;
+    e->data = data;
+    e->len = len;
+    e->order_next = NULL;
+
+    pthread_mutex_lock(&store->lock);
+
+    // 同一位置重复消费时（重新seek、重平衡回放、重新读取同一页），替换已有记录的内容，
+    // 保持每个位置只有一条记录；淘汰顺序沿用原来的写入位置
+    StoreEntry* existing = *store_find_slot(store, partition, offset);
+    if (existing) {
+        free(e);
+        store->total_bytes = store->total_bytes - existing->len + len;
+        kafka_memory_charge(store->memory, (int64_t)len - (int64_t)existing->len);
+        free(existing->data);
+        existing->data = data;
+        existing->len = len;
+        while (store->oldest && store->total_bytes > store->max_bytes) {
+            store_evict_oldest(store);
+        }
+        pthread_mutex_unlock(&store->lock);
+        return;
+    }
+
+    while (store->oldest && (store->total_bytes + len > store->max_bytes || kafka_memory_over_limit())) {
+        store_evict_oldest(store);
+    }
+
+    if (store->entry_count >= store->bucket_count) {
+        store_grow(store);
+    }
+
+    size_t b = store_hash(partition, offset, store->bucket_count);
+    e->bucket_next = store->buckets[b];
+    store->buckets[b] = e;
+
+    if (store->newest) {
+        store->newest->order_next = e;
+    } else {
+        store->oldest = e;
+    }
+    store->newest = e;
+    store->entry_count++;
+    store->total_bytes += len;
+    kafka_memory_charge(store->memory, (int64_t)(len + sizeof(StoreEntry)));
+
+    pthread_mutex_unlock(&store->lock);
+}
+
+// 淘汰最旧的记录，直到进程内存回落到恢复线以下（或者存储已空）。
+// 消费循环因内存暂停后不再有新记录写入，写入时的淘汰只到软上限为止，需要由它主动调用
+void kafka_store_shed(KafkaStoreHandle handle) {
+    KafkaStore* store = (KafkaStore*)handle;
+    if (!store) {
+        return;
+    }
+    pthread_mutex_lock(&store->lock);
+    size_t evicted = 0;
+    while (store->oldest && !kafka_memory_below_resume_mark()) {
+        store_evict_oldest(store);
+        evicted++;
+    }
+    pthread_mutex_unlock(&store->lock);
+    if (evicted > 0) {
+        KLOG_DEBUG("Store shed %zu entries under memory pressure", evicted);
+    }
+}
+
+// 按UTF-8字符边界截断，返回不超过max_bytes的长度
+size_t kafka_utf8_prefix_len(const char* data, size_t len, size_t max_bytes) {
+    if (len <= max_bytes) {
+        return len;
+    }
+
+    size_t n = max_bytes;
+    // 退到被截断字符的首字节
+    while (n > 0 && ((unsigned char)data[n] & 0xC0) == 0x80) {
+        n--;
+    }
+    return n;
+}
+
+// 获取完整消息内容（返回副本，需调用free_kafka_payload释放）
+char* fetch_kafka_payload(KafkaStoreHandle handle, int32_t partition, int64_t offset, int32_t* len) {
+    if (len) {
+        *len = 0;
+    }
+    if (!handle) {
+        return NULL;
+    }
+
+    KafkaStore* store = (KafkaStore*)handle;
+    pthread_mutex_lock(&store->lock);
+    StoreEntry* e = *store_find_slot(store, partition, offset);
+    char* copy = NULL;
+    if (e) {
+        copy = malloc(e->len + 1);
+        if (copy) {
+            memcpy(copy, e->data, e->len);
+            copy[e->len] = '\0';
+            if (len) {
+                *len = (int32_t)e->len;
+            }
+        }
+    }
+    pthread_mutex_unlock(&store->lock);
+
+    return copy;
+}
+
+// 释放完整消息内容
+void free_kafka_payload(char* payload) {
+    free(payload);
+}
@@ -0,0 +1,334 @@
+#include "kafka_internal.h"
+#include <ctype.h>
+
+// 主题索引：按名称排序的主题列表加三元组（trigram）倒排索引，用于主题列表的边输入边搜索。
+// 刷新时和上一次的列表做有序合并，只把新增和删除的主题交给Dart，不再整体替换列表。
+// 搜索不区分大小写；查询不少于3个字符时取最短的倒排表做候选，再逐个确认子串，
+// 结果按排序后的下标返回，Dart侧直接映射到自己保存的同序列表。
+
+#define INDEX_ALPHABET 64
+#define INDEX_GRAMS (INDEX_ALPHABET * INDEX_ALPHABET * INDEX_ALPHABET)
+
+struct KafkaTopicIndex {
+    pthread_mutex_t lock;
+    int32_t refs;           // 调用方一个引用，异步刷新执行期间各持有一个
+    char** names;           // 按strcmp排序
+    char** lower;           // 小写形式，用于子串匹配
+    int32_t count;
+    int32_t* gram_start;    // 每个三元组的倒排表在gram_ids中的起点（INDEX_GRAMS + 1项）
+    int32_t* gram_ids;      // 倒排表，每个表内的下标递增
+};
+
+typedef struct KafkaTopicIndex KafkaTopicIndex;
+
+// 主题名只允许字母、数字和 . _ -，其他字符折叠到剩余的编码上（候选会再用strstr确认）
+static uint32_t gram_char(unsigned char c) {
+    if (c >= 'a' && c <= 'z') {
+        return c - 'a' + 1;
+    }
+    if (c >= '0' && c <= '9') {
+        return c - '0' + 27;
+    }
+    switch (c) {
+        case '.': return 37;
+        case '_': return 38;
+        case '-': return 39;
+        default: return 40 + c % (INDEX_ALPHABET - 40);
+    }
+}
+
+static uint32_t gram_at(const char* s) {
+    return (gram_char((unsigned char)s[0]) * INDEX_ALPHABET + gram_char((unsigned char)s[1])) * INDEX_ALPHABET +
+        gram_char((unsigned char)s[2]);
+}
+
+static char* lower_dup(const char* s) {
+    char* out = strdup(s);
+    if (out) {
+        for (char* p = out; *p; p++) {
+            *p = (char)tolower((unsigned char)*p);
+        }
+    }
+    return out;
+}
+
+static int compare_names(const void* a, const void* b) {
+    return strcmp(*(const char* const*)a, *(const char* const*)b);
+}
+
+static void names_free(char** names, int32_t count) {
+    if (!names) {
+        return;
+    }
+    for (int32_t i = 0; i < count; i++) {
+        free(names[i]);
+    }
+    free(names);
+}
+
+// 重建倒排索引（调用方持有index->lock），失败时索引为空，搜索退回线性扫描
+static void grams_rebuild_locked(KafkaTopicIndex* index) {
+    free(index->gram_start);
+    free(index->gram_ids);
+    index->gram_start = NULL;
+    index->gram_ids = NULL;
+
+    int32_t* start = calloc(INDEX_GRAMS + 1, sizeof(int32_t));
+    int32_t* last = malloc(INDEX_GRAMS * sizeof(int32_t));
+    if (!start || !last) {
+        free(start);
+        free(last);
+        return;
+    }
+
+    // 第一遍统计每个三元组的主题数（同一主题内重复的三元组只算一次）
+    memset(last, 0xff, INDEX_GRAMS * sizeof(int32_t));
+    int64_t total = 0;
+    for (int32_t i = 0; i < index->count; i++) {
+        const char* s = index->lower[i];
+        for (size_t j = 0; s[j] && s[j + 1] && s[j + 2]; j++) {
+            uint32_t g = gram_at(s + j);
+            if (last[g] != i) {
+                last[g] = i;
+                start[g + 1]++;
+                total++;
+            }
+        }
+    }
+    for (uint32_t g = 0; g < INDEX_GRAMS; g++) {
+        start[g + 1] += start[g];
+    }
+
+    int32_t* ids = malloc((total > 0 ? total : 1) * sizeof(int32_t));
+    int32_t* fill = malloc(INDEX_GRAMS * sizeof(int32_t));
+    if (!ids || !fill) {
+        free(start);
+        free(last);
+        free(ids);
+        free(fill);
+        return;
+    }
+    memcpy(fill, start, INDEX_GRAMS * sizeof(int32_t));
+    memset(last, 0xff, INDEX_GRAMS * sizeof(int32_t));
+    for (int32_t i = 0; i < index->count; i++) {
+        const char* s = index->lower[i];
+        for (size_t j = 0; s[j] && s[j + 1] && s[j + 2]; j++) {
+            uint32_t g = gram_at(s + j);
+            if (last[g] != i) {
+                last[g] = i;
+                ids[fill[g]++] = i;
+            }
+        }
+    }
+    free(last);
+    free(fill);
+
+    index->gram_start = start;
+    index->gram_ids = ids;
+}
+
+// 创建主题索引
+KafkaTopicIndexHandle create_kafka_topic_index(void) {
+    KafkaTopicIndex* index = calloc(1, sizeof(KafkaTopicIndex));
+    if (!index) {
+        return NULL;
+    }
+    pthread_mutex_init(&index->lock, NULL);
+    index->refs = 1;
+    return index;
+}
+
+void kafka_topic_index_retain(KafkaTopicIndexHandle handle) {
+    KafkaTopicIndex* index = (KafkaTopicIndex*)handle;
+    pthread_mutex_lock(&index->lock);
+    index->refs++;
+    pthread_mutex_unlock(&index->lock);
+}
+
+// 销毁主题索引（还有异步刷新在使用时，由最后一个引用释放）
+void destroy_kafka_topic_index(KafkaTopicIndexHandle handle) {
+    if (!handle) {
+        return;
+    }
+    KafkaTopicIndex* index = (KafkaTopicIndex*)handle;
+    pthread_mutex_lock(&index->lock);
+    int32_t refs = --index->refs;
+    pthread_mutex_unlock(&index->lock);
+    if (refs > 0) {
+        return;
+    }
+    names_free(index->names, index->count);
+    names_free(index->lower, index->count);
+    free(index->gram_start);
+    free(index->gram_ids);
+    pthread_mutex_destroy(&index->lock);
+    free(index);
+}
+
+// 用集群当前的主题列表刷新索引，返回和上一次相比新增和删除的主题
+KafkaTopicIndexDiff* refresh_kafka_topic_index(KafkaTopicIndexHandle handle, KafkaClientHandle client) {
+    if (!handle || !client) {
+        KLOG_ERROR("refresh_kafka_topic_index - Invalid parameters");
+        return NULL;
+    }
+    KafkaTopicIndex* index = (KafkaTopicIndex*)handle;
+
+    KafkaMetadataRef* ref;
+    const struct rd_kafka_metadata* metadata = kafka_metadata_all(client, &ref);
+    if (!metadata) {
+        KLOG_ERROR("refresh_kafka_topic_index - Failed to get metadata");
+        return NULL;
+    }
+
+    // 和get_kafka_topics一样过滤内部主题（以__开头）
+    int32_t n = 0;
+    char** names = malloc((metadata->topic_cnt > 0 ? metadata->topic_cnt : 1) * sizeof(char*));
+    char** lower = malloc((metadata->topic_cnt > 0 ? metadata->topic_cnt : 1) * sizeof(char*));
+    KafkaTopicIndexDiff* diff = calloc(1, sizeof(KafkaTopicIndexDiff));
+    int failed = !names || !lower || !diff;
+    for (int i = 0; !failed && i < metadata->topic_cnt; i++) {
+        const char* topic = metadata->topics[i].topic;
+        if (strncmp(topic, "__", 2) == 0) {
+            continue;
+        }
+        names[n] = strdup(topic);
+        if (!names[n]) {
+            failed = 1;
+            break;
+        }
+        n++;
+    }
+    kafka_metadata_release(client, ref);
+
+    if (!failed) {
+        qsort(names, n, sizeof(char*), compare_names);
+        for (int32_t i = 0; i < n; i++) {
+            lower[i] = lower_dup(names[i]);
+            if (!lower[i]) {
+                names_free(lower, i);
+                lower = NULL;
+                failed = 1;
+                break;
+            }
+        }
+    }
+    if (failed) {
+        KLOG_ERROR("refresh_kafka_topic_index - Failed to allocate topic names");
+        names_free(names, n);
+        free(lower);
+        free(diff);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&index->lock);
+    // 两个有序列表合并，得到新增和删除的主题
+    int32_t old_count = index->count;
+    diff->added = malloc((n > 0 ? n : 1) * sizeof(char*));
+    diff->removed = malloc((old_count > 0 ? old_count : 1) * sizeof(char*));
+    if (!diff->added || !diff->removed) {
+        pthread_mutex_unlock(&index->lock);
+        free(diff->added);
+        free(diff->removed);
+        free(diff);
+        names_free(names, n);
+        names_free(lower, n);
+        return NULL;
+    }
+    int32_t i = 0;
+    int32_t j = 0;
+    while (i < old_count || j < n) {
+        int cmp = i >= old_count ? 1 : j >= n ? -1 : strcmp(index->names[i], names[j]);
+        if (cmp == 0) {
+            i++;
+            j++;
+        } else if (cmp < 0) {
+            diff->removed[diff->removed_count++] = strdup(index->names[i++]);
+        } else {
+            diff->added[diff->added_count++] = strdup(names[j++]);
+        }
+    }
+    diff->total = n;
+
+    int changed = diff->added_count > 0 || diff->removed_count > 0 || !index->gram_start;
+    names_free(index->names, old_count);
+    names_free(index->lower, old_count);
+    index->names = names;
+    index->lower = lower;
+    index->count = n;
+    if (changed) {
+        grams_rebuild_locked(index);
+    }
+    pthread_mutex_unlock(&index->lock);
+
+    KLOG_DEBUG("refresh_kafka_topic_index - %d topics, %d added, %d removed",
+        n, diff->added_count, diff->removed_count);
+    return diff;
+}
+
+// 释放刷新结果
+void free_kafka_topic_index_diff(KafkaTopicIndexDiff* diff) {
+    if (!diff) {
+        return;
+    }
+    names_free(diff->added, diff->added_count);
+    names_free(diff->removed, diff->removed_count);
+    free(diff);
+}
+
+// 搜索名称中包含query（不区分大小写）的主题，返回它们在排序后列表中的下标（递增）
+int32_t* search_kafka_topic_index(KafkaTopicIndexHandle handle, const char* query, int32_t* count) {
+    if (!handle || !query || !count) {
+        KLOG_ERROR("search_kafka_topic_index - Invalid parameters");
+        return NULL;
+    }
+    *count = 0;
+    KafkaTopicIndex* index = (KafkaTopicIndex*)handle;
+    char* q = lower_dup(query);
+    if (!q) {
+        return NULL;
+    }
+    size_t qlen = strlen(q);
+
+    pthread_mutex_lock(&index->lock);
+    int32_t* matches = malloc((index->count > 0 ? index->count : 1) * sizeof(int32_t));
+    if (!matches) {
+        pthread_mutex_unlock(&index->lock);
+        free(q);
+        return NULL;
+    }
+
+    int32_t n = 0;
+    if (qlen >= 3 && index->gram_start) {
+        // 取查询中倒排表最短的三元组作为候选集
+        uint32_t best = gram_at(q);
+        for (size_t j = 1; j + 2 < qlen; j++) {
+            uint32_t g = gram_at(q + j);
+            if (index->gram_start[g + 1] - index->gram_start[g] <
+                index->gram_start[best + 1] - index->gram_start[best]) {
+                best = g;
+            }
+        }
+        for (int32_t k = index->gram_start[best]; k < index->gram_start[best + 1]; k++) {
+            int32_t id = index->gram_ids[k];
+            if (strstr(index->lower[id], q)) {
+                matches[n++] = id;
+            }
+        }
+    } else {
+        for (int32_t id = 0; id < index->count; id++) {
+            if (strstr(index->lower[id], q)) {
+                matches[n++] = id;
+            }
+        }
+    }
+    pthread_mutex_unlock(&index->lock);
+    free(q);
+
+    *count = n;
+    return matches;
+}
+
+// 释放搜索结果
+void free_kafka_topic_index_matches(int32_t* matches) {
+    free(matches);
+}
@@ -0,0 +1,629 @@
+#include <errno.h>
+#include <time.h>
+#include <sys/time.h>
+#include <zlib.h>
+#include "kafka_internal.h"
+
+// 自动保存写入线程：消费路径只把原始字节拷贝进待写缓冲区，
+// 写入线程成批取走后一次fwrite+fflush（group commit），并按大小/时间轮转文件，
+// 轮转出的文件交给压缩线程在后台gzip。
+
+#define WRITER_MAX_PENDING_BYTES (32 * 1024 * 1024)  // 待写缓冲区上限，超过时消费路径等待
+#define WRITER_GROUP_COMMIT_BYTES (256 * 1024)       // 不足该大小时稍等片刻再提交
+#define WRITER_GROUP_COMMIT_LINGER_MS 10
+#define WRITER_OUT_FLUSH_BYTES (1024 * 1024)
+#define WRITER_GZIP_CHUNK (256 * 1024)
+
+enum {
+    WRITER_FORMAT_JSON = 0,
+    WRITER_FORMAT_CSV = 1,
+    WRITER_FORMAT_TXT = 2,
+};
+
+typedef struct CompressJob {
+    char* path;
+    struct CompressJob* next;
+} CompressJob;
+
+typedef struct {
+    char* data;
+    size_t len;
+    size_t cap;
+    KafkaMemoryAccount* memory;     // 扩容时按容量记账
+} ByteBuffer;
+
+struct KafkaWriter {
+    char* path;
+    int format;
+    int64_t rotate_bytes;
+    int32_t rotate_interval_sec;
+    int compress;
+
+    // 当前文件（仅写入线程访问）
+    FILE* fp;
+    int64_t file_bytes;
+    time_t file_opened_at;
+    int64_t records_in_file;
+    int32_t rotation_seq;
+    ByteBuffer out;
+
+    // 待写缓冲区，格式为 [uint32长度][原始字节]...
+    pthread_mutex_t lock;
+    pthread_cond_t has_data;
+    pthread_cond_t has_space;
+    ByteBuffer pending;
+    ByteBuffer spare;
+    int stopping;
+    pthread_t thread;
+
+    // 压缩线程
+    pthread_mutex_t compress_lock;
+    pthread_cond_t compress_cond;
+    CompressJob* jobs_head;
+    CompressJob* jobs_tail;
+    int compress_stopping;
+    pthread_t compress_thread;
+};
+
+static int buffer_reserve(ByteBuffer* buf, size_t extra) {
+    if (buf->len + extra <= buf->cap) {
+        return 1;
+    }
+    size_t cap = buf->cap ? buf->cap : 64 * 1024;
+    while (cap < buf->len + extra) {
+        cap *= 2;
+    }
+    char* data = realloc(buf->data, cap);
+    if (!data) {
+        return 0;
+    }
+    kafka_memory_charge(buf->memory, (int64_t)(cap - buf->cap));
+    buf->data = data;
+    buf->cap = cap;
+    return 1;
+}
+
+static void buffer_append(ByteBuffer* buf, const void* data, size_t len) {
+    if (len == 0 || !buffer_reserve(buf, len)) {
+        return;
+    }
+    memcpy(buf->data + buf->len, data, len);
+    buf->len += len;
+}
+
+// ============ 压缩线程 ============
+
+static int gzip_file(const char* src, const char* dst) {
+    FILE* in = fopen(src, "rb");
+    if (!in) {
+        return 0;
+    }
+    gzFile out = gzopen(dst, "wb6");
+    if (!out) {
+        fclose(in);
+        return 0;
+    }
+
+    char* chunk = malloc(WRITER_GZIP_CHUNK);
+    int ok = chunk != NULL;
+    size_t n;
+    while (ok && (n = fread(chunk, 1, WRITER_GZIP_CHUNK, in)) > 0) {
+        if (gzwrite(out, chunk, (unsigned)n) != (int)n) {
+            ok = 0;
+        }
+    }
+    if (ferror(in)) {
+        ok = 0;
+    }
+
+    free(chunk);
+    fclose(in);
+    if (gzclose(out) != Z_OK) {
+        ok = 0;
+    }
+    return ok;
+}
+
+static void* compress_thread_main(void* arg) {
+    KafkaWriter* w = (KafkaWriter*)arg;
+
+    for (;;) {
+        pthread_mutex_lock(&w->compress_lock);
+        while (!w->jobs_head && !w->compress_stopping) {
+            pthread_cond_wait(&w->compress_cond, &w->compress_lock);
+        }
+        CompressJob* job = w->jobs_head;
+        if (job) {
+            w->jobs_head = job->next;
+            if (!w->jobs_head) {
+                w->jobs_tail = NULL;
+            }
+        }
+        pthread_mutex_unlock(&w->compress_lock);
+
+        if (!job) {
+            break;  // 已停止且队列为空
+        }
+
+        size_t len = strlen(job->path);
+        char* dst = malloc(len + 4);
+        if (dst) {
+            memcpy(dst, job->path, len);
+            memcpy(dst + len, ".gz", 4);
+            if (gzip_file(job->path, dst)) {
+                remove(job->path);
+            } else {
+                KLOG_ERROR("auto-save - Failed to compress %s", job->path);
+                remove(dst);
+            }
+            free(dst);
+        }
+        free(job->path);
+        free(job);
+    }
+
+    return NULL;
+}
+
+static void enqueue_compress(KafkaWriter* w, char* path) {
+    CompressJob* job = malloc(sizeof(CompressJob));
+    if (!job) {
+        free(path);
+        return;
+    }
+    job->path = path;
+    job->next = NULL;
+
+    pthread_mutex_lock(&w->compress_lock);
+    if (w->jobs_tail) {
+        w->jobs_tail->next = job;
+    } else {
+        w->jobs_head = job;
+    }
+    w->jobs_tail = job;
+    pthread_cond_signal(&w->compress_cond);
+    pthread_mutex_unlock(&w->compress_lock);
+}
+
+// ============ 文件与轮转（仅写入线程） ============
+
+static void out_flush(KafkaWriter* w) {
+    if (w->fp && w->out.len > 0) {
+        if (fwrite(w->out.data, 1, w->out.len, w->fp) != w->out.len) {
+            KLOG_ERROR("auto-save - Failed to write %s: %s", w->path, strerror(errno));
+        }
+    }
+    w->out.len = 0;
+}
+
+static void out_write(KafkaWriter* w, const void* data, size_t len) {
+    buffer_append(&w->out, data, len);
+    w->file_bytes += (int64_t)len;
+}
+
+static void write_header(KafkaWriter* w) {
+    switch (w->format) {
+        case WRITER_FORMAT_JSON:
+            out_write(w, "[", 1);
+            break;
+        case WRITER_FORMAT_CSV:
+            out_write(w, "Message\n", 8);
+            break;
+        default:
+            // TXT 不需要文件头
+            break;
+    }
+}
+
+static void write_footer(KafkaWriter* w) {
+    if (w->format == WRITER_FORMAT_JSON) {
+        out_write(w, "\n]", 2);
+    }
+}
+
+static int open_file(KafkaWriter* w) {
+    w->fp = fopen(w->path, "wb");
+    if (!w->fp) {
+        KLOG_ERROR("auto-save - Failed to open %s: %s", w->path, strerror(errno));
+        return 0;
+    }
+    w->file_bytes = 0;
+    w->records_in_file = 0;
+    w->file_opened_at = time(NULL);
+    write_header(w);
+    return 1;
+}
+
+static void close_file(KafkaWriter* w) {
+    if (!w->fp) {
+        return;
+    }
+    write_footer(w);
+    out_flush(w);
+    fclose(w->fp);
+    w->fp = NULL;
+}
+
+// 轮转后的文件名：在扩展名前插入时间戳和序号，如 messages-20250101-120000-1.json
+static char* rotated_path(KafkaWriter* w) {
+    const char* slash = strrchr(w->path, '/');
+    const char* dot = strrchr(w->path, '.');
+    if (!dot || (slash && dot < slash)) {
+        dot = w->path + strlen(w->path);
+    }
+
+    char stamp[32];
+    time_t now = time(NULL);
+    struct tm tm_now;
+    localtime_r(&now, &tm_now);
+    strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm_now);
+
+    size_t base_len = (size_t)(dot - w->path);
+    size_t len = base_len + strlen(stamp) + strlen(dot) + 32;
+    char* result = malloc(len);
+    if (!result) {
+        return NULL;
+    }
+    snprintf(result, len, "%.*s-%s-%d%s", (int)base_len, w->path, stamp, ++w->rotation_seq, dot);
+    return result;
+}
+
+static void rotate_if_needed(KafkaWriter* w) {
+    if (!w->fp || w->records_in_file == 0) {
+        return;
+    }
+
+    int by_size = w->rotate_bytes > 0 && w->file_bytes >= w->rotate_bytes;
+    int by_time = w->rotate_interval_sec > 0 &&
+                  time(NULL) - w->file_opened_at >= w->rotate_interval_sec;
+    if (!by_size && !by_time) {
+        return;
+    }
+
+    close_file(w);
+
+    char* target = rotated_path(w);
+    if (target && rename(w->path, target) == 0) {
+        if (w->compress) {
+            enqueue_compress(w, target);
+        } else {
+            free(target);
+        }
+    } else {
+        KLOG_ERROR("auto-save - Failed to rotate %s", w->path);
+        free(target);
+    }
+
+    open_file(w);
+}
+
+// ============ 记录格式化 ============
+
+// 带引号的JSON字符串，非法UTF-8序列的每个字节替换为U+FFFD
+static void write_json_string(KafkaWriter* w, const unsigned char* s, size_t len) {
+    static const char hex[] = "0123456789abcdef";
+    out_write(w, "\"", 1);
+    size_t run = 0;
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = s[i];
+        if (c >= 0x80) {
+            size_t n = kafka_utf8_char_len((const char*)s + i, len - i);
+            if (n > 0) {
+                i += n - 1;
+                continue;
+            }
+            out_write(w, s + run, i - run);
+            out_write(w, "\xEF\xBF\xBD", 3);
+            run = i + 1;
+            continue;
+        }
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        out_write(w, s + run, i - run);
+        run = i + 1;
+        switch (c) {
+            case '"': out_write(w, "\\\"", 2); break;
+            case '\\': out_write(w, "\\\\", 2); break;
+            case '\n': out_write(w, "\\n", 2); break;
+            case '\r': out_write(w, "\\r", 2); break;
+            case '\t': out_write(w, "\\t", 2); break;
+            case '\b': out_write(w, "\\b", 2); break;
+            case '\f': out_write(w, "\\f", 2); break;
+            default: {
+                char esc[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+                out_write(w, esc, 6);
+            }
+        }
+    }
+    out_write(w, s + run, len - run);
+    out_write(w, "\"", 1);
+}
+
+// CSV字段转义：处理逗号、引号和换行符
+static void write_csv_field(KafkaWriter* w, const char* s, size_t len) {
+    int needs_quote = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (s[i] == ',' || s[i] == '"' || s[i] == '\n' || s[i] == '\r') {
+            needs_quote = 1;
+            break;
+        }
+    }
+    if (!needs_quote) {
+        out_write(w, s, len);
+        return;
+    }
+
+    out_write(w, "\"", 1);
+    size_t run = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (s[i] == '"') {
+            out_write(w, s + run, i + 1 - run);
+            out_write(w, "\"", 1);
+            run = i + 1;
+        }
+    }
+    out_write(w, s + run, len - run);
+    out_write(w, "\"", 1);
+}
+
+static void write_record(KafkaWriter* w, const char* payload, size_t len) {
+    rotate_if_needed(w);
+    if (!w->fp) {
+        return;
+    }
+
+    switch (w->format) {
+        case WRITER_FORMAT_JSON:
+            // JSON格式：每条消息作为数组元素，合法JSON原样写入，否则作为字符串
+            if (w->records_in_file > 0) {
+                out_write(w, ",\n", 2);
+            }
+            if (kafka_json_validate(payload, len)) {
+                out_write(w, payload, len);
+            } else {
+                write_json_string(w, (const unsigned char*)payload, len);
+            }
+            break;
+        case WRITER_FORMAT_CSV:
+            write_csv_field(w, payload, len);
+            out_write(w, "\n", 1);
+            break;
+        default:
+            out_write(w, payload, len);
+            out_write(w, "\n", 1);
+    }
+    w->records_in_file++;
+
+    if (w->out.len >= WRITER_OUT_FLUSH_BYTES) {
+        out_flush(w);
+    }
+}
+
+// ============ 写入线程 ============
+
+static void* writer_thread_main(void* arg) {
+    KafkaWriter* w = (KafkaWriter*)arg;
+
+    for (;;) {
+        pthread_mutex_lock(&w->lock);
+        while (w->pending.len == 0 && !w->stopping) {
+            // 按时间轮转时等到轮转时刻为止，主题空闲时文件也按时关闭并压缩
+            // （fp、records_in_file、file_opened_at只有写入线程修改）
+            if (w->rotate_interval_sec <= 0 || !w->fp || w->records_in_file == 0) {
+                pthread_cond_wait(&w->has_data, &w->lock);
+                continue;
+            }
+            struct timespec deadline = { w->file_opened_at + w->rotate_interval_sec, 0 };
+            if (pthread_cond_timedwait(&w->has_data, &w->lock, &deadline) == ETIMEDOUT &&
+                w->pending.len == 0 && !w->stopping) {
+                pthread_mutex_unlock(&w->lock);
+                rotate_if_needed(w);
+                pthread_mutex_lock(&w->lock);
+            }
+        }
+
+        // 数据不多时稍等片刻，把更多消息合并进同一次提交
+        if (w->pending.len < WRITER_GROUP_COMMIT_BYTES && !w->stopping) {
+            struct timeval now;
+            gettimeofday(&now, NULL);
+            struct timespec deadline;
+            long nsec = now.tv_usec * 1000L + WRITER_GROUP_COMMIT_LINGER_MS * 1000000L;
+            deadline.tv_sec = now.tv_sec + nsec / 1000000000L;
+            deadline.tv_nsec = nsec % 1000000000L;
+            pthread_cond_timedwait(&w->has_data, &w->lock, &deadline);
+        }
+
+        ByteBuffer batch = w->pending;
+        w->pending = w->spare;
+        w->pending.len = 0;
+        int stopping = w->stopping;
+        pthread_cond_broadcast(&w->has_space);
+        pthread_mutex_unlock(&w->lock);
+
+        size_t pos = 0;
+        while (pos + sizeof(uint32_t) <= batch.len) {
+            uint32_t len;
+            memcpy(&len, batch.data + pos, sizeof(len));
+            pos += sizeof(len);
+            write_record(w, batch.data + pos, len);
+            pos += len;
+        }
+        out_flush(w);
+        if (w->fp) {
+            fflush(w->fp);
+        }
+
+        pthread_mutex_lock(&w->lock);
+        batch.len = 0;
+        w->spare = batch;
+        pthread_mutex_unlock(&w->lock);
+
+        if (stopping) {
+            break;
+        }
+    }
+
+    close_file(w);
+    return NULL;
+}
+
+// 追加一条原始消息，缓冲区满时等待写入线程追上
+static void kafka_writer_append(KafkaWriter* w, const void* payload, size_t len) {
+    if (!w) {
+        return;
+    }
+    if (!payload) {
+        len = 0;
+    }
+
+    uint32_t record_len = (uint32_t)len;
+    pthread_mutex_lock(&w->lock);
+    while (!w->stopping && w->pending.len > 0 &&
+           w->pending.len + sizeof(record_len) + len > WRITER_MAX_PENDING_BYTES) {
+        pthread_cond_wait(&w->has_space, &w->lock);
+    }
+    if (!w->stopping && buffer_reserve(&w->pending, sizeof(record_len) + len)) {
+        buffer_append(&w->pending, &record_len, sizeof(record_len));
+        buffer_append(&w->pending, payload, len);
+        pthread_cond_signal(&w->has_data);
+    }
+    pthread_mutex_unlock(&w->lock);
+}
+
+// 消费路径调用：如果启用了自动保存，把原始字节交给写入线程
+void kafka_consumer_autosave(KafkaConsumer* c, const void* payload, size_t len) {
+    pthread_mutex_lock(&c->writer_lock);
+    if (c->writer) {
+        kafka_writer_append(c->writer, payload, len);
+    }
+    pthread_mutex_unlock(&c->writer_lock);
+}
+
+// 刷盘、写文件尾并释放写入线程
+static void kafka_writer_destroy(KafkaWriter* w) {
+    if (!w) {
+        return;
+    }
+
+    pthread_mutex_lock(&w->lock);
+    w->stopping = 1;
+    pthread_cond_broadcast(&w->has_data);
+    pthread_cond_broadcast(&w->has_space);
+    pthread_mutex_unlock(&w->lock);
+    pthread_join(w->thread, NULL);
+
+    // 压缩线程会先处理完队列中剩余的文件
+    pthread_mutex_lock(&w->compress_lock);
+    w->compress_stopping = 1;
+    pthread_cond_signal(&w->compress_cond);
+    pthread_mutex_unlock(&w->compress_lock);
+    pthread_join(w->compress_thread, NULL);
+
+    pthread_cond_destroy(&w->compress_cond);
+    pthread_mutex_destroy(&w->compress_lock);
+    pthread_cond_destroy(&w->has_space);
+    pthread_cond_destroy(&w->has_data);
+    pthread_mutex_destroy(&w->lock);
+    kafka_memory_account_destroy(w->out.memory);
+    free(w->pending.data);
+    free(w->spare.data);
+    free(w->out.data);
+    free(w->path);
+    free(w);
+}
+
+static int parse_format(const char* format) {
+    if (format && strcmp(format, "csv") == 0) {
+        return WRITER_FORMAT_CSV;
+    }
+    if (format && strcmp(format, "txt") == 0) {
+        return WRITER_FORMAT_TXT;
+    }
+    return WRITER_FORMAT_JSON;
+}
+
+// 启动自动保存
+KafkaErrorCode start_kafka_auto_save(
+    KafkaClientHandle consumer,
+    const char* file_path,
+    const char* format,
+    int64_t rotate_bytes,
+    int32_t rotate_interval_sec,
+    int32_t compress) {
+    if (!consumer || !file_path) {
+        return KAFKA_ERROR;
+    }
+
+    KafkaConsumer* c = (KafkaConsumer*)consumer;
+    stop_kafka_auto_save(consumer);
+
+    KafkaWriter* w = calloc(1, sizeof(KafkaWriter));
+    if (!w) {
+        return KAFKA_ERROR;
+    }
+
+    w->path = strdup(file_path);
+    w->format = parse_format(format);
+    w->rotate_bytes = rotate_bytes;
+    w->rotate_interval_sec = rotate_interval_sec;
+    w->compress = compress != 0;
+    w->out.memory = kafka_memory_account_create("autosave", rd_kafka_name(c->rk));
+    w->pending.memory = w->out.memory;
+    w->spare.memory = w->out.memory;
+    if (!w->path || !open_file(w)) {
+        kafka_memory_account_destroy(w->out.memory);
+        free(w->path);
+        free(w);
+        return KAFKA_ERROR_FILE;
+    }
+
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->has_data, NULL);
+    pthread_cond_init(&w->has_space, NULL);
+    pthread_mutex_init(&w->compress_lock, NULL);
+    pthread_cond_init(&w->compress_cond, NULL);
+
+    int compress_started = pthread_create(&w->compress_thread, NULL, compress_thread_main, w) == 0;
+    if (!compress_started || pthread_create(&w->thread, NULL, writer_thread_main, w) != 0) {
+        if (compress_started) {
+            pthread_mutex_lock(&w->compress_lock);
+            w->compress_stopping = 1;
+            pthread_cond_signal(&w->compress_cond);
+            pthread_mutex_unlock(&w->compress_lock);
+            pthread_join(w->compress_thread, NULL);
+        }
+        fclose(w->fp);
+        pthread_cond_destroy(&w->compress_cond);
+        pthread_mutex_destroy(&w->compress_lock);
+        pthread_cond_destroy(&w->has_space);
+        pthread_cond_destroy(&w->has_data);
+        pthread_mutex_destroy(&w->lock);
+        kafka_memory_account_destroy(w->out.memory);
+        free(w->out.data);
+        free(w->path);
+        free(w);
+        return KAFKA_ERROR;
+    }
+
+    pthread_mutex_lock(&c->writer_lock);
+    c->writer = w;
+    pthread_mutex_unlock(&c->writer_lock);
+    return KAFKA_OK;
+}
+
+// 停止自动保存，等待剩余数据写完
+KafkaErrorCode stop_kafka_auto_save(KafkaClientHandle consumer) {
+    if (!consumer) {
+        return KAFKA_ERROR;
+    }
+
+    KafkaConsumer* c = (KafkaConsumer*)consumer;
+    pthread_mutex_lock(&c->writer_lock);
+    KafkaWriter* w = c->writer;
+    c->writer = NULL;
+    pthread_mutex_unlock(&c->writer_lock);
+
+    kafka_writer_destroy(w);
+    return KAFKA_OK;
+}
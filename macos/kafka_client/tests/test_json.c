@@ -0,0 +1,45 @@
+#include "../kafka_internal.h"
+#include <assert.h>
+
+// JSON字符串输出：非法UTF-8序列替换为U+FFFD，合法的多字节字符原样保留；语法校验拒绝字符串中的非法UTF-8
+
+static int append_equals(const char* input, size_t len, const char* expected) {
+    KafkaBuffer b = {0};
+    kafka_buffer_append_json_string(&b, input, len);
+    size_t out_len = 0;
+    char* out = kafka_buffer_detach(&b, &out_len);
+    int ok = out && out_len == strlen(expected) && memcmp(out, expected, out_len) == 0;
+    free(out);
+    return ok;
+}
+
+static void test_append_json_string_utf8(void) {
+    assert(append_equals("", 0, "\"\""));
+    assert(append_equals("a\"b\\\n", 5, "\"a\\\"b\\\\\\n\""));
+    // 合法的2/3/4字节字符
+    assert(append_equals("\xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80", 9, "\"\xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80\""));
+    // 孤立的续字节、过长编码、代理项、截断的序列
+    assert(append_equals("a\x80" "b", 3, "\"a\xEF\xBF\xBD" "b\""));
+    assert(append_equals("\xC0\xAF", 2, "\"\xEF\xBF\xBD\xEF\xBF\xBD\""));
+    assert(append_equals("\xED\xA0\x80", 3, "\"\xEF\xBF\xBD\xEF\xBF\xBD\xEF\xBF\xBD\""));
+    assert(append_equals("x\xE4\xB8", 3, "\"x\xEF\xBF\xBD\xEF\xBF\xBD\""));
+    assert(append_equals("\xFF" "\xC3\xA9", 3, "\"\xEF\xBF\xBD\xC3\xA9\""));
+}
+
+static void test_validate_rejects_invalid_utf8(void) {
+    const char ok[] = "{\"k\":\"\xE4\xB8\xAD\xF0\x9F\x98\x80\"}";
+    assert(kafka_json_validate(ok, strlen(ok)));
+
+    const char bad[] = "{\"k\":\"a\xFF\"}";
+    assert(!kafka_json_validate(bad, strlen(bad)));
+
+    const char truncated[] = "[\"\xE4\xB8\"]";
+    assert(!kafka_json_validate(truncated, strlen(truncated)));
+}
+
+int main(void) {
+    test_append_json_string_utf8();
+    test_validate_rejects_invalid_utf8();
+    printf("test_json: ok\n");
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include "../kafka_internal.h"
+#include <assert.h>
+
+// 消息存储：重复(partition, offset)写入后再淘汰，链表里不能留下已释放的记录；扩容后仍取到最新内容
+
+static char* payload(const char* text) {
+    return strdup(text);
+}
+
+static int fetch_equals(KafkaStoreHandle store, int32_t partition, int64_t offset, const char* expected) {
+    int32_t len = 0;
+    char* data = fetch_kafka_payload(store, partition, offset, &len);
+    int ok = expected ? data && len == (int32_t)strlen(expected) && memcmp(data, expected, len) == 0 : data == NULL;
+    free_kafka_payload(data);
+    return ok;
+}
+
+static void test_duplicate_offset_then_evict(void) {
+    // 容量只够放两条8字节的记录
+    KafkaStoreHandle store = create_kafka_store(16);
+    assert(store);
+
+    kafka_store_put(store, 0, 5, payload("first-5."), 8);
+    kafka_store_put(store, 0, 4, payload("offset-4"), 8);
+    // 重复写入(0, 5)替换原记录，不占用额外容量，也不挤掉(0, 4)
+    kafka_store_put(store, 0, 5, payload("second-5"), 8);
+    assert(fetch_equals(store, 0, 5, "second-5"));
+    assert(fetch_equals(store, 0, 4, "offset-4"));
+
+    // 淘汰最早写入的(0, 5)后，桶链表中不能留下它
+    kafka_store_put(store, 0, 6, payload("offset-6"), 8);
+    assert(fetch_equals(store, 0, 5, NULL));
+    assert(fetch_equals(store, 0, 4, "offset-4"));
+    assert(fetch_equals(store, 0, 6, "offset-6"));
+
+    // 继续淘汰和写入，再次访问同一位置
+    kafka_store_put(store, 0, 7, payload("offset-7"), 8);
+    kafka_store_put(store, 0, 5, payload("third-5."), 8);
+    assert(fetch_equals(store, 0, 4, NULL));
+    assert(fetch_equals(store, 0, 6, NULL));
+    assert(fetch_equals(store, 0, 7, "offset-7"));
+    assert(fetch_equals(store, 0, 5, "third-5."));
+
+    // 替换为更长的内容超过容量时淘汰旧记录
+    kafka_store_put(store, 0, 5, payload("a-much-longer-5"), 15);
+    assert(fetch_equals(store, 0, 7, NULL));
+    assert(fetch_equals(store, 0, 5, "a-much-longer-5"));
+
+    destroy_kafka_store(store);
+}
+
+static void test_duplicates_survive_grow_and_clear(void) {
+    KafkaStoreHandle store = create_kafka_store(1 << 20);
+    assert(store);
+
+    // 超过初始桶数，触发扩容；每个偏移量写两次
+    for (int64_t offset = 0; offset < 3000; offset++) {
+        kafka_store_put(store, 1, offset, payload("old"), 3);
+        kafka_store_put(store, 1, offset, payload("new"), 3);
+    }
+    assert(fetch_equals(store, 1, 0, "new"));
+    assert(fetch_equals(store, 1, 2999, "new"));
+
+    clear_kafka_store(store);
+    assert(fetch_equals(store, 1, 0, NULL));
+
+    kafka_store_put(store, 1, 0, payload("again"), 5);
+    assert(fetch_equals(store, 1, 0, "again"));
+    destroy_kafka_store(store);
+}
+
+static int64_t memory_total(void) {
+    int32_t count = 0;
+    int64_t total = 0;
+    KafkaMemoryUsage* usage = get_kafka_memory_usage(&count, &total);
+    free_kafka_memory_usage(usage, count);
+    return total;
+}
+
+static void test_shed_to_resume_mark(void) {
+    KafkaStoreHandle store = create_kafka_store(1 << 20);
+    assert(store);
+    for (int64_t offset = 0; offset < 100; offset++) {
+        char* data = malloc(1000);
+        memset(data, 'x', 1000);
+        kafka_store_put(store, 2, offset, data, 1000);
+    }
+
+    // 占用在恢复线和软上限之间：写入时的淘汰不会动它，shed要淘汰到恢复线以下
+    int64_t total = memory_total();
+    set_kafka_memory_soft_limit(total * 100 / 95);
+    assert(!kafka_memory_over_limit());
+    assert(!kafka_memory_below_resume_mark());
+
+    kafka_store_shed(store);
+    assert(kafka_memory_below_resume_mark());
+    assert(fetch_equals(store, 2, 0, NULL));
+    int32_t len = 0;
+    char* newest = fetch_kafka_payload(store, 2, 99, &len);
+    assert(newest && len == 1000);
+    free_kafka_payload(newest);
+
+    set_kafka_memory_soft_limit(0);
+    destroy_kafka_store(store);
+}
+
+int main(void) {
+    test_duplicate_offset_then_evict();
+    test_duplicates_survive_grow_and_clear();
+    test_shed_to_resume_mark();
+    printf("test_store: ok\n");
+    return 0;
+}
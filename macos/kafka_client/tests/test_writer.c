@@ -0,0 +1,56 @@
+#include "../kafka_internal.h"
+#include <assert.h>
+#include <dirent.h>
+#include <unistd.h>
+
+// 自动保存：按时间轮转时，主题空闲（没有新消息）也要按时关闭文件并在后台压缩
+
+static int count_gz(const char* dir) {
+    int n = 0;
+    DIR* d = opendir(dir);
+    assert(d);
+    for (struct dirent* e; (e = readdir(d)) != NULL;) {
+        size_t len = strlen(e->d_name);
+        if (len > 3 && strcmp(e->d_name + len - 3, ".gz") == 0) {
+            n++;
+        }
+    }
+    closedir(d);
+    return n;
+}
+
+static void test_idle_file_rotates_on_interval(void) {
+    char dir[] = "/tmp/kafka_writer_test_XXXXXX";
+    assert(mkdtemp(dir));
+    char path[256];
+    snprintf(path, sizeof(path), "%s/messages.json", dir);
+
+    KafkaConsumer* c = calloc(1, sizeof(KafkaConsumer));
+    assert(c);
+    pthread_mutex_init(&c->writer_lock, NULL);
+
+    assert(start_kafka_auto_save(c, path, "json", 0, 1, 1) == KAFKA_OK);
+    kafka_consumer_autosave(c, "{\"a\":1}", 7);
+
+    // 之后不再写入，轮转和压缩只能由写入线程的定时等待触发
+    int rotated = 0;
+    for (int i = 0; i < 50 && !rotated; i++) {
+        usleep(100 * 1000);
+        rotated = count_gz(dir) > 0;
+    }
+    assert(rotated);
+
+    assert(stop_kafka_auto_save(c) == KAFKA_OK);
+    pthread_mutex_destroy(&c->writer_lock);
+    free(c);
+
+    char cmd[300];
+    snprintf(cmd, sizeof(cmd), "rm -rf %s", dir);
+    assert(system(cmd) == 0);
+}
+
+int main(void) {
+    test_idle_file_rotates_on_interval();
+    printf("test_writer: ok\n");
+    return 0;
+}
@@ -0,0 +1,66 @@
+import 'package:flutter_test/flutter_test.dart';
+
+import 'package:flutter_kafka/ffi/kafka_worker.dart';
+
+Map<String, dynamic> _row({
+  String topic = 'orders',
+  int partition = 0,
+  int offset = 0,
+  String key = '',
+  String content = '',
+  int timestamp = 0,
+  int payloadType = 0,
+  int schemaId = -1,
+  int contentLength = 0,
+  bool truncated = false,
+}) =>
+    {
+      'topic': topic,
+      'partition': partition,
+      'offset': offset,
+      'content': content,
+      'key': key,
+      'timestamp': timestamp,
+      'payloadType': payloadType,
+      'schemaId': schemaId,
+      'contentLength': contentLength,
+      'truncated': truncated,
+    };
+
+void main() {
+  test('empty batch round-trips', () {
+    expect(KafkaRowCodec.decode(KafkaRowCodec.encode(const [])), isEmpty);
+  });
+
+  test('rows round-trip with shared topic table', () {
+    final rows = [
+      _row(topic: 'orders', partition: 3, offset: 9007199254740991,
+          key: 'k1', content: '{"id":1}', timestamp: 1700000000123,
+          contentLength: 8),
+      _row(topic: '订单-事件', partition: 0, offset: 0, key: '',
+          content: '', timestamp: -1, payloadType: 2, schemaId: 42),
+      _row(topic: 'orders', partition: -1, offset: -1001, key: '键 🔑',
+          content: 'héllo wörld ✓ 😀', contentLength: 123456,
+          truncated: true),
+    ];
+
+    final bytes = KafkaRowCodec.encode(rows);
+    final decoded = KafkaRowCodec.decode(bytes);
+
+    expect(decoded, rows);
+    // 两个不同的主题只写一次
+    expect(bytes.buffer.asByteData().getUint32(0), 2);
+  });
+
+  test('truncated flag is preserved per row', () {
+    final rows = [
+      for (int i = 0; i < 4; i++)
+        _row(offset: i, content: 'x' * i, truncated: i.isOdd),
+    ];
+
+    final decoded = KafkaRowCodec.decode(KafkaRowCodec.encode(rows));
+
+    expect([for (final row in decoded) row['truncated']],
+        [false, true, false, true]);
+  });
+}